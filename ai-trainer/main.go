@@ -4,6 +4,7 @@ import (
 	"bytes"
 	"context"
 	"encoding/json"
+	"errors"
 	"fmt"
 	"io"
 	"log"
@@ -21,7 +22,9 @@ import (
 
 type trainer struct {
 	client       *http.Client
+	streamClient *http.Client // no timeout: batch responses last the whole batch
 	baseURL      string
+	backendURLs  []string // baseURL first; batches are split across all of them
 	pollInterval time.Duration
 	logger       *log.Logger
 	totalBoards  int
@@ -40,6 +43,14 @@ type trainer struct {
 	openingPlies       int
 	eloK               float64
 	validationPassRate float64
+	batchMatches       bool
+	matchWorkers       int
+	sprt               bool
+	sprtElo0           float64
+	sprtElo1           float64
+	sprtAlpha          float64
+	sprtBeta           float64
+	concurrentGames    int
 	originalConfig     map[string]any
 	configOverridden   bool
 
@@ -92,6 +103,7 @@ type trainerStatus struct {
 	ChampionHeuristic   heuristicConfig   `json:"champion_heuristic"`
 	ChallengerHeuristic heuristicConfig   `json:"challenger_heuristic"`
 	ChallengerDetails   []trainerDetail   `json:"challenger_details,omitempty"`
+	Sprt                []trainerSprt     `json:"sprt,omitempty"`
 }
 
 type trainerMatch struct {
@@ -112,6 +124,14 @@ type trainerDetail struct {
 	Heuristics heuristicConfig `json:"heuristics"`
 }
 
+type trainerSprt struct {
+	ID      string  `json:"id"`
+	Games   int     `json:"games"`
+	Score   float64 `json:"score"`
+	LLR     float64 `json:"llr"`
+	Verdict string  `json:"verdict,omitempty"`
+}
+
 type heuristicConfig struct {
 	Open4               float64 `json:"open_4"`
 	Closed4             float64 `json:"closed_4"`
@@ -137,16 +157,92 @@ type heuristicsResponse struct {
 }
 
 type openingMove struct {
-	X int
-	Y int
+	X int `json:"x"`
+	Y int `json:"y"`
+}
+
+type batchMatchJob struct {
+	ID      string           `json:"id"`
+	Black   *heuristicConfig `json:"black_heuristics"`
+	White   *heuristicConfig `json:"white_heuristics"`
+	Opening []openingMove    `json:"opening"`
 }
 
+type batchMatchResult struct {
+	Index  int    `json:"index"`
+	ID     string `json:"id"`
+	Status string `json:"status"`
+	Winner int    `json:"winner"`
+	Moves  int    `json:"moves"`
+	Error  string `json:"error"`
+}
+
+var errBatchUnsupported = errors.New("backend has no batch match endpoint")
+
 type contender struct {
 	ID         string
 	Heuristics heuristicConfig
 	Elo        float64
 }
 
+type sprtParams struct {
+	elo0, elo1   float64
+	lower, upper float64 // LLR bounds from alpha and beta
+}
+
+// sprtTest is a sequential probability ratio test of a challenger against the
+// champion, H0 elo = elo0 against H1 elo = elo1. Its samples are head-to-head
+// scores (both colors on one opening), and the LLR is the normal
+// approximation for their mean, as fishtest computes it for game pairs. Half
+// a won and half a lost head-to-head of prior keep the variance above zero
+// while every sample ends the same way.
+type sprtTest struct {
+	pairs   int
+	sum     float64
+	sumSq   float64
+	llr     float64
+	verdict string // "stronger" once LLR reaches the upper bound, "weaker" at the lower
+}
+
+func newSprtParams(elo0, elo1, alpha, beta float64) sprtParams {
+	return sprtParams{
+		elo0:  elo0,
+		elo1:  elo1,
+		lower: math.Log(beta / (1 - alpha)),
+		upper: math.Log((1 - beta) / alpha),
+	}
+}
+
+func eloToScore(elo float64) float64 {
+	return 1.0 / (1.0 + math.Pow(10, -elo/400.0))
+}
+
+func (s *sprtTest) add(score float64, p sprtParams) {
+	s.pairs++
+	s.sum += score
+	s.sumSq += score * score
+	n := float64(s.pairs) + 1
+	mean := (s.sum + 0.5) / n
+	variance := (s.sumSq+0.5)/n - mean*mean
+	s0, s1 := eloToScore(p.elo0), eloToScore(p.elo1)
+	s.llr = n * (s1 - s0) * (2*mean - s0 - s1) / (2 * variance)
+	if s.verdict != "" {
+		return
+	}
+	if s.llr >= p.upper {
+		s.verdict = "stronger"
+	} else if s.llr <= p.lower {
+		s.verdict = "weaker"
+	}
+}
+
+func (s *sprtTest) score() float64 {
+	if s.pairs == 0 {
+		return 0
+	}
+	return s.sum / float64(s.pairs)
+}
+
 func main() {
 	logger, closeLog, err := buildLogger("/logs/AITrainer.log")
 	if err != nil {
@@ -203,11 +299,39 @@ func main() {
 	if validationPassRate <= 0 || validationPassRate > 1 {
 		validationPassRate = 0.52
 	}
+	batchMatches := getenvInt("TRAINER_BATCH_MATCHES", 1) != 0
+	matchWorkers := getenvInt("TRAINER_MATCH_WORKERS", 0)
+	backendURLs := []string{baseURL}
+	for _, url := range strings.Split(getenv("BACKEND_URLS", ""), ",") {
+		if url = strings.TrimSpace(url); url != "" && url != baseURL {
+			backendURLs = append(backendURLs, url)
+		}
+	}
+	sprt := getenvInt("HEURISTIC_SPRT", 1) != 0
+	sprtElo0 := getenvFloat("HEURISTIC_SPRT_ELO0", 0)
+	sprtElo1 := getenvFloat("HEURISTIC_SPRT_ELO1", 100)
+	if sprtElo1 <= sprtElo0 {
+		sprtElo1 = sprtElo0 + 100
+	}
+	sprtAlpha := getenvFloat("HEURISTIC_SPRT_ALPHA", 0.05)
+	if sprtAlpha <= 0 || sprtAlpha >= 0.5 {
+		sprtAlpha = 0.05
+	}
+	sprtBeta := getenvFloat("HEURISTIC_SPRT_BETA", 0.05)
+	if sprtBeta <= 0 || sprtBeta >= 0.5 {
+		sprtBeta = 0.05
+	}
+	concurrentGames := getenvInt("TRAINER_CONCURRENT_GAMES", 16)
+	if concurrentGames < 2 {
+		concurrentGames = 2
+	}
 	t := &trainer{
 		client: &http.Client{
 			Timeout: 10 * time.Second,
 		},
+		streamClient:       &http.Client{},
 		baseURL:            baseURL,
+		backendURLs:        backendURLs,
 		pollInterval:       time.Duration(pollMs) * time.Millisecond,
 		logger:             logger,
 		mode:               mode,
@@ -224,6 +348,14 @@ func main() {
 		openingPlies:       openingPlies,
 		eloK:               eloK,
 		validationPassRate: validationPassRate,
+		batchMatches:       batchMatches,
+		matchWorkers:       matchWorkers,
+		sprt:               sprt,
+		sprtElo0:           sprtElo0,
+		sprtElo1:           sprtElo1,
+		sprtAlpha:          sprtAlpha,
+		sprtBeta:           sprtBeta,
+		concurrentGames:    concurrentGames,
 		status: trainerStatus{
 			Running:   false,
 			Mode:      mode,
@@ -234,7 +366,7 @@ func main() {
 		},
 	}
 
-	t.logf("AI trainer service started. backend=%s mode=%s poll_interval=%s", t.baseURL, t.mode, t.pollInterval)
+	t.logf("AI trainer service started. backends=%s mode=%s poll_interval=%s", strings.Join(t.backendURLs, ","), t.mode, t.pollInterval)
 	t.startStatusAPI()
 
 	if autostart != "" {
@@ -577,6 +709,9 @@ func (t *trainer) runHeuristicTraining(ctx context.Context) error {
 		default:
 		}
 		roundTotal := (len(population) * (len(population) - 1) / 2) * len(trainOpenings)
+		if t.sprt {
+			roundTotal = (len(population) - 1) * max(t.matchesPerRound/2, 1)
+		}
 		roundStart := time.Now().UTC()
 		t.updateStatus(func(s *trainerStatus) {
 			s.Generation = generation
@@ -585,16 +720,41 @@ func (t *trainer) runHeuristicTraining(ctx context.Context) error {
 			s.RoundMatchesTotal = roundTotal
 			s.EtaSeconds = 0
 		})
-		gamesPlayed, err := t.runPopulationRound(ctx, population, trainOpenings, generation, roundStart, roundTotal)
+		var gamesPlayed int
+		var tests []sprtTest
+		if t.sprt {
+			gamesPlayed, tests, err = t.runSprtRound(ctx, population, trainOpenings, generation, roundStart, roundTotal)
+		} else {
+			gamesPlayed, err = t.runPopulationRound(ctx, population, trainOpenings, generation, roundStart, roundTotal)
+		}
 		if err != nil {
 			return err
 		}
+
+		promoted := false
+		if t.sprt {
+			// The SPRT already is the validation: promote the best challenger
+			// it found stronger, if any.
+			winner := -1
+			for i := 1; i < len(tests); i++ {
+				if tests[i].verdict == "stronger" && (winner < 0 || tests[i].score() > tests[winner].score()) {
+					winner = i
+				}
+			}
+			if winner > 0 {
+				rate := tests[winner].score()
+				t.updateStatus(func(s *trainerStatus) {
+					s.LastValidationRate = rate
+				})
+				champion = contender{ID: fmt.Sprintf("champion-g%d", generation), Heuristics: population[winner].Heuristics, Elo: 1500}
+				promoted = true
+			}
+		}
 		sortContendersByElo(population)
 		best := population[0]
 		challenger := population[1]
 
-		promoted := false
-		if !heuristicsEqual(best.Heuristics, champion.Heuristics) {
+		if !t.sprt && !heuristicsEqual(best.Heuristics, champion.Heuristics) {
 			points, total, err := t.runValidation(ctx, best.Heuristics, champion.Heuristics, valOpenings)
 			if err != nil {
 				return err
@@ -634,6 +794,14 @@ func (t *trainer) runHeuristicTraining(ctx context.Context) error {
 }
 
 func (t *trainer) runPopulationRound(ctx context.Context, population []contender, openings [][]openingMove, generation int, roundStart time.Time, roundTotal int) (int, error) {
+	if t.batchMatches {
+		games, err := t.runPopulationRoundBatch(ctx, population, openings, generation, roundStart, roundTotal)
+		if !errors.Is(err, errBatchUnsupported) {
+			return games, err
+		}
+		t.logf("%v; falling back to one game at a time", err)
+		t.batchMatches = false
+	}
 	games := 0
 	for i := 0; i < len(population); i++ {
 		for j := i + 1; j < len(population); j++ {
@@ -654,43 +822,214 @@ func (t *trainer) runPopulationRound(ctx context.Context, population []contender
 				if err != nil {
 					return games, err
 				}
-				updateElo(&population[i], &population[j], result, t.eloK)
 				games++
-				ranked := make([]contender, len(population))
-				copy(ranked, population)
-				sortContendersByElo(ranked)
-				t.updateStatus(func(s *trainerStatus) {
-					s.GamesPlayed = games
-					s.TopContenders = toStandings(ranked, 8)
-					s.ChallengerDetails = toChallengerDetails(ranked, s.ChampionHeuristic, 8)
-					if len(ranked) > 0 {
-						s.ChampionHeuristic = ranked[0].Heuristics
-					}
-					if len(ranked) > 1 {
-						s.ChallengerHeuristic = ranked[1].Heuristics
-					}
-					if roundTotal > 0 && games > 0 {
-						elapsedSec := time.Since(roundStart).Seconds()
-						avgSec := elapsedSec / float64(games)
-						remaining := roundTotal - games
-						if remaining < 0 {
-							remaining = 0
-						}
-						s.EtaSeconds = int(math.Round(avgSec * float64(remaining)))
-					} else {
-						s.EtaSeconds = 0
-					}
-				})
-				if games%5 == 0 || games == 1 {
-					t.logf("Gen %d game %d pop(%s vs %s) result=%.1f stones=%d", generation, games, population[i].ID, population[j].ID, result, stones)
-				}
+				t.recordPopulationGame(population, i, j, result, stones, games, generation, roundStart, roundTotal)
 			}
 		}
 	}
 	return games, nil
 }
 
+// runSprtRound tests every challenger against the champion, population[0],
+// with an SPRT instead of a full round robin. Head-to-heads are played in
+// waves of at most concurrentGames games, shared among the undecided
+// challengers and split across the backends. A challenger stops once its test
+// is decided or after matchesPerRound games. Elo follows the same games, so
+// the population can still be ranked for the next generation.
+func (t *trainer) runSprtRound(ctx context.Context, population []contender, openings [][]openingMove, generation int, roundStart time.Time, roundTotal int) (int, []sprtTest, error) {
+	params := newSprtParams(t.sprtElo0, t.sprtElo1, t.sprtAlpha, t.sprtBeta)
+	tests := make([]sprtTest, len(population))
+	maxPairs := max(t.matchesPerRound/2, 1)
+	t.updateStatus(func(s *trainerStatus) {
+		s.CurrentMatch = &trainerMatch{WhiteID: population[0].ID, Stage: "sprt"}
+		s.GamesPlayed = 0
+		s.Sprt = toSprtStandings(population, tests)
+	})
+	type pairing struct {
+		i      int
+		points float64
+		stones int
+		legs   int
+	}
+	games := 0
+	for {
+		if ctx.Err() != nil {
+			return games, tests, ctx.Err()
+		}
+		var undecided []int
+		for i := 1; i < len(population); i++ {
+			if tests[i].verdict == "" && tests[i].pairs < maxPairs {
+				undecided = append(undecided, i)
+			}
+		}
+		if len(undecided) == 0 {
+			break
+		}
+		perChallenger := max(t.concurrentGames/(2*len(undecided)), 1)
+		var pairings []pairing
+		var jobs []batchMatchJob
+		for _, i := range undecided {
+			for k := tests[i].pairs; k < tests[i].pairs+perChallenger && k < maxPairs; k++ {
+				id := fmt.Sprintf("g%d-%s-sprt%d", generation, population[i].ID, k)
+				pairings = append(pairings, pairing{i: i})
+				jobs = append(jobs, headToHeadJobs(id, population[i].Heuristics, population[0].Heuristics, openings[k%len(openings)])...)
+			}
+		}
+		err := t.playMatchJobs(ctx, jobs, func(result batchMatchResult) {
+			p := &pairings[result.Index/2]
+			p.points += headToHeadPoints(result.Winner, result.Index%2 == 0)
+			p.stones += result.Moves
+			p.legs++
+			if p.legs < 2 {
+				return
+			}
+			games++
+			tests[p.i].add(p.points/2.0, params)
+			t.recordPopulationGame(population, p.i, 0, p.points/2.0, p.stones/2, games, generation, roundStart, roundTotal)
+			t.updateStatus(func(s *trainerStatus) {
+				s.Sprt = toSprtStandings(population, tests)
+			})
+		})
+		if err != nil {
+			return games, tests, err
+		}
+	}
+	for i := 1; i < len(population); i++ {
+		verdict := tests[i].verdict
+		if verdict == "" {
+			verdict = "undecided"
+		}
+		t.logf("Gen %d sprt %s vs %s: %s after %d head-to-heads score=%.3f llr=%.2f", generation, population[i].ID, population[0].ID, verdict, tests[i].pairs, tests[i].score(), tests[i].llr)
+	}
+	return games, tests, nil
+}
+
+func toSprtStandings(population []contender, tests []sprtTest) []trainerSprt {
+	out := make([]trainerSprt, 0, len(population))
+	for i := 1; i < len(population); i++ {
+		out = append(out, trainerSprt{
+			ID:      population[i].ID,
+			Games:   2 * tests[i].pairs,
+			Score:   tests[i].score(),
+			LLR:     tests[i].llr,
+			Verdict: tests[i].verdict,
+		})
+	}
+	return out
+}
+
+// playMatchJobs plays jobs as batches across the backends, or one live game
+// at a time on the main backend when batches are off or unsupported.
+func (t *trainer) playMatchJobs(ctx context.Context, jobs []batchMatchJob, onResult func(batchMatchResult)) error {
+	if t.batchMatches {
+		err := t.runMatchBatches(ctx, jobs, onResult)
+		if !errors.Is(err, errBatchUnsupported) {
+			return err
+		}
+		t.logf("%v; falling back to one game at a time", err)
+		t.batchMatches = false
+	}
+	for i, job := range jobs {
+		if ctx.Err() != nil {
+			return ctx.Err()
+		}
+		status, stones, err := t.playConfiguredGame(ctx, *job.Black, *job.White, job.Opening)
+		if err != nil {
+			return err
+		}
+		onResult(batchMatchResult{Index: i, ID: job.ID, Status: status.Status, Winner: status.Winner, Moves: stones})
+	}
+	return nil
+}
+
+// runPopulationRoundBatch plays the whole round as one backend batch. Elo is
+// updated as each head-to-head's second game comes back.
+func (t *trainer) runPopulationRoundBatch(ctx context.Context, population []contender, openings [][]openingMove, generation int, roundStart time.Time, roundTotal int) (int, error) {
+	type pairing struct {
+		i, j   int
+		points float64
+		stones int
+		legs   int
+	}
+	var pairings []pairing
+	var jobs []batchMatchJob
+	for i := 0; i < len(population); i++ {
+		for j := i + 1; j < len(population); j++ {
+			for openingIdx, opening := range openings {
+				id := fmt.Sprintf("g%d-%s-%s-o%d", generation, population[i].ID, population[j].ID, openingIdx)
+				pairings = append(pairings, pairing{i: i, j: j})
+				jobs = append(jobs, headToHeadJobs(id, population[i].Heuristics, population[j].Heuristics, opening)...)
+			}
+		}
+	}
+	t.updateStatus(func(s *trainerStatus) {
+		s.CurrentMatch = &trainerMatch{Stage: "population_batch"}
+		s.GamesPlayed = 0
+	})
+	games := 0
+	err := t.runMatchBatches(ctx, jobs, func(result batchMatchResult) {
+		p := &pairings[result.Index/2]
+		p.points += headToHeadPoints(result.Winner, result.Index%2 == 0)
+		p.stones += result.Moves
+		p.legs++
+		if p.legs == 2 {
+			games++
+			t.recordPopulationGame(population, p.i, p.j, p.points/2.0, p.stones/2, games, generation, roundStart, roundTotal)
+		}
+	})
+	return games, err
+}
+
+func (t *trainer) recordPopulationGame(population []contender, i, j int, result float64, stones, games, generation int, roundStart time.Time, roundTotal int) {
+	updateElo(&population[i], &population[j], result, t.eloK)
+	ranked := make([]contender, len(population))
+	copy(ranked, population)
+	sortContendersByElo(ranked)
+	t.updateStatus(func(s *trainerStatus) {
+		s.GamesPlayed = games
+		s.TopContenders = toStandings(ranked, 8)
+		s.ChallengerDetails = toChallengerDetails(ranked, s.ChampionHeuristic, 8)
+		if len(ranked) > 0 {
+			s.ChampionHeuristic = ranked[0].Heuristics
+		}
+		if len(ranked) > 1 {
+			s.ChallengerHeuristic = ranked[1].Heuristics
+		}
+		if roundTotal > 0 && games > 0 {
+			elapsedSec := time.Since(roundStart).Seconds()
+			avgSec := elapsedSec / float64(games)
+			remaining := roundTotal - games
+			if remaining < 0 {
+				remaining = 0
+			}
+			s.EtaSeconds = int(math.Round(avgSec * float64(remaining)))
+		} else {
+			s.EtaSeconds = 0
+		}
+	})
+	if games%5 == 0 || games == 1 {
+		t.logf("Gen %d game %d pop(%s vs %s) result=%.1f stones=%d", generation, games, population[i].ID, population[j].ID, result, stones)
+	}
+}
+
 func (t *trainer) runValidation(ctx context.Context, candidate heuristicConfig, champion heuristicConfig, openings [][]openingMove) (float64, float64, error) {
+	if t.batchMatches {
+		var jobs []batchMatchJob
+		for openingIdx, opening := range openings {
+			jobs = append(jobs, headToHeadJobs(fmt.Sprintf("val-o%d", openingIdx), candidate, champion, opening)...)
+		}
+		points := 0.0
+		total := 0.0
+		err := t.runMatchBatches(ctx, jobs, func(result batchMatchResult) {
+			points += headToHeadPoints(result.Winner, result.Index%2 == 0) / 2.0
+			total += 0.5
+		})
+		if !errors.Is(err, errBatchUnsupported) {
+			return points, total, err
+		}
+		t.logf("%v; falling back to one game at a time", err)
+		t.batchMatches = false
+	}
 	points := 0.0
 	total := 0.0
 	for _, opening := range openings {
@@ -724,20 +1063,160 @@ func (t *trainer) playHeadToHead(ctx context.Context, first, second heuristicCon
 			return 0, 0, err
 		}
 		stones += matchStones
-		switch status.Winner {
-		case 1:
-			if firstBlack {
-				points += 1.0
+		points += headToHeadPoints(status.Winner, firstBlack)
+	}
+	return points / 2.0, stones / 2, nil
+}
+
+// headToHeadPoints scores one game for the first contender of a head-to-head.
+func headToHeadPoints(winner int, firstBlack bool) float64 {
+	switch winner {
+	case 1:
+		if firstBlack {
+			return 1.0
+		}
+	case 2:
+		if !firstBlack {
+			return 1.0
+		}
+	default:
+		return 0.5
+	}
+	return 0
+}
+
+// headToHeadJobs returns the two games of a head-to-head, first contender
+// black then white, so a job's index parity says which side first played.
+func headToHeadJobs(id string, first, second heuristicConfig, opening []openingMove) []batchMatchJob {
+	return []batchMatchJob{
+		{ID: id + "-b", Black: &first, White: &second, Opening: opening},
+		{ID: id + "-w", Black: &second, White: &first, Opening: opening},
+	}
+}
+
+// runMatchBatches splits jobs into one batch per backend, keeping each
+// head-to-head's two games together, and plays the batches concurrently.
+// onResult gets indices into jobs and is never called concurrently.
+func (t *trainer) runMatchBatches(ctx context.Context, jobs []batchMatchJob, onResult func(batchMatchResult)) error {
+	pairs := (len(jobs) + 1) / 2
+	backends := t.backendURLs[:max(minInt(len(t.backendURLs), pairs), 1)]
+	if len(backends) == 1 {
+		return t.runMatchBatch(ctx, backends[0], jobs, onResult)
+	}
+	var mu sync.Mutex
+	var wg sync.WaitGroup
+	errs := make([]error, len(backends))
+	start := 0
+	for b, url := range backends {
+		end := minInt(2*(pairs*(b+1)/len(backends)), len(jobs))
+		chunk, offset := jobs[start:end], start
+		start = end
+		wg.Add(1)
+		go func(b int, url string) {
+			defer wg.Done()
+			errs[b] = t.runMatchBatch(ctx, url, chunk, func(result batchMatchResult) {
+				result.Index += offset
+				mu.Lock()
+				onResult(result)
+				mu.Unlock()
+			})
+		}(b, url)
+	}
+	wg.Wait()
+	if ctx.Err() != nil {
+		return ctx.Err()
+	}
+	unsupported := 0
+	for b, err := range errs {
+		if errors.Is(err, errBatchUnsupported) {
+			unsupported++
+		} else if err != nil {
+			return fmt.Errorf("%s: %w", backends[b], err)
+		}
+	}
+	if unsupported == len(backends) {
+		return errBatchUnsupported
+	}
+	if unsupported > 0 {
+		// Some games already counted, so a sequential replay would count them twice.
+		return fmt.Errorf("%d of %d backends have no batch match endpoint", unsupported, len(backends))
+	}
+	return nil
+}
+
+// runMatchBatch plays jobs through the headless match runner of the backend
+// at baseURL and hands each finished game to onResult as it streams back.
+// Any game that does not finish fails the batch, as a timed-out game fails a
+// sequential round.
+func (t *trainer) runMatchBatch(ctx context.Context, baseURL string, jobs []batchMatchJob, onResult func(batchMatchResult)) error {
+	body, err := json.Marshal(map[string]any{
+		"jobs":            jobs,
+		"workers":         t.matchWorkers,
+		"game_timeout_ms": t.heuristicTimeout.Milliseconds(),
+	})
+	if err != nil {
+		return err
+	}
+	req, err := http.NewRequestWithContext(ctx, http.MethodPost, baseURL+"/api/matches/batch", bytes.NewReader(body))
+	if err != nil {
+		return err
+	}
+	req.Header.Set("Content-Type", "application/json")
+	resp, err := t.streamClient.Do(req)
+	if err != nil {
+		if ctx.Err() != nil {
+			return ctx.Err()
+		}
+		return err
+	}
+	defer resp.Body.Close()
+	if resp.StatusCode == http.StatusNotFound || resp.StatusCode == http.StatusMethodNotAllowed {
+		return errBatchUnsupported
+	}
+	if resp.StatusCode != http.StatusOK {
+		respBody, _ := io.ReadAll(io.LimitReader(resp.Body, 1024))
+		return fmt.Errorf("POST /api/matches/batch -> %d: %s", resp.StatusCode, string(respBody))
+	}
+	decoder := json.NewDecoder(resp.Body)
+	received := 0
+	var failed error
+	for {
+		var result batchMatchResult
+		if err := decoder.Decode(&result); err != nil {
+			if errors.Is(err, io.EOF) {
+				break
 			}
-		case 2:
-			if !firstBlack {
-				points += 1.0
+			if ctx.Err() != nil {
+				return ctx.Err()
 			}
+			return err
+		}
+		received++
+		switch result.Status {
+		case "black_won", "white_won", "draw":
 		default:
-			points += 0.5
+			if failed == nil {
+				failed = fmt.Errorf("match %s ended %s after %d moves", result.ID, result.Status, result.Moves)
+				if result.Error != "" {
+					failed = fmt.Errorf("%w: %s", failed, result.Error)
+				}
+			}
+			continue
+		}
+		if result.Index >= 0 && result.Index < len(jobs) {
+			onResult(result)
 		}
 	}
-	return points / 2.0, stones / 2, nil
+	if failed != nil {
+		return failed
+	}
+	if received != len(jobs) {
+		if ctx.Err() != nil {
+			return ctx.Err()
+		}
+		return fmt.Errorf("match batch returned %d of %d games", received, len(jobs))
+	}
+	return nil
 }
 
 func (t *trainer) playConfiguredGame(ctx context.Context, black heuristicConfig, white heuristicConfig, opening []openingMove) (statusResponse, int, error) {
@@ -1029,18 +1508,25 @@ func defaultHeuristics() heuristicConfig {
 	}
 }
 
+// applyHeuristicConfigOverride applies the training search settings on every
+// backend, since batches may run on any of them.
 func (t *trainer) applyHeuristicConfigOverride() error {
-	var status statusResponse
-	if err := t.getJSON("/api/status", &status); err != nil {
-		return err
-	}
-	cfg := status.Config
-	if cfg == nil {
-		return nil
+	for _, baseURL := range t.backendURLs {
+		var status statusResponse
+		if err := t.getJSONAt(baseURL, "/api/status", &status); err != nil {
+			return err
+		}
+		cfg := status.Config
+		if cfg == nil {
+			continue
+		}
+		cfg["ai_use_tt_cache"] = false
+		cfg["ai_time_budget_ms"] = t.aiTimeBudgetMs
+		if err := t.postJSONAt(baseURL, "/api/settings", map[string]any{"config": cfg}, nil); err != nil {
+			return err
+		}
 	}
-	cfg["ai_use_tt_cache"] = false
-	cfg["ai_time_budget_ms"] = t.aiTimeBudgetMs
-	return t.postJSON("/api/settings", map[string]any{"config": cfg}, nil)
+	return nil
 }
 
 func (t *trainer) restoreHeuristicConfigOverride() error {
@@ -1122,7 +1608,11 @@ func (t *trainer) ttIsFull() (bool, error) {
 }
 
 func (t *trainer) getJSON(path string, out any) error {
-	req, err := http.NewRequest(http.MethodGet, t.baseURL+path, nil)
+	return t.getJSONAt(t.baseURL, path, out)
+}
+
+func (t *trainer) getJSONAt(baseURL, path string, out any) error {
+	req, err := http.NewRequest(http.MethodGet, baseURL+path, nil)
 	if err != nil {
 		return err
 	}
@@ -1139,11 +1629,15 @@ func (t *trainer) getJSON(path string, out any) error {
 }
 
 func (t *trainer) postJSON(path string, payload any, out any) error {
+	return t.postJSONAt(t.baseURL, path, payload, out)
+}
+
+func (t *trainer) postJSONAt(baseURL, path string, payload any, out any) error {
 	body, err := json.Marshal(payload)
 	if err != nil {
 		return err
 	}
-	req, err := http.NewRequest(http.MethodPost, t.baseURL+path, bytes.NewReader(body))
+	req, err := http.NewRequest(http.MethodPost, baseURL+path, bytes.NewReader(body))
 	if err != nil {
 		return err
 	}
@@ -29,41 +29,99 @@ type ThreatWeights struct {
 	ForkFourPlus float64
 }
 
+type threatKind uint8
+
+const (
+	threatWin5 threatKind = iota
+	threatOpen4
+	threatClosed4
+	threatBroken4
+	threatOpen3
+	threatBroken3
+	threatClosed3
+	threatOpen2
+	threatBroken2
+)
+
+// evalPatterns is the source for evalWindowTable; earlier entries win.
 type patternMatch struct {
 	pattern string
-	apply   func(*ThreatTotals)
+	kind    threatKind
 }
 
 var evalPatterns = [...]patternMatch{
-	{pattern: "MMMMM", apply: func(t *ThreatTotals) { t.Win5++ }},
-	{pattern: ".MMMM.", apply: func(t *ThreatTotals) { t.Open4++ }},
-	{pattern: "OMMMM.", apply: func(t *ThreatTotals) { t.Closed4++ }},
-	{pattern: ".MMMMO", apply: func(t *ThreatTotals) { t.Closed4++ }},
-	{pattern: ".MMM.M.", apply: func(t *ThreatTotals) { t.Broken4++ }},
-	{pattern: ".M.MMM.", apply: func(t *ThreatTotals) { t.Broken4++ }},
-	{pattern: ".MMM.", apply: func(t *ThreatTotals) { t.Open3++ }},
-	{pattern: ".MM.M.", apply: func(t *ThreatTotals) { t.Broken3++ }},
-	{pattern: ".M.MM.", apply: func(t *ThreatTotals) { t.Broken3++ }},
-	{pattern: ".MM.", apply: func(t *ThreatTotals) { t.Open2++ }},
-	{pattern: ".M.M.", apply: func(t *ThreatTotals) { t.Broken2++ }},
+	{pattern: "MMMMM", kind: threatWin5},
+	{pattern: ".MMMM.", kind: threatOpen4},
+	{pattern: "OMMMM.", kind: threatClosed4},
+	{pattern: ".MMMMO", kind: threatClosed4},
+	{pattern: ".MMM.M.", kind: threatBroken4},
+	{pattern: ".M.MMM.", kind: threatBroken4},
+	{pattern: ".MMM.", kind: threatOpen3},
+	{pattern: ".MM.M.", kind: threatBroken3},
+	{pattern: ".M.MM.", kind: threatBroken3},
+	{pattern: ".MM.", kind: threatOpen2},
+	{pattern: ".M.M.", kind: threatBroken2},
+}
+
+// evalLineSet lists every scored line for a board size, plus for each cell
+// the row, column, diagonal and anti-diagonal line through it (-1 if none).
+type evalLineSet struct {
+	lines     [][]int
+	cellLines [][4]int
 }
 
 type lineCache struct {
-	mu    sync.Mutex
-	lines map[int][][]int
+	mu   sync.Mutex
+	sets map[int]*evalLineSet
 }
 
-var cachedLines = &lineCache{lines: make(map[int][][]int)}
+var cachedLines = &lineCache{sets: make(map[int]*evalLineSet)}
 
 func getLinesForSize(size int) [][]int {
+	return getLineSetForSize(size).lines
+}
+
+func getLineSetForSize(size int) *evalLineSet {
 	cachedLines.mu.Lock()
 	defer cachedLines.mu.Unlock()
-	if lines, ok := cachedLines.lines[size]; ok {
-		return lines
+	if set, ok := cachedLines.sets[size]; ok {
+		return set
 	}
-	lines := buildLines(size)
-	cachedLines.lines[size] = lines
-	return lines
+	set := buildLineSet(size)
+	cachedLines.sets[size] = set
+	return set
+}
+
+func buildLineSet(size int) *evalLineSet {
+	set := &evalLineSet{lines: buildLines(size)}
+	if size <= 0 {
+		return set
+	}
+	set.cellLines = make([][4]int, size*size)
+	for i := range set.cellLines {
+		set.cellLines[i] = [4]int{-1, -1, -1, -1}
+	}
+	for lineIdx, line := range set.lines {
+		if len(line) < 2 {
+			continue
+		}
+		dir := 0
+		step := line[1] - line[0]
+		switch step {
+		case 1:
+			dir = 0
+		case size:
+			dir = 1
+		case size + 1:
+			dir = 2
+		default:
+			dir = 3
+		}
+		for _, idx := range line {
+			set.cellLines[idx][dir] = lineIdx
+		}
+	}
+	return set
 }
 
 func buildLines(size int) [][]int {
@@ -129,22 +187,73 @@ func collectDiag(size, startX, startY, dx, dy int) []int {
 }
 
 func EvaluateBoard(board Board, sideToMove PlayerColor, config Config) float64 {
-	weights := resolveThreatWeights(config)
-	lines := getLinesForSize(board.Size())
-	me := sideToMove
-	opp := otherPlayer(sideToMove)
-	var tokensBufStack [64]byte
-	tokensBuf := tokensBufStack[:board.Size()+2]
-
-	var totalsMe ThreatTotals
-	var totalsOpp ThreatTotals
-
-	for _, line := range lines {
-		tokensMe := buildTokensInto(board, line, me, tokensBuf)
-		accumulatePatterns(tokensMe, &totalsMe)
-		tokensOpp := buildTokensInto(board, line, opp, tokensBuf)
-		accumulatePatterns(tokensOpp, &totalsOpp)
+	return scoreEvalTotals(computeEvalTotals(board), sideToMove, resolveThreatWeights(config))
+}
+
+// EvalTotals holds the threat totals of each color summed over every line.
+type EvalTotals struct {
+	Black ThreatTotals
+	White ThreatTotals
+}
+
+func (t EvalTotals) forPlayer(player PlayerColor) ThreatTotals {
+	if player == PlayerBlack {
+		return t.Black
+	}
+	return t.White
+}
+
+func computeEvalTotals(board Board) EvalTotals {
+	var totals EvalTotals
+	for _, line := range getLinesForSize(board.Size()) {
+		accumulateLineTotals(&board, line, &totals, 1)
 	}
+	return totals
+}
+
+func accumulateLineTotals(board *Board, line []int, totals *EvalTotals, sign int) {
+	var black, white ThreatTotals
+	packed, n := encodeLine(board, line)
+	accumulateEncodedLine(packed, n, 0, &black)
+	accumulateEncodedLine(packed, n, 1, &white)
+	totals.Black.add(black, sign)
+	totals.White.add(white, sign)
+}
+
+// updateEvalTotals rescores only the lines through the changed cells, moving
+// totals from the before board to the after board.
+func updateEvalTotals(totals *EvalTotals, before, after *Board, changed []Move) {
+	size := after.Size()
+	set := getLineSetForSize(size)
+	var touchedStack [64]int
+	touched := touchedStack[:0]
+	for _, move := range changed {
+		for _, lineIdx := range set.cellLines[move.Y*size+move.X] {
+			if lineIdx < 0 {
+				continue
+			}
+			seen := false
+			for _, existing := range touched {
+				if existing == lineIdx {
+					seen = true
+					break
+				}
+			}
+			if !seen {
+				touched = append(touched, lineIdx)
+			}
+		}
+	}
+	for _, lineIdx := range touched {
+		line := set.lines[lineIdx]
+		accumulateLineTotals(before, line, totals, -1)
+		accumulateLineTotals(after, line, totals, 1)
+	}
+}
+
+func scoreEvalTotals(totals EvalTotals, sideToMove PlayerColor, weights ThreatWeights) float64 {
+	totalsMe := totals.forPlayer(sideToMove)
+	totalsOpp := totals.forPlayer(otherPlayer(sideToMove))
 
 	if totalsMe.Win5 > 0 {
 		return evalInf
@@ -167,67 +276,31 @@ func EvaluateBoard(board Board, sideToMove PlayerColor, config Config) float64 {
 	return score
 }
 
-func resolveThreatWeights(config Config) ThreatWeights {
-	config.Heuristics = resolvedHeuristicConfig(config)
-	return ThreatWeights{
-		Open4:        config.Heuristics.Open4,
-		Closed4:      config.Heuristics.Closed4,
-		Broken4:      config.Heuristics.Broken4,
-		Open3:        config.Heuristics.Open3,
-		Broken3:      config.Heuristics.Broken3,
-		Closed3:      config.Heuristics.Closed3,
-		Open2:        config.Heuristics.Open2,
-		Broken2:      config.Heuristics.Broken2,
-		ForkOpen3:    config.Heuristics.ForkOpen3,
-		ForkFourPlus: config.Heuristics.ForkFourPlus,
+// evaluateState scores state from sideToMove's view, reusing the incremental
+// totals carried by the state when they match the current position.
+func evaluateState(state *GameState, sideToMove PlayerColor, weights ThreatWeights) float64 {
+	if !state.evalTotalsCurrent() {
+		return scoreEvalTotals(computeEvalTotals(state.Board), sideToMove, weights)
 	}
+	return scoreEvalTotals(state.EvalTotals, sideToMove, weights)
 }
 
-func buildTokensInto(board Board, line []int, player PlayerColor, buf []byte) []byte {
-	needed := len(line) + 2
-	if cap(buf) < needed {
-		buf = make([]byte, needed)
-	} else {
-		buf = buf[:needed]
-	}
-	buf[0] = 'O'
-	for i, idx := range line {
-		cell := board.cells[idx]
-		switch cell {
-		case CellEmpty:
-			buf[i+1] = '.'
-		case CellBlack:
-			if player == PlayerBlack {
-				buf[i+1] = 'M'
-			} else {
-				buf[i+1] = 'O'
-			}
-		case CellWhite:
-			if player == PlayerWhite {
-				buf[i+1] = 'M'
-			} else {
-				buf[i+1] = 'O'
-			}
-		}
-	}
-	buf[needed-1] = 'O'
-	return buf
+func resolveThreatWeights(config Config) ThreatWeights {
+	return threatWeightsFor(resolvedHeuristicConfig(config))
 }
 
-func accumulatePatterns(tokens []byte, totals *ThreatTotals) {
-	for i := 0; i < len(tokens); i++ {
-		matched := false
-		for _, entry := range evalPatterns {
-			if matchAt(tokens, entry.pattern, i) {
-				entry.apply(totals)
-				i += len(entry.pattern) - 1
-				matched = true
-				break
-			}
-		}
-		if matched {
-			continue
-		}
+func threatWeightsFor(heuristics HeuristicConfig) ThreatWeights {
+	return ThreatWeights{
+		Open4:        heuristics.Open4,
+		Closed4:      heuristics.Closed4,
+		Broken4:      heuristics.Broken4,
+		Open3:        heuristics.Open3,
+		Broken3:      heuristics.Broken3,
+		Closed3:      heuristics.Closed3,
+		Open2:        heuristics.Open2,
+		Broken2:      heuristics.Broken2,
+		ForkOpen3:    heuristics.ForkOpen3,
+		ForkFourPlus: heuristics.ForkFourPlus,
 	}
 }
 
@@ -243,6 +316,41 @@ func matchAt(tokens []byte, pattern string, start int) bool {
 	return true
 }
 
+func (t *ThreatTotals) add(o ThreatTotals, sign int) {
+	t.Win5 += sign * o.Win5
+	t.Open4 += sign * o.Open4
+	t.Closed4 += sign * o.Closed4
+	t.Broken4 += sign * o.Broken4
+	t.Open3 += sign * o.Open3
+	t.Broken3 += sign * o.Broken3
+	t.Closed3 += sign * o.Closed3
+	t.Open2 += sign * o.Open2
+	t.Broken2 += sign * o.Broken2
+}
+
+func (t *ThreatTotals) addKind(kind threatKind) {
+	switch kind {
+	case threatWin5:
+		t.Win5++
+	case threatOpen4:
+		t.Open4++
+	case threatClosed4:
+		t.Closed4++
+	case threatBroken4:
+		t.Broken4++
+	case threatOpen3:
+		t.Open3++
+	case threatBroken3:
+		t.Broken3++
+	case threatClosed3:
+		t.Closed3++
+	case threatOpen2:
+		t.Open2++
+	case threatBroken2:
+		t.Broken2++
+	}
+}
+
 func weightedSum(t ThreatTotals, w ThreatWeights) float64 {
 	return float64(t.Open4)*w.Open4 +
 		float64(t.Closed4)*w.Closed4 +
@@ -58,3 +58,137 @@ func TestEvaluateWinFive(t *testing.T) {
 		t.Fatalf("expected win score for five in row, got %f", score)
 	}
 }
+
+func TestIncrementalEvalTotalsMatchFullRescan(t *testing.T) {
+	settings := DefaultGameSettings()
+	settings.BoardSize = 9
+	settings.ForbidDoubleThreeBlack = false
+	rules := NewRules(settings)
+	state := DefaultGameState(settings)
+	state.Status = StatusRunning
+	state.ToMove = PlayerBlack
+	state.refreshEvalTotals()
+
+	// Black (3,4) then (6,4) captures the white pair at (4,4)-(5,4).
+	moves := []Move{{X: 3, Y: 4}, {X: 4, Y: 4}, {X: 2, Y: 2}, {X: 5, Y: 4}, {X: 6, Y: 4}}
+	undos := make([]searchMoveUndo, len(moves))
+	for i, move := range moves {
+		if !applyMoveWithUndo(&state, rules, move, state.ToMove, &undos[i]) {
+			t.Fatalf("expected move %d (%d,%d) to be legal", i, move.X, move.Y)
+		}
+		if !state.evalTotalsCurrent() {
+			t.Fatalf("expected eval totals to stay current after move %d", i)
+		}
+		if want := computeEvalTotals(state.Board); state.EvalTotals != want {
+			t.Fatalf("incremental totals diverged after move %d: got %+v want %+v", i, state.EvalTotals, want)
+		}
+	}
+	if state.Board.At(4, 4) != CellEmpty || state.Board.At(5, 4) != CellEmpty {
+		t.Fatalf("expected white pair to be captured")
+	}
+	for i := len(moves) - 1; i >= 0; i-- {
+		undoMoveWithUndo(&state, undos[i])
+		if want := computeEvalTotals(state.Board); state.EvalTotals != want {
+			t.Fatalf("totals mismatch after undoing move %d: got %+v want %+v", i, state.EvalTotals, want)
+		}
+	}
+}
+
+func referenceLineTotals(board Board, line []int, player PlayerColor) ThreatTotals {
+	tokens := []byte{'O'}
+	for _, idx := range line {
+		switch cell := board.At(idx%board.Size(), idx/board.Size()); {
+		case cell == CellEmpty:
+			tokens = append(tokens, '.')
+		case cell == CellFromPlayer(player):
+			tokens = append(tokens, 'M')
+		default:
+			tokens = append(tokens, 'O')
+		}
+	}
+	tokens = append(tokens, 'O')
+	var totals ThreatTotals
+	for i := 0; i < len(tokens); i++ {
+		for _, entry := range evalPatterns {
+			if matchAt(tokens, entry.pattern, i) {
+				totals.addKind(entry.kind)
+				i += len(entry.pattern) - 1
+				break
+			}
+		}
+	}
+	return totals
+}
+
+func TestEvalWindowTableMatchesStringPatterns(t *testing.T) {
+	board := NewBoard(19)
+	rng := splitmix64{state: 0x2545f4914f6cdd1d}
+	for round := 0; round < 200; round++ {
+		board.Reset(19)
+		for i := 0; i < 120; i++ {
+			seed := rng.next()
+			x := int(seed % 19)
+			y := int((seed >> 8) % 19)
+			cell := CellBlack
+			if seed&(1<<20) != 0 {
+				cell = CellWhite
+			}
+			board.Set(x, y, cell)
+		}
+		for _, line := range getLinesForSize(19) {
+			var got EvalTotals
+			accumulateLineTotals(&board, line, &got, 1)
+			if want := referenceLineTotals(board, line, PlayerBlack); got.Black != want {
+				t.Fatalf("black totals mismatch: got %+v want %+v", got.Black, want)
+			}
+			if want := referenceLineTotals(board, line, PlayerWhite); got.White != want {
+				t.Fatalf("white totals mismatch: got %+v want %+v", got.White, want)
+			}
+		}
+	}
+}
+
+func TestThreatWindowTableMatchesContiguousScan(t *testing.T) {
+	board := NewBoard(11)
+	rng := splitmix64{state: 0x9e3779b97f4a7c15}
+	for round := 0; round < 200; round++ {
+		board.Reset(11)
+		for i := 0; i < 50; i++ {
+			seed := rng.next()
+			cell := CellBlack
+			if seed&(1<<20) != 0 {
+				cell = CellWhite
+			}
+			board.Set(int(seed%11), int((seed>>8)%11), cell)
+		}
+		for y := 0; y < 11; y++ {
+			for x := 0; x < 11; x++ {
+				if !board.IsEmpty(x, y) {
+					continue
+				}
+				move := Move{X: x, Y: y}
+				flags := threatFlagsAt(&board, move, 0, 1)
+				for colorIdx, target := range []Cell{CellBlack, CellWhite} {
+					var want uint8
+					for _, dir := range threatDirections {
+						left := countContiguous(board, x, y, -dir[0], -dir[1], target)
+						right := countContiguous(board, x, y, dir[0], dir[1], target)
+						switch total := left + right + 1; {
+						case total >= 5:
+							want |= threatFlagWin
+						case total == 4:
+							want |= threatFlagFour
+						case total == 3:
+							if board.IsEmpty(x-(left+1)*dir[0], y-(left+1)*dir[1]) && board.IsEmpty(x+(right+1)*dir[0], y+(right+1)*dir[1]) {
+								want |= threatFlagOpenThree
+							}
+						}
+					}
+					if flags[colorIdx] != want {
+						t.Fatalf("threat flags at (%d,%d) for %v: got %03b want %03b", x, y, target, flags[colorIdx], want)
+					}
+				}
+			}
+		}
+	}
+}
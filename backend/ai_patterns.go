@@ -0,0 +1,165 @@
+package main
+
+// Line windows are encoded with two bits per cell so pattern detection turns
+// into table loads. Tables are generated once at startup from evalPatterns.
+const (
+	windowEmpty uint64 = 0
+	windowBlack uint64 = 1
+	windowWhite uint64 = 2
+	windowEdge  uint64 = 3
+)
+
+const (
+	evalWindowCells = 7
+	evalWindowMask  = 1<<(2*evalWindowCells) - 1
+
+	threatWindowReach = 4
+	threatWindowSize  = 1 << (2 * 2 * threatWindowReach)
+)
+
+// Threat flag bits returned by threatWindowTable.
+const (
+	threatFlagWin uint8 = 1 << iota
+	threatFlagFour
+	threatFlagOpenThree
+)
+
+var (
+	// evalWindowTable[color][window] is 1+index of the first evalPatterns
+	// entry matching at the window start, or 0.
+	evalWindowTable [2][evalWindowMask + 1]uint8
+	// threatWindowTable[color][window] holds threat flags for placing color
+	// between four cells on each side.
+	threatWindowTable [2][threatWindowSize]uint8
+)
+
+func init() {
+	buildEvalWindowTables()
+	buildThreatWindowTables()
+}
+
+func playerWindowIndex(player PlayerColor) int {
+	if player == PlayerBlack {
+		return 0
+	}
+	return 1
+}
+
+func cellWindowIndex(cell Cell) int {
+	if cell == CellBlack {
+		return 0
+	}
+	return 1
+}
+
+func windowToken(value uint64, me uint64) byte {
+	switch value {
+	case windowEmpty:
+		return '.'
+	case me:
+		return 'M'
+	default:
+		return 'O'
+	}
+}
+
+func buildEvalWindowTables() {
+	var tokens [evalWindowCells]byte
+	for color, me := range [2]uint64{windowBlack, windowWhite} {
+		for code := 0; code <= evalWindowMask; code++ {
+			for i := 0; i < evalWindowCells; i++ {
+				tokens[i] = windowToken(uint64(code>>(2*i))&3, me)
+			}
+			for idx, entry := range evalPatterns {
+				if matchAt(tokens[:], entry.pattern, 0) {
+					evalWindowTable[color][code] = uint8(idx + 1)
+					break
+				}
+			}
+		}
+	}
+}
+
+func buildThreatWindowTables() {
+	for color, me := range [2]uint64{windowBlack, windowWhite} {
+		for code := 0; code < threatWindowSize; code++ {
+			// Low nibble pairs walk away from the move on the negative side,
+			// high ones on the positive side.
+			var side [2][threatWindowReach]uint64
+			for i := 0; i < threatWindowReach; i++ {
+				side[0][i] = uint64(code>>(2*i)) & 3
+				side[1][i] = uint64(code>>(2*(threatWindowReach+i))) & 3
+			}
+			var run [2]int
+			for s := 0; s < 2; s++ {
+				for run[s] < threatWindowReach && side[s][run[s]] == me {
+					run[s]++
+				}
+			}
+			total := run[0] + run[1] + 1
+			var flags uint8
+			switch {
+			case total >= 5:
+				flags = threatFlagWin
+			case total == 4:
+				flags = threatFlagFour
+			case total == 3:
+				if side[0][run[0]] == windowEmpty && side[1][run[1]] == windowEmpty {
+					flags = threatFlagOpenThree
+				}
+			}
+			threatWindowTable[color][code] = flags
+		}
+	}
+}
+
+func (b *Board) windowCell(x, y int) uint64 {
+	if !b.InBounds(x, y) {
+		return windowEdge
+	}
+	bit := uint32(1) << uint(x)
+	if b.black[y]&bit != 0 {
+		return windowBlack
+	}
+	if b.white[y]&bit != 0 {
+		return windowWhite
+	}
+	return windowEmpty
+}
+
+// encodeLine packs a board line with an edge cell on each side; cells past
+// the end read as edge too, which no pattern can match across.
+func encodeLine(board *Board, line []int) (uint64, int) {
+	packed := ^uint64(0)
+	size := board.Size()
+	for i, idx := range line {
+		shift := uint(2 * (i + 1))
+		packed &^= 3 << shift
+		packed |= board.windowCell(idx%size, idx/size) << shift
+	}
+	return packed, len(line) + 2
+}
+
+func accumulateEncodedLine(packed uint64, n int, color int, totals *ThreatTotals) {
+	table := &evalWindowTable[color]
+	for i := 0; i < n; i++ {
+		hit := table[(packed>>uint(2*i))&evalWindowMask]
+		if hit == 0 {
+			continue
+		}
+		entry := &evalPatterns[hit-1]
+		totals.addKind(entry.kind)
+		i += len(entry.pattern) - 1
+	}
+}
+
+// threatWindowCode encodes the four cells on each side of (x, y) along
+// (dx, dy) as an index into threatWindowTable.
+func threatWindowCode(board *Board, x, y, dx, dy int) int {
+	code := 0
+	for i := 1; i <= threatWindowReach; i++ {
+		code |= int(board.windowCell(x-i*dx, y-i*dy)) << uint(2*(i-1))
+		code |= int(board.windowCell(x+i*dx, y+i*dy)) << uint(2*(threatWindowReach+i-1))
+	}
+	return code
+}
@@ -29,11 +29,14 @@ type AIPlayer struct {
 	ponderState   GameState
 	ponderRules   Rules
 	ponderVersion atomic.Uint64
-	ponderKey     uint64
-	ponderMove    Move
+	ponderSlots   []ponderSlot
 	ponderReady   atomic.Bool
 	ponderStop    atomic.Bool
 	heuristics    *HeuristicConfig
+	carry         searchCarry
+	side          atomic.Int32 // side of the last search plus one; 0 before any
+	cacheGame     string
+	headless      bool // batch match player: no ponder worker, no backlog queueing
 }
 
 var moveRandomizer = rand.New(rand.NewSource(time.Now().UnixNano()))
@@ -57,25 +60,37 @@ func NewAIPlayer() *AIPlayer {
 	return player
 }
 
+// newHeadlessAIPlayer returns a player for batch matches, which only ever
+// calls ChooseMove.
+func newHeadlessAIPlayer() *AIPlayer {
+	return &AIPlayer{headless: true}
+}
+
 func (a *AIPlayer) IsHuman() bool {
 	return false
 }
 
 func (a *AIPlayer) ChooseMove(state GameState, rules Rules) Move {
 	config := a.effectiveConfig()
+	a.side.Store(int32(state.ToMove) + 1)
 	stats := &SearchStats{Start: time.Now()}
-	cache := SharedSearchCache()
+	cache := a.searchCache(config)
 	settings := AIScoreSettings{
-		Depth:     config.AiDepth,
-		TimeoutMs: config.AiTimeoutMs,
-		BoardSize: state.Board.Size(),
-		Player:    state.ToMove,
-		Cache:     cache,
-		Config:    config,
-		Stats:     stats,
+		Depth:            config.AiDepth,
+		TimeoutMs:        config.AiTimeoutMs,
+		BoardSize:        state.Board.Size(),
+		Player:           state.ToMove,
+		Cache:            cache,
+		Config:           config,
+		Profile:          newSearchProfile(config),
+		Stats:            stats,
+		Carry:            &a.carry,
+		SkipQueueBacklog: a.headless,
+		TraceLabel:       "choose",
 	}
 	scores := ScoreBoard(state, rules, settings)
 	bestMove, ok := a.selectBestMove(state, rules, settings, stats, scores)
+	recordSearchMetrics("choose", stats)
 	if config.AiLogSearchStats {
 		logSearchStats("choose", stats, settings)
 	}
@@ -100,6 +115,7 @@ func (a *AIPlayer) StartThinkingWithConfig(state GameState, rules Rules, ghostSi
 		<-a.workerDone
 	}
 	a.thinking.Store(true)
+	a.side.Store(int32(state.ToMove) + 1)
 	a.moveReady.Store(false)
 	a.ghostActive.Store(false)
 	a.stopSignal.Store(false)
@@ -111,7 +127,7 @@ func (a *AIPlayer) StartThinkingWithConfig(state GameState, rules Rules, ghostSi
 	go func() {
 		defer close(done)
 		stats := &SearchStats{Start: time.Now()}
-		cache := SharedSearchCache()
+		cache := a.searchCache(config)
 		settings := AIScoreSettings{
 			Depth:      config.AiDepth,
 			TimeoutMs:  config.AiTimeoutMs,
@@ -119,8 +135,11 @@ func (a *AIPlayer) StartThinkingWithConfig(state GameState, rules Rules, ghostSi
 			Player:     stateCopy.ToMove,
 			Cache:      cache,
 			Config:     config,
+			Profile:    newSearchProfile(config),
 			ShouldStop: func() bool { return a.stopSignal.Load() },
 			Stats:      stats,
+			Carry:      &a.carry,
+			TraceLabel: "think",
 		}
 		if config.GhostMode && ghostSink != nil {
 			throttleMs := config.AiGhostThrottleMs
@@ -156,6 +175,7 @@ func (a *AIPlayer) StartThinkingWithConfig(state GameState, rules Rules, ghostSi
 			return
 		}
 		bestMove, ok := a.selectBestMove(stateCopy, rulesCopy, settings, stats, scores)
+		recordSearchMetrics("think", settings.Stats)
 		if settings.Config.AiLogSearchStats {
 			logSearchStats("think", settings.Stats, settings)
 		}
@@ -215,17 +235,22 @@ func (a *AIPlayer) GhostBoardCopy() Board {
 }
 
 func (a *AIPlayer) OnMoveApplied(state GameState, rules Rules) {
-	ensureTT(SharedSearchCache(), GetConfig())
+	config := a.effectiveConfig()
+	ensureTT(a.searchCache(config), config)
+	a.carry.reroot(&state)
 	a.updatePonderState(state, rules)
 }
 
 func (a *AIPlayer) CacheSize() int {
-	return TranspositionSize(SharedSearchCache())
+	return TranspositionSize(a.searchCache(a.effectiveConfig()))
 }
 
 func (a *AIPlayer) ResetForConfigChange() {
 	a.stopSignal.Store(true)
 	a.ponderReady.Store(false)
+	a.carry.mu.Lock()
+	a.carry.reset()
+	a.carry.mu.Unlock()
 	a.stopSignal.Store(false)
 }
 
@@ -250,8 +275,12 @@ func (a *AIPlayer) startPonderWorker() {
 			if state.Hash == 0 {
 				state.recomputeHashes()
 			}
+			if config.AiPonderReplies > 0 && a.isOpponentTurn(state) {
+				a.ponderReplies(state, rules, config, version)
+				continue
+			}
 			stats := &SearchStats{Start: time.Now()}
-			cache := SharedSearchCache()
+			cache := a.searchCache(config)
 			settings := AIScoreSettings{
 				Depth:      config.AiDepth,
 				TimeoutMs:  config.AiTimeoutMs,
@@ -259,6 +288,7 @@ func (a *AIPlayer) startPonderWorker() {
 				Player:     state.ToMove,
 				Cache:      cache,
 				Config:     config,
+				Profile:    newSearchProfile(config),
 				ShouldStop: func() bool { return a.stopSignal.Load() || a.ponderVersion.Load() != version },
 				Stats:      stats,
 			}
@@ -267,16 +297,16 @@ func (a *AIPlayer) startPonderWorker() {
 				continue
 			}
 			bestMove, ok := a.selectBestMove(state, rules, settings, stats, scores)
+			recordSearchMetrics("ponder", stats)
 			if settings.Config.AiLogSearchStats {
 				logSearchStats("ponder", stats, settings)
 			}
 			if ok {
 				bestMove.Depth = stats.CompletedDepths
-				key := ttKeyFor(state, settings.BoardSize)
+				key := orientedKeyFor(&state, settings.BoardSize)
 				a.ponderMu.Lock()
 				if a.ponderVersion.Load() == version {
-					a.ponderKey = key
-					a.ponderMove = bestMove
+					a.ponderSlots = []ponderSlot{{key: key, move: bestMove, ready: true}}
 					a.ponderReady.Store(true)
 				}
 				a.ponderMu.Unlock()
@@ -287,7 +317,7 @@ func (a *AIPlayer) startPonderWorker() {
 
 func (a *AIPlayer) updatePonderState(state GameState, rules Rules) {
 	config := a.effectiveConfig()
-	if !config.AiPonderingEnabled {
+	if a.headless || !config.AiPonderingEnabled {
 		return
 	}
 	if state.Hash == 0 {
@@ -298,6 +328,7 @@ func (a *AIPlayer) updatePonderState(state GameState, rules Rules) {
 	a.ponderRules = rules
 	a.ponderVersion.Add(1)
 	a.ponderReady.Store(false)
+	a.ponderSlots = nil
 	a.ponderCond.Signal()
 	a.ponderMu.Unlock()
 }
@@ -308,6 +339,21 @@ func (a *AIPlayer) SetHeuristicsOverride(heuristics *HeuristicConfig) {
 	a.configMutex.Unlock()
 }
 
+// SetCachePartition names the game this player searches for; with
+// AiCachePartitioned its searches use that game's pool partition.
+func (a *AIPlayer) SetCachePartition(game string) {
+	a.configMutex.Lock()
+	a.cacheGame = game
+	a.configMutex.Unlock()
+}
+
+func (a *AIPlayer) searchCache(config Config) *AISearchCache {
+	a.configMutex.RLock()
+	game := a.cacheGame
+	a.configMutex.RUnlock()
+	return searchCacheFor(game, config)
+}
+
 func (a *AIPlayer) effectiveConfig() Config {
 	config := GetConfig()
 	a.configMutex.RLock()
@@ -326,16 +372,20 @@ func (a *AIPlayer) TakePonderedMove(state GameState, rules Rules) (Move, bool) {
 	if state.Hash == 0 {
 		state.recomputeHashes()
 	}
-	key := ttKeyFor(state, state.Board.Size())
+	key := orientedKeyFor(&state, state.Board.Size())
 	a.ponderMu.Lock()
 	defer a.ponderMu.Unlock()
-	if !a.ponderReady.Load() || a.ponderKey != key {
+	if !a.ponderReady.Load() {
 		return Move{}, false
 	}
-	move := a.ponderMove
-	if ok, _ := rules.IsLegal(state, move, state.ToMove); ok {
-		a.ponderReady.Store(false)
-		return move, true
+	for _, slot := range a.ponderSlots {
+		if !slot.ready || slot.key != key {
+			continue
+		}
+		if ok, _ := rules.IsLegal(state, slot.move, state.ToMove); ok {
+			a.ponderReady.Store(false)
+			return slot.move, true
+		}
 	}
 	return Move{}, false
 }
@@ -390,13 +440,13 @@ func bestMoveFromScores(scores []float64, state GameState, rules Rules, size int
 
 func (a *AIPlayer) selectBestMove(state GameState, rules Rules, settings AIScoreSettings, stats *SearchStats, scores []float64) (Move, bool) {
 	candidates := collectCandidateMoves(state, state.ToMove, settings.BoardSize)
-	candidateSet := buildCandidateSet(candidates)
+	inCandidates := buildCandidateSet(candidates)
 	bestMove, ok := bestMoveFromScores(scores, state, rules, settings.BoardSize)
 	if !ok {
 		return Move{}, false
 	}
 	candidateFallbackUsed := false
-	if _, ok := candidateSet[moveKey{X: bestMove.X, Y: bestMove.Y}]; !ok {
+	if !inCandidates.Has(bestMove) {
 		log.Printf("[ai-player] best move %v outside candidate set, trying fallback candidate", bestMove)
 		if fallback, found := firstLegalCandidate(state, rules, candidates, settings.BoardSize); found {
 			log.Printf("[ai-player] fallback candidate %v", fallback)
@@ -417,7 +467,7 @@ func (a *AIPlayer) selectBestMove(state GameState, rules Rules, settings AIScore
 	if lostModeMove, changed := maybeSelectLostModeMove(scores, state, rules, settings, bestMove); changed {
 		bestMove = lostModeMove
 		fallbackUsed = false
-		if _, ok := candidateSet[moveKey{X: bestMove.X, Y: bestMove.Y}]; !ok {
+		if !inCandidates.Has(bestMove) {
 			log.Printf("[ai-player] lost-mode move %v outside candidate set, reverting to fallback candidate", bestMove)
 			if fallback, found := firstLegalCandidate(state, rules, candidates, settings.BoardSize); found {
 				bestMove = fallback
@@ -553,7 +603,7 @@ func (a *AIPlayer) depthOneBackupMove(state GameState, rules Rules) (Move, bool)
 		TimeoutMs:        config.AiTimeoutMs,
 		BoardSize:        state.Board.Size(),
 		Player:           state.ToMove,
-		Cache:            SharedSearchCache(),
+		Cache:            a.searchCache(config),
 		Config:           config,
 		SkipQueueBacklog: true,
 	}
@@ -621,19 +671,26 @@ func randomAdjacentMove(state GameState, rules Rules) (Move, bool) {
 	return Move{}, false
 }
 
-type moveKey struct {
-	X int
-	Y int
-}
+// candidateSet is a per-row bitmask of candidate cells.
+type candidateSet [maxBoardSize]uint32
 
-func buildCandidateSet(candidates []candidateMove) map[moveKey]struct{} {
-	set := make(map[moveKey]struct{}, len(candidates))
+func buildCandidateSet(candidates []candidateMove) candidateSet {
+	var set candidateSet
 	for _, cand := range candidates {
-		set[moveKey{X: cand.move.X, Y: cand.move.Y}] = struct{}{}
+		if cand.move.X >= 0 && cand.move.X < maxBoardSize && cand.move.Y >= 0 && cand.move.Y < maxBoardSize {
+			set[cand.move.Y] |= 1 << uint(cand.move.X)
+		}
 	}
 	return set
 }
 
+func (s *candidateSet) Has(move Move) bool {
+	if move.X < 0 || move.X >= maxBoardSize || move.Y < 0 || move.Y >= maxBoardSize {
+		return false
+	}
+	return s[move.Y]&(1<<uint(move.X)) != 0
+}
+
 func logMoveSelection(player PlayerColor, move Move, depth, boardSize int) {
 	if boardSize <= 0 {
 		return
@@ -707,10 +764,12 @@ func opponentReplyFragilityGap(state GameState, rules Rules, settings AIScoreSet
 	if replyLimit > len(replyCandidates) {
 		replyLimit = len(replyCandidates)
 	}
-	ctx := minimaxContext{
+	settings = withSearchProfile(settings)
+	ctx := &minimaxContext{
 		rules:    rules,
 		settings: settings,
 		start:    time.Now(),
+		profile:  settings.Profile,
 	}
 	replies := orderCandidateMoves(next, ctx, opponent, oppMaximizing, 1, replyCandidates, replyLimit, nil)
 	if len(replies) == 0 {
@@ -726,7 +785,7 @@ func opponentReplyFragilityGap(state GameState, rules Rules, settings AIScoreSet
 		if !applyMove(&replyState, rules, reply, opponent) {
 			continue
 		}
-		score := evaluateStateHeuristic(replyState, rules, settings)
+		score := evaluateStateHeuristic(&replyState, ctx)
 		if oppMaximizing {
 			if !haveBest || score > best {
 				second = best
@@ -769,14 +828,7 @@ func logSearchStats(tag string, stats *SearchStats, settings AIScoreSettings) {
 	if stats == nil {
 		return
 	}
-	elapsed := time.Duration(0)
-	if !stats.Start.IsZero() {
-		elapsed = time.Since(stats.Start)
-	} else {
-		for _, d := range stats.DepthDurations {
-			elapsed += d
-		}
-	}
+	elapsed := searchElapsed(stats)
 	avgBranch := 0.0
 	if stats.Nodes > 0 {
 		avgBranch = float64(stats.CandidateCount) / float64(stats.Nodes)
@@ -813,11 +865,15 @@ func logSearchStats(tag string, stats *SearchStats, settings AIScoreSettings) {
 	if stats.EvalCacheProbes > 0 {
 		evalHitRate = float64(stats.EvalCacheHits) * 100.0 / float64(stats.EvalCacheProbes)
 	}
+	pvsResearchRate := 0.0
+	if stats.PVSNullWindows > 0 {
+		pvsResearchRate = float64(stats.PVSResearches) * 100.0 / float64(stats.PVSNullWindows)
+	}
 	ttSize := 0
 	ttSize = TranspositionSize(settings.Cache)
 	var mem runtime.MemStats
 	runtime.ReadMemStats(&mem)
-	fmt.Printf("[ai:%s] t=%dms depth=%d completed=%d nodes=%d nps=%.0f tt_size=%d tt_probe=%d tt_hit=%d tt_hit_rate=%.1f%% tt_hit_flag=(e:%d l:%d u:%d) tt_store=%d tt_replace=%d tt_replace_rate=%.1f%% cutoffs=%d tt_cutoff=%d ab_cutoff=%d tt_cutoff_rate=%.1f%% avg_branch=%.2f avg_root=%.2f avg_deep=%.2f eval_probe=%d eval_hit=%d eval_hit_rate=%.1f%% mem_alloc=%s mem_heap=%s mem_total=%s mem_sys=%s depth_times=[%s]\\n",
+	fmt.Printf("[ai:%s] t=%dms depth=%d completed=%d nodes=%d nps=%.0f tt_size=%d tt_probe=%d tt_hit=%d tt_hit_rate=%.1f%% tt_hit_flag=(e:%d l:%d u:%d) tt_store=%d tt_replace=%d tt_replace_rate=%.1f%% cutoffs=%d tt_cutoff=%d ab_cutoff=%d tt_cutoff_rate=%.1f%% avg_branch=%.2f avg_root=%.2f avg_deep=%.2f eval_probe=%d eval_hit=%d eval_hit_rate=%.1f%% eval_collide=%d rt_probe=%d rt_hit=%d rt_collide=%d pvs_null=%d pvs_research=%d pvs_research_rate=%.1f%% asp_research=%d carried_depth=%d soft_limit=%dms soft_stop=%v helpers=%d helper_nodes=%d mem_alloc=%s mem_heap=%s mem_total=%s mem_sys=%s depth_times=[%s]\\n",
 		tag,
 		elapsed.Milliseconds(),
 		settings.Depth,
@@ -844,6 +900,19 @@ func logSearchStats(tag string, stats *SearchStats, settings AIScoreSettings) {
 		stats.EvalCacheProbes,
 		stats.EvalCacheHits,
 		evalHitRate,
+		stats.EvalCacheCollisions,
+		stats.RootTransposeProbes,
+		stats.RootTransposeHits,
+		stats.RootTransposeCollisions,
+		stats.PVSNullWindows,
+		stats.PVSResearches,
+		pvsResearchRate,
+		stats.AspirationResearches,
+		stats.CarriedDepth,
+		stats.SoftLimit.Milliseconds(),
+		stats.SoftStopped,
+		stats.HelperThreads,
+		stats.HelperNodes,
 		formatBytes(mem.Alloc),
 		formatBytes(mem.HeapAlloc),
 		formatBytes(mem.TotalAlloc),
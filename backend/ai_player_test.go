@@ -224,3 +224,46 @@ func TestMaybeSelectLostModeMoveHandlesShortScoreSlice(t *testing.T) {
 		t.Fatalf("expected lost mode to skip short score slice")
 	}
 }
+
+func TestPonderRepliesAnswersEachPredictedReply(t *testing.T) {
+	defer FlushGlobalCaches()
+	FlushGlobalCaches()
+	corpus, rules := loadBenchCorpus(t)
+	cfg := benchConfig()
+	cfg.AiDepth = 2
+	cfg.AiMaxDepth = 2
+	cfg.AiPonderReplies = 3
+	var state GameState
+	for _, pos := range corpus {
+		if pos.name == "middle_wide" {
+			state = pos.state.Clone()
+		}
+	}
+
+	ai := &AIPlayer{}
+	ai.side.Store(int32(otherPlayer(state.ToMove)) + 1)
+	if !ai.isOpponentTurn(state) {
+		t.Fatalf("expected the corpus position to be the opponent's turn")
+	}
+	ai.ponderReplies(state, rules, cfg, ai.ponderVersion.Load())
+	if len(ai.ponderSlots) != cfg.AiPonderReplies || !ai.ponderReady.Load() {
+		t.Fatalf("expected %d ready slots, got %+v", cfg.AiPonderReplies, ai.ponderSlots)
+	}
+	for _, slot := range ai.ponderSlots {
+		if !slot.ready {
+			t.Fatalf("slot for reply %v is not ready", slot.reply)
+		}
+	}
+
+	// The opponent plays the last predicted reply, not the favourite.
+	slot := ai.ponderSlots[len(ai.ponderSlots)-1]
+	next := state.Clone()
+	var undo searchMoveUndo
+	if !applyMoveWithUndo(&next, rules, slot.reply, next.ToMove, &undo) {
+		t.Fatalf("predicted reply %v is illegal", slot.reply)
+	}
+	move, ok := ai.TakePonderedMove(next, rules)
+	if !ok || !move.Equals(slot.move) {
+		t.Fatalf("expected pondered move %v for reply %v, got %v (ok=%v)", slot.move, slot.reply, move, ok)
+	}
+}
@@ -1,11 +1,14 @@
 package main
 
 import (
+	"cmp"
 	"fmt"
 	"math"
-	"sort"
+	"math/bits"
+	"slices"
 	"strings"
 	"sync"
+	"sync/atomic"
 	"time"
 	"unsafe"
 )
@@ -19,7 +22,9 @@ const (
 	lmrLateMoveStart              = 4
 	lmrMinDepth                   = 4
 	lmrReduction                  = 1
-	maxSearchBoardCells           = 19 * 19
+	// Width of a PVS null window; the TT rounds scores to whole points.
+	pvsNullWindow       = 1.0
+	maxSearchBoardCells = 19 * 19
 )
 
 type AISearchCache struct {
@@ -27,6 +32,9 @@ type AISearchCache struct {
 	TT                 *TranspositionTable
 	TTSize             int
 	TTBuckets          int
+	TTLockFree         bool
+	TTLockFreeMeta     bool
+	TTRawKeys          bool
 	EvalCache          *EvalCache
 	EvalCacheSize      int
 	RootTranspose      *RootTransposeCache
@@ -49,18 +57,43 @@ type AIScoreSettings struct {
 	Stats            *SearchStats
 	DirectDepthOnly  bool
 	SkipQueueBacklog bool
+	// RunRootJobs, when set, runs the parallel root moves of a direct-depth
+	// search on an external scheduler instead of dedicated goroutines.
+	RunRootJobs func(jobs []func())
+	// Profile is Config resolved for the search; it is built from Config
+	// when nil and must not be reused after Config changes.
+	Profile *searchProfile
+	// Carry seeds killers and history from the previous search of the same
+	// player and receives this one's tables and PV when it finishes.
+	Carry *searchCarry
+	// TraceLabel names the search for the flight recorder; with
+	// AiSearchTrace on, ScoreBoard records labelled searches into Trace.
+	TraceLabel string
+	Trace      *searchTrace
+	// Time is the root search's time manager, shared by its contexts; see
+	// timeManager.
+	Time *timeManager
+	// OnDepthScores receives each completed depth's score grid after
+	// OnDepthComplete; the slice must not be kept.
+	OnDepthScores func(depth int, scores []float64)
 }
 
 type minimaxContext struct {
-	rules       Rules
-	settings    AIScoreSettings
-	start       time.Time
-	killers     [][]Move
-	history     []int
-	footprint   *searchFootprint
-	deadline    time.Time
-	hasDeadline bool
-	logIndent   int
+	rules     Rules
+	settings  AIScoreSettings
+	start     time.Time
+	killers   [][]Move
+	history   []int
+	footprint *searchFootprint
+	time      *timeManager // nil when the search has no time limit
+	scratch   *searchScratch
+	profile   *searchProfile
+	trace     *traceRing // nil unless the search is traced
+
+	// killerBase is the depthFromRoot that stands for the root position in
+	// the current iteration, so killers are indexed by real ply; see
+	// killerPly.
+	killerBase int
 }
 
 func maxScore(scores []float64) float64 {
@@ -103,6 +136,26 @@ type SearchStats struct {
 	HeuristicTime   time.Duration
 	BoardGenOps     int64
 	BoardGenTime    time.Duration
+	HelperThreads   int64
+	HelperNodes     int64
+	ThreatNodes     int64
+	// PVSNullWindows counts null-window searches of non-PV moves and
+	// PVSResearches the ones that failed high and were searched again.
+	PVSNullWindows       int64
+	PVSResearches        int64
+	AspirationResearches int64
+	// CarriedDepth is the depth of the previous search's tree that seeded
+	// this one's move ordering, or 0.
+	CarriedDepth int
+	// SoftLimit is the adaptive time manager's final soft limit and
+	// SoftStopped whether it kept another depth from starting.
+	SoftLimit   time.Duration
+	SoftStopped bool
+	// Collisions count stores that evicted another position's entry.
+	EvalCacheCollisions     int64
+	RootTransposeProbes     int64
+	RootTransposeHits       int64
+	RootTransposeCollisions int64
 
 	progressReportedNodes    int64
 	progressReportedBoardGen int64
@@ -127,20 +180,14 @@ func newAISearchCache() AISearchCache {
 	return AISearchCache{}
 }
 
-type EvalCacheEntry struct {
-	Key         uint64
-	Value       float64
-	GenWritten  uint32
-	GenLastUsed uint32
-	Valid       bool
-}
-
+// EvalCache is a lock-free always-replace cache of static evaluations. Each
+// slot is two words with check = key ^ data, like the lock-free TT, so a
+// reader racing a writer sees a miss rather than another position's score.
+// Key 0 is never stored since it matches an empty slot.
 type EvalCache struct {
-	mu      sync.Mutex
 	mask    uint64
 	buckets int
-	entries []EvalCacheEntry
-	gen     uint32
+	slots   []lockFreeSlot
 }
 
 func NewEvalCache(size uint64, buckets int) *EvalCache {
@@ -156,93 +203,67 @@ func NewEvalCache(size uint64, buckets int) *EvalCache {
 	return &EvalCache{
 		mask:    size - 1,
 		buckets: buckets,
-		entries: make([]EvalCacheEntry, int(size)*buckets),
-		gen:     1,
+		slots:   make([]lockFreeSlot, int(size)*buckets),
 	}
 }
 
-func (ec *EvalCache) NextGeneration() {
-	if ec == nil {
-		return
-	}
-	ec.mu.Lock()
-	defer ec.mu.Unlock()
-	ec.gen++
-	if ec.gen == 0 {
-		ec.gen = 1
-	}
-}
-
-func (ec *EvalCache) bucketIndex(key uint64) int {
-	return int(key&ec.mask) * ec.buckets
+func (ec *EvalCache) bucket(key uint64) []lockFreeSlot {
+	start := int(key&ec.mask) * ec.buckets
+	return ec.slots[start : start+ec.buckets]
 }
 
 func (ec *EvalCache) Get(key uint64) (float64, bool) {
-	ec.mu.Lock()
-	defer ec.mu.Unlock()
-	start := ec.bucketIndex(key)
-	for i := 0; i < ec.buckets; i++ {
-		idx := start + i
-		entry := ec.entries[idx]
-		if entry.Valid && entry.Key == key {
-			entry.GenLastUsed = ec.gen
-			ec.entries[idx] = entry
-			return entry.Value, true
+	if key == 0 {
+		return 0.0, false
+	}
+	bucket := ec.bucket(key)
+	for i := range bucket {
+		data := bucket[i].data.Load()
+		if bucket[i].check.Load()^data == key {
+			return math.Float64frombits(data), true
 		}
 	}
 	return 0.0, false
 }
 
-func (ec *EvalCache) Put(key uint64, value float64) {
-	ec.mu.Lock()
-	defer ec.mu.Unlock()
-	start := ec.bucketIndex(key)
+// Put stores value under key: over its own slot, else in an empty one, else
+// over the slot the key's high bits pick. It reports whether that evicted
+// another position.
+func (ec *EvalCache) Put(key uint64, value float64) bool {
+	if key == 0 {
+		return false
+	}
+	bucket := ec.bucket(key)
 	victim := -1
-	oldestAge := uint32(0)
-	for i := 0; i < ec.buckets; i++ {
-		idx := start + i
-		entry := ec.entries[idx]
-		if entry.Valid && entry.Key == key {
-			ec.entries[idx] = EvalCacheEntry{
-				Key:         key,
-				Value:       value,
-				GenWritten:  ec.gen,
-				GenLastUsed: ec.gen,
-				Valid:       true,
-			}
-			return
-		}
-		if !entry.Valid {
-			victim = idx
+	for i := range bucket {
+		check, data := bucket[i].check.Load(), bucket[i].data.Load()
+		if check^data == key {
+			victim = i
 			break
 		}
-		age := ec.gen - entry.GenLastUsed
-		if victim == -1 || age > oldestAge {
-			victim = idx
-			oldestAge = age
+		if victim < 0 && check == 0 && data == 0 {
+			victim = i
 		}
 	}
-	if victim >= 0 {
-		ec.entries[victim] = EvalCacheEntry{
-			Key:         key,
-			Value:       value,
-			GenWritten:  ec.gen,
-			GenLastUsed: ec.gen,
-			Valid:       true,
-		}
+	collided := false
+	if victim < 0 {
+		victim = int((key >> 32) % uint64(len(bucket)))
+		collided = true
 	}
+	data := math.Float64bits(value)
+	bucket[victim].data.Store(data)
+	bucket[victim].check.Store(key ^ data)
+	return collided
 }
 
 func (ec *EvalCache) Clear() {
 	if ec == nil {
 		return
 	}
-	ec.mu.Lock()
-	defer ec.mu.Unlock()
-	for i := range ec.entries {
-		ec.entries[i] = EvalCacheEntry{}
+	for i := range ec.slots {
+		ec.slots[i].check.Store(0)
+		ec.slots[i].data.Store(0)
 	}
-	ec.gen = 1
 }
 
 type RootTransposeEntry struct {
@@ -270,12 +291,15 @@ func (e RootTransposeEntry) ScoreFloat() float64 {
 	return float64(e.Score)
 }
 
+// RootTransposeCache is striped like the TT: Get and Put lock only the
+// stripe owning the key's bucket.
 type RootTransposeCache struct {
-	mu      sync.Mutex
-	mask    uint64
-	buckets int
-	entries []RootTransposeEntry
-	gen     uint32
+	mask       uint64
+	buckets    int
+	entries    []RootTransposeEntry
+	stripes    []sync.Mutex
+	stripeMask uint64
+	gen        atomic.Uint32
 }
 
 func NewRootTransposeCache(size uint64, buckets int) *RootTransposeCache {
@@ -288,23 +312,24 @@ func NewRootTransposeCache(size uint64, buckets int) *RootTransposeCache {
 	if (size & (size - 1)) != 0 {
 		size = nextPowerOfTwo(size)
 	}
-	return &RootTransposeCache{
-		mask:    size - 1,
-		buckets: buckets,
-		entries: make([]RootTransposeEntry, int(size)*buckets),
-		gen:     1,
+	stripes := min(uint64(64), size)
+	rtc := &RootTransposeCache{
+		mask:       size - 1,
+		buckets:    buckets,
+		entries:    make([]RootTransposeEntry, int(size)*buckets),
+		stripes:    make([]sync.Mutex, stripes),
+		stripeMask: stripes - 1,
 	}
+	rtc.gen.Store(1)
+	return rtc
 }
 
 func (rtc *RootTransposeCache) NextGeneration() {
 	if rtc == nil {
 		return
 	}
-	rtc.mu.Lock()
-	defer rtc.mu.Unlock()
-	rtc.gen++
-	if rtc.gen == 0 {
-		rtc.gen = 1
+	if rtc.gen.Add(1) == 0 {
+		rtc.gen.CompareAndSwap(0, 1)
 	}
 }
 
@@ -312,6 +337,22 @@ func (rtc *RootTransposeCache) bucketIndex(key uint64) int {
 	return int(key&rtc.mask) * rtc.buckets
 }
 
+func (rtc *RootTransposeCache) stripeFor(key uint64) *sync.Mutex {
+	return &rtc.stripes[key&rtc.mask&rtc.stripeMask]
+}
+
+func (rtc *RootTransposeCache) lockAll() {
+	for i := range rtc.stripes {
+		rtc.stripes[i].Lock()
+	}
+}
+
+func (rtc *RootTransposeCache) unlockAll() {
+	for i := range rtc.stripes {
+		rtc.stripes[i].Unlock()
+	}
+}
+
 func shouldReplaceRootTransposeEntry(old RootTransposeEntry, depth int, gen uint32) bool {
 	if !old.Valid {
 		return true
@@ -330,8 +371,9 @@ func (rtc *RootTransposeCache) Get(key uint64, minDepth int) (RootTransposeEntry
 	if rtc == nil {
 		return RootTransposeEntry{}, false
 	}
-	rtc.mu.Lock()
-	defer rtc.mu.Unlock()
+	stripe := rtc.stripeFor(key)
+	stripe.Lock()
+	defer stripe.Unlock()
 	start := rtc.bucketIndex(key)
 	for i := 0; i < rtc.buckets; i++ {
 		idx := start + i
@@ -342,7 +384,7 @@ func (rtc *RootTransposeCache) Get(key uint64, minDepth int) (RootTransposeEntry
 		if entry.Flag != TTExact || entry.Depth < minDepth {
 			continue
 		}
-		entry.GenLastUsed = rtc.gen
+		entry.GenLastUsed = rtc.gen.Load()
 		rtc.entries[idx] = entry
 		return entry, true
 	}
@@ -359,14 +401,17 @@ func clampToUint8(v int) uint8 {
 	return uint8(v)
 }
 
-func (rtc *RootTransposeCache) Put(key uint64, depth int, value float64, flag TTFlag, bestRel Move, meta TTMeta) {
+// Put keeps the deeper entry for a known key and otherwise evicts the
+// stalest slot of the bucket, reporting whether that evicted another key.
+func (rtc *RootTransposeCache) Put(key uint64, depth int, value float64, flag TTFlag, bestRel Move, meta TTMeta) bool {
 	if rtc == nil {
-		return
+		return false
 	}
-	rtc.mu.Lock()
-	defer rtc.mu.Unlock()
+	stripe := rtc.stripeFor(key)
+	stripe.Lock()
+	defer stripe.Unlock()
 	start := rtc.bucketIndex(key)
-	gen := rtc.gen
+	gen := rtc.gen.Load()
 	newEntry := RootTransposeEntry{
 		Key:         key,
 		Depth:       depth,
@@ -392,13 +437,13 @@ func (rtc *RootTransposeCache) Put(key uint64, depth int, value float64, flag TT
 		entry := rtc.entries[idx]
 		if !entry.Valid {
 			rtc.entries[idx] = newEntry
-			return
+			return false
 		}
 		if entry.Key == key {
 			if shouldReplaceRootTransposeEntry(entry, depth, gen) {
 				rtc.entries[idx] = newEntry
 			}
-			return
+			return false
 		}
 	}
 	victim := start
@@ -412,41 +457,50 @@ func (rtc *RootTransposeCache) Put(key uint64, depth int, value float64, flag TT
 		}
 	}
 	rtc.entries[victim] = newEntry
+	return true
 }
 
 func (rtc *RootTransposeCache) Clear() {
 	if rtc == nil {
 		return
 	}
-	rtc.mu.Lock()
-	defer rtc.mu.Unlock()
+	rtc.lockAll()
+	defer rtc.unlockAll()
 	for i := range rtc.entries {
 		rtc.entries[i] = RootTransposeEntry{}
 	}
-	rtc.gen = 1
+	rtc.gen.Store(1)
 }
 
-func (rtc *RootTransposeCache) snapshotEntries() []RootTransposeEntry {
+func (rtc *RootTransposeCache) slotCount() int {
 	if rtc == nil {
-		return nil
+		return 0
 	}
-	rtc.mu.Lock()
-	defer rtc.mu.Unlock()
-	entries := make([]RootTransposeEntry, len(rtc.entries))
-	copy(entries, rtc.entries)
-	return entries
+	return len(rtc.entries)
 }
 
-func (rtc *RootTransposeCache) loadEntries(entries []RootTransposeEntry) {
+func (rtc *RootTransposeCache) copyEntries(start int, dst []RootTransposeEntry) int {
+	if rtc == nil {
+		return 0
+	}
+	rtc.lockAll()
+	defer rtc.unlockAll()
+	if start >= len(rtc.entries) {
+		return 0
+	}
+	return copy(dst, rtc.entries[start:])
+}
+
+func (rtc *RootTransposeCache) storeEntries(start int, entries []RootTransposeEntry) {
 	if rtc == nil {
 		return
 	}
-	rtc.mu.Lock()
-	defer rtc.mu.Unlock()
-	if len(entries) > len(rtc.entries) {
-		entries = entries[:len(rtc.entries)]
+	rtc.lockAll()
+	defer rtc.unlockAll()
+	if start >= len(rtc.entries) {
+		return
 	}
-	copy(rtc.entries[:len(entries)], entries)
+	copy(rtc.entries[start:], entries)
 }
 
 type searchFootprint struct {
@@ -559,7 +613,7 @@ func buildTTMeta(state GameState, boardSize int, footprint *searchFootprint) TTM
 	}
 }
 
-func selectCache(ctx minimaxContext) *AISearchCache {
+func selectCache(ctx *minimaxContext) *AISearchCache {
 	if ctx.settings.Cache != nil {
 		return ctx.settings.Cache
 	}
@@ -599,6 +653,8 @@ func FlushGlobalCaches() {
 	if rootTranspose != nil {
 		rootTranspose.Clear()
 	}
+	SharedCachePool().Flush()
+	threatResults.Clear()
 }
 
 func ensureTT(cache *AISearchCache, config Config) *TranspositionTable {
@@ -619,10 +675,7 @@ func ensureTT(cache *AISearchCache, config Config) *TranspositionTable {
 		buckets = 2
 	}
 	if config.AiTtMaxMemoryBytes > 0 {
-		entryBytes := int64(unsafe.Sizeof(TTEntry{}))
-		if entryBytes <= 0 {
-			entryBytes = 1
-		}
+		entryBytes := ttEntryBytes(config)
 		maxEntriesByMemory := int(config.AiTtMaxMemoryBytes / entryBytes)
 		if maxEntriesByMemory < 1 {
 			maxEntriesByMemory = 1
@@ -638,16 +691,41 @@ func ensureTT(cache *AISearchCache, config Config) *TranspositionTable {
 			}
 		}
 	}
+	// The side table only exists in lock-free mode, so the meta flag alone
+	// never rebuilds a locked TT.
+	lockFreeMeta := config.AiTtLockFree && config.AiTtLockFreeMeta
 	cache.mu.Lock()
 	defer cache.mu.Unlock()
-	if cache.TT == nil || cache.TTSize != config.AiTtSize || cache.TTBuckets != buckets {
-		cache.TT = NewTranspositionTable(uint64(config.AiTtSize), buckets)
+	if cache.TT == nil || cache.TTSize != config.AiTtSize || cache.TTBuckets != buckets || cache.TTLockFree != config.AiTtLockFree || cache.TTLockFreeMeta != lockFreeMeta || cache.TTRawKeys != !config.AiTtSymmetry {
+		cache.TT = newConfiguredTT(uint64(config.AiTtSize), buckets, config)
 		cache.TTSize = config.AiTtSize
 		cache.TTBuckets = buckets
+		cache.TTLockFree = config.AiTtLockFree
+		cache.TTLockFreeMeta = lockFreeMeta
+		cache.TTRawKeys = !config.AiTtSymmetry
 	}
 	return cache.TT
 }
 
+// ttEntryBytes is the per-entry footprint of the TT config builds.
+func ttEntryBytes(config Config) int64 {
+	if config.AiTtLockFree {
+		return lockFreeTTEntryBytes(config.AiTtLockFreeMeta)
+	}
+	return int64(unsafe.Sizeof(TTEntry{}))
+}
+
+func newConfiguredTT(size uint64, buckets int, config Config) *TranspositionTable {
+	var tt *TranspositionTable
+	if config.AiTtLockFree {
+		tt = NewLockFreeTranspositionTable(size, buckets, config.AiTtLockFreeMeta)
+	} else {
+		tt = NewTranspositionTable(size, buckets)
+	}
+	tt.rawKeys = !config.AiTtSymmetry
+	return tt
+}
+
 func floorPowerOfTwo(value int) int {
 	if value < 1 {
 		return 1
@@ -744,25 +822,23 @@ func computeBBox(board Board, boardSize int) boardBBox {
 		spread: 0,
 		stones: 0,
 	}
+	rowMask := uint32(1)<<uint(boardSize) - 1
 	for y := 0; y < boardSize; y++ {
-		for x := 0; x < boardSize; x++ {
-			if board.At(x, y) == CellEmpty {
-				continue
-			}
-			bbox.stones++
-			if x < bbox.minX {
-				bbox.minX = x
-			}
-			if x > bbox.maxX {
-				bbox.maxX = x
-			}
-			if y < bbox.minY {
-				bbox.minY = y
-			}
-			if y > bbox.maxY {
-				bbox.maxY = y
-			}
+		row := board.Occupied(y) & rowMask
+		if row == 0 {
+			continue
+		}
+		bbox.stones += bits.OnesCount32(row)
+		if x := bits.TrailingZeros32(row); x < bbox.minX {
+			bbox.minX = x
+		}
+		if x := 31 - bits.LeadingZeros32(row); x > bbox.maxX {
+			bbox.maxX = x
+		}
+		if y < bbox.minY {
+			bbox.minY = y
 		}
+		bbox.maxY = y
 	}
 	if bbox.stones == 0 {
 		return bbox
@@ -784,7 +860,7 @@ func computeDensity(stones, width, height int) float64 {
 	return float64(stones) / float64(width*height)
 }
 
-func logAITask(ctx minimaxContext, indent int, format string, args ...interface{}) {
+func logAITask(ctx *minimaxContext, indent int, format string, args ...interface{}) {
 	if !ctx.settings.Config.AiLogSearchStats {
 		return
 	}
@@ -792,14 +868,6 @@ func logAITask(ctx minimaxContext, indent int, format string, args ...interface{
 	fmt.Printf("[ai:trace] %s%s\n", prefix, fmt.Sprintf(format, args...))
 }
 
-func logPrune(ctx minimaxContext, depth int, move Move, best, alpha, beta float64) {
-	if !ctx.settings.Config.AiLogSearchStats {
-		return
-	}
-	prefix := strings.Repeat("  ", ctx.logIndent+1)
-	fmt.Printf("[ai:prune] %sdepth=%d move=(%d,%d) best=%.2f alpha=%.2f beta=%.2f\n", prefix, depth, move.X, move.Y, best, alpha, beta)
-}
-
 func computeAvgDistToCenter(board Board, boardSize int) float64 {
 	bbox := computeBBox(board, boardSize)
 	if bbox.stones == 0 {
@@ -831,15 +899,7 @@ func computeAvgDistToCenter(board Board, boardSize int) float64 {
 }
 
 func countContiguous(board Board, x, y, dx, dy int, target Cell) int {
-	count := 0
-	nx := x + dx
-	ny := y + dy
-	for board.InBounds(nx, ny) && board.At(nx, ny) == target {
-		count++
-		nx += dx
-		ny += dy
-	}
-	return count
+	return board.Run(x, y, dx, dy, target)
 }
 
 func chebDist(dx, dy int) int {
@@ -855,39 +915,30 @@ func chebDist(dx, dy int) int {
 	return dx
 }
 
-func threatFlagsForMove(board Board, move Move, target Cell) (winNow bool, createFour bool, openThree bool) {
-	directions := [4][2]int{{1, 0}, {0, 1}, {1, 1}, {1, -1}}
-	for _, dir := range directions {
-		dx := dir[0]
-		dy := dir[1]
-		left := countContiguous(board, move.X, move.Y, -dx, -dy, target)
-		right := countContiguous(board, move.X, move.Y, dx, dy, target)
-		total := left + right + 1
-		if total >= 5 {
-			winNow = true
-			continue
-		}
-		if total == 4 {
-			createFour = true
-			continue
-		}
-		if total == 3 {
-			leftX := move.X - (left+1)*dx
-			leftY := move.Y - (left+1)*dy
-			rightX := move.X + (right+1)*dx
-			rightY := move.Y + (right+1)*dy
-			openLeft := board.InBounds(leftX, leftY) && board.At(leftX, leftY) == CellEmpty
-			openRight := board.InBounds(rightX, rightY) && board.At(rightX, rightY) == CellEmpty
-			if openLeft && openRight {
-				openThree = true
-			}
-		}
+var threatDirections = [4][2]int{{1, 0}, {0, 1}, {1, 1}, {1, -1}}
+
+// threatFlagsAt looks up the threat flags for two colors at once, sharing the
+// window encoding of each direction.
+func threatFlagsAt(board *Board, move Move, colorA, colorB int) [2]uint8 {
+	var flags [2]uint8
+	for _, dir := range threatDirections {
+		code := threatWindowCode(board, move.X, move.Y, dir[0], dir[1])
+		flags[0] |= threatWindowTable[colorA][code]
+		flags[1] |= threatWindowTable[colorB][code]
 	}
-	return winNow, createFour, openThree
+	return flags
+}
+
+func threatFlagsSplit(flags uint8) (winNow bool, createFour bool, openThree bool) {
+	return flags&threatFlagWin != 0, flags&threatFlagFour != 0, flags&threatFlagOpenThree != 0
 }
 
 func generateThreatMoves(board Board, boardSize int, toPlay PlayerColor) ([]candidateMove, bool) {
-	threats := make([]candidateMove, 0, 32)
+	return generateThreatMovesInto(make([]candidateMove, 0, 32), &board, boardSize, toPlay)
+}
+
+func generateThreatMovesInto(dst []candidateMove, board *Board, boardSize int, toPlay PlayerColor) ([]candidateMove, bool) {
+	threats := dst[:0]
 	cellCount := boardSize * boardSize
 	var seenPriorityStack [maxSearchBoardCells]int
 	seenPriority := seenPriorityStack[:0]
@@ -899,18 +950,20 @@ func generateThreatMoves(board Board, boardSize int, toPlay PlayerColor) ([]cand
 	for i := range seenPriority {
 		seenPriority[i] = maxCandidatePrio
 	}
-	toPlayCell := CellFromPlayer(toPlay)
-	oppCell := CellFromPlayer(otherPlayer(toPlay))
+	toPlayIdx := playerWindowIndex(toPlay)
+	oppIdx := playerWindowIndex(otherPlayer(toPlay))
 	urgent := false
+	// Threat flags need an adjacent stone, so only the radius-1 frontier is scanned.
+	adjacent := board.NeighborMask(1)
+	rowMask := uint32(1)<<uint(boardSize) - 1
 	for y := 0; y < boardSize; y++ {
-		for x := 0; x < boardSize; x++ {
-			if board.At(x, y) != CellEmpty {
-				continue
-			}
+		for row := adjacent[y] & rowMask; row != 0; row &= row - 1 {
+			x := bits.TrailingZeros32(row)
 			move := Move{X: x, Y: y}
 			bestPrio := maxCandidatePrio
 
-			winNow, createFour, openThree := threatFlagsForMove(board, move, toPlayCell)
+			flags := threatFlagsAt(board, move, toPlayIdx, oppIdx)
+			winNow, createFour, openThree := threatFlagsSplit(flags[0])
 			if winNow {
 				bestPrio = prioWin
 				urgent = true
@@ -925,7 +978,7 @@ func generateThreatMoves(board Board, boardSize int, toPlay PlayerColor) ([]cand
 				}
 			}
 
-			winNow, createFour, openThree = threatFlagsForMove(board, move, oppCell)
+			winNow, createFour, openThree = threatFlagsSplit(flags[1])
 			if winNow {
 				if prioBlockWin < bestPrio {
 					bestPrio = prioBlockWin
@@ -956,11 +1009,18 @@ func generateThreatMoves(board Board, boardSize int, toPlay PlayerColor) ([]cand
 }
 
 func hasUrgentThreat(board Board, boardSize int, toPlay PlayerColor) bool {
-	_, urgent := generateThreatMoves(board, boardSize, toPlay)
+	var buf [64]candidateMove
+	_, urgent := generateThreatMovesInto(buf[:0], &board, boardSize, toPlay)
 	return urgent
 }
 
 func collectCandidateMoves(state GameState, currentPlayer PlayerColor, boardSize int) []candidateMove {
+	return collectCandidateMovesInto(make([]candidateMove, 0, 64), state, currentPlayer, boardSize)
+}
+
+// collectCandidateMovesInto writes the sorted candidate list into dst's
+// backing array.
+func collectCandidateMovesInto(dst []candidateMove, state GameState, currentPlayer PlayerColor, boardSize int) []candidateMove {
 	if boardSize <= 0 {
 		boardSize = state.Board.Size()
 	}
@@ -971,10 +1031,10 @@ func collectCandidateMoves(state GameState, currentPlayer PlayerColor, boardSize
 	bbox := computeBBox(board, boardSize)
 	if bbox.stones == 0 {
 		center := boardSize / 2
-		return []candidateMove{{move: Move{X: center, Y: center}, priority: prioDefault}}
+		return append(dst[:0], candidateMove{move: Move{X: center, Y: center}, priority: prioDefault})
 	}
 	if bbox.stones == 1 {
-		moves := []candidateMove{}
+		moves := dst[:0]
 		cellCount := boardSize * boardSize
 		var seenStack [maxSearchBoardCells]bool
 		seen := seenStack[:0]
@@ -1013,7 +1073,8 @@ func collectCandidateMoves(state GameState, currentPlayer PlayerColor, boardSize
 		}
 	}
 
-	threatMoves, urgent := generateThreatMoves(board, boardSize, currentPlayer)
+	var threatBuf [64]candidateMove
+	threatMoves, urgent := generateThreatMovesInto(threatBuf[:0], &board, boardSize, currentPlayer)
 	density := computeDensity(bbox.stones, bbox.width, bbox.height)
 	margin := 2
 	if density < 0.15 {
@@ -1053,7 +1114,7 @@ func collectCandidateMoves(state GameState, currentPlayer PlayerColor, boardSize
 	for i := range seenPriority {
 		seenPriority[i] = maxCandidatePrio
 	}
-	candidates := make([]candidateMove, 0, 64)
+	candidates := dst[:0]
 	addCandidate := func(move Move, priority int) {
 		idx := move.Y*boardSize + move.X
 		if priority < seenPriority[idx] {
@@ -1089,45 +1150,28 @@ func collectCandidateMoves(state GameState, currentPlayer PlayerColor, boardSize
 		}
 	}
 
-	for y := 0; y < boardSize; y++ {
-		for x := 0; x < boardSize; x++ {
-			if board.At(x, y) == CellEmpty {
-				continue
-			}
-			for dy := -proximityRadius; dy <= proximityRadius; dy++ {
-				for dx := -proximityRadius; dx <= proximityRadius; dx++ {
-					if dx == 0 && dy == 0 {
-						continue
-					}
-					if chebDist(dx, dy) > proximityRadius {
-						continue
-					}
-					nx := x + dx
-					ny := y + dy
-					if nx < x0 || nx > x1 || ny < y0 || ny > y1 {
-						continue
-					}
-					if !board.InBounds(nx, ny) || !board.IsEmpty(nx, ny) {
-						continue
-					}
-					addCandidate(Move{X: nx, Y: ny}, prioProximity)
-				}
-			}
+	near := state.proximityMask()
+	window := (uint32(1)<<uint(x1+1) - 1) &^ (uint32(1)<<uint(x0) - 1)
+	for y := y0; y <= y1; y++ {
+		for row := near[y] & window; row != 0; row &= row - 1 {
+			addCandidate(Move{X: bits.TrailingZeros32(row), Y: y}, prioProximity)
 		}
 	}
 
-	sort.SliceStable(candidates, func(i, j int) bool {
-		if candidates[i].priority != candidates[j].priority {
-			return candidates[i].priority < candidates[j].priority
-		}
-		if candidates[i].move.Y != candidates[j].move.Y {
-			return candidates[i].move.Y < candidates[j].move.Y
-		}
-		return candidates[i].move.X < candidates[j].move.X
-	})
+	slices.SortStableFunc(candidates, compareCandidateMoves)
 	return candidates
 }
 
+func compareCandidateMoves(a, b candidateMove) int {
+	if a.priority != b.priority {
+		return a.priority - b.priority
+	}
+	if a.move.Y != b.move.Y {
+		return a.move.Y - b.move.Y
+	}
+	return a.move.X - b.move.X
+}
+
 func hardPlyCandidateCap(config Config, depthFromRoot int) int {
 	switch {
 	case depthFromRoot >= 9:
@@ -1166,8 +1210,11 @@ func tacticalKLimit(config Config, depthFromRoot int) int {
 	return 0
 }
 
-func candidateLimit(ctx minimaxContext, depthLeft, depthFromRoot int, tactical bool) int {
-	config := ctx.settings.Config
+func candidateLimit(ctx *minimaxContext, depthLeft, depthFromRoot int, tactical bool) int {
+	return ctx.profileOrResolve().candidateLimit(depthLeft, depthFromRoot, tactical)
+}
+
+func computeCandidateLimit(config Config, depthLeft, depthFromRoot int, tactical bool) int {
 	if config.AiEnableHardPlyCaps {
 		limit := hardPlyCandidateCap(config, depthFromRoot)
 		if config.AiEnableTacticalK && tactical {
@@ -1218,7 +1265,11 @@ func candidateLimit(ctx minimaxContext, depthLeft, depthFromRoot int, tactical b
 }
 
 func defensiveTacticalCandidates(candidates []candidateMove) []candidateMove {
-	filtered := make([]candidateMove, 0, len(candidates))
+	return defensiveTacticalCandidatesInto(make([]candidateMove, 0, len(candidates)), candidates)
+}
+
+func defensiveTacticalCandidatesInto(dst []candidateMove, candidates []candidateMove) []candidateMove {
+	filtered := dst[:0]
 	for _, cand := range candidates {
 		switch cand.priority {
 		case prioWin, prioBlockWin, prioBlockFour:
@@ -1235,11 +1286,19 @@ func applyCandidateCap(candidates []Move, limit int) []Move {
 	return candidates[:limit]
 }
 
-func isKillerMove(ctx minimaxContext, depthFromRoot int, move Move) bool {
-	if depthFromRoot < 0 || depthFromRoot >= len(ctx.killers) {
+// killerPly maps depthFromRoot to the killer slot of its real ply. Root
+// searches start their moves at depthFromRoot equal to the iteration depth,
+// which would put one ply in a different slot at every iteration.
+func killerPly(ctx *minimaxContext, depthFromRoot int) int {
+	return depthFromRoot - ctx.killerBase
+}
+
+func isKillerMove(ctx *minimaxContext, depthFromRoot int, move Move) bool {
+	ply := killerPly(ctx, depthFromRoot)
+	if ply < 0 || ply >= len(ctx.killers) {
 		return false
 	}
-	for _, km := range ctx.killers[depthFromRoot] {
+	for _, km := range ctx.killers[ply] {
 		if km.Equals(move) {
 			return true
 		}
@@ -1247,26 +1306,33 @@ func isKillerMove(ctx minimaxContext, depthFromRoot int, move Move) bool {
 	return false
 }
 
-func recordKiller(ctx minimaxContext, depthFromRoot int, move Move) {
-	if depthFromRoot < 0 || depthFromRoot >= len(ctx.killers) {
+func recordKiller(ctx *minimaxContext, depthFromRoot int, move Move) {
+	ply := killerPly(ctx, depthFromRoot)
+	if ply < 0 || ply >= len(ctx.killers) {
 		return
 	}
-	killers := ctx.killers[depthFromRoot]
-	if len(killers) == 0 {
-		ctx.killers[depthFromRoot] = []Move{move}
-		return
-	}
-	if killers[0].Equals(move) {
-		return
+	// Slots are updated in place; initOrderingTables gives each ply room
+	// for two killers.
+	killers := ctx.killers[ply]
+	if cap(killers) < 2 {
+		killers = make([]Move, len(killers), 2)
+		copy(killers, ctx.killers[ply])
 	}
-	if len(killers) == 1 {
-		ctx.killers[depthFromRoot] = []Move{killers[0], move}
+	switch {
+	case len(killers) == 0:
+		killers = append(killers, move)
+	case killers[0].Equals(move):
 		return
+	case len(killers) == 1:
+		killers = append(killers, move)
+	default:
+		killers[1] = killers[0]
+		killers[0] = move
 	}
-	ctx.killers[depthFromRoot] = []Move{move, killers[0]}
+	ctx.killers[ply] = killers
 }
 
-func recordHistory(ctx minimaxContext, boardSize int, move Move, depthLeft int) {
+func recordHistory(ctx *minimaxContext, boardSize int, move Move, depthLeft int) {
 	if len(ctx.history) == 0 || boardSize <= 0 {
 		return
 	}
@@ -1278,17 +1344,26 @@ func recordHistory(ctx minimaxContext, boardSize int, move Move, depthLeft int)
 	ctx.history[idx] += bonus
 }
 
-func orderCandidateMoves(state GameState, ctx minimaxContext, currentPlayer PlayerColor, maximizing bool, depthFromRoot int, candidates []candidateMove, maxCandidates int, pvMove *Move) []Move {
-	evalSettings := ctx.settings
-	evalSettings.Player = currentPlayer
+type scoredMove struct {
+	score    float64
+	priority int
+	move     Move
+}
+
+func orderCandidateMoves(state GameState, ctx *minimaxContext, currentPlayer PlayerColor, maximizing bool, depthFromRoot int, candidates []candidateMove, maxCandidates int, pvMove *Move) []Move {
+	return orderCandidateMovesInto(nil, state, ctx, currentPlayer, maximizing, depthFromRoot, candidates, maxCandidates, pvMove)
+}
+
+// orderCandidateMovesInto orders candidates using buf's scored and moves
+// lists; a nil buf allocates fresh ones. The result aliases buf.moves.
+func orderCandidateMovesInto(buf *plyScratch, state GameState, ctx *minimaxContext, currentPlayer PlayerColor, maximizing bool, depthFromRoot int, candidates []candidateMove, maxCandidates int, pvMove *Move) []Move {
+	var local plyScratch
+	if buf == nil {
+		buf = &local
+	}
 	// Full move simulation + eval for ordering is expensive; keep it to shallow nodes.
 	useExpensiveOrdering := depthFromRoot <= 2
-	type scoredMove struct {
-		score    float64
-		priority int
-		move     Move
-	}
-	scored := make([]scoredMove, 0, len(candidates))
+	scored := buf.scored[:0]
 	cache := selectCache(ctx)
 	opponentHasImmediateWin := false
 	if useExpensiveOrdering {
@@ -1315,7 +1390,7 @@ func orderCandidateMoves(state GameState, ctx minimaxContext, currentPlayer Play
 					undoMoveWithUndo(&blockState, undo)
 				}
 			}
-			score = heuristicForMove(state, ctx.rules, evalSettings, move)
+			score = heuristicForMove(&state, ctx, currentPlayer, move)
 		}
 		if ctx.settings.Config.AiEnableKillerMoves && isKillerMove(ctx, depthFromRoot, move) {
 			boost := float64(ctx.settings.Config.AiKillerBoost)
@@ -1338,68 +1413,105 @@ func orderCandidateMoves(state GameState, ctx minimaxContext, currentPlayer Play
 		}
 		scored = append(scored, scoredMove{score: score, priority: priority, move: move})
 	}
-	sort.SliceStable(scored, func(i, j int) bool {
-		if scored[i].priority != scored[j].priority {
-			return scored[i].priority < scored[j].priority
-		}
-		if maximizing {
-			return scored[i].score > scored[j].score
-		}
-		return scored[i].score < scored[j].score
-	})
+	if maximizing {
+		slices.SortStableFunc(scored, compareScoredMovesMax)
+	} else {
+		slices.SortStableFunc(scored, compareScoredMovesMin)
+	}
 	if pvMove != nil {
 		for i := range scored {
 			if scored[i].move.Equals(*pvMove) {
 				pvEntry := scored[i]
-				copy(scored[i:], scored[i+1:])
-				scored = scored[:len(scored)-1]
-				scored = append([]scoredMove{pvEntry}, scored...)
+				copy(scored[1:i+1], scored[:i])
+				scored[0] = pvEntry
 				break
 			}
 		}
 	}
+	buf.scored = scored
 	if maxCandidates > 0 && len(scored) > maxCandidates {
 		scored = scored[:maxCandidates]
 	}
-	moves := make([]Move, 0, len(scored))
+	moves := buf.moves[:0]
 	for _, entry := range scored {
 		moves = append(moves, entry.move)
 	}
+	buf.moves = moves
 	return moves
 }
 
-func orderCandidates(state GameState, ctx minimaxContext, currentPlayer PlayerColor, maximizing bool, depthFromRoot int, maxCandidates int, pvMove *Move) []Move {
-	candidates := collectCandidateMoves(state, currentPlayer, ctx.settings.BoardSize)
-	return orderCandidateMoves(state, ctx, currentPlayer, maximizing, depthFromRoot, candidates, maxCandidates, pvMove)
+func compareScoredMovesMax(a, b scoredMove) int {
+	if a.priority != b.priority {
+		return a.priority - b.priority
+	}
+	return cmp.Compare(b.score, a.score)
+}
+
+func compareScoredMovesMin(a, b scoredMove) int {
+	if a.priority != b.priority {
+		return a.priority - b.priority
+	}
+	return cmp.Compare(a.score, b.score)
+}
+
+func orderCandidates(state GameState, ctx *minimaxContext, currentPlayer PlayerColor, maximizing bool, depthFromRoot int, maxCandidates int, pvMove *Move) []Move {
+	return orderCandidatesInto(nil, state, ctx, currentPlayer, maximizing, depthFromRoot, maxCandidates, pvMove)
 }
 
-func orderMovesFromList(state GameState, ctx minimaxContext, currentPlayer PlayerColor, maximizing bool, depthFromRoot int, moves []Move, pvMove *Move, priority int) []Move {
-	candidates := make([]candidateMove, 0, len(moves))
+func orderCandidatesInto(buf *plyScratch, state GameState, ctx *minimaxContext, currentPlayer PlayerColor, maximizing bool, depthFromRoot int, maxCandidates int, pvMove *Move) []Move {
+	if buf == nil {
+		candidates := collectCandidateMoves(state, currentPlayer, ctx.settings.BoardSize)
+		return orderCandidateMovesInto(nil, state, ctx, currentPlayer, maximizing, depthFromRoot, candidates, maxCandidates, pvMove)
+	}
+	buf.candidates = collectCandidateMovesInto(buf.candidates, state, currentPlayer, ctx.settings.BoardSize)
+	return orderCandidateMovesInto(buf, state, ctx, currentPlayer, maximizing, depthFromRoot, buf.candidates, maxCandidates, pvMove)
+}
+
+func orderMovesFromList(state GameState, ctx *minimaxContext, currentPlayer PlayerColor, maximizing bool, depthFromRoot int, moves []Move, pvMove *Move, priority int) []Move {
+	return orderMovesFromListInto(nil, state, ctx, currentPlayer, maximizing, depthFromRoot, moves, pvMove, priority)
+}
+
+// orderMovesFromListInto must not be given a moves slice aliasing
+// buf.candidates.
+func orderMovesFromListInto(buf *plyScratch, state GameState, ctx *minimaxContext, currentPlayer PlayerColor, maximizing bool, depthFromRoot int, moves []Move, pvMove *Move, priority int) []Move {
+	var candidates []candidateMove
+	if buf != nil {
+		candidates = buf.candidates[:0]
+	} else {
+		candidates = make([]candidateMove, 0, len(moves))
+	}
 	for _, move := range moves {
 		candidates = append(candidates, candidateMove{move: move, priority: priority})
 	}
-	return orderCandidateMoves(state, ctx, currentPlayer, maximizing, depthFromRoot, candidates, 0, pvMove)
+	if buf != nil {
+		buf.candidates = candidates
+	}
+	return orderCandidateMovesInto(buf, state, ctx, currentPlayer, maximizing, depthFromRoot, candidates, 0, pvMove)
 }
 
-func isTacticalPosition(state GameState, ctx minimaxContext, currentPlayer PlayerColor) bool {
+func isTacticalPosition(state GameState, ctx *minimaxContext, currentPlayer PlayerColor) bool {
 	cache := selectCache(ctx)
-	if len(findImmediateWinMovesCached(cache, state, ctx.rules, currentPlayer, ctx.settings.BoardSize, ctx.settings.Config)) > 0 {
+	if hasImmediateWinCached(cache, state, ctx.rules, currentPlayer, ctx.settings.BoardSize, ctx.settings.Config) {
 		return true
 	}
-	if len(findImmediateWinMovesCached(cache, state, ctx.rules, otherPlayer(currentPlayer), ctx.settings.BoardSize, ctx.settings.Config)) > 0 {
+	if hasImmediateWinCached(cache, state, ctx.rules, otherPlayer(currentPlayer), ctx.settings.BoardSize, ctx.settings.Config) {
 		return true
 	}
-	if len(findCaptureMoves(state, ctx.rules, currentPlayer)) > 0 {
+	var moveBuf [32]Move
+	if len(findCaptureMovesInto(moveBuf[:0], state, ctx.rules, currentPlayer)) > 0 {
 		return true
 	}
-	if len(findCaptureMoves(state, ctx.rules, otherPlayer(currentPlayer))) > 0 {
+	if len(findCaptureMovesInto(moveBuf[:0], state, ctx.rules, otherPlayer(currentPlayer))) > 0 {
 		return true
 	}
-	_, urgent := generateThreatMoves(state.Board, ctx.settings.BoardSize, currentPlayer)
-	return urgent
+	return hasUrgentThreat(state.Board, ctx.settings.BoardSize, currentPlayer)
 }
 
-func tacticalCandidates(state GameState, ctx minimaxContext, currentPlayer PlayerColor) []candidateMove {
+func tacticalCandidates(state GameState, ctx *minimaxContext, currentPlayer PlayerColor) []candidateMove {
+	return tacticalCandidatesInto(make([]candidateMove, 0, 16), state, ctx, currentPlayer)
+}
+
+func tacticalCandidatesInto(dst []candidateMove, state GameState, ctx *minimaxContext, currentPlayer PlayerColor) []candidateMove {
 	cache := selectCache(ctx)
 	boardSize := ctx.settings.BoardSize
 	cellCount := boardSize * boardSize
@@ -1424,20 +1536,22 @@ func tacticalCandidates(state GameState, ctx minimaxContext, currentPlayer Playe
 		}
 	}
 
-	for _, move := range findImmediateWinMovesCached(cache, state, ctx.rules, currentPlayer, boardSize, ctx.settings.Config) {
+	var moveBuf [32]Move
+	for _, move := range findImmediateWinMovesInto(moveBuf[:0], cache, state, ctx.rules, currentPlayer, boardSize, ctx.settings.Config) {
 		addMove(move, prioWin)
 	}
-	for _, move := range findImmediateWinMovesCached(cache, state, ctx.rules, otherPlayer(currentPlayer), boardSize, ctx.settings.Config) {
+	for _, move := range findImmediateWinMovesInto(moveBuf[:0], cache, state, ctx.rules, otherPlayer(currentPlayer), boardSize, ctx.settings.Config) {
 		addMove(move, prioBlockWin)
 	}
-	for _, move := range findCaptureMoves(state, ctx.rules, currentPlayer) {
+	for _, move := range findCaptureMovesInto(moveBuf[:0], state, ctx.rules, currentPlayer) {
 		addMove(move, prioCreateFour)
 	}
-	for _, move := range findCaptureMoves(state, ctx.rules, otherPlayer(currentPlayer)) {
+	for _, move := range findCaptureMovesInto(moveBuf[:0], state, ctx.rules, otherPlayer(currentPlayer)) {
 		addMove(move, prioBlockFour)
 	}
 
-	threatMoves, _ := generateThreatMoves(state.Board, boardSize, currentPlayer)
+	var threatBuf [64]candidateMove
+	threatMoves, _ := generateThreatMovesInto(threatBuf[:0], &state.Board, boardSize, currentPlayer)
 	for _, cand := range threatMoves {
 		switch cand.priority {
 		case prioCreateFour, prioBlockFour:
@@ -1460,13 +1574,13 @@ func tacticalCandidates(state GameState, ctx minimaxContext, currentPlayer Playe
 		}
 	}
 
-	moves := make([]candidateMove, 0, 16)
+	moves := dst[:0]
 	for idx, prio := range seenPriority {
 		if prio == maxCandidatePrio {
 			continue
 		}
 		move := Move{X: idx % boardSize, Y: idx / boardSize}
-		if ok, _ := ctx.rules.IsLegal(state, move, currentPlayer); ok {
+		if legalInSearch(&state, ctx.rules, move, currentPlayer) {
 			moves = append(moves, candidateMove{move: move, priority: prio})
 		}
 	}
@@ -1488,13 +1602,15 @@ func evalKey(stateHash uint64, boardSize int, player PlayerColor) uint64 {
 	return stateHash ^ mixKey(uint64(boardSize)<<32|uint64(player))
 }
 
-func evalBoardCached(state GameState, rules Rules, settings AIScoreSettings, cache *AISearchCache) float64 {
-	_ = rules
-	board := state.Board
+// evalBoardCached scores state for Black through the eval cache. It reads
+// settings through ctx so leaves do not copy them.
+func evalBoardCached(state *GameState, ctx *minimaxContext) float64 {
+	settings := &ctx.settings
+	profile := ctx.profileOrResolve()
 	if settings.SkipQueueBacklog || !settings.Config.AiEnableEvalCache {
-		return EvaluateBoard(board, PlayerBlack, settings.Config)
+		return evaluateState(state, PlayerBlack, profile.weights)
 	}
-	evalCache := ensureEvalCache(cache, settings.Config)
+	evalCache := ensureEvalCache(selectCache(ctx), settings.Config)
 	stateHash := state.Hash
 	if evalCache != nil {
 		if settings.Stats != nil {
@@ -1518,8 +1634,8 @@ func evalBoardCached(state GameState, rules Rules, settings AIScoreSettings, cac
 	if sampleEvalTiming {
 		evalStart = time.Now()
 	}
-	value := EvaluateBoard(board, PlayerBlack, settings.Config)
-	value += captureUrgencyHeuristic(state, rules, settings.Config)
+	value := evaluateState(state, PlayerBlack, profile.weights)
+	value += captureUrgencyScore(state, ctx.rules, &profile.heuristics)
 	if stats := settings.Stats; stats != nil {
 		stats.HeuristicCalls++
 		if sampleEvalTiming {
@@ -1528,7 +1644,9 @@ func evalBoardCached(state GameState, rules Rules, settings AIScoreSettings, cac
 	}
 	if evalCache != nil && stateHash != 0 {
 		if math.Abs(value) >= settings.Config.AiEvalCacheMinAbs {
-			evalCache.Put(evalKey(stateHash, settings.BoardSize, state.ToMove), value)
+			if evalCache.Put(evalKey(stateHash, settings.BoardSize, state.ToMove), value) && settings.Stats != nil {
+				settings.Stats.EvalCacheCollisions++
+			}
 		}
 	}
 	return value
@@ -1536,8 +1654,13 @@ func evalBoardCached(state GameState, rules Rules, settings AIScoreSettings, cac
 
 func captureUrgencyHeuristic(state GameState, rules Rules, config Config) float64 {
 	heuristics := resolvedHeuristicConfig(config)
-	blackCaptureMoves := findCaptureMoves(state, rules, PlayerBlack)
-	whiteCaptureMoves := findCaptureMoves(state, rules, PlayerWhite)
+	return captureUrgencyScore(&state, rules, &heuristics)
+}
+
+func captureUrgencyScore(state *GameState, rules Rules, heuristics *HeuristicConfig) float64 {
+	var blackBuf, whiteBuf [32]Move
+	blackCaptureMoves := findCaptureMovesInto(blackBuf[:0], *state, rules, PlayerBlack)
+	whiteCaptureMoves := findCaptureMovesInto(whiteBuf[:0], *state, rules, PlayerWhite)
 
 	score := 0.0
 	score += float64(len(blackCaptureMoves)-len(whiteCaptureMoves)) * heuristics.CaptureNow
@@ -1561,10 +1684,10 @@ func captureUrgencyHeuristic(state GameState, rules Rules, config Config) float6
 		score -= heuristics.CaptureNearWin
 	}
 
-	if len(blackCaptureMoves) == 0 && hasCaptureInTwoPlies(state, rules, PlayerBlack, heuristics.CaptureInTwoLimit) {
+	if len(blackCaptureMoves) == 0 && hasCaptureInTwoPlies(*state, rules, PlayerBlack, heuristics.CaptureInTwoLimit) {
 		score += heuristics.CaptureInTwo
 	}
-	if len(whiteCaptureMoves) == 0 && hasCaptureInTwoPlies(state, rules, PlayerWhite, heuristics.CaptureInTwoLimit) {
+	if len(whiteCaptureMoves) == 0 && hasCaptureInTwoPlies(*state, rules, PlayerWhite, heuristics.CaptureInTwoLimit) {
 		score -= heuristics.CaptureInTwo
 	}
 
@@ -1579,19 +1702,21 @@ func hasCaptureInTwoPlies(state GameState, rules Rules, player PlayerColor, prep
 	if prepLimit <= 0 {
 		return false
 	}
-	candidates := collectCandidateMoves(state, player, state.Board.Size())
+	var candidateBuf [128]candidateMove
+	var moveBuf [32]Move
+	candidates := collectCandidateMovesInto(candidateBuf[:0], state, player, state.Board.Size())
 	tried := 0
 	probeState := state
 	for _, cand := range candidates {
 		move := cand.move
-		if ok, _ := rules.IsLegal(probeState, move, player); !ok {
+		if !legalInSearch(&probeState, rules, move, player) {
 			continue
 		}
 		var undo searchMoveUndo
 		if !applyMoveWithUndo(&probeState, rules, move, player, &undo) {
 			continue
 		}
-		if len(findCaptureMoves(probeState, rules, player)) > 0 {
+		if len(findCaptureMovesInto(moveBuf[:0], probeState, rules, player)) > 0 {
 			undoMoveWithUndo(&probeState, undo)
 			return true
 		}
@@ -1604,22 +1729,19 @@ func hasCaptureInTwoPlies(state GameState, rules Rules, player PlayerColor, prep
 	return false
 }
 
-func heuristicForMove(state GameState, rules Rules, settings AIScoreSettings, move Move) float64 {
-	if ok, _ := rules.IsLegal(state, move, settings.Player); !ok {
-		return illegalScore
-	}
-	next := state
+// heuristicForMove evaluates state after move, playing and undoing it in
+// place rather than on a copy.
+func heuristicForMove(state *GameState, ctx *minimaxContext, player PlayerColor, move Move) float64 {
 	var undo searchMoveUndo
-	if !applyMoveWithUndo(&next, rules, move, settings.Player, &undo) {
+	if !applyMoveWithUndo(state, ctx.rules, move, player, &undo) {
 		return illegalScore
 	}
-	cache := selectCache(minimaxContext{settings: settings})
-	score := evalBoardCached(next, rules, settings, cache)
-	undoMoveWithUndo(&next, undo)
+	score := evalBoardCached(state, ctx)
+	undoMoveWithUndo(state, undo)
 	return score
 }
 
-func evaluateStateHeuristic(state GameState, rules Rules, settings AIScoreSettings) float64 {
+func evaluateStateHeuristic(state *GameState, ctx *minimaxContext) float64 {
 	switch state.Status {
 	case StatusDraw:
 		return 0.0
@@ -1628,14 +1750,13 @@ func evaluateStateHeuristic(state GameState, rules Rules, settings AIScoreSettin
 	case StatusWhiteWon:
 		return -winScore
 	}
-	cache := selectCache(minimaxContext{settings: settings})
-	return evalBoardCached(state, rules, settings, cache)
+	return evalBoardCached(state, ctx)
 }
 
-func tacticalExtensionScore(state GameState, ctx minimaxContext, currentPlayer PlayerColor, depthFromRoot int) float64 {
+func tacticalExtensionScore(state GameState, ctx *minimaxContext, currentPlayer PlayerColor, depthFromRoot int) float64 {
 	candidates := tacticalCandidates(state, ctx, currentPlayer)
 	if len(candidates) == 0 {
-		return evaluateStateHeuristic(state, ctx.rules, ctx.settings)
+		return evaluateStateHeuristic(&state, ctx)
 	}
 	maximizing := currentPlayer == PlayerBlack
 	best := math.Inf(-1)
@@ -1652,7 +1773,7 @@ func tacticalExtensionScore(state GameState, ctx minimaxContext, currentPlayer P
 		if !applyMoveWithUndo(&next, ctx.rules, move, currentPlayer, &undo) {
 			continue
 		}
-		score := evaluateStateHeuristic(next, ctx.rules, ctx.settings)
+		score := evaluateStateHeuristic(&next, ctx)
 		undoMoveWithUndo(&next, undo)
 		if maximizing {
 			if score > best {
@@ -1665,23 +1786,16 @@ func tacticalExtensionScore(state GameState, ctx minimaxContext, currentPlayer P
 		}
 	}
 	if math.IsInf(best, 1) || math.IsInf(best, -1) {
-		return evaluateStateHeuristic(state, ctx.rules, ctx.settings)
+		return evaluateStateHeuristic(&state, ctx)
 	}
 	return best
 }
 
-func timedOut(ctx minimaxContext) bool {
+func timedOut(ctx *minimaxContext) bool {
 	if ctx.settings.ShouldStop != nil && ctx.settings.ShouldStop() {
 		return true
 	}
-	if ctx.hasDeadline && !ctx.deadline.IsZero() && time.Now().After(ctx.deadline) {
-		return true
-	}
-	if ctx.settings.TimeoutMs <= 0 {
-		return false
-	}
-	elapsed := time.Since(ctx.start).Milliseconds()
-	return int(elapsed) >= ctx.settings.TimeoutMs
+	return ctx.time != nil && ctx.time.expired()
 }
 
 func initOrderingTables(settings AIScoreSettings) ([][]Move, []int) {
@@ -1689,6 +1803,10 @@ func initOrderingTables(settings AIScoreSettings) ([][]Move, []int) {
 	var history []int
 	if settings.Config.AiEnableKillerMoves {
 		killers = make([][]Move, settings.Depth+2)
+		slots := make([]Move, 2*len(killers))
+		for i := range killers {
+			killers[i] = slots[2*i : 2*i : 2*i+2]
+		}
 	}
 	if settings.Config.AiEnableHistoryMoves {
 		history = make([]int, settings.BoardSize*settings.BoardSize)
@@ -1696,19 +1814,24 @@ func initOrderingTables(settings AIScoreSettings) ([][]Move, []int) {
 	return killers, history
 }
 
-func newMinimaxContext(rules Rules, settings AIScoreSettings, start time.Time) minimaxContext {
+func newMinimaxContext(rules Rules, settings AIScoreSettings, start time.Time) *minimaxContext {
 	killers, history := initOrderingTables(settings)
-	ctx := minimaxContext{
-		rules:     rules,
-		settings:  settings,
-		start:     start,
-		killers:   killers,
-		history:   history,
-		logIndent: 0,
-	}
-	if settings.Config.AiTimeBudgetMs > 0 {
-		ctx.deadline = start.Add(time.Duration(settings.Config.AiTimeBudgetMs-100) * time.Millisecond)
-		ctx.hasDeadline = true
+	ctx := &minimaxContext{
+		rules:    rules,
+		settings: settings,
+		start:    start,
+		killers:  killers,
+		history:  history,
+		scratch:  newSearchScratch(2*settings.Depth + 4),
+		profile:  settings.Profile,
+		trace:    settings.Trace.ring(),
+	}
+	if ctx.profile == nil {
+		ctx.profile = newSearchProfile(settings.Config)
+	}
+	ctx.time = settings.Time
+	if ctx.time == nil {
+		ctx.time = newTimeManager(settings, start)
 	}
 	return ctx
 }
@@ -1728,15 +1851,32 @@ type searchMoveUndo struct {
 	prevHash          uint64
 	prevHashSym       [8]uint64
 	prevCanonHash     uint64
+	prevEvalTotals    EvalTotals
+	prevEvalHash      uint64
+	prevEvalValid     bool
+	frontierTracked   bool
+	prevFrontierHash  uint64
+	prevFrontierValid bool
+	legalityTracked   bool
+	prevLegality      legalityMasks
+	prevLegalityHash  uint64
+	prevLegalityValid bool
 }
 
 func applyMove(state *GameState, rules Rules, move Move, player PlayerColor) bool {
-	if ok, _ := rules.IsLegal(*state, move, player); !ok {
+	if !legalInSearch(state, rules, move, player) {
 		return false
 	}
 	prevCapturedBlack := state.CapturedBlack
 	prevCapturedWhite := state.CapturedWhite
 	prevToMove := state.ToMove
+	trackEval := state.evalTotalsCurrent()
+	trackFrontier := state.frontierCurrent()
+	trackLegality := state.legalityCurrent(rules)
+	var before Board
+	if trackEval {
+		before = state.Board
+	}
 	cell := playerCell(player)
 	state.Board.Set(move.X, move.Y, cell)
 	state.LastMove = move
@@ -1748,6 +1888,15 @@ func applyMove(state *GameState, rules Rules, move Move, player PlayerColor) boo
 	for _, captured := range captures {
 		state.Board.Remove(captured.X, captured.Y)
 	}
+	if trackEval {
+		updateEvalTotalsForMove(state, &before, move, captures)
+	}
+	if trackFrontier {
+		state.Frontier.applyMove(state.Board.Size(), move, captures)
+	}
+	if trackLegality {
+		updateLegalityForMove(state, move, captures)
+	}
 	if len(captures) > 0 {
 		capturedCount := len(captures)
 		if player == PlayerBlack {
@@ -1781,11 +1930,20 @@ func applyMove(state *GameState, rules Rules, move Move, player PlayerColor) boo
 
 	state.ToMove = otherPlayer(player)
 	UpdateHashAfterMove(state, move, player, captures, prevToMove, prevCapturedBlack, prevCapturedWhite)
+	if trackEval {
+		state.EvalHash = state.Hash
+	}
+	if trackFrontier {
+		state.FrontierHash = state.Hash
+	}
+	if trackLegality {
+		state.LegalityHash = state.Hash
+	}
 	return true
 }
 
 func applyMoveWithUndo(state *GameState, rules Rules, move Move, player PlayerColor, undo *searchMoveUndo) bool {
-	if ok, _ := rules.IsLegal(*state, move, player); !ok {
+	if !legalInSearch(state, rules, move, player) {
 		return false
 	}
 	prevCapturedBlack := state.CapturedBlack
@@ -1805,6 +1963,27 @@ func applyMoveWithUndo(state *GameState, rules Rules, move Move, player PlayerCo
 		undo.prevHash = state.Hash
 		undo.prevHashSym = state.HashSym
 		undo.prevCanonHash = state.CanonHash
+		undo.prevEvalTotals = state.EvalTotals
+		undo.prevEvalHash = state.EvalHash
+		undo.prevEvalValid = state.EvalValid
+		undo.prevFrontierHash = state.FrontierHash
+		undo.prevFrontierValid = state.FrontierValid
+	}
+	trackEval := state.evalTotalsCurrent()
+	trackFrontier := state.frontierCurrent()
+	trackLegality := state.legalityCurrent(rules)
+	if undo != nil {
+		undo.frontierTracked = trackFrontier
+		undo.legalityTracked = trackLegality
+		undo.prevLegalityHash = state.LegalityHash
+		undo.prevLegalityValid = state.LegalityValid
+		if trackLegality {
+			undo.prevLegality = state.Legality
+		}
+	}
+	var before Board
+	if trackEval {
+		before = state.Board
 	}
 	cell := playerCell(player)
 	state.Board.Set(move.X, move.Y, cell)
@@ -1826,6 +2005,15 @@ func applyMoveWithUndo(state *GameState, rules Rules, move Move, player PlayerCo
 	if undo != nil {
 		undo.captureCount = len(captures)
 	}
+	if trackEval {
+		updateEvalTotalsForMove(state, &before, move, captures)
+	}
+	if trackFrontier {
+		state.Frontier.applyMove(state.Board.Size(), move, captures)
+	}
+	if trackLegality {
+		updateLegalityForMove(state, move, captures)
+	}
 	if len(captures) > 0 {
 		capturedCount := len(captures)
 		if player == PlayerBlack {
@@ -1859,6 +2047,15 @@ func applyMoveWithUndo(state *GameState, rules Rules, move Move, player PlayerCo
 
 	state.ToMove = otherPlayer(player)
 	UpdateHashAfterMove(state, move, player, captures, prevToMove, prevCapturedBlack, prevCapturedWhite)
+	if trackEval {
+		state.EvalHash = state.Hash
+	}
+	if trackFrontier {
+		state.FrontierHash = state.Hash
+	}
+	if trackLegality {
+		state.LegalityHash = state.Hash
+	}
 	return true
 }
 
@@ -1879,6 +2076,33 @@ func undoMoveWithUndo(state *GameState, undo searchMoveUndo) {
 	state.Hash = undo.prevHash
 	state.HashSym = undo.prevHashSym
 	state.CanonHash = undo.prevCanonHash
+	state.EvalTotals = undo.prevEvalTotals
+	state.EvalHash = undo.prevEvalHash
+	state.EvalValid = undo.prevEvalValid
+	if undo.frontierTracked {
+		state.Frontier.undoMove(state.Board.Size(), undo.move, undo.captures[:min(undo.captureCount, len(undo.captures))])
+	}
+	state.FrontierHash = undo.prevFrontierHash
+	state.FrontierValid = undo.prevFrontierValid
+	if undo.legalityTracked {
+		state.Legality = undo.prevLegality
+	}
+	state.LegalityHash = undo.prevLegalityHash
+	state.LegalityValid = undo.prevLegalityValid
+}
+
+func updateLegalityForMove(state *GameState, move Move, captures []Move) {
+	var changedStack [17]Move
+	changed := append(changedStack[:0], move)
+	changed = append(changed, captures...)
+	state.Legality.update(&state.Board, changed)
+}
+
+func updateEvalTotalsForMove(state *GameState, before *Board, move Move, captures []Move) {
+	var changedStack [17]Move
+	changed := append(changedStack[:0], move)
+	changed = append(changed, captures...)
+	updateEvalTotals(&state.EvalTotals, before, &state.Board, changed)
 }
 
 func shouldApplyLMR(depth int, moveIndex int, quietNode bool) bool {
@@ -1892,7 +2116,7 @@ func shouldApplyLMR(depth int, moveIndex int, quietNode bool) bool {
 }
 
 func isImmediateWin(state GameState, rules Rules, move Move, player PlayerColor) bool {
-	if ok, _ := rules.IsLegal(state, move, player); !ok {
+	if !legalInSearch(&state, rules, move, player) {
 		return false
 	}
 	board := state.Board
@@ -1920,6 +2144,10 @@ func isImmediateWinCached(cache *AISearchCache, state GameState, rules Rules, mo
 }
 
 func findAlignmentWinMoves(board Board, player PlayerColor, winLen int) []Move {
+	return findAlignmentWinMovesInto(make([]Move, 0, 8), &board, player, winLen)
+}
+
+func findAlignmentWinMovesInto(dst []Move, board *Board, player PlayerColor, winLen int) []Move {
 	if winLen <= 0 {
 		winLen = 5
 	}
@@ -1932,7 +2160,7 @@ func findAlignmentWinMoves(board Board, player PlayerColor, winLen int) []Move {
 	} else {
 		seen = make([]bool, cellCount)
 	}
-	moves := make([]Move, 0, 8)
+	moves := dst[:0]
 	cell := CellFromPlayer(player)
 	directions := [4][2]int{{1, 0}, {0, 1}, {1, 1}, {1, -1}}
 	for y := 0; y < size; y++ {
@@ -1941,8 +2169,8 @@ func findAlignmentWinMoves(board Board, player PlayerColor, winLen int) []Move {
 				continue
 			}
 			for _, dir := range directions {
-				left := countContiguous(board, x, y, -dir[0], -dir[1], cell)
-				right := countContiguous(board, x, y, dir[0], dir[1], cell)
+				left := countContiguous(*board, x, y, -dir[0], -dir[1], cell)
+				right := countContiguous(*board, x, y, dir[0], dir[1], cell)
 				if left+right+1 >= winLen {
 					idx := y*size + x
 					if !seen[idx] {
@@ -1957,7 +2185,7 @@ func findAlignmentWinMoves(board Board, player PlayerColor, winLen int) []Move {
 	return moves
 }
 
-func wouldCapture(board Board, move Move, playerCell, opponentCell Cell) bool {
+func wouldCapture(board *Board, move Move, playerCell, opponentCell Cell) bool {
 	directions := [8][2]int{{1, 0}, {-1, 0}, {0, 1}, {0, -1}, {1, 1}, {-1, -1}, {1, -1}, {-1, 1}}
 	for i := 0; i < 8; i++ {
 		dx := directions[i][0]
@@ -1979,6 +2207,13 @@ func wouldCapture(board Board, move Move, playerCell, opponentCell Cell) bool {
 }
 
 func findCaptureMoves(state GameState, rules Rules, player PlayerColor) []Move {
+	return findCaptureMovesInto(make([]Move, 0, 8), state, rules, player)
+}
+
+func findCaptureMovesInto(dst []Move, state GameState, rules Rules, player PlayerColor) []Move {
+	if state.legalityCurrent(rules) {
+		return captureMovesFromMasks(dst, &state, rules, player)
+	}
 	board := state.Board
 	size := board.Size()
 	cellCount := size * size
@@ -1989,7 +2224,7 @@ func findCaptureMoves(state GameState, rules Rules, player PlayerColor) []Move {
 	} else {
 		seen = make([]bool, cellCount)
 	}
-	moves := make([]Move, 0, 8)
+	moves := dst[:0]
 	playerCell := CellFromPlayer(player)
 	opponentCell := CellFromPlayer(otherPlayer(player))
 	for y := 0; y < size; y++ {
@@ -2016,10 +2251,10 @@ func findCaptureMoves(state GameState, rules Rules, player PlayerColor) []Move {
 					}
 					seen[idx] = true
 					move := Move{X: nx, Y: ny}
-					if ok, _ := rules.IsLegal(state, move, player); !ok {
+					if !wouldCapture(&board, move, playerCell, opponentCell) {
 						continue
 					}
-					if wouldCapture(board, move, playerCell, opponentCell) {
+					if ok, _ := rules.IsLegal(state, move, player); ok {
 						moves = append(moves, move)
 					}
 				}
@@ -2066,6 +2301,10 @@ func countCapturablePairs(board Board, player PlayerColor) int {
 }
 
 func findCaptureWinMoves(state GameState, rules Rules, player PlayerColor) []Move {
+	return findCaptureWinMovesInto(make([]Move, 0, 8), state, rules, player)
+}
+
+func findCaptureWinMovesInto(dst []Move, state GameState, rules Rules, player PlayerColor) []Move {
 	remaining := rules.CaptureWinStones()
 	if player == PlayerBlack {
 		remaining -= state.CapturedBlack
@@ -2073,9 +2312,9 @@ func findCaptureWinMoves(state GameState, rules Rules, player PlayerColor) []Mov
 		remaining -= state.CapturedWhite
 	}
 	if remaining > 2 {
-		return nil
+		return dst[:0]
 	}
-	return findCaptureMoves(state, rules, player)
+	return findCaptureMovesInto(dst, state, rules, player)
 }
 
 func capturesRemaining(state GameState, rules Rules, player PlayerColor) int {
@@ -2093,7 +2332,8 @@ func hasDecisiveCaptureThreat(state GameState, rules Rules, player PlayerColor)
 	if remaining <= 0 {
 		return true
 	}
-	captureMoves := findCaptureMoves(state, rules, player)
+	var moveBuf [32]Move
+	captureMoves := findCaptureMovesInto(moveBuf[:0], state, rules, player)
 	if len(captureMoves) == 0 {
 		return false
 	}
@@ -2115,6 +2355,10 @@ func hasDecisiveCaptureThreat(state GameState, rules Rules, player PlayerColor)
 }
 
 func findCaptureThreatResponses(state GameState, rules Rules, defender PlayerColor, attacker PlayerColor, boardSize int) []Move {
+	return findCaptureThreatResponsesInto(make([]Move, 0, 8), state, rules, defender, attacker, boardSize)
+}
+
+func findCaptureThreatResponsesInto(dst []Move, state GameState, rules Rules, defender PlayerColor, attacker PlayerColor, boardSize int) []Move {
 	if boardSize <= 0 {
 		boardSize = state.Board.Size()
 	}
@@ -2122,7 +2366,7 @@ func findCaptureThreatResponses(state GameState, rules Rules, defender PlayerCol
 		boardSize = state.Board.Size()
 	}
 	board := state.Board
-	moves := make([]Move, 0, 8)
+	moves := dst[:0]
 	probeState := state
 	for y := 0; y < boardSize; y++ {
 		for x := 0; x < boardSize; x++ {
@@ -2130,7 +2374,7 @@ func findCaptureThreatResponses(state GameState, rules Rules, defender PlayerCol
 				continue
 			}
 			move := Move{X: x, Y: y}
-			if ok, _ := rules.IsLegal(probeState, move, defender); !ok {
+			if !legalInSearch(&probeState, rules, move, defender) {
 				continue
 			}
 			var undo searchMoveUndo
@@ -2147,8 +2391,12 @@ func findCaptureThreatResponses(state GameState, rules Rules, defender PlayerCol
 }
 
 func findImmediateWinMovesCached(cache *AISearchCache, state GameState, rules Rules, player PlayerColor, boardSize int, config Config) []Move {
+	return findImmediateWinMovesInto(make([]Move, 0, 4), cache, state, rules, player, boardSize, config)
+}
+
+func findImmediateWinMovesInto(dst []Move, cache *AISearchCache, state GameState, rules Rules, player PlayerColor, boardSize int, config Config) []Move {
 	if !config.AiUseScanWinIn1 {
-		moves := make([]Move, 0, 4)
+		moves := dst[:0]
 		board := state.Board
 		for y := 0; y < boardSize; y++ {
 			for x := 0; x < boardSize; x++ {
@@ -2156,7 +2404,7 @@ func findImmediateWinMovesCached(cache *AISearchCache, state GameState, rules Ru
 					continue
 				}
 				move := Move{X: x, Y: y}
-				if ok, _ := rules.IsLegal(state, move, player); !ok {
+				if !legalInSearch(&state, rules, move, player) {
 					continue
 				}
 				if isImmediateWinCached(cache, state, rules, move, player, boardSize) {
@@ -2166,8 +2414,9 @@ func findImmediateWinMovesCached(cache *AISearchCache, state GameState, rules Ru
 		}
 		return moves
 	}
-	alignment := findAlignmentWinMoves(state.Board, player, rules.WinLength())
-	capture := findCaptureWinMoves(state, rules, player)
+	var alignmentBuf, captureBuf [16]Move
+	alignment := findAlignmentWinMovesInto(alignmentBuf[:0], &state.Board, player, rules.WinLength())
+	capture := findCaptureWinMovesInto(captureBuf[:0], state, rules, player)
 	cellCount := boardSize * boardSize
 	var seenStack [maxSearchBoardCells]bool
 	seen := seenStack[:0]
@@ -2176,7 +2425,8 @@ func findImmediateWinMovesCached(cache *AISearchCache, state GameState, rules Ru
 	} else {
 		seen = make([]bool, cellCount)
 	}
-	candidates := make([]Move, 0, len(alignment)+len(capture))
+	var candidateBuf [32]Move
+	candidates := candidateBuf[:0]
 	for _, move := range alignment {
 		idx := move.Y*boardSize + move.X
 		if idx < 0 || idx >= len(seen) || seen[idx] {
@@ -2193,9 +2443,9 @@ func findImmediateWinMovesCached(cache *AISearchCache, state GameState, rules Ru
 		seen[idx] = true
 		candidates = append(candidates, move)
 	}
-	moves := make([]Move, 0, len(candidates))
+	moves := dst[:0]
 	for _, move := range candidates {
-		if ok, _ := rules.IsLegal(state, move, player); !ok {
+		if !legalInSearch(&state, rules, move, player) {
 			continue
 		}
 		if isImmediateWinCached(cache, state, rules, move, player, boardSize) {
@@ -2206,6 +2456,10 @@ func findImmediateWinMovesCached(cache *AISearchCache, state GameState, rules Ru
 }
 
 func findBlockingMoves(cache *AISearchCache, state GameState, rules Rules, player PlayerColor, boardSize int, config Config) []Move {
+	return findBlockingMovesInto(make([]Move, 0, 8), cache, state, rules, player, boardSize, config)
+}
+
+func findBlockingMovesInto(dst []Move, cache *AISearchCache, state GameState, rules Rules, player PlayerColor, boardSize int, config Config) []Move {
 	if boardSize <= 0 {
 		boardSize = state.Board.Size()
 	}
@@ -2213,7 +2467,7 @@ func findBlockingMoves(cache *AISearchCache, state GameState, rules Rules, playe
 		boardSize = state.Board.Size()
 	}
 	board := state.Board
-	moves := make([]Move, 0, 8)
+	moves := dst[:0]
 	probeState := state
 	for y := 0; y < boardSize; y++ {
 		for x := 0; x < boardSize; x++ {
@@ -2221,7 +2475,7 @@ func findBlockingMoves(cache *AISearchCache, state GameState, rules Rules, playe
 				continue
 			}
 			move := Move{X: x, Y: y}
-			if ok, _ := rules.IsLegal(probeState, move, player); !ok {
+			if !legalInSearch(&probeState, rules, move, player) {
 				continue
 			}
 			var undo searchMoveUndo
@@ -2245,7 +2499,8 @@ func hasImmediateWinCached(cache *AISearchCache, state GameState, rules Rules, p
 	if boardSize > state.Board.Size() {
 		boardSize = state.Board.Size()
 	}
-	return len(findImmediateWinMovesCached(cache, state, rules, player, boardSize, config)) > 0
+	var moveBuf [16]Move
+	return len(findImmediateWinMovesInto(moveBuf[:0], cache, state, rules, player, boardSize, config)) > 0
 }
 
 func formatMoves(moves []Move) string {
@@ -2266,10 +2521,12 @@ func formatMoves(moves []Move) string {
 	return string(out)
 }
 
-func minimax(state *GameState, ctx minimaxContext, depth int, currentPlayer PlayerColor, depthFromRoot int, alpha, beta float64) float64 {
-	logAITask(ctx, ctx.logIndent, "minimax enter depth=%d depthFromRoot=%d", depth, depthFromRoot)
+func minimax(state *GameState, ctx *minimaxContext, depth int, currentPlayer PlayerColor, depthFromRoot int, alpha, beta float64) float64 {
+	if ctx.trace != nil {
+		ctx.trace.emit(traceNode, traceInstant, depthFromRoot, depth, Move{}, 0)
+	}
 	if timedOut(ctx) || state.Status != StatusRunning {
-		return evaluateStateHeuristic(*state, ctx.rules, ctx.settings)
+		return evaluateStateHeuristic(state, ctx)
 	}
 	if depth <= 0 {
 		if ctx.settings.Config.AiEnableTacticalExt && ctx.settings.Config.AiTacticalExtDepth > 0 {
@@ -2277,7 +2534,7 @@ func minimax(state *GameState, ctx minimaxContext, depth int, currentPlayer Play
 				return tacticalExtensionScore(*state, ctx, currentPlayer, depthFromRoot)
 			}
 		}
-		return evaluateStateHeuristic(*state, ctx.rules, ctx.settings)
+		return evaluateStateHeuristic(state, ctx)
 	}
 
 	if ctx.settings.Stats != nil {
@@ -2289,24 +2546,18 @@ func minimax(state *GameState, ctx minimaxContext, depth int, currentPlayer Play
 	cache := selectCache(ctx)
 	tt := ensureTT(cache, ctx.settings.Config)
 	boardSize := ctx.settings.BoardSize
-	boardHash := ttKeyFor(*state, boardSize)
-	heuristicHash := heuristicHashFromConfig(ctx.settings.Config)
+	boardHash := tt.KeyFor(state, boardSize)
+	heuristicHash := ctx.profile.heuristicHash
 	alphaOrig := alpha
 	betaOrig := beta
 	var pvMove *Move
 	if ctx.settings.Stats != nil {
 		ctx.settings.Stats.TTProbes++
 	}
-	trace := ctx.settings.Config.AiLogSearchStats
-	var ttStart time.Time
-	if trace {
-		ttStart = time.Now()
-	}
 	if tt != nil {
-		if entry, ok := tt.Probe(boardHash, heuristicHash); ok {
-			if trace {
-				ttDuration := time.Since(ttStart).Milliseconds()
-				logAITask(ctx, ctx.logIndent+1, "TT exact probe depth=%d took=%dms hit=true", depth, ttDuration)
+		if entry, ok := tt.ProbeState(state, boardHash, heuristicHash); ok {
+			if ctx.trace != nil {
+				ctx.trace.emit(traceTTHit, traceInstant, depthFromRoot, entry.Depth, entry.BestMove, entry.ScoreFloat())
 			}
 			if ctx.settings.Stats != nil {
 				ctx.settings.Stats.TTHits++
@@ -2324,25 +2575,17 @@ func minimax(state *GameState, ctx minimaxContext, depth int, currentPlayer Play
 				pvMove = &pv
 			}
 			if entry.Depth >= depth {
-				logAITask(ctx, ctx.logIndent+1, "TT exact entry depth=%d flag=%d value=%.2f", entry.Depth, entry.Flag, entry.ScoreFloat())
 				if _, ret, value := applyTTEntry(entry, depth, &alpha, &beta, ctx.settings.Stats); ret {
-					logAITask(ctx, ctx.logIndent+1, "TT exact returning value=%.2f", value)
+					if ctx.trace != nil {
+						ctx.trace.emit(traceTTCutoff, traceInstant, depthFromRoot, depth, Move{}, value)
+					}
 					return value
 				}
 			}
 		} else {
-			if trace {
-				ttDuration := time.Since(ttStart).Milliseconds()
-				logAITask(ctx, ctx.logIndent+1, "TT exact probe depth=%d took=%dms hit=false", depth, ttDuration)
-			}
-		}
-	} else {
-		if trace {
-			ttDuration := time.Since(ttStart).Milliseconds()
-			logAITask(ctx, ctx.logIndent+1, "TT exact probe depth=%d took=%dms table=nil", depth, ttDuration)
+			prefetchCold(tt, boardHash, heuristicHash, depthFromRoot, ctx.settings.Config)
 		}
 	}
-	logAITask(ctx, ctx.logIndent, "No TT hit; continuing search")
 
 	maximizing := currentPlayer == PlayerBlack
 	best := math.Inf(-1)
@@ -2353,6 +2596,10 @@ func minimax(state *GameState, ctx minimaxContext, depth int, currentPlayer Play
 	secondBestMove := Move{}
 	cache = selectCache(ctx)
 	checkForcedLines := depthFromRoot <= 2 || depth <= 2
+	scratch := ctx.scratch.ply(depthFromRoot)
+	if scratch == nil {
+		scratch = &plyScratch{}
+	}
 	var immediateWins []Move
 	mustBlock := false
 	mustRespondCapture := false
@@ -2360,11 +2607,13 @@ func minimax(state *GameState, ctx minimaxContext, depth int, currentPlayer Play
 	tactical := false
 	opponentUrgent := false
 	if checkForcedLines {
-		immediateWins = findImmediateWinMovesCached(cache, *state, ctx.rules, currentPlayer, ctx.settings.BoardSize, ctx.settings.Config)
+		immediateWins = findImmediateWinMovesInto(scratch.wins, cache, *state, ctx.rules, currentPlayer, ctx.settings.BoardSize, ctx.settings.Config)
+		scratch.wins = immediateWins
 		if len(immediateWins) == 0 {
 			mustBlock = hasImmediateWinCached(cache, *state, ctx.rules, otherPlayer(currentPlayer), ctx.settings.BoardSize, ctx.settings.Config)
 			if !mustBlock && hasDecisiveCaptureThreat(*state, ctx.rules, otherPlayer(currentPlayer)) {
-				captureResponses = findCaptureThreatResponses(*state, ctx.rules, currentPlayer, otherPlayer(currentPlayer), ctx.settings.BoardSize)
+				captureResponses = findCaptureThreatResponsesInto(scratch.responses, *state, ctx.rules, currentPlayer, otherPlayer(currentPlayer), ctx.settings.BoardSize)
+				scratch.responses = captureResponses
 				mustRespondCapture = len(captureResponses) > 0
 			}
 		}
@@ -2380,33 +2629,35 @@ func minimax(state *GameState, ctx minimaxContext, depth int, currentPlayer Play
 	var truncatedCandidates []Move
 	var candidates []Move
 	if len(immediateWins) > 0 {
-		candidates = orderMovesFromList(*state, ctx, currentPlayer, maximizing, depthFromRoot, immediateWins, pvMove, prioWin)
+		candidates = orderMovesFromListInto(scratch, *state, ctx, currentPlayer, maximizing, depthFromRoot, immediateWins, pvMove, prioWin)
 	} else if mustBlock {
-		blockMoves := findBlockingMoves(cache, *state, ctx.rules, currentPlayer, ctx.settings.BoardSize, ctx.settings.Config)
-		candidates = orderMovesFromList(*state, ctx, currentPlayer, maximizing, depthFromRoot, blockMoves, pvMove, prioBlockWin)
+		scratch.blocks = findBlockingMovesInto(scratch.blocks, cache, *state, ctx.rules, currentPlayer, ctx.settings.BoardSize, ctx.settings.Config)
+		candidates = orderMovesFromListInto(scratch, *state, ctx, currentPlayer, maximizing, depthFromRoot, scratch.blocks, pvMove, prioBlockWin)
 	} else if mustRespondCapture {
-		candidates = orderMovesFromList(*state, ctx, currentPlayer, maximizing, depthFromRoot, captureResponses, pvMove, prioBlockWin)
+		candidates = orderMovesFromListInto(scratch, *state, ctx, currentPlayer, maximizing, depthFromRoot, captureResponses, pvMove, prioBlockWin)
 	} else if ctx.settings.Config.AiEnableTacticalMode && tactical {
-		tacticalMoves := tacticalCandidates(*state, ctx, currentPlayer)
+		tacticalMoves := tacticalCandidatesInto(scratch.tactical, *state, ctx, currentPlayer)
+		scratch.tactical = tacticalMoves
 		if opponentUrgent {
-			defensiveMoves := defensiveTacticalCandidates(tacticalMoves)
+			defensiveMoves := defensiveTacticalCandidatesInto(scratch.defensive, tacticalMoves)
+			scratch.defensive = defensiveMoves
 			if len(defensiveMoves) > 0 {
-				candidates = orderCandidateMoves(*state, ctx, currentPlayer, maximizing, depthFromRoot, defensiveMoves, 0, pvMove)
+				candidates = orderCandidateMovesInto(scratch, *state, ctx, currentPlayer, maximizing, depthFromRoot, defensiveMoves, 0, pvMove)
 			} else {
-				blockMoves := findBlockingMoves(cache, *state, ctx.rules, currentPlayer, ctx.settings.BoardSize, ctx.settings.Config)
-				if len(blockMoves) > 0 {
-					candidates = orderMovesFromList(*state, ctx, currentPlayer, maximizing, depthFromRoot, blockMoves, pvMove, prioBlockWin)
+				scratch.blocks = findBlockingMovesInto(scratch.blocks, cache, *state, ctx.rules, currentPlayer, ctx.settings.BoardSize, ctx.settings.Config)
+				if len(scratch.blocks) > 0 {
+					candidates = orderMovesFromListInto(scratch, *state, ctx, currentPlayer, maximizing, depthFromRoot, scratch.blocks, pvMove, prioBlockWin)
 				} else {
-					candidates = orderCandidates(*state, ctx, currentPlayer, maximizing, depthFromRoot, maxCandidates, pvMove)
+					candidates = orderCandidatesInto(scratch, *state, ctx, currentPlayer, maximizing, depthFromRoot, maxCandidates, pvMove)
 				}
 			}
 		} else if len(tacticalMoves) > 0 {
-			candidates = orderCandidateMoves(*state, ctx, currentPlayer, maximizing, depthFromRoot, tacticalMoves, 0, pvMove)
+			candidates = orderCandidateMovesInto(scratch, *state, ctx, currentPlayer, maximizing, depthFromRoot, tacticalMoves, 0, pvMove)
 		} else {
-			candidates = orderCandidates(*state, ctx, currentPlayer, maximizing, depthFromRoot, maxCandidates, pvMove)
+			candidates = orderCandidatesInto(scratch, *state, ctx, currentPlayer, maximizing, depthFromRoot, maxCandidates, pvMove)
 		}
 	} else {
-		candidates = orderCandidates(*state, ctx, currentPlayer, maximizing, depthFromRoot, maxCandidates, pvMove)
+		candidates = orderCandidatesInto(scratch, *state, ctx, currentPlayer, maximizing, depthFromRoot, maxCandidates, pvMove)
 	}
 	candidates = applyCandidateCap(candidates, maxCandidates)
 	if ctx.settings.Config.AiLogSearchStats {
@@ -2442,7 +2693,7 @@ func minimax(state *GameState, ctx minimaxContext, depth int, currentPlayer Play
 			}
 			if tt != nil {
 				meta := buildTTMeta(*state, ctx.settings.BoardSize, ctx.footprint)
-				replaced, overwrote := tt.Store(boardHash, heuristicHash, depth, win, TTExact, move, meta)
+				replaced, overwrote := tt.StoreState(state, boardHash, heuristicHash, depth, win, TTExact, move, meta)
 				if ctx.settings.Stats != nil {
 					ctx.settings.Stats.TTStores++
 					if replaced || overwrote {
@@ -2462,15 +2713,20 @@ func minimax(state *GameState, ctx minimaxContext, depth int, currentPlayer Play
 			}
 			reducedSearch = searchDepth < depth
 		}
-		value := evaluateMoveWithCache(state, ctx, currentPlayer, move, searchDepth, depthFromRoot, boardHash, nil, alpha, beta)
-		if reducedSearch {
-			needsResearch := false
-			if maximizing {
-				needsResearch = value > alpha
-			} else {
-				needsResearch = value < beta
-			}
-			if needsResearch {
+		searchAlpha, searchBeta := alpha, beta
+		nullWindow := false
+		// Children at depth 1 are scored statically, so a window buys nothing.
+		if idx > 0 && depth > 1 && ctx.settings.Config.AiEnablePVS {
+			searchAlpha, searchBeta, nullWindow = pvsWindow(alpha, beta, maximizing)
+		}
+		value := evaluateMoveWithCache(state, ctx, currentPlayer, move, searchDepth, depthFromRoot, boardHash, nil, searchAlpha, searchBeta)
+		if reducedSearch && improvesBound(value, alpha, beta, maximizing) {
+			value = evaluateMoveWithCache(state, ctx, currentPlayer, move, depth, depthFromRoot, boardHash, nil, searchAlpha, searchBeta)
+		}
+		if nullWindow {
+			countPVSNullWindow(ctx.settings.Stats)
+			if pvsFailedHigh(value, alpha, beta) && !timedOut(ctx) {
+				countPVSResearch(ctx.settings.Stats)
 				value = evaluateMoveWithCache(state, ctx, currentPlayer, move, depth, depthFromRoot, boardHash, nil, alpha, beta)
 			}
 		}
@@ -2501,7 +2757,9 @@ func minimax(state *GameState, ctx minimaxContext, depth int, currentPlayer Play
 				ctx.settings.Stats.Cutoffs++
 				ctx.settings.Stats.ABCutoffs++
 			}
-			logPrune(ctx, depth, move, best, alpha, beta)
+			if ctx.trace != nil {
+				ctx.trace.emit(traceCutoff, traceInstant, depthFromRoot, depth, move, best)
+			}
 			if ctx.settings.Config.AiEnableKillerMoves {
 				recordKiller(ctx, depthFromRoot, move)
 			}
@@ -2530,9 +2788,11 @@ func minimax(state *GameState, ctx minimaxContext, depth int, currentPlayer Play
 	} else if best >= betaOrig {
 		flag = TTLower
 	}
-	if tt != nil {
+	// An interrupted node only searched part of its moves; keep it out of the
+	// TT so stopped helpers and timeouts cannot publish partial scores.
+	if tt != nil && !timedOut(ctx) {
 		meta := buildTTMeta(*state, ctx.settings.BoardSize, ctx.footprint)
-		replaced, overwrote := tt.Store(boardHash, heuristicHash, depth, best, flag, bestMove, meta)
+		replaced, overwrote := tt.StoreState(state, boardHash, heuristicHash, depth, best, flag, bestMove, meta)
 		if ctx.settings.Stats != nil {
 			ctx.settings.Stats.TTStores++
 			if replaced || overwrote {
@@ -2544,6 +2804,73 @@ func minimax(state *GameState, ctx minimaxContext, depth int, currentPlayer Play
 	return best
 }
 
+// pvsWindow narrows (alpha, beta) to the null window on the side the mover
+// improves. It reports false while that side is still unbounded or the window
+// is already null, and the caller keeps the full window.
+func pvsWindow(alpha, beta float64, maximizing bool) (float64, float64, bool) {
+	if beta-alpha <= pvsNullWindow {
+		return alpha, beta, false
+	}
+	if maximizing {
+		if math.IsInf(alpha, -1) {
+			return alpha, beta, false
+		}
+		return alpha, alpha + pvsNullWindow, true
+	}
+	if math.IsInf(beta, 1) {
+		return alpha, beta, false
+	}
+	return beta - pvsNullWindow, beta, true
+}
+
+func improvesBound(value, alpha, beta float64, maximizing bool) bool {
+	if maximizing {
+		return value > alpha
+	}
+	return value < beta
+}
+
+// pvsFailedHigh reports a null-window score that beats the current best but
+// does not cut off the full window, so its exact value is still unknown.
+func pvsFailedHigh(value, alpha, beta float64) bool {
+	return value > alpha && value < beta
+}
+
+func countPVSNullWindow(stats *SearchStats) {
+	if stats != nil {
+		stats.PVSNullWindows++
+	}
+}
+
+func countPVSResearch(stats *SearchStats) {
+	if stats != nil {
+		stats.PVSResearches++
+	}
+}
+
+// searchRootMovePVS searches a root move against the running root bound:
+// with a null window once a bound exists, then with the full window when the
+// move fails high.
+func searchRootMovePVS(state *GameState, ctx *minimaxContext, move Move, depth int, boardHash uint64, outCached *bool, alpha, beta float64) float64 {
+	settings := ctx.settings
+	maximizing := settings.Player == PlayerBlack
+	searchAlpha, searchBeta, nullWindow := alpha, beta, false
+	if depth > 1 && settings.Config.AiEnablePVS {
+		searchAlpha, searchBeta, nullWindow = pvsWindow(alpha, beta, maximizing)
+	}
+	ctx.killerBase = depth
+	score := evaluateMoveWithCache(state, ctx, settings.Player, move, depth, depth, boardHash, outCached, searchAlpha, searchBeta)
+	if !nullWindow {
+		return score
+	}
+	countPVSNullWindow(settings.Stats)
+	if pvsFailedHigh(score, alpha, beta) && !timedOut(ctx) {
+		countPVSResearch(settings.Stats)
+		score = evaluateMoveWithCache(state, ctx, settings.Player, move, depth, depth, boardHash, outCached, alpha, beta)
+	}
+	return score
+}
+
 func applyTTEntry(entry TTEntry, depth int, alpha *float64, beta *float64, stats *SearchStats) (used bool, ret bool, value float64) {
 	if entry.Depth < depth {
 		return false, false, 0.0
@@ -2572,14 +2899,14 @@ func applyTTEntry(entry TTEntry, depth int, alpha *float64, beta *float64, stats
 	return true, false, entry.ScoreFloat()
 }
 
-func evaluateMoveWithCache(state *GameState, ctx minimaxContext, currentPlayer PlayerColor, move Move, depthLeft int, depthFromRoot int, boardHash uint64, outCached *bool, alpha, beta float64) float64 {
+func evaluateMoveWithCache(state *GameState, ctx *minimaxContext, currentPlayer PlayerColor, move Move, depthLeft int, depthFromRoot int, boardHash uint64, outCached *bool, alpha, beta float64) float64 {
 	if timedOut(ctx) {
-		return evaluateStateHeuristic(*state, ctx.rules, ctx.settings)
+		return evaluateStateHeuristic(state, ctx)
 	}
 	_ = boardHash
 
 	score := illegalScore
-	if ok, _ := ctx.rules.IsLegal(*state, move, currentPlayer); ok {
+	if legalInSearch(state, ctx.rules, move, currentPlayer) {
 		sampleBoardTiming := false
 		if stats := ctx.settings.Stats; stats != nil {
 			nextOp := stats.BoardGenOps + 1
@@ -2608,11 +2935,9 @@ func evaluateMoveWithCache(state *GameState, ctx minimaxContext, currentPlayer P
 				ctx.settings.OnGhostUpdate(state.Clone())
 			}
 			if depthLeft <= 1 || timedOut(ctx) {
-				score = evaluateStateHeuristic(*state, ctx.rules, ctx.settings)
+				score = evaluateStateHeuristic(state, ctx)
 			} else {
-				nextCtx := ctx
-				nextCtx.logIndent = ctx.logIndent + 1
-				score = minimax(state, nextCtx, depthLeft-1, otherPlayer(currentPlayer), depthFromRoot+1, alpha, beta)
+				score = minimax(state, ctx, depthLeft-1, otherPlayer(currentPlayer), depthFromRoot+1, alpha, beta)
 			}
 			undoMoveWithUndo(state, undo)
 		}
@@ -2623,7 +2948,7 @@ func evaluateMoveWithCache(state *GameState, ctx minimaxContext, currentPlayer P
 	return score
 }
 
-func scoreBoardAtDepth(state GameState, settings AIScoreSettings, ctx minimaxContext, depth int, alpha, beta float64, outUsedCache *bool) ([]float64, bool) {
+func scoreBoardAtDepth(state GameState, settings AIScoreSettings, ctx *minimaxContext, depth int, alpha, beta float64, outUsedCache *bool) ([]float64, bool) {
 	if timedOut(ctx) {
 		return nil, false
 	}
@@ -2632,13 +2957,13 @@ func scoreBoardAtDepth(state GameState, settings AIScoreSettings, ctx minimaxCon
 	for i := range scores {
 		scores[i] = illegalScore
 	}
-	boardHash := ttKeyFor(state, settings.BoardSize)
-	heuristicHash := heuristicHashFromConfig(settings.Config)
+	heuristicHash := ctx.profile.heuristicHash
 	cache := selectCache(ctx)
 	tt := ensureTT(cache, settings.Config)
+	boardHash := tt.KeyFor(&state, settings.BoardSize)
 	var pvMove *Move
 	if tt != nil {
-		if entry, ok := tt.Probe(boardHash, heuristicHash); ok {
+		if entry, ok := tt.ProbeState(&state, boardHash, heuristicHash); ok {
 			if entry.BestMove.IsValid(settings.BoardSize) {
 				pv := entry.BestMove
 				pvMove = &pv
@@ -2734,15 +3059,30 @@ func scoreBoardAtDepth(state GameState, settings AIScoreSettings, ctx minimaxCon
 		}
 		idx := move.Y*settings.BoardSize + move.X
 		cached := false
-		score := evaluateMoveWithCache(&state, ctx, settings.Player, move, depth, depth, boardHash, &cached, rootAlpha, rootBeta)
-		if settings.Config.AiEnableAspiration && (score <= aspirationAlpha || score >= aspirationBeta) {
+		score := searchRootMovePVS(&state, ctx, move, depth, boardHash, &cached, rootAlpha, rootBeta)
+		// Only a fail against an aspiration edge no searched move has moved
+		// yet can hide the best move; that side is opened for the rest of
+		// the depth. Fails against a raised bound just mean a worse move.
+		failLow := score <= rootAlpha && rootAlpha == aspirationAlpha && !math.IsInf(aspirationAlpha, -1)
+		failHigh := score >= rootBeta && rootBeta == aspirationBeta && !math.IsInf(aspirationBeta, 1)
+		if settings.Config.AiEnableAspiration && (failLow || failHigh) {
 			if timedOut(ctx) {
 				if outUsedCache != nil {
 					*outUsedCache = usedCache
 				}
 				return nil, false
 			}
-			score = evaluateMoveWithCache(&state, ctx, settings.Player, move, depth, depth, boardHash, &cached, math.Inf(-1), math.Inf(1))
+			if settings.Stats != nil {
+				settings.Stats.AspirationResearches++
+			}
+			if failLow {
+				aspirationAlpha = math.Inf(-1)
+				rootAlpha = aspirationAlpha
+			} else {
+				aspirationBeta = math.Inf(1)
+				rootBeta = aspirationBeta
+			}
+			score = evaluateMoveWithCache(&state, ctx, settings.Player, move, depth, depth, boardHash, &cached, rootAlpha, rootBeta)
 		}
 		if cached {
 			usedCache = true
@@ -2787,13 +3127,46 @@ func mergeSearchStats(dst, src *SearchStats) {
 	dst.DeepSamples += src.DeepSamples
 	dst.EvalCacheProbes += src.EvalCacheProbes
 	dst.EvalCacheHits += src.EvalCacheHits
+	dst.EvalCacheCollisions += src.EvalCacheCollisions
+	dst.RootTransposeProbes += src.RootTransposeProbes
+	dst.RootTransposeHits += src.RootTransposeHits
+	dst.RootTransposeCollisions += src.RootTransposeCollisions
 	dst.HeuristicCalls += src.HeuristicCalls
 	dst.HeuristicTime += src.HeuristicTime
 	dst.BoardGenOps += src.BoardGenOps
 	dst.BoardGenTime += src.BoardGenTime
+	dst.HelperThreads += src.HelperThreads
+	dst.HelperNodes += src.HelperNodes
+	dst.PVSNullWindows += src.PVSNullWindows
+	dst.PVSResearches += src.PVSResearches
+	dst.AspirationResearches += src.AspirationResearches
 }
 
 func rootShapeKey(state GameState, boardSize int) (uint64, boardBBox, bool) {
+	keys, bbox, ok := rootShapeKeys(state, boardSize, 1)
+	return keys[0], bbox, ok
+}
+
+// rootTransposeKey is rootShapeKey folded over the eight board symmetries
+// when AiTtSymmetry is set; sym maps the state's frame onto the stored one.
+func rootTransposeKey(state GameState, boardSize int, config Config) (key uint64, bbox boardBBox, sym int, ok bool) {
+	if !config.AiTtSymmetry {
+		key, bbox, ok = rootShapeKey(state, boardSize)
+		return key, bbox, 0, ok
+	}
+	keys, bbox, ok := rootShapeKeys(state, boardSize, len(symmetryTransforms))
+	for i := 1; i < len(keys); i++ {
+		if keys[i] < keys[sym] {
+			sym = i
+		}
+	}
+	return keys[sym], bbox, sym, ok
+}
+
+// rootShapeKeys hashes the stones inside the bounding box as seen through the
+// first n symmetry transforms; keys[0] is the untransformed shape.
+func rootShapeKeys(state GameState, boardSize int, n int) ([8]uint64, boardBBox, bool) {
+	var keys [8]uint64
 	if boardSize <= 0 {
 		boardSize = state.Board.Size()
 	}
@@ -2802,15 +3175,26 @@ func rootShapeKey(state GameState, boardSize int) (uint64, boardBBox, bool) {
 	}
 	bbox := computeBBox(state.Board, boardSize)
 	if bbox.stones == 0 || bbox.width <= 0 || bbox.height <= 0 {
-		return 0, bbox, false
+		return keys, bbox, false
 	}
-	key := mixKey(uint64(bbox.width)<<32 | uint64(bbox.height))
 	meta := uint64(state.ToMove&0xff)<<56 | uint64(state.Status&0xff)<<48
 	meta ^= uint64(state.CapturedBlack&0xffff) << 24
 	meta ^= uint64(state.CapturedWhite & 0xffff)
-	key ^= mixKey(meta)
+	common := mixKey(meta)
 	if state.MustCapture {
-		key ^= mixKey(0xc31f5d9f2c5a4b17)
+		common ^= mixKey(0xc31f5d9f2c5a4b17)
+	}
+	var widths [8]int
+	for i := 0; i < n; i++ {
+		w, h := transformDims(bbox.width, bbox.height, symmetryTransforms[i])
+		widths[i] = w
+		keys[i] = mixKey(uint64(w)<<32|uint64(h)) ^ common
+	}
+	addToken := func(relX, relY int, tag uint64) {
+		for i := 0; i < n; i++ {
+			tx, ty := transformRect(relX, relY, bbox.width, bbox.height, symmetryTransforms[i])
+			keys[i] ^= mixKey(uint64(ty*widths[i]+tx)<<2 | tag)
+		}
 	}
 	for _, forced := range state.ForcedCaptureMoves {
 		relX := forced.X - bbox.minX
@@ -2818,26 +3202,81 @@ func rootShapeKey(state GameState, boardSize int) (uint64, boardBBox, bool) {
 		if relX < 0 || relY < 0 || relX >= bbox.width || relY >= bbox.height {
 			continue
 		}
-		rel := relY*bbox.width + relX
-		key ^= mixKey(uint64(rel)<<2 | 3)
+		addToken(relX, relY, 3)
 	}
 	for y := bbox.minY; y <= bbox.maxY; y++ {
 		for x := bbox.minX; x <= bbox.maxX; x++ {
-			cell := state.Board.At(x, y)
-			if cell == CellEmpty {
-				continue
-			}
-			rel := (y-bbox.minY)*bbox.width + (x - bbox.minX)
-			token := uint64(rel) << 2
-			if cell == CellBlack {
-				token |= 1
-			} else if cell == CellWhite {
-				token |= 2
+			switch state.Board.At(x, y) {
+			case CellBlack:
+				addToken(x-bbox.minX, y-bbox.minY, 1)
+			case CellWhite:
+				addToken(x-bbox.minX, y-bbox.minY, 2)
 			}
-			key ^= mixKey(token)
 		}
 	}
-	return key, bbox, true
+	return keys, bbox, true
+}
+
+// transformRootFrame maps a root-transpose frame (growth, wall hits and size)
+// and the best move inside it through transform.
+func transformRootFrame(bestRel Move, meta TTMeta, transform symmetryTransform) (Move, TTMeta) {
+	w, h := meta.FrameW, meta.FrameH
+	out := TTMeta{}
+	out.FrameW, out.FrameH = transformDims(w, h, transform)
+	x, y := transformRect(bestRel.X, bestRel.Y, w, h, transform)
+	grow := [4]int{meta.GrowLeft, meta.GrowRight, meta.GrowTop, meta.GrowBottom}
+	hit := [4]bool{meta.HitLeft, meta.HitRight, meta.HitTop, meta.HitBottom}
+	// Each side moves to wherever a cell just beyond it lands.
+	beyond := [4][2]int{{-1, 0}, {w, 0}, {0, -1}, {0, h}}
+	for side, cell := range beyond {
+		tx, ty := transformRect(cell[0], cell[1], w, h, transform)
+		switch {
+		case tx < 0:
+			out.GrowLeft, out.HitLeft = grow[side], hit[side]
+		case tx >= out.FrameW:
+			out.GrowRight, out.HitRight = grow[side], hit[side]
+		case ty < 0:
+			out.GrowTop, out.HitTop = grow[side], hit[side]
+		default:
+			out.GrowBottom, out.HitBottom = grow[side], hit[side]
+		}
+	}
+	return Move{X: x, Y: y}, out
+}
+
+// lookupRootTranspose returns the root-transpose entry for state with its
+// frame and best move in state's orientation.
+func lookupRootTranspose(rootTranspose *RootTransposeCache, state GameState, boardSize int, minDepth int, config Config) (RootTransposeEntry, boardBBox, bool) {
+	key, bbox, sym, ok := rootTransposeKey(state, boardSize, config)
+	if !ok {
+		return RootTransposeEntry{}, bbox, false
+	}
+	entry, ok := rootTranspose.Get(key, minDepth)
+	if !ok || sym == 0 {
+		return entry, bbox, ok
+	}
+	meta := TTMeta{
+		GrowLeft:   int(entry.GrowLeft),
+		GrowRight:  int(entry.GrowRight),
+		GrowTop:    int(entry.GrowTop),
+		GrowBottom: int(entry.GrowBottom),
+		FrameW:     int(entry.FrameW),
+		FrameH:     int(entry.FrameH),
+		HitLeft:    entry.HitLeft,
+		HitRight:   entry.HitRight,
+		HitTop:     entry.HitTop,
+		HitBottom:  entry.HitBottom,
+	}
+	bestRel, meta := transformRootFrame(entry.BestRel, meta, symmetryTransforms[inverseSymmetry[sym]])
+	entry.BestRel = bestRel
+	entry.GrowLeft = clampToUint8(meta.GrowLeft)
+	entry.GrowRight = clampToUint8(meta.GrowRight)
+	entry.GrowTop = clampToUint8(meta.GrowTop)
+	entry.GrowBottom = clampToUint8(meta.GrowBottom)
+	entry.FrameW = clampToUint8(meta.FrameW)
+	entry.FrameH = clampToUint8(meta.FrameH)
+	entry.HitLeft, entry.HitRight, entry.HitTop, entry.HitBottom = meta.HitLeft, meta.HitRight, meta.HitTop, meta.HitBottom
+	return entry, bbox, true
 }
 
 func storeRootTransposeExact(state GameState, settings AIScoreSettings, cache *AISearchCache, depth int, score float64, bestMove Move, meta TTMeta) {
@@ -2848,7 +3287,7 @@ func storeRootTransposeExact(state GameState, settings AIScoreSettings, cache *A
 	if rootTranspose == nil {
 		return
 	}
-	key, bbox, ok := rootShapeKey(state, settings.BoardSize)
+	key, bbox, sym, ok := rootTransposeKey(state, settings.BoardSize, settings.Config)
 	if !ok {
 		return
 	}
@@ -2861,7 +3300,12 @@ func storeRootTransposeExact(state GameState, settings AIScoreSettings, cache *A
 	if bestRel.X < 0 || bestRel.Y < 0 || bestRel.X >= meta.FrameW || bestRel.Y >= meta.FrameH {
 		return
 	}
-	rootTranspose.Put(key, depth, score, TTExact, bestRel, meta)
+	if sym != 0 {
+		bestRel, meta = transformRootFrame(bestRel, meta, symmetryTransforms[sym])
+	}
+	if rootTranspose.Put(key, depth, score, TTExact, bestRel, meta) && settings.Stats != nil {
+		settings.Stats.RootTransposeCollisions++
+	}
 }
 
 func scoreBoardFromRootTranspose(state GameState, rules Rules, settings AIScoreSettings, cache *AISearchCache) ([]float64, bool) {
@@ -2872,11 +3316,13 @@ func scoreBoardFromRootTranspose(state GameState, rules Rules, settings AIScoreS
 	if rootTranspose == nil {
 		return nil, false
 	}
-	key, bbox, ok := rootShapeKey(state, settings.BoardSize)
-	if !ok {
-		return nil, false
+	entry, bbox, ok := lookupRootTranspose(rootTranspose, state, settings.BoardSize, settings.Depth, settings.Config)
+	if settings.Stats != nil {
+		settings.Stats.RootTransposeProbes++
+		if ok {
+			settings.Stats.RootTransposeHits++
+		}
 	}
-	entry, ok := rootTranspose.Get(key, settings.Depth)
 	if !ok {
 		return nil, false
 	}
@@ -2931,9 +3377,9 @@ func scoreBoardFromRootTranspose(state GameState, rules Rules, settings AIScoreS
 }
 
 func scoreBoardFromRootTT(state GameState, rules Rules, settings AIScoreSettings, cache *AISearchCache, tt *TranspositionTable, rootHash uint64) ([]float64, bool) {
-	heuristicHash := heuristicHashFromConfig(settings.Config)
+	heuristicHash := withSearchProfile(settings).Profile.heuristicHash
 	if tt != nil {
-		entry, ok := tt.Probe(rootHash, heuristicHash)
+		entry, ok := tt.ProbeState(&state, rootHash, heuristicHash)
 		if ok && entry.Flag == TTExact && entry.Depth >= settings.Depth && entry.BestMove.IsValid(settings.BoardSize) {
 			if legal, _ := rules.IsLegal(state, entry.BestMove, settings.Player); legal {
 				scores := make([]float64, settings.BoardSize*settings.BoardSize)
@@ -2954,6 +3400,9 @@ func scoreBoardFromRootTT(state GameState, rules Rules, settings AIScoreSettings
 	if scores, ok := scoreBoardFromRootTranspose(state, rules, settings, cache); ok {
 		return scores, true
 	}
+	if scores, ok := scoreBoardFromBook(state, rules, settings); ok {
+		return scores, true
+	}
 	if settings.Stats != nil {
 		settings.Stats.TTProbes++
 	}
@@ -3053,9 +3502,19 @@ func ScoreBoardDirectDepthParallel(state GameState, rules Rules, settings AIScor
 	if settings.Config == (Config{}) {
 		settings.Config = GetConfig()
 	}
+	settings = withSearchProfile(settings)
 	if state.Hash == 0 {
 		state.recomputeHashes()
 	}
+	if !state.evalTotalsCurrent() {
+		state.refreshEvalTotals()
+	}
+	if !state.frontierCurrent() {
+		state.refreshFrontier()
+	}
+	if !state.legalityCurrent(rules) {
+		state.refreshLegality(rules)
+	}
 
 	scores := make([]float64, settings.BoardSize*settings.BoardSize)
 	for i := range scores {
@@ -3078,8 +3537,15 @@ func ScoreBoardDirectDepthParallel(state GameState, rules Rules, settings AIScor
 		}
 		return scores, true
 	}
-
+	if bookScores, ok := scoreBoardFromBook(state, rules, settings); ok {
+		return bookScores, true
+	}
 	start := time.Now()
+	settings.Time = startTimeManager(settings, start)
+	defer settings.Time.stop()
+	if threatScores, ok := scoreBoardFromThreatSolver(state, rules, settings); ok {
+		return threatScores, true
+	}
 	baseCtx := newMinimaxContext(rules, settings, start)
 	baseCtx.footprint = newSearchFootprint(state, settings.BoardSize)
 
@@ -3088,22 +3554,17 @@ func ScoreBoardDirectDepthParallel(state GameState, rules Rules, settings AIScor
 	if tt != nil {
 		tt.NextGeneration()
 	}
-	if settings.Config.AiEnableEvalCache {
-		if evalCache := ensureEvalCache(cache, settings.Config); evalCache != nil {
-			evalCache.NextGeneration()
-		}
-	}
 	if settings.Config.AiEnableRootTranspose {
 		if rootTranspose := ensureRootTransposeCache(cache, settings.Config); rootTranspose != nil {
 			rootTranspose.NextGeneration()
 		}
 	}
 
-	boardHash := ttKeyFor(state, settings.BoardSize)
-	heuristicHash := heuristicHashFromConfig(settings.Config)
+	boardHash := tt.KeyFor(&state, settings.BoardSize)
+	heuristicHash := settings.Profile.heuristicHash
 	var pvMove *Move
 	if tt != nil {
-		if entry, ok := tt.Probe(boardHash, heuristicHash); ok && entry.BestMove.IsValid(settings.BoardSize) {
+		if entry, ok := tt.ProbeState(&state, boardHash, heuristicHash); ok && entry.BestMove.IsValid(settings.BoardSize) {
 			pv := entry.BestMove
 			pvMove = &pv
 		}
@@ -3202,7 +3663,7 @@ func ScoreBoardDirectDepthParallel(state GameState, rules Rules, settings AIScor
 			boundBeta = score
 		}
 	}
-	evaluateRootMove := func(localState *GameState, localCtx minimaxContext, localSettings AIScoreSettings, localStats *SearchStats, move Move) float64 {
+	evaluateRootMove := func(localState *GameState, localCtx *minimaxContext, localSettings AIScoreSettings, localStats *SearchStats, move Move) float64 {
 		if settings.Config.AiQuickWinExit && isImmediateWinCached(cache, *localState, rules, move, settings.Player, settings.BoardSize) {
 			win := -winScore
 			if settings.Player == PlayerBlack {
@@ -3215,13 +3676,27 @@ func ScoreBoardDirectDepthParallel(state GameState, rules Rules, settings AIScor
 			return win
 		}
 		alphaBound, betaBound := readRootBounds()
-		score := evaluateMoveWithCache(localState, localCtx, settings.Player, move, settings.Depth, settings.Depth, boardHash, nil, alphaBound, betaBound)
+		score := searchRootMovePVS(localState, localCtx, move, settings.Depth, boardHash, nil, alphaBound, betaBound)
 		updateRootBound(score)
 		flushSearchProgress(localStats, localSettings)
 		return score
 	}
 
-	if workers == 1 {
+	if workers > 1 && useLazySMP(settings.Config) {
+		helpers := startLazySMPHelpers(state, rules, settings, candidates, settings.Depth, settings.Depth+1, workers-1, start)
+		mainStats := &SearchStats{}
+		mainSettings := settings
+		mainSettings.Stats = mainStats
+		mainCtx := newMinimaxContext(rules, mainSettings, start)
+		mainCtx.footprint = baseCtx.footprint
+		mainState := state.Clone()
+		for _, move := range candidates {
+			score := evaluateRootMove(&mainState, mainCtx, mainSettings, mainStats, move)
+			scores[move.Y*settings.BoardSize+move.X] = score
+		}
+		mergeSearchStats(settings.Stats, mainStats)
+		helpers.finish(settings.Stats)
+	} else if workers == 1 {
 		localStats := &SearchStats{}
 		localSettings := settings
 		localSettings.Stats = localStats
@@ -3248,7 +3723,26 @@ func ScoreBoardDirectDepthParallel(state GameState, rules Rules, settings AIScor
 		mergeSearchStats(settings.Stats, mainStats)
 
 		remaining := candidates[1:]
-		if len(remaining) > 0 {
+		if len(remaining) > 0 && settings.RunRootJobs != nil {
+			jobStats := make([]SearchStats, len(remaining))
+			jobs := make([]func(), len(remaining))
+			for i, move := range remaining {
+				i, move := i, move
+				jobs[i] = func() {
+					localStats := &jobStats[i]
+					localSettings := settings
+					localSettings.Stats = localStats
+					localCtx := newMinimaxContext(rules, localSettings, start)
+					localCtx.footprint = baseCtx.footprint
+					localState := state.Clone()
+					scores[move.Y*settings.BoardSize+move.X] = evaluateRootMove(&localState, localCtx, localSettings, localStats, move)
+				}
+			}
+			settings.RunRootJobs(jobs)
+			for i := range jobStats {
+				mergeSearchStats(settings.Stats, &jobStats[i])
+			}
+		} else if len(remaining) > 0 {
 			workerCount := workers - 1
 			if workerCount < 1 {
 				workerCount = 1
@@ -3322,7 +3816,7 @@ func ScoreBoardDirectDepthParallel(state GameState, rules Rules, settings AIScor
 	}
 	meta := buildTTMeta(state, settings.BoardSize, baseCtx.footprint)
 	if tt != nil && foundBest {
-		replaced, overwrote := tt.Store(boardHash, heuristicHash, settings.Depth, bestScore, TTExact, bestMove, meta)
+		replaced, overwrote := tt.StoreState(&state, boardHash, heuristicHash, settings.Depth, bestScore, TTExact, bestMove, meta)
 		if settings.Stats != nil {
 			settings.Stats.TTStores++
 			if replaced || overwrote {
@@ -3354,9 +3848,19 @@ func ScoreBoard(state GameState, rules Rules, settings AIScoreSettings) []float6
 	if settings.Config == (Config{}) {
 		settings.Config = GetConfig()
 	}
+	settings = withSearchProfile(settings)
 	if state.Hash == 0 {
 		state.recomputeHashes()
 	}
+	if !state.evalTotalsCurrent() {
+		state.refreshEvalTotals()
+	}
+	if !state.frontierCurrent() {
+		state.refreshFrontier()
+	}
+	if !state.legalityCurrent(rules) {
+		state.refreshLegality(rules)
+	}
 	queueState := GameState{}
 	queueStateReady := false
 	if settings.Config.AiQueueEnabled && !settings.SkipQueueBacklog && !settings.DirectDepthOnly {
@@ -3372,7 +3876,18 @@ func ScoreBoard(state GameState, rules Rules, settings AIScoreSettings) []float6
 	if settings.Config.AiMinDepth > 0 {
 		minDepth = settings.Config.AiMinDepth
 	}
-	ctx := newMinimaxContext(rules, settings, time.Now())
+	if settings.Trace == nil && settings.TraceLabel != "" && settings.Config.AiSearchTrace {
+		settings.Trace = newSearchTrace(settings.TraceLabel, settings.Config.AiSearchTraceEvents)
+		defer settings.Trace.finish()
+	}
+	start := time.Now()
+	settings.Time = startTimeManager(settings, start)
+	defer settings.Time.stop()
+	ctx := newMinimaxContext(rules, settings, start)
+	if ctx.trace != nil {
+		ctx.trace.emit(traceSearch, traceBegin, 0, settings.Depth, Move{}, 0)
+		defer ctx.trace.emit(traceSearch, traceEnd, 0, settings.Depth, Move{}, 0)
+	}
 	if settings.Stats != nil && settings.Stats.Start.IsZero() {
 		settings.Stats.Start = ctx.start
 	}
@@ -3405,22 +3920,33 @@ func ScoreBoard(state GameState, rules Rules, settings AIScoreSettings) []float6
 	if tt != nil {
 		tt.NextGeneration()
 	}
-	if settings.Config.AiEnableEvalCache {
-		if evalCache := ensureEvalCache(cache, settings.Config); evalCache != nil {
-			evalCache.NextGeneration()
-		}
-	}
 	if settings.Config.AiEnableRootTranspose {
 		if rootTranspose := ensureRootTransposeCache(cache, settings.Config); rootTranspose != nil {
 			rootTranspose.NextGeneration()
 		}
 	}
-	rootHash := ttKeyFor(state, settings.BoardSize)
-	ttHeuristicHash := heuristicHashFromConfig(settings.Config)
+	rootHash := tt.KeyFor(&state, settings.BoardSize)
+	ttHeuristicHash := settings.Profile.heuristicHash
 	if scores, ok := scoreBoardFromRootTT(state, rules, settings, cache, tt, rootHash); ok {
 		logAITask(ctx, 1, "Root TT shortcut hit depth=%d", settings.Depth)
 		return scores
 	}
+	if scores, ok := scoreBoardFromThreatSolver(state, rules, settings); ok {
+		logAITask(ctx, 1, "Threat solver proved a forced win")
+		return scores
+	}
+	if settings.Config.AiLazySmpHelpers > 0 && useLazySMP(settings.Config) {
+		helpers := startLazySMPHelpers(state, rules, settings, candidateMovesOnly(initialCandidates), minDepth, settings.Depth, settings.Config.AiLazySmpHelpers, startTime)
+		defer helpers.finish(settings.Stats)
+	}
+	if settings.Config.AiReuseSearchTree {
+		if carried, ok := settings.Carry.seed(ctx, &state); ok {
+			if settings.Stats != nil {
+				settings.Stats.CarriedDepth = carried
+			}
+			logAITask(ctx, 1, "Seeded ordering from carried tree depth=%d", carried)
+		}
+	}
 	var scores []float64
 	var lastScores []float64
 	var lastBestScore float64
@@ -3451,10 +3977,19 @@ func ScoreBoard(state GameState, rules Rules, settings AIScoreSettings) []float6
 		}
 		return result
 	}
+	settings.Time.observeRoot(&state, func() bool {
+		return isTacticalPosition(state, ctx, settings.Player) || hasUrgentThreat(state.Board, settings.BoardSize, otherPlayer(settings.Player))
+	})
+	softStopped := false
 	for depth := startDepth; depth <= settings.Depth; depth++ {
 		if timedOut(ctx) && depth > minDepth {
 			break
 		}
+		if depth > minDepth && settings.Time.pastSoftLimit() {
+			logAITask(ctx, 1, "Soft time limit reached before depth %d", depth)
+			softStopped = true
+			break
+		}
 		logAITask(ctx, 1, "Depth %d start", depth)
 		depthStart := time.Now()
 		if settings.Config.AiQuickWinExit {
@@ -3473,7 +4008,7 @@ func ScoreBoard(state GameState, rules Rules, settings AIScoreSettings) []float6
 					winScores[move.Y*settings.BoardSize+move.X] = win
 					if tt != nil {
 						meta := buildTTMeta(state, settings.BoardSize, ctx.footprint)
-						replaced, overwrote := tt.Store(rootHash, ttHeuristicHash, depth, win, TTExact, move, meta)
+						replaced, overwrote := tt.StoreState(&state, rootHash, ttHeuristicHash, depth, win, TTExact, move, meta)
 						if settings.Stats != nil {
 							settings.Stats.TTStores++
 							if replaced || overwrote {
@@ -3501,7 +4036,13 @@ func ScoreBoard(state GameState, rules Rules, settings AIScoreSettings) []float6
 		}
 		usedCache := false
 		var completed bool
+		if ctx.trace != nil {
+			ctx.trace.emit(traceIteration, traceBegin, 0, depth, Move{}, 0)
+		}
 		scores, completed = scoreBoardAtDepth(state, settings, ctx, depth, alpha, beta, &usedCache)
+		if ctx.trace != nil {
+			ctx.trace.emit(traceIteration, traceEnd, 0, depth, Move{}, 0)
+		}
 		if !completed {
 			if settings.Config.AiReturnLastComplete && lastScores != nil {
 				break
@@ -3582,7 +4123,7 @@ func ScoreBoard(state GameState, rules Rules, settings AIScoreSettings) []float6
 		}
 		meta := buildTTMeta(state, settings.BoardSize, ctx.footprint)
 		if tt != nil && bestX >= 0 && bestY >= 0 {
-			replaced, overwrote := tt.Store(rootHash, ttHeuristicHash, depth, bestScore, TTExact, Move{X: bestX, Y: bestY}, meta)
+			replaced, overwrote := tt.StoreState(&state, rootHash, ttHeuristicHash, depth, bestScore, TTExact, Move{X: bestX, Y: bestY}, meta)
 			if settings.Stats != nil {
 				settings.Stats.TTStores++
 				if replaced || overwrote {
@@ -3596,16 +4137,27 @@ func ScoreBoard(state GameState, rules Rules, settings AIScoreSettings) []float6
 			if settings.OnDepthComplete != nil {
 				settings.OnDepthComplete(depth, Move{X: bestX, Y: bestY}, bestScore)
 			}
+			settings.Time.depthCompleted(Move{X: bestX, Y: bestY}, bestScore)
+		}
+		if settings.OnDepthScores != nil {
+			settings.OnDepthScores(depth, scores)
 		}
 		lastDepthCompleted = depth
 		lastScores = scores
 		lastBestScore = bestScore
 		haveBest = true
 	}
+	if settings.Config.AiReuseSearchTree && tt != nil && lastDepthCompleted > 0 {
+		settings.Carry.capture(state, ctx, tt, lastDepthCompleted)
+	}
 	totalDuration := time.Since(startTime)
 	logAITask(ctx, 0, "ScoreBoard finished depth=%d total=%dms", lastDepthCompleted, totalDuration.Milliseconds())
+	if settings.Stats != nil && settings.Time != nil {
+		settings.Stats.SoftLimit = settings.Time.soft
+		settings.Stats.SoftStopped = softStopped
+	}
 	if !settings.DirectDepthOnly && lastDepthCompleted < settings.Depth {
-		if timedOut(ctx) || (ctx.settings.ShouldStop != nil && ctx.settings.ShouldStop()) {
+		if softStopped || timedOut(ctx) || (ctx.settings.ShouldStop != nil && ctx.settings.ShouldStop()) {
 			if queueStateReady {
 				enqueueSearchBacklogTask(queueState, rules)
 			}
@@ -3664,6 +4216,12 @@ func ttKeyFor(state GameState, boardSize int) uint64 {
 	return key
 }
 
+// orientedKeyFor is ttKeyFor without symmetry folding, for anything that
+// remembers a move rather than a score.
+func orientedKeyFor(state *GameState, boardSize int) uint64 {
+	return state.Hash ^ mixKey(uint64(boardSize)<<32|uint64(state.Status))
+}
+
 func mixKey(v uint64) uint64 {
 	v += 0x9e3779b97f4a7c15
 	v = (v ^ (v >> 30)) * 0xbf58476d1ce4e5b9
@@ -1,9 +1,12 @@
 package main
 
 import (
+	"math"
 	"reflect"
+	"sync"
 	"sync/atomic"
 	"testing"
+	"time"
 )
 
 func TestScoreBoardStoresRootTTEntryAtCompletedDepth(t *testing.T) {
@@ -56,8 +59,8 @@ func TestScoreBoardStoresRootTTEntryAtCompletedDepth(t *testing.T) {
 	if tt == nil {
 		t.Fatalf("expected TT to be initialized")
 	}
-	rootKey := ttKeyFor(state, settings.BoardSize)
-	entry, hit := tt.Probe(rootKey, heuristicHashFromConfig(cfg))
+	rootKey := tt.KeyFor(&state, settings.BoardSize)
+	entry, hit := tt.ProbeState(&state, rootKey, heuristicHashFromConfig(cfg))
 	if !hit {
 		t.Fatalf("expected root board entry in TT")
 	}
@@ -313,8 +316,13 @@ func TestHeuristicForMoveStronglyPenalizesCreatingCapturablePair(t *testing.T) {
 		Player:    PlayerBlack,
 		Config:    DefaultConfig(),
 	}
-	risky := heuristicForMove(state, rules, scoreSettings, Move{X: 5, Y: 4})
-	safer := heuristicForMove(state, rules, scoreSettings, Move{X: 4, Y: 5})
+	ctx := newMinimaxContext(rules, scoreSettings, time.Now())
+	before := state
+	risky := heuristicForMove(&state, ctx, PlayerBlack, Move{X: 5, Y: 4})
+	safer := heuristicForMove(&state, ctx, PlayerBlack, Move{X: 4, Y: 5})
+	if state.Board != before.Board || state.Hash != before.Hash || state.ToMove != before.ToMove {
+		t.Fatalf("heuristicForMove should leave the state as it found it")
+	}
 
 	if risky >= safer-1000.0 {
 		t.Fatalf("expected risky move to be strongly penalized (risky=%.2f safer=%.2f)", risky, safer)
@@ -396,16 +404,16 @@ func TestCandidateLimitAppliesDeepPlyCaps(t *testing.T) {
 	cfg.AiMaxCandidatesPly9 = 8
 	ctx := minimaxContext{settings: AIScoreSettings{Config: cfg}}
 
-	if got := candidateLimit(ctx, 10, 6, false); got != 24 {
+	if got := candidateLimit(&ctx, 10, 6, false); got != 24 {
 		t.Fatalf("expected hard cap for ply <= 6, got %d", got)
 	}
-	if got := candidateLimit(ctx, 10, 7, false); got != 16 {
+	if got := candidateLimit(&ctx, 10, 7, false); got != 16 {
 		t.Fatalf("expected ply-7 cap to apply, got %d", got)
 	}
-	if got := candidateLimit(ctx, 10, 8, false); got != 12 {
+	if got := candidateLimit(&ctx, 10, 8, false); got != 12 {
 		t.Fatalf("expected ply-8 cap to apply, got %d", got)
 	}
-	if got := candidateLimit(ctx, 10, 9, false); got != 8 {
+	if got := candidateLimit(&ctx, 10, 9, false); got != 8 {
 		t.Fatalf("expected ply-9 cap to apply, got %d", got)
 	}
 }
@@ -418,7 +426,7 @@ func TestCandidateLimitAllowsTacticalLimitToTightenHardCap(t *testing.T) {
 	cfg.AiKTactDeep = 6
 	ctx := minimaxContext{settings: AIScoreSettings{Config: cfg}}
 
-	if got := candidateLimit(ctx, 10, 9, true); got != 6 {
+	if got := candidateLimit(&ctx, 10, 9, true); got != 6 {
 		t.Fatalf("expected tactical limit to tighten hard cap, got %d", got)
 	}
 }
@@ -430,7 +438,7 @@ func TestCandidateLimitKeepsLegacyPathWhenHardCapsDisabled(t *testing.T) {
 	cfg.AiTopCandidates = 6
 	ctx := minimaxContext{settings: AIScoreSettings{Config: cfg}}
 
-	if got := candidateLimit(ctx, 10, 9, false); got != 6 {
+	if got := candidateLimit(&ctx, 10, 9, false); got != 6 {
 		t.Fatalf("expected legacy candidate limit when hard caps disabled, got %d", got)
 	}
 }
@@ -524,8 +532,8 @@ func TestScoreBoardUsesRootTTExactShortcut(t *testing.T) {
 		t.Fatalf("expected TT to be initialized")
 	}
 	best := Move{X: 4, Y: 3}
-	rootKey := ttKeyFor(state, settings.BoardSize)
-	tt.Store(rootKey, heuristicHashFromConfig(cfg), 10, 1234, TTExact, best, TTMeta{})
+	rootKey := tt.KeyFor(&state, settings.BoardSize)
+	tt.StoreState(&state, rootKey, heuristicHashFromConfig(cfg), 10, 1234, TTExact, best, TTMeta{})
 
 	stats := &SearchStats{}
 	scores := ScoreBoard(state, rules, AIScoreSettings{
@@ -635,3 +643,292 @@ func TestScoreBoardUsesRootTransposeShortcutAcrossTranslation(t *testing.T) {
 		t.Fatalf("expected translated best move (%d,%d), got (%d,%d)", bestBase.X+dx, bestBase.Y+dy, bestTranslated.X, bestTranslated.Y)
 	}
 }
+
+func TestScoreBoardDirectDepthParallelLazySMPReportsHelperStats(t *testing.T) {
+	prev := GetConfig()
+	cfg := prev
+	cfg.AiDepth = 2
+	cfg.AiMinDepth = 2
+	cfg.AiMaxDepth = 2
+	cfg.AiQuickWinExit = false
+	cfg.AiEnableEvalCache = false
+	cfg.AiEnableAspiration = false
+	cfg.AiEnableKillerMoves = false
+	cfg.AiEnableHistoryMoves = false
+	cfg.AiTimeBudgetMs = 0
+	cfg.AiSearchParallelMode = searchParallelLazySMP
+	configStore.Update(cfg)
+	defer func() {
+		configStore.Update(prev)
+		FlushGlobalCaches()
+	}()
+
+	settings := DefaultGameSettings()
+	settings.BoardSize = 7
+	rules := NewRules(settings)
+	state := DefaultGameState(settings)
+	state.Status = StatusRunning
+	state.ToMove = PlayerBlack
+	state.Board.Set(3, 3, CellBlack)
+	state.Board.Set(2, 3, CellWhite)
+	state.recomputeHashes()
+
+	lazyCache := newAISearchCache()
+	lazyStats := &SearchStats{}
+	lazyScores, completed := ScoreBoardDirectDepthParallel(state, rules, AIScoreSettings{
+		Depth:           2,
+		BoardSize:       settings.BoardSize,
+		Player:          state.ToMove,
+		Cache:           &lazyCache,
+		Config:          cfg,
+		Stats:           lazyStats,
+		DirectDepthOnly: true,
+	}, 4)
+	if !completed {
+		t.Fatalf("expected lazy SMP search to complete")
+	}
+	if lazyStats.HelperThreads != 3 {
+		t.Fatalf("expected stats from 3 helpers, got %d", lazyStats.HelperThreads)
+	}
+	if _, ok := bestMoveFromScores(lazyScores, state, rules, settings.BoardSize); !ok {
+		t.Fatalf("expected lazy SMP search to return a move")
+	}
+}
+
+func minimaxAllocFixture(boardSize int) (GameState, Rules, *minimaxContext, *AISearchCache, Config) {
+	cfg := GetConfig()
+	cfg.AiQuickWinExit = false
+	cfg.AiTimeBudgetMs = 0
+	settings := DefaultGameSettings()
+	settings.BoardSize = boardSize
+	rules := NewRules(settings)
+	state := DefaultGameState(settings)
+	state.Status = StatusRunning
+	state.ToMove = PlayerBlack
+	c := boardSize / 2
+	state.Board.Set(c, c, CellBlack)
+	state.Board.Set(c+1, c, CellWhite)
+	state.Board.Set(c, c+1, CellBlack)
+	state.Board.Set(c+1, c+1, CellWhite)
+	state.Board.Set(c-1, c-1, CellBlack)
+	state.Board.Set(c+2, c+2, CellWhite)
+	state.recomputeHashes()
+	state.refreshEvalTotals()
+	state.refreshFrontier()
+	cache := newAISearchCache()
+	ctx := newMinimaxContext(rules, AIScoreSettings{
+		Depth:           3,
+		BoardSize:       boardSize,
+		Player:          PlayerBlack,
+		Cache:           &cache,
+		Config:          cfg,
+		Stats:           &SearchStats{},
+		DirectDepthOnly: true,
+	}, time.Now())
+	return state, rules, ctx, &cache, cfg
+}
+
+func TestMinimaxNodeExpansionDoesNotAllocate(t *testing.T) {
+	state, _, ctx, cache, cfg := minimaxAllocFixture(9)
+	allocs := testing.AllocsPerRun(5, func() {
+		ensureTT(cache, cfg).Clear()
+		minimax(&state, ctx, 2, PlayerBlack, 3, math.Inf(-1), math.Inf(1))
+	})
+	if allocs != 0 {
+		t.Fatalf("expected allocation-free search after warm-up, got %.1f allocs per search", allocs)
+	}
+}
+
+func TestGameStateCloneDoesNotAllocate(t *testing.T) {
+	state, _, _, _, _ := minimaxAllocFixture(9)
+	state.MustCapture = true
+	state.ForcedCaptureMoves = []Move{{X: 1, Y: 1}}
+	state.WinningLine = []Move{{X: 2, Y: 2}}
+	var clone GameState
+	if allocs := testing.AllocsPerRun(10, func() { clone = state.Clone() }); allocs != 0 {
+		t.Fatalf("expected Clone to be a plain copy, got %.1f allocs", allocs)
+	}
+	clone.Board.Set(0, 0, CellWhite)
+	clone.ForcedCaptureMoves = nil
+	if state.Board.At(0, 0) != CellEmpty || len(state.ForcedCaptureMoves) != 1 {
+		t.Fatalf("writes to a clone leaked into the original")
+	}
+}
+
+func BenchmarkMinimaxNodeAllocs(b *testing.B) {
+	state, _, ctx, cache, cfg := minimaxAllocFixture(15)
+	minimax(&state, ctx, 3, PlayerBlack, 3, math.Inf(-1), math.Inf(1))
+	stats := ctx.settings.Stats
+	startNodes := stats.Nodes
+	b.ReportAllocs()
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		ensureTT(cache, cfg).Clear()
+		minimax(&state, ctx, 3, PlayerBlack, 3, math.Inf(-1), math.Inf(1))
+	}
+	b.StopTimer()
+	if nodes := stats.Nodes - startNodes; nodes > 0 {
+		b.ReportMetric(float64(nodes)/float64(b.N), "nodes/op")
+	}
+}
+
+func TestPVSMatchesFullWindowSearch(t *testing.T) {
+	const depth = 4
+	corpus, rules := loadBenchCorpus(t)
+	search := func(state GameState, pvs bool) (Move, float64, *SearchStats) {
+		cfg := benchConfig()
+		cfg.AiMaxDepth = depth
+		cfg.AiEnableThreatSolver = false
+		cfg.AiEnablePVS = pvs
+		// Killers, history and the caches make the tree depend on the order
+		// moves were searched in; without them both searches see the same
+		// tree and must agree on the root value.
+		cfg.AiEnableKillerMoves = false
+		cfg.AiEnableHistoryMoves = false
+		cfg.AiTtSize = 0
+		cfg.AiTtMaxEntries = 0
+		cfg.AiEnableEvalCache = false
+		cfg.AiEnableRootTranspose = false
+		cache := newAISearchCache()
+		stats := &SearchStats{}
+		scores := ScoreBoard(state, rules, AIScoreSettings{
+			Depth:            depth,
+			BoardSize:        state.Board.Size(),
+			Player:           state.ToMove,
+			Cache:            &cache,
+			Config:           cfg,
+			Stats:            stats,
+			DirectDepthOnly:  true,
+			SkipQueueBacklog: true,
+		})
+		move, ok := bestMoveFromScores(scores, state, rules, state.Board.Size())
+		if !ok {
+			t.Fatalf("expected a legal best move")
+		}
+		return move, scoreForMove(scores, move, state.Board.Size()), stats
+	}
+	var nullWindows int64
+	for _, pos := range corpus {
+		_, fullScore, fullStats := search(pos.state.Clone(), false)
+		pvsMove, pvsScore, pvsStats := search(pos.state.Clone(), true)
+		if math.Abs(pvsScore-fullScore) > 1e-6*math.Max(1, math.Abs(fullScore)) {
+			t.Fatalf("%s: PVS best %v scored %g, full window scored %g", pos.name, pvsMove, pvsScore, fullScore)
+		}
+		if fullStats.PVSNullWindows != 0 {
+			t.Fatalf("%s: full-window search ran %d null-window searches", pos.name, fullStats.PVSNullWindows)
+		}
+		if pvsStats.PVSResearches > pvsStats.PVSNullWindows {
+			t.Fatalf("%s: %d re-searches for %d null windows", pos.name, pvsStats.PVSResearches, pvsStats.PVSNullWindows)
+		}
+		nullWindows += pvsStats.PVSNullWindows
+	}
+	if nullWindows == 0 {
+		t.Fatalf("expected PVS to search some moves with a null window")
+	}
+}
+
+func TestRootTransposeSharesEntryAcrossSymmetries(t *testing.T) {
+	settings := DefaultGameSettings()
+	size := settings.BoardSize
+	rules := NewRules(settings)
+	stones := []struct {
+		x, y int
+		cell Cell
+	}{{8, 8, CellBlack}, {9, 8, CellWhite}, {8, 10, CellBlack}, {11, 9, CellWhite}}
+	build := func(transform symmetryTransform) GameState {
+		state := DefaultGameState(settings)
+		state.Status = StatusRunning
+		state.ToMove = PlayerBlack
+		for _, stone := range stones {
+			x, y := transformCoord(stone.x, stone.y, size, transform)
+			state.Board.Set(x, y, stone.cell)
+		}
+		state.recomputeHashes()
+		return state
+	}
+	for _, symmetric := range []bool{true, false} {
+		cfg := DefaultConfig()
+		cfg.AiTtSymmetry = symmetric
+		cache := newAISearchCache()
+		scoreSettings := AIScoreSettings{Depth: 6, BoardSize: size, Player: PlayerBlack, Config: cfg}
+		base := build(symmetryTransforms[0])
+		footprint := newSearchFootprint(base, size)
+		footprint.ObserveMove(Move{X: 12, Y: 7})
+		best := Move{X: 10, Y: 10}
+		storeRootTransposeExact(base, scoreSettings, &cache, 6, 321, best, buildTTMeta(base, size, footprint))
+		for i, transform := range symmetryTransforms {
+			state := build(transform)
+			scores, ok := scoreBoardFromRootTranspose(state, rules, scoreSettings, &cache)
+			if !symmetric {
+				if i == 1 && ok {
+					t.Fatalf("expected a rotated shape to miss without symmetry folding")
+				}
+				continue
+			}
+			wantX, wantY := transformCoord(best.X, best.Y, size, transform)
+			if !ok || scores[wantY*size+wantX] != 321 {
+				t.Fatalf("transform %d: expected root transpose hit at (%d,%d), ok=%v", i, wantX, wantY, ok)
+			}
+		}
+	}
+}
+
+func TestEvalCacheReportsCollisionsAndNeverMixesEntries(t *testing.T) {
+	ec := NewEvalCache(1, 2)
+	if ec.Put(1, 1.5) || ec.Put(3, 3.5) {
+		t.Fatalf("stores into empty slots reported a collision")
+	}
+	if ec.Put(1, -1.5) {
+		t.Fatalf("overwriting a key's own slot reported a collision")
+	}
+	if v, ok := ec.Get(1); !ok || v != -1.5 {
+		t.Fatalf("Get(1) = %v, %v; want -1.5", v, ok)
+	}
+	if !ec.Put(5, 5.5) {
+		t.Fatalf("store into a full bucket did not report a collision")
+	}
+	if _, ok := ec.Get(0); ok {
+		t.Fatalf("key 0 hit an empty slot")
+	}
+
+	// Writers racing on one bucket may evict each other but a hit must
+	// always return the value stored under that key.
+	ec = NewEvalCache(1, 2)
+	var wg sync.WaitGroup
+	var bad atomic.Int64
+	for w := 0; w < 4; w++ {
+		wg.Add(1)
+		go func(w int) {
+			defer wg.Done()
+			for i := 0; i < 20000; i++ {
+				key := uint64(1 + (i+w)%7)
+				ec.Put(key, float64(key)*10)
+				if v, ok := ec.Get(uint64(1 + (i*3+w)%7)); ok && v != float64(uint64(1+(i*3+w)%7))*10 {
+					bad.Add(1)
+				}
+			}
+		}(w)
+	}
+	wg.Wait()
+	if bad.Load() != 0 {
+		t.Fatalf("%d reads returned another key's value", bad.Load())
+	}
+}
+
+func TestRootTransposeCachePutReportsEviction(t *testing.T) {
+	rtc := NewRootTransposeCache(1, 2)
+	for _, key := range []uint64{1, 2} {
+		if rtc.Put(key, 2, 10, TTExact, Move{}, TTMeta{}) {
+			t.Fatalf("Put(%d) into a free slot reported an eviction", key)
+		}
+	}
+	if rtc.Put(1, 3, 20, TTExact, Move{}, TTMeta{}) {
+		t.Fatalf("deepening a stored key reported an eviction")
+	}
+	if !rtc.Put(3, 4, 30, TTExact, Move{}, TTMeta{}) {
+		t.Fatalf("Put into a full bucket did not report an eviction")
+	}
+	if entry, ok := rtc.Get(3, 4); !ok || entry.Score != scoreToTT(30) {
+		t.Fatalf("Get(3) = %+v, %v", entry, ok)
+	}
+}
@@ -1,7 +1,6 @@
 package main
 
 import (
-	"encoding/json"
 	"net/http"
 	"sort"
 	"strconv"
@@ -17,6 +16,8 @@ type analiticsQueueEntryDTO struct {
 	CurrentDepth        int     `json:"current_depth"`
 	TargetDepth         int     `json:"target_depth"`
 	Hits                int     `json:"hits"`
+	Visits              int     `json:"visits"`
+	ExpectedReuse       float64 `json:"expected_reuse"`
 	Analyzing           bool    `json:"analyzing"`
 	AnalysisStartedAtMs int64   `json:"analysis_started_at_ms"`
 }
@@ -30,16 +31,30 @@ type analiticsPayload struct {
 	Event        string                    `json:"event"`
 	Entry        *analiticsQueueEventEntry `json:"entry,omitempty"`
 	TotalInQueue int                       `json:"total_in_queue"`
+	Uplift       analiticsUplift           `json:"uplift"`
 	UpdatedAt    int64                     `json:"updated_at_ms"`
 }
 
+// analiticsUplift measures what the backlog bought: the share of positions
+// reached in real games that an earlier backlog analysis had deepened, and
+// that share per hour of backlog board time.
+type analiticsUplift struct {
+	LivePositions  int64   `json:"live_positions"`
+	BacklogHits    int64   `json:"backlog_hits"`
+	HitRate        float64 `json:"hit_rate"`
+	BacklogHours   float64 `json:"backlog_hours"`
+	HitRatePerHour float64 `json:"hit_rate_per_backlog_hour"`
+}
+
 type analiticsQueueEventEntry struct {
-	ID                  string `json:"id"`
-	CurrentDepth        int    `json:"current_depth"`
-	TargetDepth         int    `json:"target_depth"`
-	Hits                int    `json:"hits"`
-	Analyzing           bool   `json:"analyzing"`
-	AnalysisStartedAtMs int64  `json:"analysis_started_at_ms"`
+	ID                  string  `json:"id"`
+	CurrentDepth        int     `json:"current_depth"`
+	TargetDepth         int     `json:"target_depth"`
+	Hits                int     `json:"hits"`
+	Visits              int     `json:"visits"`
+	ExpectedReuse       float64 `json:"expected_reuse"`
+	Analyzing           bool    `json:"analyzing"`
+	AnalysisStartedAtMs int64   `json:"analysis_started_at_ms"`
 }
 
 type backlogAnalyticsEntry struct {
@@ -48,8 +63,11 @@ type backlogAnalyticsEntry struct {
 	Stones              int
 	Created             time.Time
 	Hits                int
+	Visits              int
 	CurrentDepth        int
 	TargetDepth         int
+	BacklogDepth        int
+	Reuse               float64
 	Analyzing           bool
 	AnalysisStartedAtMs int64
 }
@@ -84,8 +102,14 @@ func (h *AnaliticsHub) Run(done <-chan struct{}) {
 				h.mu.Unlock()
 				continue
 			}
+			h.mu.Unlock()
+			frame := encodeWSFrame("analitics", payload)
+			if frame == nil {
+				continue
+			}
+			h.mu.Lock()
 			for client := range h.clients {
-				client.sendJSON(wsMessage{Type: "analitics", Payload: mustMarshal(payload)})
+				client.sendFrame(frame)
 			}
 			h.mu.Unlock()
 		}
@@ -114,14 +138,12 @@ func (h *AnaliticsHub) Unregister(c *AnaliticsClient) {
 	h.mu.Unlock()
 }
 
-func (c *AnaliticsClient) sendJSON(msg wsMessage) {
-	data, err := json.Marshal(msg)
-	if err != nil {
-		return
-	}
+func (c *AnaliticsClient) sendFrame(frame []byte) bool {
 	select {
-	case c.send <- data:
+	case c.send <- frame:
+		return true
 	default:
+		return false
 	}
 }
 
@@ -137,9 +159,10 @@ func serveAnaliticsWS(hub *AnaliticsHub, w http.ResponseWriter, r *http.Request)
 	initial := analiticsPayload{
 		Event:        "snapshot",
 		TotalInQueue: searchBacklogManager.TotalAnaliticsQueue(),
+		Uplift:       searchBacklogManager.AnaliticsUplift(),
 		UpdatedAt:    time.Now().UnixMilli(),
 	}
-	client.sendJSON(wsMessage{Type: "analitics", Payload: mustMarshal(initial)})
+	client.sendFrame(encodeWSFrame("analitics", initial))
 
 	go func() {
 		defer conn.Close()
@@ -180,6 +203,8 @@ func analiticsEntryToDTO(entry backlogAnalyticsEntry) analiticsQueueEntryDTO {
 		CurrentDepth:        entry.CurrentDepth,
 		TargetDepth:         entry.TargetDepth,
 		Hits:                entry.Hits,
+		Visits:              entry.Visits,
+		ExpectedReuse:       entry.Reuse,
 		Analyzing:           entry.Analyzing,
 		AnalysisStartedAtMs: entry.AnalysisStartedAtMs,
 	}
@@ -191,6 +216,8 @@ func analiticsEntryToEventEntry(entry backlogAnalyticsEntry) analiticsQueueEvent
 		CurrentDepth:        entry.CurrentDepth,
 		TargetDepth:         entry.TargetDepth,
 		Hits:                entry.Hits,
+		Visits:              entry.Visits,
+		ExpectedReuse:       entry.Reuse,
 		Analyzing:           entry.Analyzing,
 		AnalysisStartedAtMs: entry.AnalysisStartedAtMs,
 	}
@@ -202,7 +229,15 @@ func sortAnaliticsQueue(entries []backlogAnalyticsEntry) {
 	})
 }
 
+// compareAnaliticsPriority puts the higher expected reuse first and breaks
+// ties by hits, stones, remaining depth and age.
 func compareAnaliticsPriority(a, b backlogAnalyticsEntry) int {
+	if a.Reuse != b.Reuse {
+		if a.Reuse > b.Reuse {
+			return -1
+		}
+		return 1
+	}
 	if a.Hits != b.Hits {
 		if a.Hits > b.Hits {
 			return -1
@@ -246,6 +281,21 @@ func analiticsRemainingDepth(entry backlogAnalyticsEntry) int {
 	return remaining
 }
 
+// backlogProximityStones is the stone distance from the live position at
+// which a board's expected reuse halves.
+const backlogProximityStones = 4
+
+// backlogExpectedReuse estimates the future TT hits analyzing entry buys: how
+// often games reached it, times the depth it still has to gain, discounted by
+// its distance from live, the live game's board, when there is one.
+func backlogExpectedReuse(entry backlogAnalyticsEntry, live *Board) float64 {
+	reuse := float64(entry.Hits+entry.Visits) * float64(analiticsRemainingDepth(entry))
+	if live != nil {
+		reuse /= 1 + float64(entry.Board.StoneDistance(live))/backlogProximityStones
+	}
+	return reuse
+}
+
 func analiticsTopBoardsLimit() int {
 	limit := GetConfig().AiAnaliticsTopBoards
 	if limit <= 0 {
@@ -0,0 +1,346 @@
+package main
+
+import (
+	"context"
+	"encoding/json"
+	"errors"
+	"fmt"
+	"net/http"
+	"runtime"
+	"sync"
+	"time"
+
+	"github.com/gorilla/websocket"
+)
+
+// analysisPosition is one position of an analyze batch. It is given either as
+// a board, rows of 0 (empty), 1 (black) and 2 (white) with the side to move
+// and capture counts, or as moves played from the empty default board. Zero
+// limits fall back to the request's, then to the config's; depth is capped
+// at AiDepth.
+type analysisPosition struct {
+	ID            string           `json:"id"`
+	Board         [][]int          `json:"board"`
+	NextPlayer    int              `json:"next_player"`
+	CapturedBlack int              `json:"captured_black"`
+	CapturedWhite int              `json:"captured_white"`
+	Moves         []Move           `json:"moves"`
+	Depth         int              `json:"depth"`
+	TimeMs        int              `json:"time_ms"`
+	Heuristics    *HeuristicConfig `json:"heuristics"`
+}
+
+const (
+	// analysisMaxPositions caps the positions of one analyze batch.
+	analysisMaxPositions = 64
+	// analysisMaxSocketBatches caps the batches one /ws/analyze socket runs
+	// at a time.
+	analysisMaxSocketBatches = 4
+)
+
+// analysisSlots bounds the positions searched at once across every analyze
+// request, HTTP or WebSocket.
+var analysisSlots = make(chan struct{}, runtime.GOMAXPROCS(0))
+
+type analysisRequest struct {
+	ID        string             `json:"id"`
+	Positions []analysisPosition `json:"positions"`
+	Depth     int                `json:"depth"`
+	TimeMs    int                `json:"time_ms"`
+	Workers   int                `json:"workers"`
+}
+
+// analysisEvent is one streamed line: "depth" after each completed depth,
+// "result" or "error" once per position, and "done", with the position count
+// in Index, when the batch ends.
+// Scores are Black-positive and null on cells that were not searched; the PV
+// starts with the TT's best move, which can differ from BestMove when the
+// search stopped mid-depth.
+type analysisEvent struct {
+	Event      string       `json:"event"`
+	Batch      string       `json:"batch,omitempty"`
+	Index      int          `json:"index"`
+	ID         string       `json:"id,omitempty"`
+	Depth      int          `json:"depth,omitempty"`
+	BestMove   *Move        `json:"best_move,omitempty"`
+	Score      *float64     `json:"score,omitempty"`
+	Scores     [][]*float64 `json:"scores,omitempty"`
+	PV         []Move       `json:"pv,omitempty"`
+	Nodes      int64        `json:"nodes,omitempty"`
+	DurationMs int64        `json:"duration_ms,omitempty"`
+	Error      string       `json:"error,omitempty"`
+}
+
+func validateAnalysisRequest(req analysisRequest) error {
+	if len(req.Positions) == 0 {
+		return errors.New("no positions")
+	}
+	if len(req.Positions) > analysisMaxPositions {
+		return fmt.Errorf("%d positions, at most %d per batch", len(req.Positions), analysisMaxPositions)
+	}
+	return nil
+}
+
+// runAnalysisBatch searches req's positions concurrently against the shared
+// TT and hands their events to emit, one goroutine at a time. Positions run on
+// req.Workers goroutines of their own, so backlog work never holds them up,
+// and each search takes one of the analysisSlots shared by all batches.
+// Nothing is queued for the backlog. Cancelling ctx stops the running searches
+// and skips the rest.
+func runAnalysisBatch(ctx context.Context, req analysisRequest, emit func(analysisEvent)) {
+	var emitMu sync.Mutex
+	send := func(event analysisEvent) {
+		event.Batch = req.ID
+		emitMu.Lock()
+		emit(event)
+		emitMu.Unlock()
+	}
+	var wg sync.WaitGroup
+	wg.Add(len(req.Positions))
+	run := func(i int) {
+		defer wg.Done()
+		select {
+		case analysisSlots <- struct{}{}:
+		case <-ctx.Done():
+			return
+		}
+		defer func() { <-analysisSlots }()
+		if ctx.Err() == nil {
+			analyzePosition(ctx, req, i, send)
+		}
+	}
+	next := make(chan int)
+	for w := 0; w < min(matchWorkers(req.Workers, len(req.Positions)), runtime.GOMAXPROCS(0)); w++ {
+		go func() {
+			for i := range next {
+				run(i)
+			}
+		}()
+	}
+	for i := range req.Positions {
+		next <- i
+	}
+	close(next)
+	wg.Wait()
+	send(analysisEvent{Event: "done", Index: len(req.Positions)})
+}
+
+func analyzePosition(ctx context.Context, req analysisRequest, index int, send func(analysisEvent)) {
+	pos := req.Positions[index]
+	start := time.Now()
+	state, rules, err := analysisState(pos)
+	if err != nil {
+		send(analysisEvent{Event: "error", Index: index, ID: pos.ID, Error: err.Error()})
+		return
+	}
+	config := GetConfig()
+	if pos.Heuristics != nil {
+		config.Heuristics = *pos.Heuristics
+	}
+	config.AiTimeBudgetMs = firstPositive(pos.TimeMs, req.TimeMs, config.AiTimeBudgetMs)
+	config.AiMaxDepth = min(firstPositive(pos.Depth, req.Depth, config.AiDepth), max(config.AiDepth, 1))
+	config.AiMinDepth = min(config.AiMinDepth, config.AiMaxDepth)
+	size := state.Board.Size()
+	cache := SharedSearchCache()
+	stats := &SearchStats{Start: start}
+	settings := AIScoreSettings{
+		Depth:            config.AiMaxDepth,
+		BoardSize:        size,
+		Player:           state.ToMove,
+		Cache:            cache,
+		Config:           config,
+		TimeoutMs:        config.AiTimeoutMs,
+		Profile:          newSearchProfile(config),
+		Stats:            stats,
+		ShouldStop:       func() bool { return ctx.Err() != nil },
+		SkipQueueBacklog: true,
+		TraceLabel:       "analyze",
+	}
+	tt := ensureTT(cache, config)
+	event := func(kind string, depth int, scores []float64) analysisEvent {
+		e := analysisEvent{Event: kind, Index: index, ID: pos.ID, Depth: depth, Scores: analysisGrid(scores, size)}
+		if move, ok := bestMoveFromScores(scores, state, rules, size); ok {
+			e.BestMove = &move
+			if score := scores[move.Y*size+move.X]; score != illegalScore {
+				e.Score = &score
+			}
+		}
+		if tt != nil {
+			e.PV = principalVariation(state, rules, tt, size, settings.Profile.heuristicHash, max(depth, 1))
+		}
+		return e
+	}
+	settings.OnDepthScores = func(depth int, scores []float64) {
+		send(event("depth", depth, scores))
+	}
+	scores := ScoreBoard(state.Clone(), rules, settings)
+	recordSearchMetrics("analyze", stats)
+	if config.AiLogSearchStats {
+		logSearchStats("analyze", stats, settings)
+	}
+	result := event("result", stats.CompletedDepths, scores)
+	result.Nodes = stats.Nodes
+	result.DurationMs = time.Since(start).Milliseconds()
+	send(result)
+}
+
+// analysisState builds the position to search and its rules. A board is
+// checked like a game position: the side to move is 1 or 2, capture counts
+// are short of the capture goal, and no five stands unless the side to move
+// can break it by capture, which it then must, as in the game.
+func analysisState(pos analysisPosition) (GameState, Rules, error) {
+	settings := DefaultGameSettings()
+	if len(pos.Board) == 0 {
+		g := Game{headless: true}
+		settings.BlackType = PlayerHuman
+		settings.WhiteType = PlayerHuman
+		g.Reset(settings)
+		g.Start()
+		for _, move := range pos.Moves {
+			if ok, reason := g.TryApplyMove(move); !ok {
+				return GameState{}, Rules{}, fmt.Errorf("move (%d,%d): %s", move.X, move.Y, reason)
+			}
+		}
+		if g.state.Status != StatusRunning {
+			return GameState{}, Rules{}, errors.New("game is over: " + statusToString(g.state.Status))
+		}
+		return g.State(), g.rules, nil
+	}
+	size := len(pos.Board)
+	if size < settings.WinLength || size > maxBoardSize {
+		return GameState{}, Rules{}, fmt.Errorf("board size %d out of range", size)
+	}
+	settings.BoardSize = size
+	state := DefaultGameState(settings)
+	state.Status = StatusRunning
+	for y, row := range pos.Board {
+		if len(row) != size {
+			return GameState{}, Rules{}, fmt.Errorf("row %d has %d cells, want %d", y, len(row), size)
+		}
+		for x, value := range row {
+			if value < 0 || value > 2 {
+				return GameState{}, Rules{}, fmt.Errorf("cell (%d,%d) is %d, want 0, 1 or 2", x, y, value)
+			}
+			if value != 0 {
+				state.Board.Set(x, y, intToCell(value))
+			}
+		}
+	}
+	if pos.NextPlayer != 1 && pos.NextPlayer != 2 {
+		return GameState{}, Rules{}, fmt.Errorf("next_player is %d, want 1 or 2", pos.NextPlayer)
+	}
+	for _, count := range []int{pos.CapturedBlack, pos.CapturedWhite} {
+		if count < 0 || count >= settings.CaptureWinStones {
+			return GameState{}, Rules{}, fmt.Errorf("capture count %d out of range [0,%d)", count, settings.CaptureWinStones)
+		}
+	}
+	state.ToMove = intToPlayer(pos.NextPlayer)
+	state.CapturedBlack = pos.CapturedBlack
+	state.CapturedWhite = pos.CapturedWhite
+	rules := NewRules(settings)
+	mover := otherPlayer(state.ToMove)
+	if rules.hasAnyAlignment(state.Board, CellFromPlayer(state.ToMove)) {
+		return GameState{}, Rules{}, errors.New("game is over: the side to move already has five in a row")
+	}
+	if rules.hasAnyAlignment(state.Board, CellFromPlayer(mover)) {
+		forced := rules.FindAlignmentBreakCaptures(state, state.ToMove)
+		if len(forced) == 0 {
+			return GameState{}, Rules{}, errors.New("game is over: five in a row cannot be broken by capture")
+		}
+		state.MustCapture = true
+		state.ForcedCaptureMoves = forced
+	}
+	state.recomputeHashes()
+	return state, rules, nil
+}
+
+func analysisGrid(scores []float64, size int) [][]*float64 {
+	if len(scores) < size*size {
+		return nil
+	}
+	grid := make([][]*float64, size)
+	for y := range grid {
+		grid[y] = make([]*float64, size)
+		for x := range grid[y] {
+			if score := scores[y*size+x]; score != illegalScore {
+				grid[y][x] = &score
+			}
+		}
+	}
+	return grid
+}
+
+func firstPositive(values ...int) int {
+	for _, v := range values {
+		if v > 0 {
+			return v
+		}
+	}
+	return 0
+}
+
+// serveAnalyzeWS runs the batch of each "analyze" message and streams its
+// events as "analysis" frames. Up to analysisMaxSocketBatches batches run side
+// by side and tell their events apart by the request id; more are refused
+// until one finishes. Closing the socket cancels them.
+func serveAnalyzeWS(w http.ResponseWriter, r *http.Request) {
+	upgrader := websocket.Upgrader{CheckOrigin: func(r *http.Request) bool { return true }}
+	conn, err := upgrader.Upgrade(w, r, nil)
+	if err != nil {
+		return
+	}
+	ctx, cancel := context.WithCancel(context.Background())
+	send := make(chan []byte, 64)
+	go func() {
+		defer conn.Close()
+		if err := writeWSWithHeartbeat(conn, send); err != nil {
+			cancel()
+		}
+	}()
+	emit := func(event analysisEvent) {
+		select {
+		case send <- encodeWSFrame("analysis", event):
+		case <-ctx.Done():
+		}
+	}
+	var batches sync.WaitGroup
+	inFlight := make(chan struct{}, analysisMaxSocketBatches)
+	defer func() {
+		cancel()
+		batches.Wait()
+		close(send)
+	}()
+	for {
+		_, message, err := conn.ReadMessage()
+		if err != nil {
+			return
+		}
+		var msg wsMessage
+		if err := json.Unmarshal(message, &msg); err != nil || msg.Type != "analyze" {
+			continue
+		}
+		var req analysisRequest
+		if err := json.Unmarshal(msg.Payload, &req); err != nil {
+			emit(analysisEvent{Event: "error", Batch: req.ID, Error: "invalid payload"})
+			continue
+		}
+		if err := validateAnalysisRequest(req); err != nil {
+			emit(analysisEvent{Event: "error", Batch: req.ID, Error: err.Error()})
+			continue
+		}
+		select {
+		case inFlight <- struct{}{}:
+		default:
+			emit(analysisEvent{Event: "error", Batch: req.ID, Error: fmt.Sprintf("%d batches already running on this socket", analysisMaxSocketBatches)})
+			continue
+		}
+		batches.Add(1)
+		go func() {
+			defer func() {
+				<-inFlight
+				batches.Done()
+			}()
+			runAnalysisBatch(ctx, req, emit)
+		}()
+	}
+}
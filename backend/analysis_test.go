@@ -0,0 +1,136 @@
+package main
+
+import (
+	"context"
+	"testing"
+)
+
+func TestRunAnalysisBatchStreamsDepthsAndResults(t *testing.T) {
+	prev := GetConfig()
+	cfg := benchConfig()
+	cfg.AiMinDepth = 1
+	cfg.AiDepth = 3
+	cfg.AiEnableBook = false
+	configStore.Update(cfg)
+	FlushGlobalCaches()
+	defer func() {
+		configStore.Update(prev)
+		FlushGlobalCaches()
+	}()
+
+	board := make([][]int, 15)
+	for y := range board {
+		board[y] = make([]int, 15)
+	}
+	board[7][7], board[7][8], board[6][6] = 1, 2, 1
+	req := analysisRequest{
+		ID:    "review",
+		Depth: 2,
+		Positions: []analysisPosition{
+			{ID: "moves", Moves: []Move{{X: 9, Y: 9}, {X: 10, Y: 9}, {X: 9, Y: 10}}},
+			{ID: "board", Board: board, NextPlayer: 2, Depth: 9}, // capped at AiDepth
+			{ID: "bad", Moves: []Move{{X: 9, Y: 9}, {X: 9, Y: 9}}},
+		},
+	}
+	depths := map[string][]int{}
+	results := map[string]analysisEvent{}
+	done := 0
+	runAnalysisBatch(context.Background(), req, func(event analysisEvent) {
+		if event.Batch != req.ID {
+			t.Errorf("event for batch %q, want %q", event.Batch, req.ID)
+		}
+		switch event.Event {
+		case "depth":
+			depths[event.ID] = append(depths[event.ID], event.Depth)
+		case "result", "error":
+			if event.Index < 0 || event.Index >= len(req.Positions) || req.Positions[event.Index].ID != event.ID {
+				t.Errorf("%s: index %d", event.ID, event.Index)
+			}
+			results[event.ID] = event
+		case "done":
+			done++
+		}
+	})
+	if done != 1 || len(results) != len(req.Positions) {
+		t.Fatalf("done=%d results=%d", done, len(results))
+	}
+	if bad := results["bad"]; bad.Event != "error" || bad.Error == "" {
+		t.Fatalf("illegal moves should fail: %+v", bad)
+	}
+	for id, want := range map[string]int{"moves": 2, "board": 3} {
+		result := results[id]
+		if result.Event != "result" || result.Depth != want || result.BestMove == nil || result.Score == nil {
+			t.Fatalf("%s: %+v", id, result)
+		}
+		if got := depths[id]; len(got) != want || got[len(got)-1] != want {
+			t.Fatalf("%s: depth events %v, want 1..%d", id, got, want)
+		}
+		size := len(result.Scores)
+		if best := result.BestMove; result.Scores[best.Y][best.X] == nil || *result.Scores[best.Y][best.X] != *result.Score {
+			t.Fatalf("%s: best move %v is not scored in the grid", id, best)
+		}
+		if len(result.PV) == 0 || !result.PV[0].IsValid(size) {
+			t.Fatalf("%s: no PV", id)
+		}
+	}
+	if grid := results["board"].Scores; len(grid) != 15 || grid[7][7] != nil {
+		t.Fatalf("board grid should be 15x15 with occupied cells unscored")
+	}
+}
+
+func TestValidateAnalysisRequestCapsBatchSize(t *testing.T) {
+	if err := validateAnalysisRequest(analysisRequest{}); err == nil {
+		t.Fatalf("an empty batch should be rejected")
+	}
+	req := analysisRequest{Positions: make([]analysisPosition, analysisMaxPositions)}
+	if err := validateAnalysisRequest(req); err != nil {
+		t.Fatalf("a full batch should pass: %v", err)
+	}
+	req.Positions = append(req.Positions, analysisPosition{})
+	if err := validateAnalysisRequest(req); err == nil {
+		t.Fatalf("a batch over %d positions should be rejected", analysisMaxPositions)
+	}
+}
+
+func TestAnalysisStateChecksBoards(t *testing.T) {
+	board := func(stones map[Move]int) [][]int {
+		rows := make([][]int, 15)
+		for y := range rows {
+			rows[y] = make([]int, 15)
+		}
+		for m, v := range stones {
+			rows[m.Y][m.X] = v
+		}
+		return rows
+	}
+	five := map[Move]int{}
+	for x := 5; x <= 9; x++ {
+		five[Move{X: x, Y: 5}] = 2
+	}
+	breakable := map[Move]int{{X: 7, Y: 6}: 2, {X: 7, Y: 7}: 1}
+	for m, v := range five {
+		breakable[m] = v
+	}
+	quiet := board(map[Move]int{{X: 7, Y: 7}: 1})
+
+	for name, pos := range map[string]analysisPosition{
+		"no side to move":  {Board: quiet},
+		"third player":     {Board: quiet, NextPlayer: 3},
+		"negative capture": {Board: quiet, NextPlayer: 2, CapturedBlack: -2},
+		"capture goal met": {Board: quiet, NextPlayer: 2, CapturedWhite: 10},
+		"mover has five":   {Board: board(five), NextPlayer: 2},
+		"unbreakable five": {Board: board(five), NextPlayer: 1},
+	} {
+		if _, _, err := analysisState(pos); err == nil {
+			t.Fatalf("%s: expected the board to be rejected", name)
+		}
+	}
+
+	state, _, err := analysisState(analysisPosition{Board: board(breakable), NextPlayer: 1, CapturedBlack: 8})
+	if err != nil {
+		t.Fatalf("breakable five: %v", err)
+	}
+	if !state.MustCapture || !containsMove(state.ForcedCaptureMoves, Move{X: 7, Y: 4}) {
+		t.Fatalf("expected the break capture (7,4) to be forced, got must=%v %v", state.MustCapture, state.ForcedCaptureMoves)
+	}
+}
@@ -0,0 +1,281 @@
+package main
+
+import (
+	"bufio"
+	"fmt"
+	"os"
+	"strconv"
+	"strings"
+	"testing"
+	"time"
+)
+
+// Run with: go test -run '^$' -bench . -count 10 | tee new.txt, then compare
+// two runs with benchstat old.txt new.txt.
+
+const (
+	benchCorpusPath  = "testdata/bench_positions.txt"
+	benchSearchDepth = 3
+	benchWorkers     = 4
+)
+
+type benchPosition struct {
+	name     string
+	category string
+	state    GameState
+}
+
+func loadBenchCorpus(tb testing.TB) ([]benchPosition, Rules) {
+	tb.Helper()
+	settings := DefaultGameSettings()
+	rules := NewRules(settings)
+	file, err := os.Open(benchCorpusPath)
+	if err != nil {
+		tb.Fatalf("open corpus: %v", err)
+	}
+	defer file.Close()
+
+	var corpus []benchPosition
+	var current *benchPosition
+	row := 0
+	scanner := bufio.NewScanner(file)
+	for line := 1; scanner.Scan(); line++ {
+		text := strings.TrimSpace(scanner.Text())
+		if strings.HasPrefix(text, "#") || (text == "" && current == nil) {
+			continue
+		}
+		if current == nil {
+			pos, err := parseBenchHeader(text, settings)
+			if err != nil {
+				tb.Fatalf("%s:%d: %v", benchCorpusPath, line, err)
+			}
+			corpus = append(corpus, pos)
+			current = &corpus[len(corpus)-1]
+			row = 0
+			continue
+		}
+		if len(text) != settings.BoardSize {
+			tb.Fatalf("%s:%d: row has %d cells, want %d", benchCorpusPath, line, len(text), settings.BoardSize)
+		}
+		for x, c := range text {
+			switch c {
+			case 'x':
+				current.state.Board.Set(x, row, CellBlack)
+			case 'o':
+				current.state.Board.Set(x, row, CellWhite)
+			case '.':
+			default:
+				tb.Fatalf("%s:%d: unexpected cell %q", benchCorpusPath, line, c)
+			}
+		}
+		row++
+		if row == settings.BoardSize {
+			current.state.recomputeHashes()
+			current = nil
+		}
+	}
+	if err := scanner.Err(); err != nil {
+		tb.Fatalf("read corpus: %v", err)
+	}
+	if current != nil {
+		tb.Fatalf("%s: position %s is missing rows", benchCorpusPath, current.name)
+	}
+	return corpus, rules
+}
+
+func parseBenchHeader(text string, settings GameSettings) (benchPosition, error) {
+	fields := strings.Fields(text)
+	if len(fields) != 6 || fields[0] != "position" {
+		return benchPosition{}, fmt.Errorf("want \"position <name> <category> <to_move> <captured_black> <captured_white>\", got %q", text)
+	}
+	pos := benchPosition{name: fields[1], category: fields[2], state: DefaultGameState(settings)}
+	pos.state.Status = StatusRunning
+	switch fields[3] {
+	case "black":
+		pos.state.ToMove = PlayerBlack
+	case "white":
+		pos.state.ToMove = PlayerWhite
+	default:
+		return benchPosition{}, fmt.Errorf("unknown side to move %q", fields[3])
+	}
+	var err error
+	if pos.state.CapturedBlack, err = strconv.Atoi(fields[4]); err != nil {
+		return benchPosition{}, err
+	}
+	if pos.state.CapturedWhite, err = strconv.Atoi(fields[5]); err != nil {
+		return benchPosition{}, err
+	}
+	return pos, nil
+}
+
+func benchConfig() Config {
+	cfg := DefaultConfig()
+	cfg.AiQueueEnabled = false
+	cfg.AiTimeBudgetMs = 0
+	cfg.AiTimeoutMs = 0
+	cfg.AiMinDepth = 1
+	cfg.AiMaxDepth = benchSearchDepth
+	cfg.AiTtSize = 1 << 16
+	cfg.AiLogSearchStats = false
+	return cfg
+}
+
+func TestBenchCorpusCoversEveryCategory(t *testing.T) {
+	corpus, _ := loadBenchCorpus(t)
+	seen := map[string]int{}
+	for _, pos := range corpus {
+		seen[pos.category]++
+		if !hasStoneWithin(pos.state.Board, pos.state.Board.Size()) {
+			t.Fatalf("position %s has no stones", pos.name)
+		}
+	}
+	for _, category := range []string{"opening", "middlegame", "tactical"} {
+		if seen[category] == 0 {
+			t.Fatalf("corpus has no %s positions", category)
+		}
+	}
+}
+
+func BenchmarkEvaluateBoard(b *testing.B) {
+	corpus, _ := loadBenchCorpus(b)
+	cfg := benchConfig()
+	for _, pos := range corpus {
+		b.Run(pos.name, func(b *testing.B) {
+			b.ReportAllocs()
+			for i := 0; i < b.N; i++ {
+				EvaluateBoard(pos.state.Board, pos.state.ToMove, cfg)
+			}
+		})
+	}
+}
+
+func BenchmarkCollectCandidateMoves(b *testing.B) {
+	corpus, _ := loadBenchCorpus(b)
+	for _, pos := range corpus {
+		state := pos.state
+		state.refreshFrontier()
+		size := state.Board.Size()
+		b.Run(pos.name, func(b *testing.B) {
+			buf := make([]candidateMove, 0, scratchMovesPerPly)
+			b.ReportAllocs()
+			for i := 0; i < b.N; i++ {
+				buf = collectCandidateMovesInto(buf[:0], state, state.ToMove, size)
+			}
+		})
+	}
+}
+
+func BenchmarkApplyUndoMove(b *testing.B) {
+	corpus, rules := loadBenchCorpus(b)
+	for _, pos := range corpus {
+		state := pos.state.Clone()
+		state.refreshEvalTotals()
+		state.refreshFrontier()
+		moves := candidateMovesOnly(collectCandidateMoves(state, state.ToMove, state.Board.Size()))
+		b.Run(pos.name, func(b *testing.B) {
+			var undo searchMoveUndo
+			b.ReportAllocs()
+			for i := 0; i < b.N; i++ {
+				if applyMoveWithUndo(&state, rules, moves[i%len(moves)], state.ToMove, &undo) {
+					undoMoveWithUndo(&state, undo)
+				}
+			}
+		})
+	}
+}
+
+func BenchmarkTTProbeStore(b *testing.B) {
+	for _, lockFree := range []bool{false, true} {
+		name := "striped"
+		if lockFree {
+			name = "lock_free"
+		}
+		b.Run(name, func(b *testing.B) {
+			cfg := benchConfig()
+			cfg.AiTtLockFree = lockFree
+			tt := newConfiguredTT(uint64(cfg.AiTtSize), cfg.AiTtBuckets, cfg)
+			hh := heuristicHashFromConfig(cfg)
+			rng := splitmix64{state: 7}
+			keys := make([]uint64, 1<<14)
+			for i := range keys {
+				keys[i] = rng.next()
+			}
+			b.ReportAllocs()
+			b.ResetTimer()
+			for i := 0; i < b.N; i++ {
+				key := keys[i&(len(keys)-1)]
+				tt.Store(key, hh, i&7+1, float64(i), TTExact, Move{X: i % 19, Y: i / 19 % 19}, TTMeta{})
+				tt.Probe(keys[(i*7)&(len(keys)-1)], hh)
+			}
+		})
+	}
+}
+
+// benchmarkSearch runs one fixed-depth root search per op on a fresh cache, so
+// no iteration is answered by an earlier one's TT.
+func benchmarkSearch(b *testing.B, search func(GameState, Rules, AIScoreSettings)) {
+	corpus, rules := loadBenchCorpus(b)
+	cfg := benchConfig()
+	for _, pos := range corpus {
+		b.Run(pos.name, func(b *testing.B) {
+			var nodes int64
+			var elapsed time.Duration
+			b.ReportAllocs()
+			for i := 0; i < b.N; i++ {
+				b.StopTimer()
+				cache := newAISearchCache()
+				ensureTT(&cache, cfg)
+				ensureEvalCache(&cache, cfg)
+				ensureRootTransposeCache(&cache, cfg)
+				stats := &SearchStats{}
+				settings := AIScoreSettings{
+					Depth:            benchSearchDepth,
+					BoardSize:        pos.state.Board.Size(),
+					Player:           pos.state.ToMove,
+					Cache:            &cache,
+					Config:           cfg,
+					Stats:            stats,
+					DirectDepthOnly:  true,
+					SkipQueueBacklog: true,
+				}
+				state := pos.state.Clone()
+				b.StartTimer()
+				start := time.Now()
+				search(state, rules, settings)
+				elapsed += time.Since(start)
+				nodes += stats.Nodes
+			}
+			if elapsed > 0 {
+				b.ReportMetric(float64(nodes)/elapsed.Seconds(), "nodes/s")
+			}
+			b.ReportMetric(float64(elapsed.Microseconds())/1000/float64(b.N), "ms-to-depth")
+		})
+	}
+}
+
+func BenchmarkScoreBoard(b *testing.B) {
+	benchmarkSearch(b, func(state GameState, rules Rules, settings AIScoreSettings) {
+		ScoreBoard(state, rules, settings)
+	})
+}
+
+func BenchmarkScoreBoardDirectDepthParallel(b *testing.B) {
+	benchmarkSearch(b, func(state GameState, rules Rules, settings AIScoreSettings) {
+		ScoreBoardDirectDepthParallel(state, rules, settings, benchWorkers)
+	})
+}
+
+func BenchmarkThreatSolver(b *testing.B) {
+	corpus, rules := loadBenchCorpus(b)
+	cfg := benchConfig()
+	for _, pos := range corpus {
+		b.Run(pos.name, func(b *testing.B) {
+			var nodes int
+			b.ReportAllocs()
+			for i := 0; i < b.N; i++ {
+				nodes += solveThreatSpace(pos.state, rules, pos.state.ToMove, cfg).Nodes
+			}
+			b.ReportMetric(float64(nodes)/float64(b.N), "nodes/op")
+		})
+	}
+}
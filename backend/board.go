@@ -1,6 +1,9 @@
 package main
 
-import "fmt"
+import (
+	"fmt"
+	"math/bits"
+)
 
 type Cell int
 
@@ -10,9 +13,15 @@ const (
 	CellWhite
 )
 
+// maxBoardSize bounds the bitboard rows; one uint32 per row and color.
+const maxBoardSize = 19
+
+// Board is a per-color bitboard: bit x of black[y]/white[y] marks a stone at
+// (x, y). It is a plain value, so copying or cloning never allocates.
 type Board struct {
 	size  int
-	cells []Cell
+	black [maxBoardSize]uint32
+	white [maxBoardSize]uint32
 }
 
 func NewBoard(boardSize int) Board {
@@ -22,53 +31,173 @@ func NewBoard(boardSize int) Board {
 }
 
 func (b *Board) Reset(boardSize int) {
-	b.size = boardSize
-	b.cells = make([]Cell, boardSize*boardSize)
+	if boardSize > maxBoardSize {
+		panic(fmt.Sprintf("board size %d exceeds maximum %d", boardSize, maxBoardSize))
+	}
+	*b = Board{size: boardSize}
 }
 
-func (b Board) At(x, y int) Cell {
-	return b.cells[b.index(x, y)]
+func (b *Board) At(x, y int) Cell {
+	bit := uint32(1) << uint(x)
+	if b.black[y]&bit != 0 {
+		return CellBlack
+	}
+	if b.white[y]&bit != 0 {
+		return CellWhite
+	}
+	return CellEmpty
 }
 
 func (b *Board) Set(x, y int, value Cell) {
-	b.cells[b.index(x, y)] = value
+	bit := uint32(1) << uint(x)
+	b.black[y] &^= bit
+	b.white[y] &^= bit
+	switch value {
+	case CellBlack:
+		b.black[y] |= bit
+	case CellWhite:
+		b.white[y] |= bit
+	}
 }
 
 func (b *Board) Remove(x, y int) {
-	b.cells[b.index(x, y)] = CellEmpty
+	bit := uint32(1) << uint(x)
+	b.black[y] &^= bit
+	b.white[y] &^= bit
 }
 
-func (b Board) InBounds(x, y int) bool {
+func (b *Board) InBounds(x, y int) bool {
 	return x >= 0 && y >= 0 && x < b.size && y < b.size
 }
 
-func (b Board) IsEmpty(x, y int) bool {
-	return b.InBounds(x, y) && b.At(x, y) == CellEmpty
+func (b *Board) IsEmpty(x, y int) bool {
+	return b.InBounds(x, y) && (b.black[y]|b.white[y])&(uint32(1)<<uint(x)) == 0
+}
+
+// Has reports whether (x, y) is on the board and holds cell.
+func (b *Board) Has(x, y int, cell Cell) bool {
+	if !b.InBounds(x, y) {
+		return false
+	}
+	bit := uint32(1) << uint(x)
+	switch cell {
+	case CellBlack:
+		return b.black[y]&bit != 0
+	case CellWhite:
+		return b.white[y]&bit != 0
+	default:
+		return (b.black[y]|b.white[y])&bit == 0
+	}
+}
+
+// Row returns the stones of cell on row y as a bitmask; CellEmpty yields the
+// empty intersections.
+func (b *Board) Row(y int, cell Cell) uint32 {
+	switch cell {
+	case CellBlack:
+		return b.black[y]
+	case CellWhite:
+		return b.white[y]
+	default:
+		return ^(b.black[y] | b.white[y]) & b.rowMask()
+	}
+}
+
+// Occupied returns the bitmask of stones of either color on row y.
+func (b *Board) Occupied(y int) uint32 {
+	return b.black[y] | b.white[y]
 }
 
-func (b Board) CountEmpty() int {
+func (b *Board) StoneCount() int {
 	count := 0
-	for _, cell := range b.cells {
-		if cell == CellEmpty {
-			count++
-		}
+	for y := 0; y < b.size; y++ {
+		count += bits.OnesCount32(b.black[y] | b.white[y])
 	}
 	return count
 }
 
-func (b Board) Size() int {
+// StoneDistance counts the cells where b and other hold different stones; a
+// stone of the other color counts twice.
+func (b *Board) StoneDistance(other *Board) int {
+	count := 0
+	for y := 0; y < maxBoardSize; y++ {
+		count += bits.OnesCount32(b.black[y]^other.black[y]) + bits.OnesCount32(b.white[y]^other.white[y])
+	}
+	return count
+}
+
+func (b *Board) CountEmpty() int {
+	return b.size*b.size - b.StoneCount()
+}
+
+func (b *Board) Size() int {
 	return b.size
 }
 
 func (b Board) Clone() Board {
-	clone := Board{size: b.size}
-	clone.cells = make([]Cell, len(b.cells))
-	copy(clone.cells, b.cells)
-	return clone
+	return b
+}
+
+// Run counts consecutive cells equal to target starting one step from (x, y)
+// in direction (dx, dy). Horizontal runs resolve with a single bit scan.
+func (b *Board) Run(x, y, dx, dy int, target Cell) int {
+	if dy == 0 && dx != 0 && y >= 0 && y < b.size {
+		row := b.Row(y, target) & b.rowMask()
+		if dx > 0 {
+			if x+1 >= b.size || x+1 < 0 {
+				return 0
+			}
+			return bits.TrailingZeros32(^(row >> uint(x+1)))
+		}
+		if x <= 0 || x > b.size {
+			return 0
+		}
+		return bits.LeadingZeros32(^(row << uint(32-x)))
+	}
+	count := 0
+	nx := x + dx
+	ny := y + dy
+	for b.Has(nx, ny, target) {
+		count++
+		nx += dx
+		ny += dy
+	}
+	return count
+}
+
+// NeighborMask returns, per row, the empty intersections within Chebyshev
+// distance radius of any stone.
+func (b *Board) NeighborMask(radius int) [maxBoardSize]uint32 {
+	var spread [maxBoardSize]uint32
+	var out [maxBoardSize]uint32
+	mask := b.rowMask()
+	for y := 0; y < b.size; y++ {
+		occ := b.black[y] | b.white[y]
+		row := occ
+		for r := 1; r <= radius; r++ {
+			row |= occ<<uint(r) | occ>>uint(r)
+		}
+		spread[y] = row & mask
+	}
+	for y := 0; y < b.size; y++ {
+		var row uint32
+		for dy := -radius; dy <= radius; dy++ {
+			ny := y + dy
+			if ny >= 0 && ny < b.size {
+				row |= spread[ny]
+			}
+		}
+		out[y] = row &^ (b.black[y] | b.white[y])
+	}
+	return out
+}
+
+func (b *Board) rowMask() uint32 {
+	return uint32(1)<<uint(b.size) - 1
 }
 
-func (b Board) index(x, y int) int {
-	return y*b.size + x
+func (b *Board) atIndex(idx int) Cell {
+	return b.At(idx%b.size, idx/b.size)
 }
 
 func (c Cell) String() string {
@@ -0,0 +1,65 @@
+package main
+
+import "testing"
+
+func TestBoardCloneIsIndependent(t *testing.T) {
+	board := NewBoard(19)
+	board.Set(3, 4, CellBlack)
+	clone := board.Clone()
+	clone.Set(3, 4, CellWhite)
+	clone.Set(18, 18, CellBlack)
+
+	if board.At(3, 4) != CellBlack {
+		t.Fatalf("expected original stone to stay black, got %v", board.At(3, 4))
+	}
+	if board.At(18, 18) != CellEmpty {
+		t.Fatalf("expected original board to ignore clone writes")
+	}
+	if clone.CountEmpty() != 19*19-2 {
+		t.Fatalf("expected two stones on clone, got %d empty", clone.CountEmpty())
+	}
+}
+
+func TestBoardRunMatchesCellScan(t *testing.T) {
+	board := NewBoard(9)
+	for x := 1; x <= 4; x++ {
+		board.Set(x, 2, CellBlack)
+	}
+	board.Set(5, 2, CellWhite)
+	board.Set(2, 3, CellBlack)
+	board.Set(3, 4, CellBlack)
+
+	directions := [8][2]int{{1, 0}, {-1, 0}, {0, 1}, {0, -1}, {1, 1}, {-1, -1}, {1, -1}, {-1, 1}}
+	for y := 0; y < 9; y++ {
+		for x := 0; x < 9; x++ {
+			for _, dir := range directions {
+				for _, target := range []Cell{CellEmpty, CellBlack, CellWhite} {
+					want := 0
+					for nx, ny := x+dir[0], y+dir[1]; board.InBounds(nx, ny) && board.At(nx, ny) == target; nx, ny = nx+dir[0], ny+dir[1] {
+						want++
+					}
+					if got := board.Run(x, y, dir[0], dir[1], target); got != want {
+						t.Fatalf("run from (%d,%d) dir %v target %v: got %d want %d", x, y, dir, target, got, want)
+					}
+				}
+			}
+		}
+	}
+}
+
+func TestBoardNeighborMaskCoversEmptyRing(t *testing.T) {
+	board := NewBoard(9)
+	board.Set(0, 0, CellBlack)
+	board.Set(8, 8, CellWhite)
+	near := board.NeighborMask(2)
+
+	for y := 0; y < 9; y++ {
+		for x := 0; x < 9; x++ {
+			want := board.IsEmpty(x, y) && ((x <= 2 && y <= 2) || (x >= 6 && y >= 6))
+			got := near[y]&(uint32(1)<<uint(x)) != 0
+			if got != want {
+				t.Fatalf("neighbor mask at (%d,%d): got %v want %v", x, y, got, want)
+			}
+		}
+	}
+}
@@ -2,8 +2,12 @@ package main
 
 func persistCaches() {
 	persistTTPersistence(GetConfig(), SharedSearchCache())
+	syncSharedPositionBook()
+	syncSharedColdTier()
 }
 
 func loadPersistedCaches() {
 	loadTTPersistence(GetConfig(), SharedSearchCache())
+	openSharedPositionBook(GetConfig())
+	openSharedColdTier(GetConfig())
 }
@@ -0,0 +1,186 @@
+package main
+
+import (
+	"fmt"
+	"log"
+	"sort"
+	"sync"
+	"time"
+)
+
+// SearchCachePool gives each game and heuristic profile its own
+// AISearchCache, so one game's searches never evict or flush another's. The
+// pool keeps the partitions' TTs under AiCachePoolMaxBytes by dropping
+// the least recently used partition; a search holding a dropped cache keeps
+// it until it finishes.
+type SearchCachePool struct {
+	mu         sync.Mutex
+	partitions map[cachePartitionKey]*cachePartition
+	evictions  int64
+	clock      uint64 // bumped per Acquire; orders partitions by recency
+}
+
+type cachePartitionKey struct {
+	Game          string
+	HeuristicHash uint64
+}
+
+type cachePartition struct {
+	key      cachePartitionKey
+	cache    *AISearchCache
+	bytes    int64
+	created  time.Time
+	lastUsed time.Time
+	lastTick uint64
+	acquires int64
+}
+
+type cachePartitionStats struct {
+	Game          string `json:"game"`
+	HeuristicHash string `json:"heuristic_hash"`
+	Count         int    `json:"count"`
+	Capacity      int    `json:"capacity"`
+	CapacityBytes int64  `json:"capacity_bytes"`
+	Acquires      int64  `json:"acquires"`
+	CreatedAt     int64  `json:"created_at_ms"`
+	LastUsedAt    int64  `json:"last_used_at_ms"`
+}
+
+type cachePoolStats struct {
+	Partitions []cachePartitionStats `json:"partitions"`
+	UsedBytes  int64                 `json:"used_bytes"`
+	MaxBytes   int64                 `json:"max_bytes"`
+	Evictions  int64                 `json:"evictions"`
+}
+
+var sharedCachePool = newSearchCachePool()
+
+func newSearchCachePool() *SearchCachePool {
+	return &SearchCachePool{partitions: map[cachePartitionKey]*cachePartition{}}
+}
+
+func SharedCachePool() *SearchCachePool {
+	return sharedCachePool
+}
+
+// searchCacheFor returns the cache searches for game under config should
+// use: the shared cache unless partitioning is on and the game is named.
+func searchCacheFor(game string, config Config) *AISearchCache {
+	if !config.AiCachePartitioned || game == "" {
+		return SharedSearchCache()
+	}
+	return SharedCachePool().Acquire(game, config)
+}
+
+// Acquire returns the partition for game and config's heuristics, creating
+// it and sizing its TT from config when needed. The TT is built outside the
+// pool lock, so other games never wait on an allocation.
+func (p *SearchCachePool) Acquire(game string, config Config) *AISearchCache {
+	key := cachePartitionKey{Game: game, HeuristicHash: heuristicHashFromConfig(config)}
+	now := time.Now()
+	p.mu.Lock()
+	part := p.partitions[key]
+	if part == nil {
+		cache := newAISearchCache()
+		part = &cachePartition{key: key, cache: &cache, created: now}
+		p.partitions[key] = part
+	}
+	p.clock++
+	part.lastUsed = now
+	part.lastTick = p.clock
+	part.acquires++
+	p.mu.Unlock()
+
+	tt := ensureTT(part.cache, config)
+
+	p.mu.Lock()
+	defer p.mu.Unlock()
+	// The partition may have been flushed or evicted while its TT was
+	// built; the caller keeps it like any search holding a dropped cache.
+	if p.partitions[key] != part {
+		return part.cache
+	}
+	if tt != nil {
+		part.bytes = int64(tt.Capacity()) * ttEntryBytes(config)
+	}
+	p.evictLocked(config.AiCachePoolMaxBytes, part)
+	return part.cache
+}
+
+func (p *SearchCachePool) evictLocked(maxBytes int64, keep *cachePartition) {
+	if maxBytes <= 0 {
+		return
+	}
+	for p.usedBytesLocked() > maxBytes {
+		var victim *cachePartition
+		for _, part := range p.partitions {
+			if part != keep && (victim == nil || part.lastTick < victim.lastTick) {
+				victim = part
+			}
+		}
+		if victim == nil {
+			return
+		}
+		delete(p.partitions, victim.key)
+		p.evictions++
+		log.Printf("[ai:cache] evicted partition game=%s heuristics=%016x (%d bytes)", victim.key.Game, victim.key.HeuristicHash, victim.bytes)
+	}
+}
+
+func (p *SearchCachePool) usedBytesLocked() int64 {
+	total := int64(0)
+	for _, part := range p.partitions {
+		total += part.bytes
+	}
+	return total
+}
+
+// FlushGame drops every partition of game and reports how many there were.
+func (p *SearchCachePool) FlushGame(game string) int {
+	p.mu.Lock()
+	defer p.mu.Unlock()
+	flushed := 0
+	for key := range p.partitions {
+		if key.Game == game {
+			delete(p.partitions, key)
+			flushed++
+		}
+	}
+	return flushed
+}
+
+func (p *SearchCachePool) Flush() {
+	p.mu.Lock()
+	defer p.mu.Unlock()
+	clear(p.partitions)
+}
+
+func (p *SearchCachePool) Stats(maxBytes int64) cachePoolStats {
+	p.mu.Lock()
+	parts := make([]cachePartition, 0, len(p.partitions))
+	for _, part := range p.partitions {
+		parts = append(parts, *part)
+	}
+	stats := cachePoolStats{UsedBytes: p.usedBytesLocked(), MaxBytes: maxBytes, Evictions: p.evictions}
+	p.mu.Unlock()
+	sort.Slice(parts, func(i, j int) bool { return parts[i].lastTick > parts[j].lastTick })
+	stats.Partitions = make([]cachePartitionStats, 0, len(parts))
+	for _, part := range parts {
+		entry := cachePartitionStats{
+			Game:          part.key.Game,
+			HeuristicHash: fmt.Sprintf("%016x", part.key.HeuristicHash),
+			CapacityBytes: part.bytes,
+			Acquires:      part.acquires,
+			CreatedAt:     part.created.UnixMilli(),
+			LastUsedAt:    part.lastUsed.UnixMilli(),
+		}
+		entry.Count = TranspositionSize(part.cache)
+		part.cache.mu.Lock()
+		if part.cache.TT != nil {
+			entry.Capacity = part.cache.TT.Capacity()
+		}
+		part.cache.mu.Unlock()
+		stats.Partitions = append(stats.Partitions, entry)
+	}
+	return stats
+}
@@ -0,0 +1,99 @@
+package main
+
+import (
+	"sync"
+	"testing"
+)
+
+func cachePoolTestConfig() Config {
+	cfg := DefaultConfig()
+	cfg.AiCachePartitioned = true
+	cfg.AiTtSize = 1 << 10
+	cfg.AiTtMaxMemoryBytes = 0
+	return cfg
+}
+
+func TestCachePoolIsolatesGamesAndProfiles(t *testing.T) {
+	pool := newSearchCachePool()
+	cfg := cachePoolTestConfig()
+	a := pool.Acquire("game-a", cfg)
+	b := pool.Acquire("game-b", cfg)
+	if a == b {
+		t.Fatalf("expected separate partitions per game")
+	}
+	other := cfg
+	other.Heuristics.Open4 *= 2
+	if pool.Acquire("game-a", other) == a {
+		t.Fatalf("expected separate partitions per heuristic profile")
+	}
+	if pool.Acquire("game-a", cfg) != a {
+		t.Fatalf("expected the same partition for the same game and profile")
+	}
+
+	a.TT.Store(1, heuristicHashFromConfig(cfg), 3, 10, TTExact, Move{X: 1, Y: 1}, TTMeta{})
+	b.TT.Store(1, heuristicHashFromConfig(cfg), 3, 10, TTExact, Move{X: 1, Y: 1}, TTMeta{})
+	if flushed := pool.FlushGame("game-a"); flushed != 2 {
+		t.Fatalf("expected both game-a partitions flushed, got %d", flushed)
+	}
+	if pool.Acquire("game-b", cfg) != b || b.TT.Count() != 1 {
+		t.Fatalf("flushing game-a touched game-b")
+	}
+	if pool.Acquire("game-a", cfg) == a {
+		t.Fatalf("expected a fresh partition after flushing game-a")
+	}
+}
+
+func TestCachePoolEvictsLeastRecentlyUsedPartition(t *testing.T) {
+	pool := newSearchCachePool()
+	cfg := cachePoolTestConfig()
+	pool.Acquire("game-a", cfg)
+	perPartition := pool.Stats(0).UsedBytes
+	cfg.AiCachePoolMaxBytes = 2 * perPartition
+	pool.Acquire("game-b", cfg)
+	pool.Acquire("game-a", cfg)
+	pool.Acquire("game-c", cfg)
+
+	stats := pool.Stats(cfg.AiCachePoolMaxBytes)
+	if stats.Evictions != 1 || len(stats.Partitions) != 2 || stats.UsedBytes > cfg.AiCachePoolMaxBytes {
+		t.Fatalf("expected one eviction down to two partitions, got %+v", stats)
+	}
+	for _, part := range stats.Partitions {
+		if part.Game == "game-b" {
+			t.Fatalf("expected game-b to be evicted as least recently used, got %+v", stats.Partitions)
+		}
+	}
+}
+
+func TestCachePoolAcquiresConcurrently(t *testing.T) {
+	pool := newSearchCachePool()
+	cfg := cachePoolTestConfig()
+	games := []string{"game-a", "game-b", "game-c", "game-d"}
+	got := make([][]*AISearchCache, len(games))
+	var wg sync.WaitGroup
+	for i, game := range games {
+		got[i] = make([]*AISearchCache, 8)
+		for j := range got[i] {
+			wg.Add(1)
+			go func(i, j int, game string) {
+				defer wg.Done()
+				got[i][j] = pool.Acquire(game, cfg)
+			}(i, j, game)
+		}
+	}
+	wg.Wait()
+
+	stats := pool.Stats(0)
+	if len(stats.Partitions) != len(games) {
+		t.Fatalf("expected %d partitions, got %+v", len(games), stats.Partitions)
+	}
+	for i, caches := range got {
+		for _, cache := range caches {
+			if cache != caches[0] || cache.TT == nil {
+				t.Fatalf("%s: concurrent acquires returned different or unsized caches", games[i])
+			}
+		}
+	}
+	if want := int64(len(games)) * int64(got[0][0].TT.Capacity()) * ttEntryBytes(cfg); stats.UsedBytes != want {
+		t.Fatalf("expected %d bytes accounted, got %d", want, stats.UsedBytes)
+	}
+}
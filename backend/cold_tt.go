@@ -0,0 +1,661 @@
+package main
+
+import (
+	"bytes"
+	"compress/flate"
+	"encoding/binary"
+	"errors"
+	"fmt"
+	"hash/crc32"
+	"io"
+	"log"
+	"os"
+	"path/filepath"
+	"sort"
+	"strings"
+	"sync"
+	"sync/atomic"
+)
+
+// ColdTier is the TT's second tier: deep EXACT entries the hot table evicts
+// are appended to a compressed file on local disk, so they outlive eviction
+// and restarts without growing the in-memory table. Entries are keyed like the
+// TT they came from (CanonHash unless AiTtSymmetry is off), with moves in the
+// same orientation.
+//
+// The file is a 32-byte header (magic, version, raw-keys flag, heuristic hash)
+// followed by blocks. Each block is a 16-byte header (payload length, record
+// count, CRC-32 of the payload) and a flate-compressed payload of records
+// sorted by key: uvarint key delta, varint score, then depth, move x+1 and
+// move y+1 as bytes. Nothing is rewritten in place; a key stored again at a
+// greater depth goes to a later block and its index slot moves there.
+//
+// The index keeps one word per key in memory: the key's high 32 bits, its
+// depth and its block. A later key with the same high bits takes over the
+// slot, and reads check the full key, so that rare case costs a miss.
+type ColdTier struct {
+	path          string
+	file          *os.File
+	heuristicHash uint64
+	rawKeys       bool
+	minDepth      int
+	maxBytes      int64
+
+	mu        sync.RWMutex
+	index     []uint64
+	used      int
+	blocks    []coldBlock
+	written   int                     // blocks[:written] are on disk
+	unwritten map[uint32][]coldRecord // sealed blocks waiting for the writer
+	open      []coldRecord            // block len(blocks), still filling
+	closed    bool                    // set by Close; add and Prefetch stop
+
+	writeMu sync.Mutex // serializes appends
+	bytes   atomic.Int64
+	flush   chan struct{}
+	probes  chan coldProbe
+	writer  sync.WaitGroup
+	prober  sync.WaitGroup
+
+	cacheMu sync.Mutex
+	cache   map[uint32][]coldRecord // decoded blocks, dropped when full
+
+	hits     atomic.Int64
+	misses   atomic.Int64
+	stores   atomic.Int64
+	promoted atomic.Int64
+	dropped  atomic.Int64
+}
+
+type ColdTierStats struct {
+	Entries  int   `json:"entries"`
+	Blocks   int   `json:"blocks"`
+	Bytes    int64 `json:"bytes"`
+	Hits     int64 `json:"hits"`
+	Misses   int64 `json:"misses"`
+	Stores   int64 `json:"stores"`
+	Promoted int64 `json:"promoted"`
+	Dropped  int64 `json:"dropped"`
+}
+
+type coldBlock struct {
+	offset int64 // payload offset
+	length uint32
+}
+
+type coldRecord struct {
+	key   uint64
+	score int32
+	depth uint8
+	x, y  int8
+}
+
+type coldProbe struct {
+	tt  *TranspositionTable
+	key uint64
+}
+
+const (
+	coldMagic            = 0x31444c4f434b4d47 // "GMKCOLD1"
+	coldVersion          = 1
+	coldHeaderBytes      = 32
+	coldBlockHeaderBytes = 16
+	coldBlockRecords     = 256
+	coldMaxBlocks        = 1<<24 - 1
+	coldCachedBlocks     = 64
+	coldMinIndexSlots    = 1 << 16
+
+	coldDepthShift = 24
+	coldFPShift    = 32
+	coldBlockMask  = 1<<coldDepthShift - 1
+)
+
+var sharedColdTier atomic.Pointer[ColdTier]
+
+// errColdTierMismatch is returned for a file that is not a cold tier of this
+// version, heuristic hash and key mode; the file is left as it is.
+var errColdTierMismatch = errors.New("cold tier mismatch")
+
+func SharedColdTier() *ColdTier {
+	return sharedColdTier.Load()
+}
+
+// OpenColdTier opens or creates the cold tier at path and indexes its blocks.
+// A file built for another version, heuristic hash or key mode is refused with
+// errColdTierMismatch and left alone. A short header or a torn last block is
+// treated as corruption: the header is rewritten or the block cut off.
+func OpenColdTier(path string, heuristicHash uint64, rawKeys bool, minDepth int, maxBytes int64) (*ColdTier, error) {
+	if dir := filepath.Dir(path); dir != "." && dir != "" {
+		if err := os.MkdirAll(dir, 0o755); err != nil {
+			return nil, err
+		}
+	}
+	file, err := os.OpenFile(path, os.O_RDWR|os.O_CREATE, 0o644)
+	if err != nil {
+		return nil, err
+	}
+	c := &ColdTier{
+		path:          path,
+		file:          file,
+		heuristicHash: heuristicHash,
+		rawKeys:       rawKeys,
+		minDepth:      max(minDepth, 1),
+		maxBytes:      maxBytes,
+		index:         make([]uint64, coldMinIndexSlots),
+		unwritten:     map[uint32][]coldRecord{},
+		open:          make([]coldRecord, 0, coldBlockRecords),
+		flush:         make(chan struct{}, 1),
+		probes:        make(chan coldProbe, 256),
+		cache:         map[uint32][]coldRecord{},
+	}
+	if err := c.load(); errors.Is(err, errColdTierMismatch) {
+		file.Close()
+		return nil, err
+	} else if err != nil {
+		log.Printf("[ai:cold] resetting %s: %v", path, err)
+		if err := c.reset(); err != nil {
+			file.Close()
+			return nil, err
+		}
+	}
+	c.writer.Add(1)
+	c.prober.Add(1)
+	go c.runWriter()
+	go c.runProber()
+	return c, nil
+}
+
+func (c *ColdTier) header() []byte {
+	buf := make([]byte, coldHeaderBytes)
+	binary.LittleEndian.PutUint64(buf[0:], coldMagic)
+	binary.LittleEndian.PutUint64(buf[8:], coldVersion)
+	if c.rawKeys {
+		buf[16] = 1
+	}
+	binary.LittleEndian.PutUint64(buf[24:], c.heuristicHash)
+	return buf
+}
+
+func (c *ColdTier) reset() error {
+	c.index = make([]uint64, coldMinIndexSlots)
+	c.used = 0
+	c.blocks = nil
+	c.written = 0
+	if err := c.file.Truncate(0); err != nil {
+		return err
+	}
+	if _, err := c.file.WriteAt(c.header(), 0); err != nil {
+		return err
+	}
+	c.bytes.Store(coldHeaderBytes)
+	return nil
+}
+
+func (c *ColdTier) load() error {
+	stat, err := c.file.Stat()
+	if err != nil {
+		return err
+	}
+	size := stat.Size()
+	if size == 0 {
+		return c.reset()
+	}
+	header := make([]byte, coldHeaderBytes)
+	if _, err := c.file.ReadAt(header, 0); err != nil {
+		return fmt.Errorf("short header: %w", err)
+	}
+	if want := c.header(); !bytes.Equal(header[:16], want[:16]) {
+		return fmt.Errorf("%w: %s is not a cold tier of layout version %d", errColdTierMismatch, c.path, coldVersion)
+	} else if !bytes.Equal(header[16:], want[16:]) {
+		return fmt.Errorf("%w: %s was built for heuristic hash %x raw keys %v", errColdTierMismatch, c.path, binary.LittleEndian.Uint64(header[24:]), header[16] == 1)
+	}
+	offset := int64(coldHeaderBytes)
+	for offset < size {
+		records, length, err := c.readBlockAt(offset, size)
+		if err != nil {
+			log.Printf("[ai:cold] truncating %s at %d: %v", c.path, offset, err)
+			if err := c.file.Truncate(offset); err != nil {
+				return err
+			}
+			break
+		}
+		id := uint32(len(c.blocks))
+		c.blocks = append(c.blocks, coldBlock{offset: offset + coldBlockHeaderBytes, length: length})
+		for _, rec := range records {
+			c.setIndex(rec.key, int(rec.depth), id)
+		}
+		offset += coldBlockHeaderBytes + int64(length)
+	}
+	c.written = len(c.blocks)
+	c.bytes.Store(offset)
+	log.Printf("[ai:cold] opened %s (%d entries in %d blocks, %d bytes)", c.path, c.used, len(c.blocks), offset)
+	return nil
+}
+
+// readBlockAt reads the block whose header starts at offset; it must end by
+// end.
+func (c *ColdTier) readBlockAt(offset int64, end int64) ([]coldRecord, uint32, error) {
+	header := make([]byte, coldBlockHeaderBytes)
+	if _, err := c.file.ReadAt(header, offset); err != nil {
+		return nil, 0, err
+	}
+	length := binary.LittleEndian.Uint32(header[0:])
+	count := binary.LittleEndian.Uint32(header[4:])
+	if offset+coldBlockHeaderBytes+int64(length) > end || count > coldBlockRecords {
+		return nil, 0, errors.New("torn block")
+	}
+	payload := make([]byte, length)
+	if _, err := c.file.ReadAt(payload, offset+coldBlockHeaderBytes); err != nil {
+		return nil, 0, err
+	}
+	if crc32.ChecksumIEEE(payload) != binary.LittleEndian.Uint32(header[8:]) {
+		return nil, 0, errors.New("block checksum mismatch")
+	}
+	records, err := decodeColdBlock(payload, int(count))
+	return records, length, err
+}
+
+func encodeColdBlock(records []coldRecord) []byte {
+	raw := make([]byte, 0, len(records)*12)
+	prev := uint64(0)
+	for _, rec := range records {
+		raw = binary.AppendUvarint(raw, rec.key-prev)
+		raw = binary.AppendVarint(raw, int64(rec.score))
+		raw = append(raw, rec.depth, byte(rec.x+1), byte(rec.y+1))
+		prev = rec.key
+	}
+	var out bytes.Buffer
+	w, _ := flate.NewWriter(&out, flate.BestSpeed)
+	w.Write(raw)
+	w.Close()
+	return out.Bytes()
+}
+
+func decodeColdBlock(payload []byte, count int) ([]coldRecord, error) {
+	raw, err := io.ReadAll(flate.NewReader(bytes.NewReader(payload)))
+	if err != nil {
+		return nil, err
+	}
+	records := make([]coldRecord, 0, count)
+	prev := uint64(0)
+	for len(records) < count {
+		delta, n := binary.Uvarint(raw)
+		if n <= 0 {
+			return nil, errors.New("corrupt record key")
+		}
+		raw = raw[n:]
+		score, n := binary.Varint(raw)
+		if n <= 0 || len(raw) < n+3 {
+			return nil, errors.New("corrupt record")
+		}
+		raw = raw[n:]
+		prev += delta
+		records = append(records, coldRecord{key: prev, score: int32(score), depth: raw[0], x: int8(raw[1]) - 1, y: int8(raw[2]) - 1})
+		raw = raw[3:]
+	}
+	return records, nil
+}
+
+func coldFingerprint(key uint64) uint64 {
+	return key >> coldFPShift
+}
+
+// findSlot returns the index slot of key's fingerprint and the word it holds,
+// 0 when the fingerprint is not indexed.
+func (c *ColdTier) findSlot(key uint64) (int, uint64) {
+	fp := coldFingerprint(key)
+	mask := uint64(len(c.index) - 1)
+	for i := mixKey(fp) & mask; ; i = (i + 1) & mask {
+		word := c.index[i]
+		if word == 0 || word>>coldFPShift == fp {
+			return int(i), word
+		}
+	}
+}
+
+func (c *ColdTier) setIndex(key uint64, depth int, block uint32) {
+	if (c.used+1)*2 > len(c.index) {
+		old := c.index
+		c.index = make([]uint64, 2*len(old))
+		for _, word := range old {
+			if word != 0 {
+				slot, _ := c.findSlot(word)
+				c.index[slot] = word
+			}
+		}
+	}
+	slot, word := c.findSlot(key)
+	if word == 0 {
+		c.used++
+	}
+	c.index[slot] = coldFingerprint(key)<<coldFPShift | uint64(depth)<<coldDepthShift | uint64(block+1)
+}
+
+// add queues an entry the hot tier is evicting. It keeps only EXACT entries at
+// least minDepth deep that are deeper than what the tier already holds, and
+// never touches the disk, since callers hold a TT lock.
+func (c *ColdTier) add(rawKeys bool, e TTEntry) {
+	if !e.Valid || e.Flag != TTExact || e.Depth < c.minDepth || e.HeuristicHash != c.heuristicHash || rawKeys != c.rawKeys {
+		return
+	}
+	depth := min(e.Depth, 255)
+	c.mu.Lock()
+	defer c.mu.Unlock()
+	if c.closed || len(c.blocks) >= coldMaxBlocks || (c.maxBytes > 0 && c.bytes.Load() >= c.maxBytes) {
+		return
+	}
+	if _, word := c.findSlot(e.Key); word != 0 && int(word>>coldDepthShift&0xff) >= depth {
+		return
+	}
+	rec := coldRecord{key: e.Key, score: e.Score, depth: uint8(depth), x: -1, y: -1}
+	if e.BestMove.X >= 0 && e.BestMove.Y >= 0 {
+		rec.x, rec.y = int8(e.BestMove.X), int8(e.BestMove.Y)
+	}
+	c.open = append(c.open, rec)
+	c.setIndex(e.Key, depth, uint32(len(c.blocks)))
+	c.stores.Add(1)
+	if len(c.open) >= coldBlockRecords {
+		c.seal()
+	}
+}
+
+// seal closes the open block and wakes the writer. Callers hold mu.
+func (c *ColdTier) seal() {
+	records := c.open
+	sort.SliceStable(records, func(i, j int) bool { return records[i].key < records[j].key })
+	kept := records[:0]
+	for i, rec := range records {
+		// A key stored twice in one block keeps its later, deeper record.
+		if i+1 < len(records) && records[i+1].key == rec.key {
+			continue
+		}
+		kept = append(kept, rec)
+	}
+	id := uint32(len(c.blocks))
+	c.blocks = append(c.blocks, coldBlock{offset: -1})
+	c.unwritten[id] = kept
+	c.open = make([]coldRecord, 0, coldBlockRecords)
+	if c.closed {
+		return // Close writes the rest itself
+	}
+	select {
+	case c.flush <- struct{}{}:
+	default:
+	}
+}
+
+func (c *ColdTier) runWriter() {
+	defer c.writer.Done()
+	for range c.flush {
+		if err := c.writePending(); err != nil {
+			log.Printf("[ai:cold] failed to append to %s: %v", c.path, err)
+		}
+	}
+}
+
+// writePending appends the sealed blocks to the file in order.
+func (c *ColdTier) writePending() error {
+	c.writeMu.Lock()
+	defer c.writeMu.Unlock()
+	for {
+		c.mu.RLock()
+		id := uint32(c.written)
+		records, ok := c.unwritten[id]
+		c.mu.RUnlock()
+		if !ok {
+			return nil
+		}
+		payload := encodeColdBlock(records)
+		buf := make([]byte, coldBlockHeaderBytes, coldBlockHeaderBytes+len(payload))
+		binary.LittleEndian.PutUint32(buf[0:], uint32(len(payload)))
+		binary.LittleEndian.PutUint32(buf[4:], uint32(len(records)))
+		binary.LittleEndian.PutUint32(buf[8:], crc32.ChecksumIEEE(payload))
+		buf = append(buf, payload...)
+		offset := c.bytes.Load()
+		if _, err := c.file.WriteAt(buf, offset); err != nil {
+			return err
+		}
+		c.mu.Lock()
+		c.blocks[id] = coldBlock{offset: offset + coldBlockHeaderBytes, length: uint32(len(payload))}
+		delete(c.unwritten, id)
+		c.written++
+		c.mu.Unlock()
+		c.bytes.Add(int64(len(buf)))
+	}
+}
+
+// Lookup returns the record stored for key.
+func (c *ColdTier) Lookup(key uint64) (coldRecord, bool) {
+	c.mu.RLock()
+	_, word := c.findSlot(key)
+	if word == 0 {
+		c.mu.RUnlock()
+		c.misses.Add(1)
+		return coldRecord{}, false
+	}
+	id := uint32(word&coldBlockMask) - 1
+	var records []coldRecord
+	var block coldBlock
+	if int(id) == len(c.blocks) {
+		for i := len(c.open) - 1; i >= 0; i-- {
+			if c.open[i].key == key {
+				rec := c.open[i]
+				c.mu.RUnlock()
+				c.hits.Add(1)
+				return rec, true
+			}
+		}
+	} else if pending, ok := c.unwritten[id]; ok {
+		records = pending
+	} else {
+		block = c.blocks[id]
+	}
+	c.mu.RUnlock()
+	if records == nil && block.offset > 0 {
+		var err error
+		if records, err = c.block(id, block); err != nil {
+			log.Printf("[ai:cold] failed to read block %d of %s: %v", id, c.path, err)
+		}
+	}
+	i := sort.Search(len(records), func(i int) bool { return records[i].key >= key })
+	if i == len(records) || records[i].key != key {
+		c.misses.Add(1)
+		return coldRecord{}, false
+	}
+	c.hits.Add(1)
+	return records[i], true
+}
+
+func (c *ColdTier) block(id uint32, block coldBlock) ([]coldRecord, error) {
+	c.cacheMu.Lock()
+	records, ok := c.cache[id]
+	c.cacheMu.Unlock()
+	if ok {
+		return records, nil
+	}
+	records, _, err := c.readBlockAt(block.offset-coldBlockHeaderBytes, c.bytes.Load())
+	if err != nil {
+		return nil, err
+	}
+	c.cacheMu.Lock()
+	if len(c.cache) >= coldCachedBlocks {
+		clear(c.cache)
+	}
+	c.cache[id] = records
+	c.cacheMu.Unlock()
+	return records, nil
+}
+
+// Promote copies key's cold entry into tt's hot tier.
+func (c *ColdTier) Promote(tt *TranspositionTable, key uint64, heuristicHash uint64) bool {
+	if c == nil || tt == nil || heuristicHash != c.heuristicHash || tt.rawKeys != c.rawKeys {
+		return false
+	}
+	rec, ok := c.Lookup(key)
+	if !ok {
+		return false
+	}
+	tt.Store(key, c.heuristicHash, int(rec.depth), float64(rec.score), TTExact, Move{X: int(rec.x), Y: int(rec.y)}, TTMeta{})
+	c.promoted.Add(1)
+	return true
+}
+
+// Prefetch queues a cold lookup of key for tt and returns at once; a hit is
+// promoted, so a later visit of the position finds it in the hot tier. Keys
+// the index does not know cost one read-locked probe, and requests beyond a
+// full queue are dropped.
+func (c *ColdTier) Prefetch(tt *TranspositionTable, key uint64, heuristicHash uint64) {
+	if c == nil || tt == nil || heuristicHash != c.heuristicHash || tt.rawKeys != c.rawKeys {
+		return
+	}
+	c.mu.RLock()
+	defer c.mu.RUnlock()
+	if c.closed {
+		return
+	}
+	if _, word := c.findSlot(key); word == 0 {
+		c.misses.Add(1)
+		return
+	}
+	select {
+	case c.probes <- coldProbe{tt: tt, key: key}:
+	default:
+		c.dropped.Add(1)
+	}
+}
+
+func (c *ColdTier) runProber() {
+	defer c.prober.Done()
+	for probe := range c.probes {
+		c.Promote(probe.tt, probe.key, c.heuristicHash)
+	}
+}
+
+func (c *ColdTier) Stats() ColdTierStats {
+	if c == nil {
+		return ColdTierStats{}
+	}
+	c.mu.RLock()
+	entries, blocks := c.used, len(c.blocks)
+	c.mu.RUnlock()
+	return ColdTierStats{
+		Entries:  entries,
+		Blocks:   blocks,
+		Bytes:    c.bytes.Load(),
+		Hits:     c.hits.Load(),
+		Misses:   c.misses.Load(),
+		Stores:   c.stores.Load(),
+		Promoted: c.promoted.Load(),
+		Dropped:  c.dropped.Load(),
+	}
+}
+
+// Sync seals the open block and writes every pending block to disk.
+func (c *ColdTier) Sync() error {
+	if c == nil {
+		return nil
+	}
+	c.mu.Lock()
+	if len(c.open) > 0 {
+		c.seal()
+	}
+	c.mu.Unlock()
+	if err := c.writePending(); err != nil {
+		return err
+	}
+	return c.file.Sync()
+}
+
+// Close syncs the tier and stops its goroutines. Later adds and prefetches
+// are dropped, and lookups that need the file miss.
+func (c *ColdTier) Close() error {
+	if c == nil {
+		return nil
+	}
+	c.mu.Lock()
+	if c.closed {
+		c.mu.Unlock()
+		return nil
+	}
+	c.closed = true
+	c.mu.Unlock()
+	close(c.probes)
+	c.prober.Wait()
+	err := c.Sync()
+	close(c.flush)
+	c.writer.Wait()
+	if closeErr := c.file.Close(); err == nil {
+		err = closeErr
+	}
+	return err
+}
+
+// spillToCold hands an entry the hot tier is evicting to the shared cold tier.
+func (tt *TranspositionTable) spillToCold(entry TTEntry) {
+	if cold := SharedColdTier(); cold != nil {
+		cold.add(tt.rawKeys, entry)
+	}
+}
+
+// prefetchCold is called on a hot-tier miss depthFromRoot plies below the
+// root.
+func prefetchCold(tt *TranspositionTable, key uint64, heuristicHash uint64, depthFromRoot int, config Config) {
+	if depthFromRoot > config.AiTtColdProbePly {
+		return
+	}
+	if cold := SharedColdTier(); cold != nil {
+		cold.Prefetch(tt, key, heuristicHash)
+	}
+}
+
+// coldTierPath names the tier file after its heuristic hash and key mode, so
+// each heuristic keeps its own file: tt_cold.bin becomes
+// tt_cold-<hash>.bin, or tt_cold-<hash>-raw.bin without symmetry folding.
+func coldTierPath(base string, heuristicHash uint64, rawKeys bool) string {
+	ext := filepath.Ext(base)
+	name := fmt.Sprintf("%s-%016x", strings.TrimSuffix(base, ext), heuristicHash)
+	if rawKeys {
+		name += "-raw"
+	}
+	return name + ext
+}
+
+// openSharedColdTier points the shared tier at cfg's file, closing the one it
+// replaces. It does nothing when the open tier already matches cfg, so it can
+// run after every config update.
+func openSharedColdTier(cfg Config) {
+	path := ""
+	if cfg.AiEnableTtCold && cfg.AiTtColdPath != "" {
+		path = coldTierPath(resolveTTPersistencePath(cfg.AiTtColdPath), heuristicHashFromConfig(cfg), !cfg.AiTtSymmetry)
+	}
+	old := SharedColdTier()
+	if old != nil && old.path == path {
+		return
+	}
+	var cold *ColdTier
+	if path != "" {
+		var err error
+		if cold, err = OpenColdTier(path, heuristicHashFromConfig(cfg), !cfg.AiTtSymmetry, cfg.AiTtColdMinDepth, cfg.AiTtColdMaxBytes); err != nil {
+			log.Printf("[ai:cold] unable to open cold tier %s: %v", path, err)
+		}
+	}
+	sharedColdTier.Store(cold)
+	if err := old.Close(); err != nil {
+		log.Printf("[ai:cold] failed to close cold tier %s: %v", old.path, err)
+	}
+}
+
+// syncSharedColdTier runs at shutdown. The tier stays open because searches
+// may still be evicting into it.
+func syncSharedColdTier() {
+	cold := SharedColdTier()
+	if cold == nil {
+		return
+	}
+	if err := cold.Sync(); err != nil {
+		log.Printf("[ai:cold] failed to sync cold tier %s: %v", cold.path, err)
+		return
+	}
+	stats := cold.Stats()
+	log.Printf("[ai:cold] synced cold tier %s (entries=%d bytes=%d hits=%d promoted=%d)", cold.path, stats.Entries, stats.Bytes, stats.Hits, stats.Promoted)
+}
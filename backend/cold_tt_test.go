@@ -0,0 +1,129 @@
+package main
+
+import (
+	"errors"
+	"os"
+	"path/filepath"
+	"testing"
+	"time"
+)
+
+func TestColdTierKeepsEvictedDeepEntriesAcrossReopen(t *testing.T) {
+	const hh = 0xfeed
+	path := filepath.Join(t.TempDir(), "cold.bin")
+	cold, err := OpenColdTier(path, hh, false, 4, 0)
+	if err != nil {
+		t.Fatal(err)
+	}
+	sharedColdTier.Store(cold)
+	defer sharedColdTier.Store(nil)
+	key := mixKey // index fingerprints need hash-like keys
+
+	// One-slot tables: each deeper store evicts the previous entry.
+	for base, tt := range map[uint64]*TranspositionTable{100: NewTranspositionTable(1, 1), 200: NewLockFreeTranspositionTable(1, 1, true)} {
+		tt.Store(key(base), hh, 6, 42, TTExact, Move{X: 3, Y: 4}, TTMeta{})
+		tt.Store(key(base+1), hh, 2, 0, TTExact, Move{}, TTMeta{}) // too shallow to evict
+		tt.Store(key(base+2), hh, 7, -5, TTExact, Move{X: 1, Y: 2}, TTMeta{})
+		tt.Store(key(base+3), hh, 9, 7, TTLower, Move{}, TTMeta{})
+	}
+	for i := uint64(0); i < coldBlockRecords; i++ {
+		cold.add(false, TTEntry{Key: key(1000 + i), HeuristicHash: hh, Depth: 5, Score: int32(i), Flag: TTExact, BestMove: Move{X: -1, Y: -1}, Valid: true})
+	}
+	cold.add(false, TTEntry{Key: key(1000), HeuristicHash: hh, Depth: 8, Score: -1, Flag: TTExact, Valid: true})
+	cold.add(false, TTEntry{Key: key(1001), HeuristicHash: hh, Depth: 3, Score: -1, Flag: TTExact, Valid: true})
+	sharedColdTier.Store(nil)
+	if err := cold.Close(); err != nil {
+		t.Fatal(err)
+	}
+
+	file, err := os.OpenFile(path, os.O_WRONLY|os.O_APPEND, 0)
+	if err != nil {
+		t.Fatal(err)
+	}
+	file.Write([]byte{9, 9, 9}) // torn block header
+	file.Close()
+
+	cold, err = OpenColdTier(path, hh, false, 4, 0)
+	if err != nil {
+		t.Fatal(err)
+	}
+	defer cold.Close()
+	if stats := cold.Stats(); stats.Entries != 4+coldBlockRecords || stats.Blocks != 2 {
+		t.Fatalf("reopened tier: %+v", stats)
+	}
+	for i, want := range map[uint64]coldRecord{
+		100:  {score: 42, depth: 6, x: 3, y: 4},
+		102:  {score: -5, depth: 7, x: 1, y: 2},
+		202:  {score: -5, depth: 7, x: 1, y: 2},
+		1000: {score: -1, depth: 8, x: 0, y: 0},
+		1001: {score: 1, depth: 5, x: -1, y: -1},
+	} {
+		want.key = key(i)
+		if got, ok := cold.Lookup(key(i)); !ok || got != want {
+			t.Fatalf("key %d: got %+v ok=%v, want %+v", i, got, ok, want)
+		}
+	}
+	for _, i := range []uint64{101, 103, 201, 203} {
+		if _, ok := cold.Lookup(key(i)); ok {
+			t.Fatalf("key %d should not be in the cold tier", i)
+		}
+	}
+
+	hot := NewTranspositionTable(16, 2)
+	cold.Prefetch(hot, key(100), hh)
+	deadline := time.Now().Add(2 * time.Second)
+	for {
+		if entry, ok := hot.Probe(key(100), hh); ok {
+			if entry.Depth != 6 || entry.Flag != TTExact || entry.Score != 42 || entry.BestMove != (Move{X: 3, Y: 4}) {
+				t.Fatalf("promoted entry: %+v", entry)
+			}
+			break
+		}
+		if time.Now().After(deadline) {
+			t.Fatalf("prefetch never promoted the entry")
+		}
+		time.Sleep(time.Millisecond)
+	}
+	if cold.Promote(hot, key(102), hh+1) {
+		t.Fatalf("an entry must not be promoted for other heuristics")
+	}
+
+	before, _ := os.Stat(path)
+	for _, other := range []struct {
+		hh  uint64
+		raw bool
+	}{{hh + 1, false}, {hh, true}} {
+		if _, err := OpenColdTier(path, other.hh, other.raw, 4, 0); !errors.Is(err, errColdTierMismatch) {
+			t.Fatalf("a tier for other heuristics or keys should be refused, got %v", err)
+		}
+	}
+	if after, _ := os.Stat(path); after.Size() != before.Size() {
+		t.Fatalf("a refused tier must be left alone, size %d -> %d", before.Size(), after.Size())
+	}
+}
+
+func TestSharedColdTierFollowsHeuristicHash(t *testing.T) {
+	cfg := DefaultConfig()
+	cfg.AiEnableTtCold = true
+	cfg.AiTtColdPath = filepath.Join(t.TempDir(), "cold.bin")
+	defer openSharedColdTier(Config{})
+
+	openSharedColdTier(cfg)
+	first := SharedColdTier()
+	if first == nil || first.path != coldTierPath(cfg.AiTtColdPath, heuristicHashFromConfig(cfg), false) {
+		t.Fatalf("tier not opened at the hashed path: %+v", first)
+	}
+	openSharedColdTier(cfg)
+	if SharedColdTier() != first {
+		t.Fatalf("an unchanged config should keep the open tier")
+	}
+	cfg.Heuristics.Open3++
+	openSharedColdTier(cfg)
+	second := SharedColdTier()
+	if second == nil || second == first || second.heuristicHash != heuristicHashFromConfig(cfg) {
+		t.Fatalf("a heuristic change should open that heuristic's tier")
+	}
+	if _, err := os.Stat(first.path); err != nil {
+		t.Fatalf("the previous tier's file should stay: %v", err)
+	}
+}
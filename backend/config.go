@@ -3,70 +3,99 @@ package main
 import "sync"
 
 type Config struct {
-	GhostMode             bool            `json:"ghost_mode"`
-	LogDepthScores        bool            `json:"log_depth_scores"`
-	AiDepth               int             `json:"ai_depth"`
-	AiTimeoutMs           int             `json:"ai_timeout_ms"`
-	AiTimeBudgetMs        int             `json:"ai_time_budget_ms"`
-	AiBacklogEstimateMs   int             `json:"ai_backlog_estimate_ms"`
-	AiMaxDepth            int             `json:"ai_max_depth"`
-	AiMinDepth            int             `json:"ai_min_depth"`
-	AiReturnLastComplete  bool            `json:"ai_return_last_complete_depth_only"`
-	AiTopCandidates       int             `json:"ai_top_candidates"`
-	AiEnableDynamicTopK   bool            `json:"ai_enable_dynamic_top_k"`
-	AiEnableHardPlyCaps   bool            `json:"ai_enable_hard_ply_caps"`
-	AiMaxCandidatesRoot   int             `json:"ai_max_candidates_root"`
-	AiMaxCandidatesMid    int             `json:"ai_max_candidates_mid"`
-	AiMaxCandidatesDeep   int             `json:"ai_max_candidates_deep"`
-	AiMaxCandidatesPly7   int             `json:"ai_max_candidates_ply7"`
-	AiMaxCandidatesPly8   int             `json:"ai_max_candidates_ply8"`
-	AiMaxCandidatesPly9   int             `json:"ai_max_candidates_ply9"`
-	AiEnableTacticalK     bool            `json:"ai_enable_tactical_k"`
-	AiKQuietRoot          int             `json:"ai_k_quiet_root"`
-	AiKQuietMid           int             `json:"ai_k_quiet_mid"`
-	AiKQuietDeep          int             `json:"ai_k_quiet_deep"`
-	AiKTactRoot           int             `json:"ai_k_tact_root"`
-	AiKTactMid            int             `json:"ai_k_tact_mid"`
-	AiKTactDeep           int             `json:"ai_k_tact_deep"`
-	AiQuickWinExit        bool            `json:"ai_quick_win_exit"`
-	AiEnableAspiration    bool            `json:"ai_enable_aspiration"`
-	AiAspWindow           float64         `json:"ai_asp_window"`
-	AiAspWindowMax        float64         `json:"ai_asp_window_max"`
-	AiTtMaxEntries        int64           `json:"ai_tt_max_entries"`
-	AiPonderingEnabled    bool            `json:"ai_pondering_enabled"`
-	AiGhostThrottleMs     int             `json:"ai_ghost_throttle_ms"`
-	AiTtSize              int             `json:"ai_tt_size"`
-	AiTtBuckets           int             `json:"ai_tt_buckets"`
-	AiTtUseSetAssoc       bool            `json:"ai_tt_use_set_assoc"`
-	AiUseTtCache          bool            `json:"ai_use_tt_cache"`
-	AiTtMaxMemoryBytes    int64           `json:"ai_tt_max_memory_bytes"`
-	AiEnableTtPersistence bool            `json:"ai_enable_tt_persistence"`
-	AiTtPersistencePath   string          `json:"ai_tt_persistence_path"`
-	AiEnableRootTranspose bool            `json:"ai_enable_root_transpose_tt"`
-	AiRootTransposeSize   int             `json:"ai_root_transpose_tt_size"`
-	AiLogSearchStats      bool            `json:"ai_log_search_stats"`
-	AiMinmaxCacheLimit    int             `json:"ai_minmax_cache_limit"`
-	AiEnableKillerMoves   bool            `json:"ai_enable_killer_moves"`
-	AiEnableHistoryMoves  bool            `json:"ai_enable_history_moves"`
-	AiKillerBoost         int             `json:"ai_killer_boost"`
-	AiHistoryBoost        int             `json:"ai_history_boost"`
-	AiUseScanWinIn1       bool            `json:"ai_use_scan_win_in_1"`
-	AiEnableTacticalMode  bool            `json:"ai_enable_tactical_mode"`
-	AiEnableTacticalExt   bool            `json:"ai_enable_tactical_extension"`
-	AiTacticalExtDepth    int             `json:"ai_tactical_extension_depth"`
-	AiEnableEvalCache     bool            `json:"ai_enable_eval_cache"`
-	AiEvalCacheSize       int             `json:"ai_eval_cache_size"`
-	AiEvalCacheMinAbs     float64         `json:"ai_eval_cache_min_abs"`
-	AiEnableLostMode      bool            `json:"ai_enable_lost_mode"`
-	AiLostModeThreshold   float64         `json:"ai_lost_mode_threshold"`
-	AiLostModeMaxMoves    int             `json:"ai_lost_mode_max_moves"`
-	AiLostModeReplyLimit  int             `json:"ai_lost_mode_reply_limit"`
-	AiLostModeMinDepth    int             `json:"ai_lost_mode_min_depth"`
-	AiQueueWorkers        int             `json:"ai_queue_workers"`
-	AiQueueAnalyzeThreads int             `json:"ai_queue_analyze_threads"`
-	AiQueueEnabled        bool            `json:"ai_enable_queue"`
-	AiAnaliticsTopBoards  int             `json:"ai_analitics_top_boards"`
-	Heuristics            HeuristicConfig `json:"heuristics"`
+	GhostMode              bool            `json:"ghost_mode"`
+	LogDepthScores         bool            `json:"log_depth_scores"`
+	AiDepth                int             `json:"ai_depth"`
+	AiTimeoutMs            int             `json:"ai_timeout_ms"`
+	AiTimeBudgetMs         int             `json:"ai_time_budget_ms"`
+	AiAdaptiveTime         bool            `json:"ai_adaptive_time"`
+	AiTimeSoftPercent      int             `json:"ai_time_soft_percent"`
+	AiBacklogEstimateMs    int             `json:"ai_backlog_estimate_ms"`
+	AiMaxDepth             int             `json:"ai_max_depth"`
+	AiMinDepth             int             `json:"ai_min_depth"`
+	AiReturnLastComplete   bool            `json:"ai_return_last_complete_depth_only"`
+	AiTopCandidates        int             `json:"ai_top_candidates"`
+	AiEnableDynamicTopK    bool            `json:"ai_enable_dynamic_top_k"`
+	AiEnableHardPlyCaps    bool            `json:"ai_enable_hard_ply_caps"`
+	AiMaxCandidatesRoot    int             `json:"ai_max_candidates_root"`
+	AiMaxCandidatesMid     int             `json:"ai_max_candidates_mid"`
+	AiMaxCandidatesDeep    int             `json:"ai_max_candidates_deep"`
+	AiMaxCandidatesPly7    int             `json:"ai_max_candidates_ply7"`
+	AiMaxCandidatesPly8    int             `json:"ai_max_candidates_ply8"`
+	AiMaxCandidatesPly9    int             `json:"ai_max_candidates_ply9"`
+	AiEnableTacticalK      bool            `json:"ai_enable_tactical_k"`
+	AiKQuietRoot           int             `json:"ai_k_quiet_root"`
+	AiKQuietMid            int             `json:"ai_k_quiet_mid"`
+	AiKQuietDeep           int             `json:"ai_k_quiet_deep"`
+	AiKTactRoot            int             `json:"ai_k_tact_root"`
+	AiKTactMid             int             `json:"ai_k_tact_mid"`
+	AiKTactDeep            int             `json:"ai_k_tact_deep"`
+	AiQuickWinExit         bool            `json:"ai_quick_win_exit"`
+	AiEnableThreatSolver   bool            `json:"ai_enable_threat_solver"`
+	AiThreatSolverDepth    int             `json:"ai_threat_solver_depth"`
+	AiThreatSolverVctDepth int             `json:"ai_threat_solver_vct_depth"`
+	AiThreatSolverMaxNodes int             `json:"ai_threat_solver_max_nodes"`
+	AiEnableAspiration     bool            `json:"ai_enable_aspiration"`
+	AiAspWindow            float64         `json:"ai_asp_window"`
+	AiAspWindowMax         float64         `json:"ai_asp_window_max"`
+	AiEnablePVS            bool            `json:"ai_enable_pvs"`
+	AiTtMaxEntries         int64           `json:"ai_tt_max_entries"`
+	AiPonderingEnabled     bool            `json:"ai_pondering_enabled"`
+	AiPonderReplies        int             `json:"ai_ponder_replies"`
+	AiPonderReplyDepth     int             `json:"ai_ponder_reply_depth"`
+	AiGhostThrottleMs      int             `json:"ai_ghost_throttle_ms"`
+	AiTtSize               int             `json:"ai_tt_size"`
+	AiTtBuckets            int             `json:"ai_tt_buckets"`
+	AiTtUseSetAssoc        bool            `json:"ai_tt_use_set_assoc"`
+	AiTtLockFree           bool            `json:"ai_tt_lock_free"`
+	AiTtLockFreeMeta       bool            `json:"ai_tt_lock_free_meta"`
+	AiTtSymmetry           bool            `json:"ai_tt_symmetry"`
+	AiUseTtCache           bool            `json:"ai_use_tt_cache"`
+	AiTtMaxMemoryBytes     int64           `json:"ai_tt_max_memory_bytes"`
+	AiCachePartitioned     bool            `json:"ai_cache_partitioned"`
+	AiCachePoolMaxBytes    int64           `json:"ai_cache_pool_max_bytes"`
+	AiEnableTtPersistence  bool            `json:"ai_enable_tt_persistence"`
+	AiTtPersistencePath    string          `json:"ai_tt_persistence_path"`
+	AiEnableRootTranspose  bool            `json:"ai_enable_root_transpose_tt"`
+	AiRootTransposeSize    int             `json:"ai_root_transpose_tt_size"`
+	AiEnableBook           bool            `json:"ai_enable_book"`
+	AiBookPath             string          `json:"ai_book_path"`
+	AiBookWritable         bool            `json:"ai_book_writable"`
+	AiBookSlots            int             `json:"ai_book_slots"`
+	AiEnableTtCold         bool            `json:"ai_enable_tt_cold"`
+	AiTtColdPath           string          `json:"ai_tt_cold_path"`
+	AiTtColdMinDepth       int             `json:"ai_tt_cold_min_depth"`
+	AiTtColdProbePly       int             `json:"ai_tt_cold_probe_ply"`
+	AiTtColdMaxBytes       int64           `json:"ai_tt_cold_max_bytes"`
+	AiLogSearchStats       bool            `json:"ai_log_search_stats"`
+	AiSearchTrace          bool            `json:"ai_search_trace"`
+	AiSearchTraceEvents    int             `json:"ai_search_trace_events"`
+	AiEnablePprof          bool            `json:"ai_enable_pprof"`
+	AiMinmaxCacheLimit     int             `json:"ai_minmax_cache_limit"`
+	AiEnableKillerMoves    bool            `json:"ai_enable_killer_moves"`
+	AiEnableHistoryMoves   bool            `json:"ai_enable_history_moves"`
+	AiReuseSearchTree      bool            `json:"ai_reuse_search_tree"`
+	AiKillerBoost          int             `json:"ai_killer_boost"`
+	AiHistoryBoost         int             `json:"ai_history_boost"`
+	AiUseScanWinIn1        bool            `json:"ai_use_scan_win_in_1"`
+	AiEnableTacticalMode   bool            `json:"ai_enable_tactical_mode"`
+	AiEnableTacticalExt    bool            `json:"ai_enable_tactical_extension"`
+	AiTacticalExtDepth     int             `json:"ai_tactical_extension_depth"`
+	AiEnableEvalCache      bool            `json:"ai_enable_eval_cache"`
+	AiEvalCacheSize        int             `json:"ai_eval_cache_size"`
+	AiEvalCacheMinAbs      float64         `json:"ai_eval_cache_min_abs"`
+	AiEnableLostMode       bool            `json:"ai_enable_lost_mode"`
+	AiLostModeThreshold    float64         `json:"ai_lost_mode_threshold"`
+	AiLostModeMaxMoves     int             `json:"ai_lost_mode_max_moves"`
+	AiLostModeReplyLimit   int             `json:"ai_lost_mode_reply_limit"`
+	AiLostModeMinDepth     int             `json:"ai_lost_mode_min_depth"`
+	AiQueueWorkers         int             `json:"ai_queue_workers"`
+	AiQueueAnalyzeThreads  int             `json:"ai_queue_analyze_threads"`
+	AiSearchParallelMode   string          `json:"ai_search_parallel_mode"`
+	AiLazySmpHelpers       int             `json:"ai_lazy_smp_helpers"`
+	AiQueueEnabled         bool            `json:"ai_enable_queue"`
+	AiAnaliticsTopBoards   int             `json:"ai_analitics_top_boards"`
+	Heuristics             HeuristicConfig `json:"heuristics"`
 }
 
 type HeuristicConfig struct {
@@ -109,6 +138,8 @@ func DefaultConfig() Config {
 
 		// Time budget mode
 		AiTimeBudgetMs:       500,
+		AiAdaptiveTime:       true, // stop starting depths at a soft limit that tracks best-move stability
+		AiTimeSoftPercent:    50,   // base soft limit, percent of the hard time budget
 		AiBacklogEstimateMs:  120000,
 		AiTimeoutMs:          0,
 		AiDepth:              10,
@@ -155,12 +186,21 @@ func DefaultConfig() Config {
 		AiUseScanWinIn1: true,
 		AiQuickWinExit:  true,
 
+		// Threat-space solver: proves VCF/VCT wins before the full-width search
+		AiEnableThreatSolver:   true,
+		AiThreatSolverDepth:    12,   // attacker threat moves per line
+		AiThreatSolverVctDepth: 2,    // threes allowed per line, 0 for VCF only
+		AiThreatSolverMaxNodes: 1000, // per root search, about 40ms at worst
+
 		// Aspiration ON (small window -> fewer nodes, usually faster)
 		// If it causes too many re-searches, increase window (not disable immediately).
 		AiEnableAspiration: true,
 		AiAspWindow:        1200.0,
 		AiAspWindowMax:     2000000000.0,
 
+		// PVS: later moves get a null window, re-searched only on fail-high
+		AiEnablePVS: true,
+
 		// Caches
 		AiEnableEvalCache: true,
 		AiEvalCacheSize:   1 << 19, // 524288
@@ -176,24 +216,41 @@ func DefaultConfig() Config {
 		// Queue
 		AiQueueWorkers:        1,
 		AiQueueAnalyzeThreads: 0,
+		AiSearchParallelMode:  "ybwc", // "ybwc" root split or "lazy_smp" shared-TT helpers
+		AiLazySmpHelpers:      0,      // helpers beside live searches in lazy_smp mode
 		AiQueueEnabled:        true,
 		AiAnaliticsTopBoards:  7,
 
 		// TT: slightly larger than 1<<18 helps a lot once you deepen regularly
 		AiTtUseSetAssoc:       true,
+		AiTtLockFree:          false, // packed two-word entries, no stripe locks
+		AiTtLockFreeMeta:      true,  // side table for hits/growth meta in lock-free mode
+		AiTtSymmetry:          true,  // one entry per position up to rotation/reflection
 		AiUseTtCache:          true,
 		AiTtBuckets:           4,
 		AiTtSize:              1 << 19, // 524288
 		AiTtMaxEntries:        0,
 		AiTtMaxMemoryBytes:    5 * 1024 * 1024 * 1024, // 5 GB
+		AiCachePartitioned:    false,                  // one TT per game and heuristic profile instead of one shared TT
+		AiCachePoolMaxBytes:   2 * 1024 * 1024 * 1024, // 2 GB across partitions, least recently used dropped first
 		AiEnableTtPersistence: true,
-		AiTtPersistencePath:   "tt_cache.gob",
+		AiTtPersistencePath:   "tt_cache.bin",
 		AiEnableRootTranspose: true,
 		AiRootTransposeSize:   1 << 16, // 65536
+		AiEnableBook:          true,
+		AiBookPath:            "position_book.bin",
+		AiBookWritable:        true,    // replicas sharing one book should set this to false
+		AiBookSlots:           1 << 18, // 16 bytes per slot
+		AiEnableTtCold:        false,   // spill deep EXACT TT evictions to a compressed file
+		AiTtColdPath:          "tt_cold.bin",
+		AiTtColdMinDepth:      4,                      // shallower entries stay hot-only
+		AiTtColdProbePly:      2,                      // hot misses this close to the root prefetch from disk
+		AiTtColdMaxBytes:      8 * 1024 * 1024 * 1024, // 8 GB, then the tier stops growing
 
 		// Move ordering helpers
 		AiEnableKillerMoves:  true,
 		AiEnableHistoryMoves: true,
+		AiReuseSearchTree:    true, // carry PV, killers and history to the next move
 
 		// Boosts: keep killer moderate, history moderate
 		AiKillerBoost:  6000,
@@ -201,10 +258,15 @@ func DefaultConfig() Config {
 
 		// Background pondering off for latency
 		AiPonderingEnabled: false,
-
-		AiGhostThrottleMs:  50,
-		AiLogSearchStats:   false,
-		AiMinmaxCacheLimit: 1000,
+		AiPonderReplies:    3, // on the opponent's turn, ponder this many predicted replies; 0 ponders the position itself
+		AiPonderReplyDepth: 2, // depth of the search that ranks those replies
+
+		AiGhostThrottleMs:   50,
+		AiLogSearchStats:    false,
+		AiSearchTrace:       false,   // record move searches for GET /api/debug/trace
+		AiSearchTraceEvents: 1 << 16, // events kept per search goroutine, 24 bytes each
+		AiEnablePprof:       false,   // serve net/http/pprof under /debug/pprof/
+		AiMinmaxCacheLimit:  1000,
 
 		Heuristics: HeuristicConfig{
 			Open4:   131633.82492556606,
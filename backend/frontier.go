@@ -0,0 +1,82 @@
+package main
+
+// frontier counts, for every intersection, the stones within proximityRadius
+// (Chebyshev). near has a bit for each cell with a nonzero count, so the
+// proximity candidates are near minus the occupied cells.
+type frontier struct {
+	counts [maxBoardSize * maxBoardSize]uint8
+	near   [maxBoardSize]uint32
+}
+
+func (f *frontier) rebuild(board *Board) {
+	*f = frontier{}
+	size := board.Size()
+	for y := 0; y < size; y++ {
+		for x := 0; x < size; x++ {
+			if board.At(x, y) != CellEmpty {
+				f.add(size, x, y)
+			}
+		}
+	}
+}
+
+func (f *frontier) add(size, x, y int) {
+	for ny := max(y-proximityRadius, 0); ny <= min(y+proximityRadius, size-1); ny++ {
+		row := ny * maxBoardSize
+		for nx := max(x-proximityRadius, 0); nx <= min(x+proximityRadius, size-1); nx++ {
+			f.counts[row+nx]++
+			f.near[ny] |= 1 << uint(nx)
+		}
+	}
+}
+
+func (f *frontier) remove(size, x, y int) {
+	for ny := max(y-proximityRadius, 0); ny <= min(y+proximityRadius, size-1); ny++ {
+		row := ny * maxBoardSize
+		for nx := max(x-proximityRadius, 0); nx <= min(x+proximityRadius, size-1); nx++ {
+			f.counts[row+nx]--
+			if f.counts[row+nx] == 0 {
+				f.near[ny] &^= 1 << uint(nx)
+			}
+		}
+	}
+}
+
+// applyMove records a placed stone and the stones it captured.
+func (f *frontier) applyMove(size int, move Move, captures []Move) {
+	f.add(size, move.X, move.Y)
+	for _, captured := range captures {
+		f.remove(size, captured.X, captured.Y)
+	}
+}
+
+func (f *frontier) undoMove(size int, move Move, captures []Move) {
+	for _, captured := range captures {
+		f.add(size, captured.X, captured.Y)
+	}
+	f.remove(size, move.X, move.Y)
+}
+
+func (s *GameState) refreshFrontier() {
+	s.Frontier.rebuild(&s.Board)
+	s.FrontierHash = s.Hash
+	s.FrontierValid = true
+}
+
+func (s *GameState) frontierCurrent() bool {
+	return s.FrontierValid && s.FrontierHash == s.Hash
+}
+
+// proximityMask returns the empty cells within proximityRadius of a stone,
+// from the frontier when it is current and from a board scan otherwise.
+func (s *GameState) proximityMask() [maxBoardSize]uint32 {
+	if !s.frontierCurrent() {
+		return s.Board.NeighborMask(proximityRadius)
+	}
+	var out [maxBoardSize]uint32
+	size := s.Board.Size()
+	for y := 0; y < size; y++ {
+		out[y] = s.Frontier.near[y] &^ s.Board.Occupied(y)
+	}
+	return out
+}
@@ -0,0 +1,49 @@
+package main
+
+import "testing"
+
+func TestFrontierTracksMovesCapturesAndUndo(t *testing.T) {
+	settings := DefaultGameSettings()
+	settings.BoardSize = 9
+	settings.ForbidDoubleThreeBlack = false
+	rules := NewRules(settings)
+	state := DefaultGameState(settings)
+	state.Status = StatusRunning
+	state.ToMove = PlayerBlack
+	state.refreshFrontier()
+
+	checkFrontier := func(label string) {
+		t.Helper()
+		if !state.frontierCurrent() {
+			t.Fatalf("expected frontier to stay current %s", label)
+		}
+		var want frontier
+		want.rebuild(&state.Board)
+		if state.Frontier != want {
+			t.Fatalf("frontier diverged from rebuild %s", label)
+		}
+		if got, scan := state.proximityMask(), state.Board.NeighborMask(proximityRadius); got != scan {
+			t.Fatalf("proximity mask mismatch %s: got %v want %v", label, got, scan)
+		}
+	}
+
+	// Black (3,4) then (6,4) captures the white pair at (4,4)-(5,4).
+	moves := []Move{{X: 3, Y: 4}, {X: 4, Y: 4}, {X: 0, Y: 0}, {X: 5, Y: 4}, {X: 6, Y: 4}}
+	undos := make([]searchMoveUndo, len(moves))
+	for i, move := range moves {
+		if !applyMoveWithUndo(&state, rules, move, state.ToMove, &undos[i]) {
+			t.Fatalf("expected move %d (%d,%d) to be legal", i, move.X, move.Y)
+		}
+		checkFrontier("after move")
+	}
+	if undos[len(undos)-1].captureCount != 2 {
+		t.Fatalf("expected last move to capture a pair, got %d", undos[len(undos)-1].captureCount)
+	}
+	for i := len(moves) - 1; i >= 0; i-- {
+		undoMoveWithUndo(&state, undos[i])
+		checkFrontier("after undo")
+	}
+	if state.Frontier != (frontier{}) {
+		t.Fatalf("expected empty frontier after undoing every move")
+	}
+}
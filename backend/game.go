@@ -2,9 +2,12 @@ package main
 
 import (
 	"fmt"
+	"sync/atomic"
 	"time"
 )
 
+var nextGameCacheID atomic.Uint64
+
 type Game struct {
 	settings           GameSettings
 	rules              Rules
@@ -18,6 +21,8 @@ type Game struct {
 	coordWidth         int
 	captureWidth       int
 	timeWidth          int
+	cacheID            string // pool partition of this game's AI searches
+	headless           bool   // batch match: headless AIs, no move suggestion
 }
 
 func NewGame(settings GameSettings) Game {
@@ -28,6 +33,9 @@ func NewGame(settings GameSettings) Game {
 
 func (g *Game) Reset(settings GameSettings) {
 	g.stopMoveSuggestion(nil)
+	if g.cacheID == "" {
+		g.cacheID = fmt.Sprintf("game-%d", nextGameCacheID.Add(1))
+	}
 	g.settings = settings
 	g.rules = NewRules(settings)
 	g.state.Reset(settings)
@@ -315,25 +323,37 @@ func (g *Game) playerForColor(color PlayerColor) IPlayer {
 }
 
 func (g *Game) createPlayers() {
+	newAI := NewAIPlayer
+	if g.headless {
+		newAI = newHeadlessAIPlayer
+	}
 	if g.settings.BlackType == PlayerHuman {
 		g.blackPlayer = NewHumanPlayer()
 	} else {
-		ai := NewAIPlayer()
+		ai := newAI()
 		ai.SetHeuristicsOverride(g.settings.BlackHeuristics)
+		ai.SetCachePartition(g.cacheID)
 		g.blackPlayer = ai
 	}
 	if g.settings.WhiteType == PlayerHuman {
 		g.whitePlayer = NewHumanPlayer()
 	} else {
-		ai := NewAIPlayer()
+		ai := newAI()
 		ai.SetHeuristicsOverride(g.settings.WhiteHeuristics)
+		ai.SetCachePartition(g.cacheID)
 		g.whitePlayer = ai
 	}
-	if g.moveSuggestionAI == nil {
+	if g.moveSuggestionAI == nil && !g.headless {
 		g.moveSuggestionAI = NewAIPlayer()
+		g.moveSuggestionAI.SetCachePartition(g.cacheID)
 	}
 }
 
+// CacheID names this game's partition in the search cache pool.
+func (g *Game) CacheID() string {
+	return g.cacheID
+}
+
 func (g *Game) syncAIPlayersToCurrentState() {
 	if aiBlack, ok := g.blackPlayer.(*AIPlayer); ok {
 		aiBlack.OnMoveApplied(g.state, g.rules)
@@ -429,12 +449,13 @@ func (g *Game) ResetForConfigChange() {
 func (g *Game) startMoveSuggestion(ghostSink func(ghostPayload)) {
 	if g.moveSuggestionAI == nil {
 		g.moveSuggestionAI = NewAIPlayer()
+		g.moveSuggestionAI.SetCachePartition(g.cacheID)
 	}
 	state := g.state.Clone()
 	if state.Hash == 0 {
 		state.recomputeHashes()
 	}
-	hash := ttKeyFor(state, state.Board.Size())
+	hash := orientedKeyFor(&state, state.Board.Size())
 	if g.moveSuggestionHash == hash && (g.moveSuggestionAI.IsThinking() || g.moveSuggestionAI.HasMoveReady()) {
 		return
 	}
@@ -449,8 +470,8 @@ func (g *Game) startMoveSuggestion(ghostSink func(ghostPayload)) {
 	suggestionConfig.AiTimeoutMs = 0
 	suggestionConfig.AiTimeBudgetMs = 0
 	heuristicHash := heuristicHashFromConfig(suggestionConfig)
-	if tt := ensureTT(SharedSearchCache(), suggestionConfig); tt != nil {
-		if entry, ok := tt.Probe(hash, heuristicHash); ok && entry.Flag == TTExact && entry.BestMove.IsValid(state.Board.Size()) {
+	if tt := ensureTT(g.moveSuggestionAI.searchCache(suggestionConfig), suggestionConfig); tt != nil {
+		if entry, ok := tt.ProbeState(&state, tt.KeyFor(&state, state.Board.Size()), heuristicHash); ok && entry.Flag == TTExact && entry.BestMove.IsValid(state.Board.Size()) {
 			if legal, _ := g.rules.IsLegal(state, entry.BestMove, state.ToMove); legal {
 				knownDepth := entry.Depth
 				if knownDepth > 10 {
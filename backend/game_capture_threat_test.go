@@ -73,12 +73,3 @@ func TestGameDoesNotStopBeforeTenthCaptureWithoutEnoughCapturedPairs(t *testing.
 		t.Fatalf("expected no threatened capture pair, got %+v", g.state.WinningCapturePair)
 	}
 }
-
-func containsMove(moves []Move, target Move) bool {
-	for _, move := range moves {
-		if move.Equals(target) {
-			return true
-		}
-	}
-	return false
-}
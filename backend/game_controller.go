@@ -32,7 +32,11 @@ func (gc *GameController) ApplyHumanMove(move Move) (bool, string) {
 	if !gc.game.CurrentPlayerIsHuman() {
 		return false, "not human turn"
 	}
-	return gc.game.TryApplyMove(move)
+	ok, reason := gc.game.TryApplyMove(move)
+	if ok {
+		searchBacklogManager.recordVisit(gc.game.state)
+	}
+	return ok, reason
 }
 
 func (gc *GameController) Tick() bool {
@@ -42,7 +46,11 @@ func (gc *GameController) Tick() bool {
 	if gc.ghostEnabled != nil {
 		ghostEnabled = gc.ghostEnabled()
 	}
-	return gc.game.Tick(ghostEnabled, gc.ghostPublisher)
+	applied := gc.game.Tick(ghostEnabled, gc.ghostPublisher)
+	if applied {
+		searchBacklogManager.recordVisit(gc.game.state)
+	}
+	return applied
 }
 
 func (gc *GameController) State() GameState {
@@ -57,6 +65,12 @@ func (gc *GameController) Settings() GameSettings {
 	return gc.game.settings
 }
 
+func (gc *GameController) CacheID() string {
+	gc.mu.Lock()
+	defer gc.mu.Unlock()
+	return gc.game.CacheID()
+}
+
 func (gc *GameController) History() MoveHistory {
 	gc.mu.Lock()
 	defer gc.mu.Unlock()
@@ -33,6 +33,19 @@ type GameState struct {
 	LastMessage        string
 	WinningLine        []Move
 	WinningCapturePair []Move
+	// EvalTotals are maintained incrementally by the search; they describe the
+	// board only while EvalValid is set and EvalHash matches Hash.
+	EvalTotals EvalTotals
+	EvalHash   uint64
+	EvalValid  bool
+	// Frontier follows the same validity rule with FrontierHash.
+	Frontier      frontier
+	FrontierHash  uint64
+	FrontierValid bool
+	// Legality follows it too, with LegalityHash.
+	Legality      legalityMasks
+	LegalityHash  uint64
+	LegalityValid bool
 }
 
 func DefaultGameState(settings GameSettings) GameState {
@@ -61,16 +74,18 @@ func (s *GameState) Reset(settings GameSettings) {
 	s.LastMessage = ""
 	s.WinningLine = nil
 	s.WinningCapturePair = nil
+	s.EvalValid = false
+	s.FrontierValid = false
+	s.LegalityValid = false
 	s.recomputeHashes()
 }
 
+// Clone returns an independent copy of s without allocating. The board and
+// the incremental search state are plain values. ForcedCaptureMoves,
+// WinningLine and WinningCapturePair are shared: only the game sets them, and
+// it always assigns a new slice rather than writing into one.
 func (s GameState) Clone() GameState {
-	clone := s
-	clone.Board = s.Board.Clone()
-	clone.ForcedCaptureMoves = append([]Move(nil), s.ForcedCaptureMoves...)
-	clone.WinningLine = append([]Move(nil), s.WinningLine...)
-	clone.WinningCapturePair = append([]Move(nil), s.WinningCapturePair...)
-	return clone
+	return s
 }
 
 func otherPlayer(player PlayerColor) PlayerColor {
@@ -86,3 +101,13 @@ func (s *GameState) recomputeHashes() {
 	s.HashSym = sym
 	s.CanonHash = canonicalSymHash(sym)
 }
+
+func (s *GameState) refreshEvalTotals() {
+	s.EvalTotals = computeEvalTotals(s.Board)
+	s.EvalHash = s.Hash
+	s.EvalValid = true
+}
+
+func (s *GameState) evalTotalsCurrent() bool {
+	return s.EvalValid && s.EvalHash == s.Hash
+}
@@ -1,8 +1,8 @@
 package main
 
 import (
-	"encoding/json"
 	"net/http"
+	"sort"
 	"sync"
 
 	"github.com/gorilla/websocket"
@@ -24,18 +24,26 @@ type ghostPayload struct {
 	HistoryLen int         `json:"history_len,omitempty"`
 	Active     bool        `json:"active"`
 	Final      bool        `json:"final,omitempty"`
+	// Changes carries a preview_delta frame: the cells that differ from the
+	// client's previous preview board, 0 for a cell that emptied.
+	Changes []cellChange `json:"changes,omitempty"`
 }
 
 type GhostClient struct {
-	hub  *GhostHub
-	conn *websocket.Conn
-	send chan []byte
+	hub           *GhostHub
+	conn          *websocket.Conn
+	send          chan []byte
+	needsKeyframe bool // next preview must be a full preview_board; guarded by hub.mu
 }
 
+// GhostHub sends preview boards as preview_delta frames against the last
+// preview. A client that just joined or dropped a frame gets the full
+// preview_board instead.
 type GhostHub struct {
 	mu        sync.Mutex
 	clients   map[*GhostClient]struct{}
 	broadcast chan ghostPayload
+	preview   map[[2]int]int // last preview board's stones, nil before any; owned by publish
 }
 
 func NewGhostHub() *GhostHub {
@@ -51,21 +59,91 @@ func (h *GhostHub) Run(done <-chan struct{}) {
 		case <-done:
 			return
 		case payload := <-h.broadcast:
-			h.mu.Lock()
-			if len(h.clients) == 0 {
-				h.mu.Unlock()
-				continue
-			}
-			for client := range h.clients {
-				client.sendJSON(wsMessage{Type: "ghost", Payload: mustMarshal(payload)})
-			}
-			h.mu.Unlock()
+			h.publish(payload)
+		}
+	}
+}
+
+// publish runs on the Run goroutine only. Frames are encoded before h.mu is
+// taken, so the lock only covers the fan-out.
+func (h *GhostHub) publish(payload ghostPayload) {
+	h.mu.Lock()
+	idle := len(h.clients) == 0
+	h.mu.Unlock()
+	if idle {
+		h.preview = nil
+		return
+	}
+	if payload.Mode != "preview_board" {
+		frame := encodeWSFrame("ghost", payload)
+		if frame == nil {
+			return
+		}
+		h.mu.Lock()
+		for client := range h.clients {
+			client.sendFrame(frame)
+		}
+		h.mu.Unlock()
+		return
+	}
+	cells := make(map[[2]int]int, len(payload.Positions))
+	for _, pos := range payload.Positions {
+		cells[[2]int{pos.X, pos.Y}] = pos.Player
+	}
+	var delta []byte
+	unchanged := false
+	if h.preview != nil {
+		changes := ghostPreviewChanges(h.preview, cells)
+		unchanged = len(changes) == 0
+		if !unchanged && len(changes) < len(payload.Positions) {
+			delta = encodeWSFrame("ghost", ghostPayload{Mode: "preview_delta", Changes: changes, Active: payload.Active})
 		}
 	}
+	keyframe := encodeWSFrame("ghost", payload)
+	if keyframe == nil {
+		return
+	}
+	h.preview = cells
+	h.mu.Lock()
+	defer h.mu.Unlock()
+	for client := range h.clients {
+		if unchanged && !client.needsKeyframe {
+			continue
+		}
+		frame := delta
+		if frame == nil || client.needsKeyframe {
+			frame = keyframe
+		}
+		client.needsKeyframe = !client.sendFrame(frame)
+	}
+}
+
+// ghostPreviewChanges lists the cells that differ between two previews in
+// row-major order.
+func ghostPreviewChanges(prev, next map[[2]int]int) []cellChange {
+	changes := []cellChange{}
+	for pos, player := range next {
+		if prev[pos] != player {
+			changes = append(changes, cellChange{X: pos[0], Y: pos[1], Value: player})
+		}
+	}
+	for pos := range prev {
+		if _, ok := next[pos]; !ok {
+			changes = append(changes, cellChange{X: pos[0], Y: pos[1], Value: 0})
+		}
+	}
+	sort.Slice(changes, func(i, j int) bool {
+		if changes[i].Y != changes[j].Y {
+			return changes[i].Y < changes[j].Y
+		}
+		return changes[i].X < changes[j].X
+	})
+	return changes
 }
 
 func (h *GhostHub) Register(c *GhostClient) {
 	h.mu.Lock()
+	c.needsKeyframe = true
 	h.clients[c] = struct{}{}
 	h.mu.Unlock()
 }
@@ -92,14 +170,12 @@ func (h *GhostHub) HasClients() bool {
 	return len(h.clients) > 0
 }
 
-func (c *GhostClient) sendJSON(msg wsMessage) {
-	data, err := json.Marshal(msg)
-	if err != nil {
-		return
-	}
+func (c *GhostClient) sendFrame(frame []byte) bool {
 	select {
-	case c.send <- data:
+	case c.send <- frame:
+		return true
 	default:
+		return false
 	}
 }
 
@@ -52,39 +52,36 @@ func (h *Hub) Run(done <-chan struct{}) {
 		case <-done:
 			return
 		case payload := <-h.broadcastBoard:
-			h.mu.Lock()
-			for client := range h.clients {
-				client.sendJSON(wsMessage{Type: "board", Payload: mustMarshal(payload)})
-			}
-			h.mu.Unlock()
+			h.broadcast("board", payload)
 		case payload := <-h.broadcastHistory:
-			h.mu.Lock()
-			for client := range h.clients {
-				client.sendJSON(wsMessage{Type: "history", Payload: mustMarshal(payload)})
-			}
-			h.mu.Unlock()
+			h.broadcast("history", payload)
 		case payload := <-h.broadcastStatus:
-			h.mu.Lock()
-			for client := range h.clients {
-				client.sendJSON(wsMessage{Type: "status", Payload: mustMarshal(payload)})
-			}
-			h.mu.Unlock()
+			h.broadcast("status", payload)
 		case payload := <-h.broadcastReset:
-			h.mu.Lock()
-			for client := range h.clients {
-				client.sendJSON(wsMessage{Type: "reset", Payload: mustMarshal(payload)})
-			}
-			h.mu.Unlock()
+			h.broadcast("reset", payload)
 		case payload := <-h.broadcastSettings:
-			h.mu.Lock()
-			for client := range h.clients {
-				client.sendJSON(wsMessage{Type: "settings", Payload: mustMarshal(payload)})
-			}
-			h.mu.Unlock()
+			h.broadcast("settings", payload)
 		}
 	}
 }
 
+// broadcast encodes payload once, outside the lock, and queues the same
+// frame on every client.
+func (h *Hub) broadcast(msgType string, payload any) {
+	if !h.HasClients() {
+		return
+	}
+	frame := encodeWSFrame(msgType, payload)
+	if frame == nil {
+		return
+	}
+	h.mu.Lock()
+	for client := range h.clients {
+		client.sendFrame(frame)
+	}
+	h.mu.Unlock()
+}
+
 func (h *Hub) Register(c *Client) {
 	h.mu.Lock()
 	h.clients[c] = struct{}{}
@@ -106,13 +103,28 @@ func (h *Hub) HasClients() bool {
 	return len(h.clients) > 0
 }
 
-func (c *Client) sendJSON(msg wsMessage) {
-	data, err := json.Marshal(msg)
+// encodeWSFrame serializes a wsMessage of msgType carrying payload. The
+// frame is shared by every client it is queued on and must not be modified.
+func encodeWSFrame(msgType string, payload any) []byte {
+	body, err := json.Marshal(payload)
 	if err != nil {
-		return
+		return nil
 	}
+	frame := make([]byte, 0, len(body)+len(msgType)+24)
+	frame = append(frame, `{"type":"`...)
+	frame = append(frame, msgType...)
+	frame = append(frame, `","payload":`...)
+	frame = append(frame, body...)
+	return append(frame, '}')
+}
+
+// sendFrame queues frame without blocking and reports whether it fit; a slow
+// client loses frames rather than stalling the hub.
+func (c *Client) sendFrame(frame []byte) bool {
 	select {
-	case c.send <- data:
+	case c.send <- frame:
+		return true
 	default:
+		return false
 	}
 }
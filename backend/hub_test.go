@@ -0,0 +1,61 @@
+package main
+
+import (
+	"encoding/json"
+	"reflect"
+	"testing"
+)
+
+func TestEncodeWSFrameMatchesWSMessage(t *testing.T) {
+	payload := historyPayload{History: []historyEntryDTO{{X: 3, Y: 4, Player: 1}}}
+	want, _ := json.Marshal(wsMessage{Type: "history", Payload: mustMarshal(payload)})
+	if got := encodeWSFrame("history", payload); string(got) != string(want) {
+		t.Fatalf("frame %s, want %s", got, want)
+	}
+}
+
+func TestGhostHubSendsPreviewDeltas(t *testing.T) {
+	hub := NewGhostHub()
+	early := &GhostClient{hub: hub, send: make(chan []byte, 8)}
+	hub.Register(early)
+	decode := func(c *GhostClient) ghostPayload {
+		t.Helper()
+		select {
+		case frame := <-c.send:
+			var msg struct {
+				Payload ghostPayload `json:"payload"`
+			}
+			if err := json.Unmarshal(frame, &msg); err != nil {
+				t.Fatalf("bad frame %s: %v", frame, err)
+			}
+			return msg.Payload
+		default:
+			t.Fatalf("no frame queued")
+			return ghostPayload{}
+		}
+	}
+	preview := func(cells ...ghostCell) ghostPayload {
+		return ghostPayload{Mode: "preview_board", Positions: cells, Active: true}
+	}
+
+	hub.publish(preview(ghostCell{X: 1, Y: 1, Player: 1}, ghostCell{X: 2, Y: 1, Player: 2}, ghostCell{X: 3, Y: 3, Player: 1}))
+	if got := decode(early); got.Mode != "preview_board" || len(got.Positions) != 3 {
+		t.Fatalf("first preview: %+v", got)
+	}
+
+	late := &GhostClient{hub: hub, send: make(chan []byte, 8)}
+	hub.Register(late)
+	hub.publish(preview(ghostCell{X: 1, Y: 1, Player: 1}, ghostCell{X: 2, Y: 1, Player: 2}, ghostCell{X: 4, Y: 3, Player: 1}))
+	want := []cellChange{{X: 3, Y: 3, Value: 0}, {X: 4, Y: 3, Value: 1}}
+	if got := decode(early); got.Mode != "preview_delta" || !reflect.DeepEqual(got.Changes, want) {
+		t.Fatalf("delta: %+v", got)
+	}
+	if got := decode(late); got.Mode != "preview_board" || len(got.Positions) != 3 {
+		t.Fatalf("late client wants a keyframe, got %+v", got)
+	}
+
+	hub.publish(preview(ghostCell{X: 1, Y: 1, Player: 1}, ghostCell{X: 2, Y: 1, Player: 2}, ghostCell{X: 4, Y: 3, Player: 1}))
+	if len(early.send)+len(late.send) != 0 {
+		t.Fatalf("an unchanged preview was sent")
+	}
+}
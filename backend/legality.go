@@ -0,0 +1,219 @@
+package main
+
+import "math/bits"
+
+var threeDirections = [4][2]int{{1, 0}, {0, 1}, {1, 1}, {1, -1}}
+
+// legalityMasks holds, per side, the empty cells where a stone would be a
+// forbidden double three and the ones where it would capture. A move re-tests
+// the capture bits within three cells along its lines at once, but only marks
+// the cells within the five-cell reach of the open-three windows as stale;
+// those are re-tested when a query reaches them, since the threat solver
+// moves far more often than it asks. The masks follow Frontier's validity
+// rule with LegalityHash and are only good for rules with the same forbid
+// flags.
+type legalityMasks struct {
+	forbidden  [2][maxBoardSize]uint32
+	capture    [2][maxBoardSize]uint32
+	staleThree [maxBoardSize]uint32
+	forbid     [2]bool
+}
+
+func (r Rules) forbidsDoubleThree(player PlayerColor) bool {
+	if player == PlayerBlack {
+		return r.settings.ForbidDoubleThreeBlack
+	}
+	return r.settings.ForbidDoubleThreeWhite
+}
+
+func (m *legalityMasks) rebuild(board *Board, rules Rules) {
+	*m = legalityMasks{forbid: [2]bool{rules.forbidsDoubleThree(PlayerBlack), rules.forbidsDoubleThree(PlayerWhite)}}
+	size := board.Size()
+	for y := 0; y < size; y++ {
+		for row := board.Row(y, CellEmpty); row != 0; row &= row - 1 {
+			x := bits.TrailingZeros32(row)
+			m.refreshCapture(board, x, y)
+			m.refreshForbidden(board, x, y)
+		}
+	}
+}
+
+// update records stones placed or removed at changed.
+func (m *legalityMasks) update(board *Board, changed []Move) {
+	for _, p := range changed {
+		if m.forbid[0] || m.forbid[1] {
+			markLines(&m.staleThree, p.X, p.Y, 5)
+		}
+		m.refreshCapture(board, p.X, p.Y)
+		for _, d := range threeDirections {
+			for k := 1; k <= 3; k++ {
+				if x, y := p.X-k*d[0], p.Y-k*d[1]; board.InBounds(x, y) {
+					m.refreshCapture(board, x, y)
+				}
+				if x, y := p.X+k*d[0], p.Y+k*d[1]; board.InBounds(x, y) {
+					m.refreshCapture(board, x, y)
+				}
+			}
+		}
+	}
+}
+
+// markLines sets the cells within reach of (x, y) on its row, column and
+// diagonals.
+func markLines(mask *[maxBoardSize]uint32, x, y, reach int) {
+	for i := -reach; i <= reach; i++ {
+		row := y + i
+		if row < 0 || row >= maxBoardSize {
+			continue
+		}
+		if i == 0 {
+			span := uint32(1)<<uint(2*reach+1) - 1
+			if x >= reach {
+				mask[row] |= span << uint(x-reach)
+			} else {
+				mask[row] |= span >> uint(reach-x)
+			}
+			continue
+		}
+		mask[row] |= 1 << uint(x)
+		if x+i >= 0 && x+i < maxBoardSize {
+			mask[row] |= 1 << uint(x+i)
+		}
+		if x-i >= 0 && x-i < maxBoardSize {
+			mask[row] |= 1 << uint(x-i)
+		}
+	}
+}
+
+// isForbidden reports whether player may not play the empty cell (x, y).
+func (m *legalityMasks) isForbidden(board *Board, x, y int, player PlayerColor) bool {
+	if !m.forbid[player] {
+		return false
+	}
+	bit := uint32(1) << uint(x)
+	if m.staleThree[y]&bit != 0 {
+		m.refreshForbidden(board, x, y)
+	}
+	return m.forbidden[player][y]&bit != 0
+}
+
+func (m *legalityMasks) refreshForbidden(board *Board, x, y int) {
+	bit := uint32(1) << uint(x)
+	m.staleThree[y] &^= bit
+	for side := 0; side < 2; side++ {
+		if m.forbid[side] && forbiddenDoubleThreeAt(board, Move{X: x, Y: y}, CellFromPlayer(PlayerColor(side))) {
+			m.forbidden[side][y] |= bit
+		} else {
+			m.forbidden[side][y] &^= bit
+		}
+	}
+}
+
+// refreshCapture re-tests both sides' capture bits at (x, y) in one pass: a
+// line captures for the side opposite the two stones next to the cell.
+func (m *legalityMasks) refreshCapture(board *Board, x, y int) {
+	bit := uint32(1) << uint(x)
+	m.capture[0][y] &^= bit
+	m.capture[1][y] &^= bit
+	if !board.IsEmpty(x, y) {
+		return
+	}
+	for _, d := range threeDirections {
+		for _, sign := range [2]int{1, -1} {
+			dx, dy := sign*d[0], sign*d[1]
+			if !board.InBounds(x+3*dx, y+3*dy) {
+				continue
+			}
+			pair := board.At(x+dx, y+dy)
+			if pair == CellEmpty || board.At(x+2*dx, y+2*dy) != pair {
+				continue
+			}
+			owner := board.At(x+3*dx, y+3*dy)
+			if owner != CellEmpty && owner != pair {
+				player, _ := PlayerFromCell(owner)
+				m.capture[player][y] |= bit
+			}
+		}
+	}
+}
+
+func forbiddenDoubleThreeAt(board *Board, move Move, cell Cell) bool {
+	openThrees := 0
+	for _, d := range threeDirections {
+		if isOpenThreeInDirection(board, move, d[0], d[1], cell) {
+			openThrees++
+			if openThrees >= 2 {
+				return true
+			}
+		}
+	}
+	return false
+}
+
+func (s *GameState) refreshLegality(rules Rules) {
+	s.Legality.rebuild(&s.Board, rules)
+	s.LegalityHash = s.Hash
+	s.LegalityValid = true
+}
+
+func (s *GameState) legalityCurrent(rules Rules) bool {
+	return s.LegalityValid && s.LegalityHash == s.Hash &&
+		s.Legality.forbid[0] == rules.forbidsDoubleThree(PlayerBlack) &&
+		s.Legality.forbid[1] == rules.forbidsDoubleThree(PlayerWhite)
+}
+
+// legalInSearch answers rules.IsLegal from the legality masks when they are
+// current, without copying the state.
+func legalInSearch(state *GameState, rules Rules, move Move, player PlayerColor) bool {
+	if !state.legalityCurrent(rules) {
+		ok, _ := rules.IsLegal(*state, move, player)
+		return ok
+	}
+	if !move.IsValid(rules.settings.BoardSize) {
+		return false
+	}
+	if player == state.ToMove && state.MustCapture && !containsMove(state.ForcedCaptureMoves, move) {
+		return false
+	}
+	if !state.Board.IsEmpty(move.X, move.Y) {
+		return false
+	}
+	return !state.Legality.isForbidden(&state.Board, move.X, move.Y, player)
+}
+
+// captureMovesFromMasks is findCaptureMovesInto for a state with current
+// masks. It keeps the scan's order: by the first stone, row-major, within two
+// cells of the move, then by the move's offset from that stone.
+func captureMovesFromMasks(dst []Move, state *GameState, rules Rules, player PlayerColor) []Move {
+	moves := dst[:0]
+	for y := 0; y < state.Board.Size(); y++ {
+		for row := state.Legality.capture[player][y]; row != 0; row &= row - 1 {
+			move := Move{X: bits.TrailingZeros32(row), Y: y}
+			if !legalInSearch(state, rules, move, player) {
+				continue
+			}
+			key := captureScanKey(&state.Board, move)
+			i := len(moves)
+			moves = append(moves, move)
+			for i > 0 && captureScanKey(&state.Board, moves[i-1]) > key {
+				moves[i] = moves[i-1]
+				i--
+			}
+			moves[i] = move
+		}
+	}
+	return moves
+}
+
+func captureScanKey(board *Board, move Move) int {
+	size := board.Size()
+	for y := max(move.Y-2, 0); y <= min(move.Y+2, size-1); y++ {
+		for x := max(move.X-2, 0); x <= min(move.X+2, size-1); x++ {
+			if !board.IsEmpty(x, y) {
+				offset := (move.Y-y+2)*5 + move.X - x + 2
+				return (y*size+x)*25 + offset
+			}
+		}
+	}
+	return 0
+}
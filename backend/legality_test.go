@@ -0,0 +1,73 @@
+package main
+
+import (
+	"math/rand"
+	"testing"
+)
+
+func TestLegalityMasksMatchRulesThroughMovesAndUndo(t *testing.T) {
+	settings := DefaultGameSettings()
+	settings.BoardSize = 11
+	settings.ForbidDoubleThreeWhite = true
+	rules := NewRules(settings)
+	state := DefaultGameState(settings)
+	state.Status = StatusRunning
+	state.refreshLegality(rules)
+
+	check := func(label string) {
+		t.Helper()
+		if !state.legalityCurrent(rules) {
+			t.Fatalf("masks went stale %s", label)
+		}
+		scan := state
+		scan.LegalityValid = false
+		for _, player := range []PlayerColor{PlayerBlack, PlayerWhite} {
+			for y := 0; y < settings.BoardSize; y++ {
+				for x := 0; x < settings.BoardSize; x++ {
+					move := Move{X: x, Y: y}
+					want, _ := rules.IsLegal(state, move, player)
+					if got := legalInSearch(&state, rules, move, player); got != want {
+						t.Fatalf("legality of (%d,%d) for %d %s: got %v want %v", x, y, player, label, got, want)
+					}
+				}
+			}
+			got := findCaptureMovesInto(nil, state, rules, player)
+			want := findCaptureMovesInto(nil, scan, rules, player)
+			if len(got) != len(want) {
+				t.Fatalf("captures for %d %s: got %v want %v", player, label, got, want)
+			}
+			for i := range got {
+				if got[i] != want[i] {
+					t.Fatalf("capture order for %d %s: got %v want %v", player, label, got, want)
+				}
+			}
+		}
+	}
+
+	rng := rand.New(rand.NewSource(7))
+	var undos []searchMoveUndo
+	forbidden := 0
+	for ply := 0; ply < 60 && state.Status == StatusRunning; ply++ {
+		// Stay near the centre so lines, threes and captures form.
+		move := Move{X: 2 + rng.Intn(7), Y: 2 + rng.Intn(7)}
+		for _, player := range []PlayerColor{PlayerBlack, PlayerWhite} {
+			if state.Board.IsEmpty(move.X, move.Y) && rules.IsForbiddenDoubleThree(state.Board, move, player) {
+				forbidden++
+			}
+		}
+		var undo searchMoveUndo
+		if !applyMoveWithUndo(&state, rules, move, state.ToMove, &undo) {
+			continue
+		}
+		undos = append(undos, undo)
+		check("after move")
+	}
+	if forbidden == 0 {
+		t.Fatalf("the game never reached a forbidden double three")
+	}
+	for len(undos) > 0 {
+		undoMoveWithUndo(&state, undos[len(undos)-1])
+		undos = undos[:len(undos)-1]
+		check("after undo")
+	}
+}
@@ -7,6 +7,7 @@ import (
 	"fmt"
 	"log"
 	"net/http"
+	"net/http/pprof"
 	"os"
 	"os/signal"
 	"strconv"
@@ -100,6 +101,10 @@ type ttCacheStatusResponse struct {
 	CapacityBytes  uint64  `json:"capacity_bytes"`
 	MaxMemoryBytes uint64  `json:"max_memory_bytes"`
 	MemoryUsage    float64 `json:"memory_usage"`
+	// Game and Pool are set when AiCachePartitioned is on: the current
+	// game's partition id and every partition's stats.
+	Game string          `json:"game,omitempty"`
+	Pool *cachePoolStats `json:"pool,omitempty"`
 }
 
 type ttCacheEntryDTO struct {
@@ -232,6 +237,8 @@ func main() {
 		}
 		if payload.Config != nil {
 			configStore.Update(*payload.Config)
+			openSharedPositionBook(GetConfig())
+			openSharedColdTier(GetConfig())
 			controller.ResetForConfigChange()
 		}
 		if payload.Settings != nil {
@@ -264,6 +271,51 @@ func main() {
 		writeJSON(w, http.StatusOK, controllerStatus(controller))
 	})
 
+	r.Post("/api/matches/batch", func(w http.ResponseWriter, r *http.Request) {
+		var payload matchBatchRequest
+		if err := json.NewDecoder(r.Body).Decode(&payload); err != nil || len(payload.Jobs) == 0 {
+			writeJSON(w, http.StatusBadRequest, map[string]string{"error": "invalid payload"})
+			return
+		}
+		// Results are streamed as NDJSON, one line per finished game.
+		w.Header().Set("Content-Type", "application/x-ndjson")
+		w.WriteHeader(http.StatusOK)
+		flusher, _ := w.(http.Flusher)
+		encoder := json.NewEncoder(w)
+		runMatchBatch(r.Context(), payload, func(result matchResult) {
+			if err := encoder.Encode(result); err != nil {
+				return
+			}
+			if flusher != nil {
+				flusher.Flush()
+			}
+		})
+	})
+
+	r.Post("/api/analyze", func(w http.ResponseWriter, r *http.Request) {
+		var payload analysisRequest
+		if err := json.NewDecoder(r.Body).Decode(&payload); err != nil {
+			writeJSON(w, http.StatusBadRequest, map[string]string{"error": "invalid payload"})
+			return
+		}
+		if err := validateAnalysisRequest(payload); err != nil {
+			writeJSON(w, http.StatusBadRequest, map[string]string{"error": err.Error()})
+			return
+		}
+		w.Header().Set("Content-Type", "application/x-ndjson")
+		w.WriteHeader(http.StatusOK)
+		flusher, _ := w.(http.Flusher)
+		encoder := json.NewEncoder(w)
+		runAnalysisBatch(r.Context(), payload, func(event analysisEvent) {
+			if err := encoder.Encode(event); err != nil {
+				return
+			}
+			if flusher != nil {
+				flusher.Flush()
+			}
+		})
+	})
+
 	r.Get("/api/analitics/queue", func(w http.ResponseWriter, r *http.Request) {
 		writeJSON(w, http.StatusOK, analiticsQueueResponse{
 			Queue:        searchBacklogManager.TopAnaliticsQueue(analiticsTopBoardsLimit()),
@@ -271,9 +323,23 @@ func main() {
 		})
 	})
 	r.Get("/api/cache/tt", func(w http.ResponseWriter, r *http.Request) {
-		writeJSON(w, http.StatusOK, ttCacheStatus())
+		status := ttCacheStatus()
+		if config := GetConfig(); config.AiCachePartitioned {
+			pool := SharedCachePool().Stats(config.AiCachePoolMaxBytes)
+			status.Game = controller.CacheID()
+			status.Pool = &pool
+		}
+		writeJSON(w, http.StatusOK, status)
 	})
 	r.Delete("/api/cache/tt", func(w http.ResponseWriter, r *http.Request) {
+		if game := r.URL.Query().Get("game"); game != "" {
+			writeJSON(w, http.StatusOK, map[string]any{
+				"cleared":    true,
+				"game":       game,
+				"partitions": SharedCachePool().FlushGame(game),
+			})
+			return
+		}
 		FlushGlobalCaches()
 		writeJSON(w, http.StatusOK, map[string]any{
 			"cleared": true,
@@ -314,6 +380,37 @@ func main() {
 		})
 	})
 
+	r.Get("/api/debug/trace", func(w http.ResponseWriter, r *http.Request) {
+		trace := latestSearchTrace(r.URL.Query().Get("label"))
+		if trace == nil {
+			writeJSON(w, http.StatusNotFound, map[string]string{"error": "no traced search; enable ai_search_trace"})
+			return
+		}
+		w.Header().Set("Content-Disposition", `attachment; filename="search-trace.json"`)
+		writeJSON(w, http.StatusOK, trace.chromeTrace())
+	})
+
+	r.Get("/metrics", func(w http.ResponseWriter, r *http.Request) {
+		w.Header().Set("Content-Type", "text/plain; version=0.0.4; charset=utf-8")
+		writeMetrics(w)
+	})
+	r.Route("/debug/pprof", func(r chi.Router) {
+		r.Use(func(next http.Handler) http.Handler {
+			return http.HandlerFunc(func(w http.ResponseWriter, r *http.Request) {
+				if !GetConfig().AiEnablePprof {
+					writeJSON(w, http.StatusNotFound, map[string]string{"error": "profiling disabled; enable ai_enable_pprof"})
+					return
+				}
+				next.ServeHTTP(w, r)
+			})
+		})
+		r.HandleFunc("/cmdline", pprof.Cmdline)
+		r.HandleFunc("/profile", pprof.Profile)
+		r.HandleFunc("/symbol", pprof.Symbol)
+		r.HandleFunc("/trace", pprof.Trace)
+		r.HandleFunc("/*", pprof.Index)
+	})
+
 	r.Get("/ws/", func(w http.ResponseWriter, r *http.Request) {
 		serveWS(hub, controller, w, r)
 	})
@@ -323,6 +420,9 @@ func main() {
 	r.Get("/ws/analitics", func(w http.ResponseWriter, r *http.Request) {
 		serveAnaliticsWS(analiticsHub, w, r)
 	})
+	r.Get("/ws/analyze", func(w http.ResponseWriter, r *http.Request) {
+		serveAnalyzeWS(w, r)
+	})
 
 	server := &http.Server{
 		Addr:    ":8080",
@@ -378,7 +478,7 @@ func serveWS(hub *Hub, controller *GameController, w http.ResponseWriter, r *htt
 	hub.Register(client)
 
 	status := controllerStatus(controller)
-	client.sendJSON(wsMessage{Type: "status", Payload: mustMarshal(status)})
+	client.sendFrame(encodeWSFrame("status", status))
 
 	go func() {
 		defer conn.Close()
@@ -400,7 +500,7 @@ func serveWS(hub *Hub, controller *GameController, w http.ResponseWriter, r *htt
 		switch msg.Type {
 		case "request_status":
 			status := controllerStatus(controller)
-			client.sendJSON(wsMessage{Type: "status", Payload: mustMarshal(status)})
+			client.sendFrame(encodeWSFrame("status", status))
 		}
 	}
 }
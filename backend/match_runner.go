@@ -0,0 +1,126 @@
+package main
+
+import (
+	"context"
+	"fmt"
+	"runtime"
+	"sync"
+	"sync/atomic"
+	"time"
+)
+
+var nextMatchBatchID atomic.Uint64
+
+// matchJob is one AI-vs-AI game of a batch. Nil heuristics use the config's.
+type matchJob struct {
+	ID      string           `json:"id"`
+	Black   *HeuristicConfig `json:"black_heuristics"`
+	White   *HeuristicConfig `json:"white_heuristics"`
+	Opening []Move           `json:"opening"`
+}
+
+type matchBatchRequest struct {
+	Jobs          []matchJob `json:"jobs"`
+	Workers       int        `json:"workers"`
+	GameTimeoutMs int        `json:"game_timeout_ms"`
+}
+
+type matchResult struct {
+	Index      int    `json:"index"`
+	ID         string `json:"id"`
+	Status     string `json:"status"`
+	Winner     int    `json:"winner"`
+	WinReason  string `json:"win_reason"`
+	Moves      int    `json:"moves"`
+	DurationMs int64  `json:"duration_ms"`
+	Error      string `json:"error,omitempty"`
+}
+
+func matchWorkers(requested, jobs int) int {
+	workers := requested
+	if workers <= 0 {
+		workers = max(runtime.GOMAXPROCS(0)/2, 1)
+	}
+	return max(min(workers, jobs), 1)
+}
+
+// runMatchBatch plays req's jobs on a pool of workers and hands each result
+// to emit as its game ends, so results arrive out of job order. emit is
+// called from one goroutine at a time. Games run headless: no hub, ghost
+// board, pondering or backlog queueing. When the cache pool is partitioned
+// each game gets its own partition, flushed when the game ends.
+func runMatchBatch(ctx context.Context, req matchBatchRequest, emit func(matchResult)) {
+	batch := nextMatchBatchID.Add(1)
+	jobs := make(chan int)
+	var emitMu sync.Mutex
+	var wg sync.WaitGroup
+	for w := 0; w < matchWorkers(req.Workers, len(req.Jobs)); w++ {
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+			for i := range jobs {
+				cacheID := fmt.Sprintf("match-%d-%d", batch, i)
+				result := playMatch(ctx, req.Jobs[i], cacheID, time.Duration(req.GameTimeoutMs)*time.Millisecond)
+				SharedCachePool().FlushGame(cacheID)
+				result.Index = i
+				emitMu.Lock()
+				emit(result)
+				emitMu.Unlock()
+			}
+		}()
+	}
+	for i := range req.Jobs {
+		select {
+		case jobs <- i:
+		case <-ctx.Done():
+		}
+		if ctx.Err() != nil {
+			break
+		}
+	}
+	close(jobs)
+	wg.Wait()
+}
+
+// playMatch plays job to the end. The opening is applied as given, then both
+// AIs move in turn; ctx and timeout are checked between moves. Its positions
+// are not backlog visits, which count real games only.
+func playMatch(ctx context.Context, job matchJob, cacheID string, timeout time.Duration) matchResult {
+	start := time.Now()
+	result := matchResult{ID: job.ID}
+	settings := DefaultGameSettings()
+	settings.BlackType = PlayerAI
+	settings.WhiteType = PlayerAI
+	settings.BlackHeuristics = cloneHeuristicConfigPtr(job.Black)
+	settings.WhiteHeuristics = cloneHeuristicConfigPtr(job.White)
+	g := Game{headless: true, cacheID: cacheID}
+	g.Reset(settings)
+	g.Start()
+	finish := func(status string, err string) matchResult {
+		result.Status = status
+		result.Error = err
+		result.Winner = winnerFromStatus(g.state.Status)
+		result.WinReason = winReasonFromState(g.state)
+		result.Moves = g.history.Size()
+		result.DurationMs = time.Since(start).Milliseconds()
+		return result
+	}
+	for _, move := range job.Opening {
+		if ok, reason := g.TryApplyMove(move); !ok {
+			return finish("error", fmt.Sprintf("opening move (%d,%d): %s", move.X, move.Y, reason))
+		}
+	}
+	for g.state.Status == StatusRunning {
+		if ctx.Err() != nil {
+			return finish("cancelled", "")
+		}
+		if timeout > 0 && time.Since(start) > timeout {
+			return finish("timeout", "")
+		}
+		move := g.currentPlayer().ChooseMove(g.State(), g.rules)
+		if ok, reason := g.TryApplyMove(move); !ok {
+			return finish("error", fmt.Sprintf("ai move (%d,%d): %s", move.X, move.Y, reason))
+		}
+	}
+	return finish(statusToString(g.state.Status), "")
+}
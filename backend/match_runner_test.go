@@ -0,0 +1,65 @@
+package main
+
+import (
+	"context"
+	"testing"
+)
+
+func TestRunMatchBatchPlaysEveryJob(t *testing.T) {
+	prev := GetConfig()
+	cfg := benchConfig()
+	cfg.AiDepth = 1
+	cfg.AiMaxDepth = 1
+	cfg.AiPonderingEnabled = true
+	configStore.Update(cfg)
+	defer func() {
+		configStore.Update(prev)
+		FlushGlobalCaches()
+	}()
+
+	aggressive := cfg.Heuristics
+	aggressive.Open3 *= 4
+	req := matchBatchRequest{
+		Jobs: []matchJob{
+			{ID: "tuned", Black: &aggressive, Opening: []Move{{X: 9, Y: 9}, {X: 10, Y: 9}}},
+			{ID: "bad", Opening: []Move{{X: 9, Y: 9}, {X: 9, Y: 9}}},
+		},
+		Workers: 2,
+	}
+	liveVisits := func() int64 {
+		searchBacklogManager.mu.Lock()
+		defer searchBacklogManager.mu.Unlock()
+		return searchBacklogManager.visits
+	}
+	visitsBefore := liveVisits()
+	results := map[string]matchResult{}
+	runMatchBatch(context.Background(), req, func(result matchResult) {
+		results[result.ID] = result
+	})
+	if len(results) != len(req.Jobs) {
+		t.Fatalf("got %d results for %d jobs", len(results), len(req.Jobs))
+	}
+	if visits := liveVisits(); visits != visitsBefore {
+		t.Fatalf("batch games counted %d backlog visits", visits-visitsBefore)
+	}
+	for i, job := range req.Jobs {
+		result := results[job.ID]
+		if result.Index != i {
+			t.Fatalf("%s: index %d, want %d", job.ID, result.Index, i)
+		}
+		if job.ID == "bad" {
+			if result.Status != "error" || result.Moves != 1 {
+				t.Fatalf("bad opening: %+v", result)
+			}
+			continue
+		}
+		switch result.Status {
+		case "black_won", "white_won", "draw":
+		default:
+			t.Fatalf("%s did not finish: %+v", job.ID, result)
+		}
+		if result.Moves <= len(job.Opening) {
+			t.Fatalf("%s: %d moves after a %d-move opening", job.ID, result.Moves, len(job.Opening))
+		}
+	}
+}
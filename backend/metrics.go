@@ -0,0 +1,229 @@
+package main
+
+import (
+	"fmt"
+	"io"
+	"math"
+	"sort"
+	"strconv"
+	"sync/atomic"
+	"time"
+)
+
+// Search metrics are plain atomics updated once per finished search from its
+// SearchStats, so recording never touches the hot loop. GET /metrics renders
+// them, plus gauges read at scrape time, in the Prometheus text format.
+
+var searchMetricTags = [...]string{"choose", "think", "ponder", "backlog", "analyze"}
+
+type searchTagMetrics struct {
+	searches   atomic.Int64
+	nodes      atomic.Int64
+	ttProbes   atomic.Int64
+	ttHits     atomic.Int64
+	ttCutoffs  atomic.Int64
+	cutoffs    atomic.Int64
+	evalProbes atomic.Int64
+	evalHits   atomic.Int64
+	lastNPS    atomic.Uint64 // float64 bits
+	duration   *metricHistogram
+	depth      *metricHistogram
+}
+
+// metricHistogram keeps per-bucket counts, not cumulative ones; the writer sums
+// them.
+type metricHistogram struct {
+	bounds []float64
+	counts []atomic.Int64 // len(bounds)+1, the last is +Inf
+	sum    atomic.Uint64  // float64 bits
+}
+
+var searchMetrics = newSearchMetrics()
+
+func newSearchMetrics() *[len(searchMetricTags)]searchTagMetrics {
+	var m [len(searchMetricTags)]searchTagMetrics
+	for i := range m {
+		m[i].duration = newMetricHistogram(0.01, 0.05, 0.1, 0.25, 0.5, 1, 2, 5, 10, 30, 60)
+		m[i].depth = newMetricHistogram(1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 12, 14, 16, 20)
+	}
+	return &m
+}
+
+func newMetricHistogram(bounds ...float64) *metricHistogram {
+	return &metricHistogram{bounds: bounds, counts: make([]atomic.Int64, len(bounds)+1)}
+}
+
+func (h *metricHistogram) observe(v float64) {
+	h.counts[sort.SearchFloat64s(h.bounds, v)].Add(1)
+	addFloat64(&h.sum, v)
+}
+
+func addFloat64(bits *atomic.Uint64, delta float64) {
+	for {
+		old := bits.Load()
+		if bits.CompareAndSwap(old, math.Float64bits(math.Float64frombits(old)+delta)) {
+			return
+		}
+	}
+}
+
+// searchElapsed is stats' wall time, or the sum of its depth times when it
+// has no start.
+func searchElapsed(stats *SearchStats) time.Duration {
+	if !stats.Start.IsZero() {
+		return time.Since(stats.Start)
+	}
+	elapsed := time.Duration(0)
+	for _, d := range stats.DepthDurations {
+		elapsed += d
+	}
+	return elapsed
+}
+
+// recordSearchMetrics adds a finished search to tag's metrics; unknown tags
+// are dropped.
+func recordSearchMetrics(tag string, stats *SearchStats) {
+	if stats == nil {
+		return
+	}
+	var m *searchTagMetrics
+	for i, name := range searchMetricTags {
+		if name == tag {
+			m = &searchMetrics[i]
+		}
+	}
+	if m == nil {
+		return
+	}
+	elapsed := searchElapsed(stats)
+	m.searches.Add(1)
+	m.nodes.Add(stats.Nodes)
+	m.ttProbes.Add(stats.TTProbes)
+	m.ttHits.Add(stats.TTHits)
+	m.ttCutoffs.Add(stats.TTCutoffs)
+	m.cutoffs.Add(stats.Cutoffs)
+	m.evalProbes.Add(stats.EvalCacheProbes)
+	m.evalHits.Add(stats.EvalCacheHits)
+	if elapsed > 0 {
+		m.lastNPS.Store(math.Float64bits(float64(stats.Nodes) / elapsed.Seconds()))
+	}
+	m.duration.observe(elapsed.Seconds())
+	m.depth.observe(float64(stats.CompletedDepths))
+}
+
+type metricsWriter struct {
+	w io.Writer
+}
+
+func (mw metricsWriter) header(name, kind, help string) {
+	fmt.Fprintf(mw.w, "# HELP %s %s\n# TYPE %s %s\n", name, help, name, kind)
+}
+
+func (mw metricsWriter) sample(name, labels string, v float64) {
+	if labels != "" {
+		labels = "{" + labels + "}"
+	}
+	fmt.Fprintf(mw.w, "%s%s %s\n", name, labels, strconv.FormatFloat(v, 'g', -1, 64))
+}
+
+func (mw metricsWriter) tagCounter(name, help string, value func(m *searchTagMetrics) float64) {
+	mw.header(name, "counter", help)
+	for i, tag := range searchMetricTags {
+		mw.sample(name, `tag="`+tag+`"`, value(&searchMetrics[i]))
+	}
+}
+
+func (mw metricsWriter) tagHistogram(name, help string, hist func(m *searchTagMetrics) *metricHistogram) {
+	mw.header(name, "histogram", help)
+	for i, tag := range searchMetricTags {
+		h := hist(&searchMetrics[i])
+		total := int64(0)
+		for b := range h.counts {
+			total += h.counts[b].Load()
+			le := "+Inf"
+			if b < len(h.bounds) {
+				le = strconv.FormatFloat(h.bounds[b], 'g', -1, 64)
+			}
+			mw.sample(name+"_bucket", `tag="`+tag+`",le="`+le+`"`, float64(total))
+		}
+		mw.sample(name+"_sum", `tag="`+tag+`"`, math.Float64frombits(h.sum.Load()))
+		mw.sample(name+"_count", `tag="`+tag+`"`, float64(total))
+	}
+}
+
+func ratio(num, den int64) float64 {
+	if den <= 0 {
+		return 0
+	}
+	return float64(num) / float64(den)
+}
+
+// writeMetrics renders every metric in the Prometheus text exposition format.
+func writeMetrics(w io.Writer) {
+	mw := metricsWriter{w: w}
+	mw.tagCounter("gomoku_searches_total", "Finished searches.", func(m *searchTagMetrics) float64 { return float64(m.searches.Load()) })
+	mw.tagCounter("gomoku_search_nodes_total", "Nodes searched.", func(m *searchTagMetrics) float64 { return float64(m.nodes.Load()) })
+	mw.tagCounter("gomoku_search_tt_probes_total", "Transposition table probes.", func(m *searchTagMetrics) float64 { return float64(m.ttProbes.Load()) })
+	mw.tagCounter("gomoku_search_tt_hits_total", "Transposition table hits.", func(m *searchTagMetrics) float64 { return float64(m.ttHits.Load()) })
+	mw.tagCounter("gomoku_search_tt_cutoffs_total", "Cutoffs answered by the transposition table.", func(m *searchTagMetrics) float64 { return float64(m.ttCutoffs.Load()) })
+	mw.tagCounter("gomoku_search_cutoffs_total", "All cutoffs, TT and alpha-beta.", func(m *searchTagMetrics) float64 { return float64(m.cutoffs.Load()) })
+	mw.tagCounter("gomoku_search_eval_cache_probes_total", "Eval cache probes.", func(m *searchTagMetrics) float64 { return float64(m.evalProbes.Load()) })
+	mw.tagCounter("gomoku_search_eval_cache_hits_total", "Eval cache hits.", func(m *searchTagMetrics) float64 { return float64(m.evalHits.Load()) })
+
+	mw.header("gomoku_search_tt_hit_ratio", "gauge", "TT hits per probe since start.")
+	mw.header("gomoku_search_tt_cutoff_ratio", "gauge", "Share of cutoffs answered by the TT since start.")
+	mw.header("gomoku_search_eval_cache_hit_ratio", "gauge", "Eval cache hits per probe since start.")
+	mw.header("gomoku_search_nodes_per_second", "gauge", "Nodes per second of the last search.")
+	for i, tag := range searchMetricTags {
+		m := &searchMetrics[i]
+		label := `tag="` + tag + `"`
+		mw.sample("gomoku_search_tt_hit_ratio", label, ratio(m.ttHits.Load(), m.ttProbes.Load()))
+		mw.sample("gomoku_search_tt_cutoff_ratio", label, ratio(m.ttCutoffs.Load(), m.cutoffs.Load()))
+		mw.sample("gomoku_search_eval_cache_hit_ratio", label, ratio(m.evalHits.Load(), m.evalProbes.Load()))
+		mw.sample("gomoku_search_nodes_per_second", label, math.Float64frombits(m.lastNPS.Load()))
+	}
+
+	mw.tagHistogram("gomoku_search_duration_seconds", "Wall time per search; for choose and think, time to move.", func(m *searchTagMetrics) *metricHistogram { return m.duration })
+	mw.tagHistogram("gomoku_search_completed_depth", "Deepest completed iteration per search.", func(m *searchTagMetrics) *metricHistogram { return m.depth })
+
+	mw.header("gomoku_backlog_queue_depth", "gauge", "Boards waiting in the analysis backlog.")
+	mw.sample("gomoku_backlog_queue_depth", "", float64(searchBacklogManager.TotalAnaliticsQueue()))
+	mw.header("gomoku_backlog_active_boards", "gauge", "Boards the backlog is analyzing.")
+	mw.sample("gomoku_backlog_active_boards", "", float64(searchBacklogManager.activeBoards.Load()))
+
+	tt := ttCacheStatus()
+	mw.header("gomoku_tt_entries", "gauge", "Entries in the shared transposition table.")
+	mw.sample("gomoku_tt_entries", "", float64(tt.Count))
+	mw.header("gomoku_tt_capacity", "gauge", "Slots in the shared transposition table.")
+	mw.sample("gomoku_tt_capacity", "", float64(tt.Capacity))
+
+	if cold := SharedColdTier(); cold != nil {
+		stats := cold.Stats()
+		mw.header("gomoku_tt_cold_entries", "gauge", "Entries in the cold TT tier.")
+		mw.sample("gomoku_tt_cold_entries", "", float64(stats.Entries))
+		mw.header("gomoku_tt_cold_bytes", "gauge", "Size of the cold TT tier's file.")
+		mw.sample("gomoku_tt_cold_bytes", "", float64(stats.Bytes))
+		mw.header("gomoku_tt_cold_hits_total", "counter", "Cold tier lookups that found their key.")
+		mw.sample("gomoku_tt_cold_hits_total", "", float64(stats.Hits))
+		mw.header("gomoku_tt_cold_misses_total", "counter", "Cold tier lookups that did not.")
+		mw.sample("gomoku_tt_cold_misses_total", "", float64(stats.Misses))
+		mw.header("gomoku_tt_cold_promoted_total", "counter", "Cold entries copied back into the hot TT.")
+		mw.sample("gomoku_tt_cold_promoted_total", "", float64(stats.Promoted))
+	}
+
+	if pool := searchBacklogManager.pool; pool != nil {
+		stats := pool.Stats()
+		mw.header("gomoku_backlog_jobs_total", "counter", "Jobs run by the backlog pool.")
+		mw.sample("gomoku_backlog_jobs_total", "", float64(stats.Executed))
+		mw.header("gomoku_backlog_jobs_stolen_total", "counter", "Backlog jobs run by a worker that stole them.")
+		mw.sample("gomoku_backlog_jobs_stolen_total", "", float64(stats.Stolen))
+		mw.header("gomoku_backlog_worker_busy_seconds_total", "counter", "Time each backlog worker spent running work.")
+		for i, busy := range stats.Busy {
+			mw.sample("gomoku_backlog_worker_busy_seconds_total", `worker="`+strconv.Itoa(i)+`"`, busy.Seconds())
+		}
+		mw.header("gomoku_backlog_worker_utilization", "gauge", "Busy share of each backlog worker since it started.")
+		for i, busy := range stats.Busy {
+			mw.sample("gomoku_backlog_worker_utilization", `worker="`+strconv.Itoa(i)+`"`, ratio(int64(busy), int64(stats.Uptime)))
+		}
+	}
+}
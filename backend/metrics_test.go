@@ -0,0 +1,47 @@
+package main
+
+import (
+	"strings"
+	"testing"
+	"time"
+)
+
+func TestWriteMetricsExposesRecordedSearches(t *testing.T) {
+	before := searchMetrics[1].searches.Load()
+	recordSearchMetrics("think", &SearchStats{
+		Nodes:           1000,
+		TTProbes:        10,
+		TTHits:          4,
+		Cutoffs:         8,
+		TTCutoffs:       2,
+		CompletedDepths: 5,
+		DepthDurations:  []time.Duration{200 * time.Millisecond},
+	})
+	recordSearchMetrics("unknown", &SearchStats{Nodes: 1})
+	if got := searchMetrics[1].searches.Load(); got != before+1 {
+		t.Fatalf("expected one more think search, got %d -> %d", before, got)
+	}
+
+	var out strings.Builder
+	writeMetrics(&out)
+	text := out.String()
+	for _, want := range []string{
+		"# TYPE gomoku_search_nodes_total counter",
+		`gomoku_search_nodes_per_second{tag="think"} 5000`,
+		`gomoku_search_completed_depth_bucket{tag="think",le="+Inf"}`,
+		`gomoku_search_duration_seconds_bucket{tag="think",le="0.25"}`,
+		"gomoku_backlog_queue_depth ",
+	} {
+		if !strings.Contains(text, want) {
+			t.Fatalf("metrics missing %q:\n%s", want, text)
+		}
+	}
+	if strings.Contains(text, "unknown") {
+		t.Fatalf("unknown tag leaked into metrics")
+	}
+	for _, line := range strings.Split(strings.TrimSpace(text), "\n") {
+		if !strings.HasPrefix(line, "#") && len(strings.Fields(line)) != 2 {
+			t.Fatalf("malformed sample line %q", line)
+		}
+	}
+}
@@ -0,0 +1,180 @@
+package main
+
+import (
+	"sort"
+	"time"
+)
+
+// ponderSlot holds the pondered answer to one position the opponent may
+// reach. ready is set once the answer is as deep as a normal turn would get.
+type ponderSlot struct {
+	key   uint64
+	reply Move
+	move  Move
+	ready bool
+}
+
+// isOpponentTurn reports whether the side to move in state is not the side
+// this player last searched for. It is false before the first search.
+func (a *AIPlayer) isOpponentTurn(state GameState) bool {
+	side := a.side.Load()
+	return side != 0 && PlayerColor(side-1) != state.ToMove
+}
+
+// ponderReplies splits the opponent's think time across their most likely
+// replies: each round deepens every reply's answer by one ply, so a reply
+// played early still finds a usable slot.
+func (a *AIPlayer) ponderReplies(state GameState, rules Rules, config Config, version uint64) {
+	stale := func() bool { return a.stopSignal.Load() || a.ponderVersion.Load() != version }
+	cache := a.searchCache(config)
+	replies := predictPonderReplies(state, rules, config, cache, config.AiPonderReplies, stale)
+	size := state.Board.Size()
+	roots := make([]GameState, 0, len(replies))
+	slots := make([]ponderSlot, 0, len(replies))
+	for _, reply := range replies {
+		child := state.Clone()
+		var undo searchMoveUndo
+		if !applyMoveWithUndo(&child, rules, reply, child.ToMove, &undo) || child.Status != StatusRunning {
+			continue
+		}
+		roots = append(roots, child)
+		slots = append(slots, ponderSlot{key: orientedKeyFor(&child, size), reply: reply})
+	}
+	if len(roots) == 0 {
+		return
+	}
+	a.ponderMu.Lock()
+	if a.ponderVersion.Load() != version {
+		a.ponderMu.Unlock()
+		return
+	}
+	a.ponderSlots = slots
+	a.ponderMu.Unlock()
+
+	minDepth := max(config.AiMinDepth, 1)
+	maxDepth := config.AiDepth
+	if config.AiMaxDepth > 0 {
+		maxDepth = config.AiMaxDepth
+	}
+	done := make([]bool, len(roots))
+	for depth := minDepth; depth <= maxDepth; depth++ {
+		for i := range roots {
+			if done[i] {
+				continue
+			}
+			if stale() {
+				return
+			}
+			cfg := config
+			cfg.AiMaxDepth = depth
+			stats := &SearchStats{Start: time.Now()}
+			settings := AIScoreSettings{
+				Depth:            depth,
+				TimeoutMs:        config.AiTimeoutMs,
+				BoardSize:        size,
+				Player:           roots[i].ToMove,
+				Cache:            cache,
+				Config:           cfg,
+				Profile:          newSearchProfile(cfg),
+				ShouldStop:       stale,
+				Stats:            stats,
+				SkipQueueBacklog: true,
+			}
+			scores := ScoreBoard(roots[i].Clone(), rules, settings)
+			if stale() {
+				return
+			}
+			move, ok := a.selectBestMove(roots[i], rules, settings, stats, scores)
+			// A search that stopped short of depth ran out of budget, which
+			// is as far as a normal turn would get too.
+			done[i] = !ok || depth == maxDepth || stats.CompletedDepths < depth
+			if !ok {
+				continue
+			}
+			move.Depth = stats.CompletedDepths
+			a.storePonderSlot(version, i, move, done[i])
+			if !done[i] {
+				continue
+			}
+			recordSearchMetrics("ponder", stats)
+			if config.AiLogSearchStats {
+				logSearchStats("ponder", stats, settings)
+			}
+		}
+	}
+}
+
+func (a *AIPlayer) storePonderSlot(version uint64, i int, move Move, ready bool) {
+	a.ponderMu.Lock()
+	defer a.ponderMu.Unlock()
+	if a.ponderVersion.Load() != version || i >= len(a.ponderSlots) {
+		return
+	}
+	a.ponderSlots[i].move = move
+	a.ponderSlots[i].ready = ready
+	if ready {
+		a.ponderReady.Store(true)
+	}
+}
+
+// predictPonderReplies ranks the side to move's replies with a shallow
+// search. When the TT answers that search with a single move, the rest are
+// taken from candidate order.
+func predictPonderReplies(state GameState, rules Rules, config Config, cache *AISearchCache, n int, stop func() bool) []Move {
+	size := state.Board.Size()
+	cfg := config
+	cfg.AiMaxDepth = max(config.AiPonderReplyDepth, 1)
+	scores := ScoreBoard(state.Clone(), rules, AIScoreSettings{
+		Depth:            cfg.AiMaxDepth,
+		BoardSize:        size,
+		Player:           state.ToMove,
+		Cache:            cache,
+		Config:           cfg,
+		Profile:          newSearchProfile(cfg),
+		ShouldStop:       stop,
+		SkipQueueBacklog: true,
+	})
+	if stop() {
+		return nil
+	}
+	type rankedMove struct {
+		move  Move
+		score float64
+	}
+	var ranked []rankedMove
+	for i, score := range scores {
+		move := Move{X: i % size, Y: i / size}
+		if score == illegalScore {
+			continue
+		}
+		if ok, _ := rules.IsLegal(state, move, state.ToMove); ok {
+			ranked = append(ranked, rankedMove{move: move, score: score})
+		}
+	}
+	maximizing := state.ToMove == PlayerBlack
+	sort.SliceStable(ranked, func(i, j int) bool {
+		if maximizing {
+			return ranked[i].score > ranked[j].score
+		}
+		return ranked[i].score < ranked[j].score
+	})
+	replies := make([]Move, 0, n)
+	for _, r := range ranked {
+		if len(replies) == n {
+			return replies
+		}
+		replies = append(replies, r.move)
+	}
+	for _, cand := range collectCandidateMoves(state, state.ToMove, size) {
+		if len(replies) == n {
+			break
+		}
+		if containsMove(replies, cand.move) {
+			continue
+		}
+		if ok, _ := rules.IsLegal(state, cand.move, state.ToMove); ok {
+			replies = append(replies, cand.move)
+		}
+	}
+	return replies
+}
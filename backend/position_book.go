@@ -0,0 +1,406 @@
+package main
+
+import (
+	"errors"
+	"fmt"
+	"log"
+	"math"
+	"math/bits"
+	"os"
+	"path/filepath"
+	"sync"
+	"sync/atomic"
+	"unsafe"
+)
+
+// PositionBook keeps deep root results in a memory-mapped file, keyed like
+// the TT (CanonHash, board size, status) with the heuristic hash folded in,
+// so they outlive TT eviction and restarts and can be shared read-only by
+// several backends. Results searched under different heuristics live side by
+// side and never answer for each other. Moves are stored in the canonical
+// orientation and mapped back on probe.
+//
+// The file is a 64-byte header followed by open-addressed two-word slots laid
+// out like the lock-free TT: check = key ^ data, so a reader racing the
+// writer sees a miss instead of a torn entry.
+//
+// data layout (low to high bits):
+//
+//	0-31  score (int32)
+//	32-39 depth
+//	40-47 move x
+//	48-55 move y
+//	56-63 board size
+type PositionBook struct {
+	mu       sync.RWMutex // held for writing only by Close, to unmap
+	path     string
+	file     *os.File
+	data     []byte
+	words    []uint64
+	mask     uint64
+	writable bool
+
+	hits   atomic.Int64
+	misses atomic.Int64
+	stores atomic.Int64
+}
+
+type PositionBookStats struct {
+	Slots    int   `json:"slots"`
+	Writable bool  `json:"writable"`
+	Hits     int64 `json:"hits"`
+	Misses   int64 `json:"misses"`
+	Stores   int64 `json:"stores"`
+}
+
+const (
+	bookMagic       = 0x314b4f4f424b4d47 // "GMKBOOK1"
+	bookVersion     = 2
+	bookHeaderWords = 8
+	bookProbeWindow = 4
+
+	bookDepthShift = 32
+	bookMoveXShift = 40
+	bookMoveYShift = 48
+	bookSizeShift  = 56
+)
+
+var sharedBook atomic.Pointer[PositionBook]
+
+func SharedPositionBook() *PositionBook {
+	return sharedBook.Load()
+}
+
+// OpenPositionBook maps path, creating it with slots entries (rounded up to a
+// power of two) when writable. A writable book with another layout is wiped;
+// a read-only one is rejected.
+func OpenPositionBook(path string, slots int, writable bool) (*PositionBook, error) {
+	if slots < bookProbeWindow {
+		slots = bookProbeWindow
+	}
+	slots = 1 << bits.Len64(uint64(slots-1))
+	flags := os.O_RDONLY
+	if writable {
+		flags = os.O_RDWR | os.O_CREATE
+		if dir := filepath.Dir(path); dir != "." && dir != "" {
+			if err := os.MkdirAll(dir, 0o755); err != nil {
+				return nil, err
+			}
+		}
+	}
+	file, err := os.OpenFile(path, flags, 0o644)
+	if err != nil {
+		return nil, err
+	}
+	stat, err := file.Stat()
+	if err != nil {
+		file.Close()
+		return nil, err
+	}
+	size := stat.Size()
+	fresh := size == 0
+	if fresh {
+		if !writable {
+			file.Close()
+			return nil, errors.New("empty position book")
+		}
+		size = int64(bookHeaderWords+2*slots) * 8
+		if err := file.Truncate(size); err != nil {
+			file.Close()
+			return nil, err
+		}
+	}
+	if size < bookHeaderWords*8 || size%8 != 0 {
+		file.Close()
+		return nil, fmt.Errorf("position book has invalid size %d", size)
+	}
+	data, err := mapBookFile(file, int(size), writable)
+	if err != nil {
+		file.Close()
+		return nil, err
+	}
+	words := unsafe.Slice((*uint64)(unsafe.Pointer(&data[0])), len(data)/8)
+	book := &PositionBook{path: path, file: file, data: data, writable: writable}
+	if !fresh {
+		if err := checkBookHeader(words); err != nil {
+			if !writable {
+				book.unmap()
+				return nil, err
+			}
+			log.Printf("[ai:book] resetting %s: %v", path, err)
+			fresh = true
+		}
+	}
+	if fresh {
+		clear(words)
+		words[0] = bookMagic
+		words[1] = bookVersion
+		words[2] = uint64((len(words) - bookHeaderWords) / 2)
+	}
+	book.words = words[bookHeaderWords:]
+	book.mask = words[2] - 1
+	return book, nil
+}
+
+func checkBookHeader(words []uint64) error {
+	slots := words[2]
+	switch {
+	case words[0] != bookMagic:
+		return errors.New("not a position book")
+	case words[1] != bookVersion:
+		return fmt.Errorf("layout version %d, want %d", words[1], bookVersion)
+	case slots == 0 || slots&(slots-1) != 0 || uint64(len(words)) != bookHeaderWords+2*slots:
+		return fmt.Errorf("slot count %d does not match file size", slots)
+	}
+	return nil
+}
+
+func packBookData(score float64, depth int, move Move, boardSize int) uint64 {
+	if score > math.MaxInt32 {
+		score = math.MaxInt32
+	} else if score < math.MinInt32 {
+		score = math.MinInt32
+	}
+	depth = min(max(depth, 1), 255)
+	return uint64(uint32(int32(score))) |
+		uint64(depth)<<bookDepthShift |
+		uint64(uint8(move.X))<<bookMoveXShift |
+		uint64(uint8(move.Y))<<bookMoveYShift |
+		uint64(uint8(boardSize))<<bookSizeShift
+}
+
+func unpackBookData(data uint64) (score float64, depth int, move Move, boardSize int) {
+	score = float64(int32(uint32(data)))
+	depth = int(uint8(data >> bookDepthShift))
+	move = Move{X: int(uint8(data >> bookMoveXShift)), Y: int(uint8(data >> bookMoveYShift))}
+	boardSize = int(uint8(data >> bookSizeShift))
+	return
+}
+
+// bookKey scopes the TT key of state to heuristicHash.
+func bookKey(state *GameState, boardSize int, heuristicHash uint64) uint64 {
+	return ttKeyFor(*state, boardSize) ^ mixKey(heuristicHash)
+}
+
+func (b *PositionBook) slot(i uint64) (check, data *uint64) {
+	i &= b.mask
+	return &b.words[2*i], &b.words[2*i+1]
+}
+
+// Probe returns the move stored for state under heuristicHash (in state's
+// orientation), its score and depth.
+func (b *PositionBook) Probe(state *GameState, boardSize int, heuristicHash uint64) (Move, float64, int, bool) {
+	if b == nil {
+		return Move{}, 0, 0, false
+	}
+	b.mu.RLock()
+	defer b.mu.RUnlock()
+	if b.words == nil {
+		return Move{}, 0, 0, false
+	}
+	key := bookKey(state, boardSize, heuristicHash)
+	for i := uint64(0); i < bookProbeWindow; i++ {
+		check, data := b.slot(key + i)
+		d := atomic.LoadUint64(data)
+		if d == 0 {
+			break
+		}
+		if atomic.LoadUint64(check)^d != key {
+			continue
+		}
+		score, depth, move, size := unpackBookData(d)
+		if size != boardSize {
+			continue
+		}
+		b.hits.Add(1)
+		return fromCanonicalMove(state, move), score, depth, true
+	}
+	b.misses.Add(1)
+	return Move{}, 0, 0, false
+}
+
+// Put records a searched root. It keeps the deeper result for a known
+// position and otherwise evicts the shallowest slot in the probe window.
+// Only one process may write a book at a time.
+func (b *PositionBook) Put(state *GameState, boardSize int, heuristicHash uint64, move Move, score float64, depth int) {
+	if b == nil || !b.writable || !move.IsValid(boardSize) {
+		return
+	}
+	b.mu.RLock()
+	defer b.mu.RUnlock()
+	if b.words == nil {
+		return
+	}
+	key := bookKey(state, boardSize, heuristicHash)
+	d := packBookData(score, depth, toCanonicalMove(state, move), boardSize)
+	victim := key
+	victimDepth := math.MaxInt
+	for i := uint64(0); i < bookProbeWindow; i++ {
+		check, data := b.slot(key + i)
+		old := atomic.LoadUint64(data)
+		if old == 0 {
+			victim = key + i
+			break
+		}
+		_, oldDepth, _, _ := unpackBookData(old)
+		if atomic.LoadUint64(check)^old == key {
+			if oldDepth > depth {
+				return
+			}
+			victim = key + i
+			break
+		}
+		if oldDepth < victimDepth {
+			victim = key + i
+			victimDepth = oldDepth
+		}
+	}
+	check, data := b.slot(victim)
+	atomic.StoreUint64(data, d)
+	atomic.StoreUint64(check, key^d)
+	b.stores.Add(1)
+}
+
+func (b *PositionBook) Stats() PositionBookStats {
+	if b == nil {
+		return PositionBookStats{}
+	}
+	b.mu.RLock()
+	defer b.mu.RUnlock()
+	return PositionBookStats{
+		Slots:    len(b.words) / 2,
+		Writable: b.writable,
+		Hits:     b.hits.Load(),
+		Misses:   b.misses.Load(),
+		Stores:   b.stores.Load(),
+	}
+}
+
+// Sync writes the book back to disk without unmapping it.
+func (b *PositionBook) Sync() error {
+	if b == nil {
+		return nil
+	}
+	b.mu.RLock()
+	defer b.mu.RUnlock()
+	if b.data == nil {
+		return nil
+	}
+	return syncBookFile(b.file, b.data, b.writable)
+}
+
+func (b *PositionBook) unmap() error {
+	err := syncBookFile(b.file, b.data, b.writable)
+	if unmapErr := unmapBookFile(b.data); err == nil {
+		err = unmapErr
+	}
+	if closeErr := b.file.Close(); err == nil {
+		err = closeErr
+	}
+	b.data = nil
+	b.words = nil
+	return err
+}
+
+// Close syncs and unmaps the book; later probes miss and puts are dropped.
+func (b *PositionBook) Close() error {
+	if b == nil {
+		return nil
+	}
+	b.mu.Lock()
+	defer b.mu.Unlock()
+	if b.data == nil {
+		return nil
+	}
+	return b.unmap()
+}
+
+// openSharedPositionBook points the shared book at cfg's file, closing the
+// one it replaces. It does nothing when the open book already matches cfg,
+// so it can run after every config update; heuristic changes need no reopen
+// because entries are keyed by heuristic hash.
+func openSharedPositionBook(cfg Config) {
+	path := ""
+	if cfg.AiEnableBook && cfg.AiBookPath != "" {
+		path = resolveTTPersistencePath(cfg.AiBookPath)
+	}
+	old := SharedPositionBook()
+	if old != nil && old.path == path && old.writable == cfg.AiBookWritable {
+		return
+	}
+	var book *PositionBook
+	if path != "" {
+		var err error
+		if book, err = OpenPositionBook(path, cfg.AiBookSlots, cfg.AiBookWritable); err != nil {
+			log.Printf("[ai:book] unable to open position book %s: %v", path, err)
+		} else {
+			log.Printf("[ai:book] opened position book %s (%d slots, writable=%v)", path, book.Stats().Slots, book.writable)
+		}
+	}
+	sharedBook.Store(book)
+	if err := old.Close(); err != nil {
+		log.Printf("[ai:book] failed to close position book %s: %v", old.path, err)
+	}
+}
+
+// syncSharedPositionBook runs at shutdown. The book stays mapped because
+// backlog workers may still be probing it.
+func syncSharedPositionBook() {
+	book := SharedPositionBook()
+	if book == nil {
+		return
+	}
+	stats := book.Stats()
+	if err := book.Sync(); err != nil {
+		log.Printf("[ai:book] failed to sync position book %s: %v", book.path, err)
+		return
+	}
+	log.Printf("[ai:book] synced position book %s (hits=%d misses=%d stores=%d)", book.path, stats.Hits, stats.Misses, stats.Stores)
+}
+
+// scoreBoardFromBook answers a root search from the book when it holds a
+// legal move searched at least as deep as requested under the search's
+// heuristics. Like the TT, the book is skipped with AiUseTtCache off.
+func scoreBoardFromBook(state GameState, rules Rules, settings AIScoreSettings) ([]float64, bool) {
+	book := SharedPositionBook()
+	if book == nil || !settings.Config.AiEnableBook || !settings.Config.AiUseTtCache || settings.Player != state.ToMove {
+		return nil, false
+	}
+	heuristicHash := withSearchProfile(settings).Profile.heuristicHash
+	move, score, depth, ok := book.Probe(&state, settings.BoardSize, heuristicHash)
+	if !ok || depth < settings.Depth || !move.IsValid(settings.BoardSize) {
+		return nil, false
+	}
+	if legal, _ := rules.IsLegal(state, move, settings.Player); !legal {
+		return nil, false
+	}
+	scores := make([]float64, settings.BoardSize*settings.BoardSize)
+	for i := range scores {
+		scores[i] = illegalScore
+	}
+	scores[move.Y*settings.BoardSize+move.X] = score
+	if settings.Stats != nil {
+		settings.Stats.CompletedDepths = depth
+	}
+	return scores, true
+}
+
+// recordBookResult stores the best move of a finished root search.
+func recordBookResult(state GameState, rules Rules, settings AIScoreSettings, scores []float64, depth int) {
+	book := SharedPositionBook()
+	if book == nil || !book.writable || !settings.Config.AiEnableBook || !settings.Config.AiUseTtCache || settings.Player != state.ToMove {
+		return
+	}
+	if state.Hash == 0 {
+		state.recomputeHashes()
+	}
+	move, ok := bestMoveFromScores(scores, state, rules, settings.BoardSize)
+	if !ok {
+		return
+	}
+	score := scoreForMove(scores, move, settings.BoardSize)
+	if score == illegalScore {
+		return
+	}
+	book.Put(&state, settings.BoardSize, withSearchProfile(settings).Profile.heuristicHash, move, score, depth)
+}
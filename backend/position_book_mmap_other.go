@@ -0,0 +1,32 @@
+//go:build !unix
+
+package main
+
+import (
+	"io"
+	"os"
+	"unsafe"
+)
+
+// Without mmap the book is read into memory and written back on sync, so it
+// cannot be shared live between processes.
+func mapBookFile(file *os.File, size int, writable bool) ([]byte, error) {
+	words := make([]uint64, size/8)
+	data := unsafe.Slice((*byte)(unsafe.Pointer(&words[0])), size)
+	if _, err := io.ReadFull(io.NewSectionReader(file, 0, int64(size)), data); err != nil {
+		return nil, err
+	}
+	return data, nil
+}
+
+func syncBookFile(file *os.File, data []byte, writable bool) error {
+	if !writable {
+		return nil
+	}
+	_, err := file.WriteAt(data, 0)
+	return err
+}
+
+func unmapBookFile(data []byte) error {
+	return nil
+}
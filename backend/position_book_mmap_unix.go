@@ -0,0 +1,29 @@
+//go:build unix
+
+package main
+
+import (
+	"os"
+	"syscall"
+)
+
+func mapBookFile(file *os.File, size int, writable bool) ([]byte, error) {
+	prot := syscall.PROT_READ
+	if writable {
+		prot |= syscall.PROT_WRITE
+	}
+	return syscall.Mmap(int(file.Fd()), 0, size, prot, syscall.MAP_SHARED)
+}
+
+// syncBookFile relies on the shared mapping and the page cache being one and
+// the same, so fsync also flushes pages dirtied through the mapping.
+func syncBookFile(file *os.File, data []byte, writable bool) error {
+	if !writable {
+		return nil
+	}
+	return file.Sync()
+}
+
+func unmapBookFile(data []byte) error {
+	return syscall.Munmap(data)
+}
@@ -0,0 +1,125 @@
+package main
+
+import (
+	"path/filepath"
+	"testing"
+)
+
+func TestPositionBookProbesSymmetricPositionsAndChecksHeuristics(t *testing.T) {
+	const size = 9
+	settings := DefaultGameSettings()
+	settings.BoardSize = size
+	stones := []struct {
+		x, y int
+		cell Cell
+	}{{4, 4, CellBlack}, {5, 4, CellWhite}, {3, 2, CellBlack}, {6, 6, CellWhite}}
+	build := func(transform symmetryTransform) GameState {
+		state := DefaultGameState(settings)
+		state.Status = StatusRunning
+		state.ToMove = PlayerBlack
+		for _, stone := range stones {
+			x, y := transformCoord(stone.x, stone.y, size, transform)
+			state.Board.Set(x, y, stone.cell)
+		}
+		state.recomputeHashes()
+		return state
+	}
+
+	path := filepath.Join(t.TempDir(), "book.bin")
+	book, err := OpenPositionBook(path, 64, true)
+	if err != nil {
+		t.Fatalf("open: %v", err)
+	}
+	base := build(symmetryTransforms[0])
+	best := Move{X: 2, Y: 3}
+	book.Put(&base, size, 1, best, 1234, 6)
+	book.Put(&base, size, 1, Move{X: 0, Y: 0}, 1, 3)
+	book.Put(&base, size, 2, Move{X: 1, Y: 1}, 99, 2)
+	if err := book.Close(); err != nil {
+		t.Fatalf("close: %v", err)
+	}
+
+	book, err = OpenPositionBook(path, 64, false)
+	if err != nil {
+		t.Fatalf("reopen: %v", err)
+	}
+	defer book.Close()
+	for i, transform := range symmetryTransforms {
+		state := build(transform)
+		move, score, depth, ok := book.Probe(&state, size, 1)
+		wantX, wantY := transformCoord(best.X, best.Y, size, transform)
+		if !ok || score != 1234 || depth != 6 || move != (Move{X: wantX, Y: wantY}) {
+			t.Fatalf("transform %d: got move=%v score=%v depth=%d ok=%v, want (%d,%d)", i, move, score, depth, ok, wantX, wantY)
+		}
+	}
+	other := base
+	other.ToMove = PlayerWhite
+	other.recomputeHashes()
+	if _, _, _, ok := book.Probe(&other, size, 1); ok {
+		t.Fatalf("expected a miss for the other side to move")
+	}
+	if move, score, depth, ok := book.Probe(&base, size, 2); !ok || move != (Move{X: 1, Y: 1}) || score != 99 || depth != 2 {
+		t.Fatalf("expected the other heuristics' own entry, got move=%v score=%v depth=%d ok=%v", move, score, depth, ok)
+	}
+	if _, _, _, ok := book.Probe(&base, size, 3); ok {
+		t.Fatalf("expected a miss for heuristics the book never searched")
+	}
+}
+
+func TestSharedPositionBookFollowsConfig(t *testing.T) {
+	cfg := DefaultConfig()
+	cfg.AiEnableBook = true
+	cfg.AiBookWritable = true
+	cfg.AiBookSlots = 64
+	cfg.AiBookPath = filepath.Join(t.TempDir(), "book.bin")
+	defer openSharedPositionBook(Config{})
+	openSharedPositionBook(cfg)
+	book := SharedPositionBook()
+	if book == nil {
+		t.Fatalf("expected the book to open")
+	}
+
+	rules := NewRules(DefaultGameSettings())
+	state := DefaultGameState(DefaultGameSettings())
+	state.Status = StatusRunning
+	state.Board.Set(9, 9, CellBlack)
+	state.ToMove = PlayerWhite
+	state.recomputeHashes()
+	size := state.Board.Size()
+	scores := make([]float64, size*size)
+	for i := range scores {
+		scores[i] = illegalScore
+	}
+	scores[9*size+10] = 50
+	settings := AIScoreSettings{Depth: 4, BoardSize: size, Player: PlayerWhite, Config: cfg}
+	recordBookResult(state, rules, settings, scores, 4)
+	if _, ok := scoreBoardFromBook(state, rules, settings); !ok {
+		t.Fatalf("expected a book hit under the heuristics that stored it")
+	}
+	other := settings
+	other.Config.Heuristics.Open4 *= 2
+	if _, ok := scoreBoardFromBook(state, rules, other); ok {
+		t.Fatalf("expected a miss under other heuristics")
+	}
+	noCache := settings
+	noCache.Config.AiUseTtCache = false
+	if _, ok := scoreBoardFromBook(state, rules, noCache); ok {
+		t.Fatalf("expected the book skipped with the TT cache off")
+	}
+
+	openSharedPositionBook(cfg)
+	if SharedPositionBook() != book {
+		t.Fatalf("expected an unchanged config to keep the open book")
+	}
+	cfg.AiBookWritable = false
+	openSharedPositionBook(cfg)
+	if reopened := SharedPositionBook(); reopened == nil || reopened == book || reopened.writable {
+		t.Fatalf("expected a read-only reopen, got %+v", reopened)
+	}
+	if _, _, _, ok := book.Probe(&state, size, 0); ok {
+		t.Fatalf("expected the replaced book to miss once closed")
+	}
+	if _, ok := scoreBoardFromBook(state, rules, settings); !ok {
+		t.Fatalf("expected the reopened book to keep the stored entry")
+	}
+}
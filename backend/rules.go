@@ -1,6 +1,9 @@
 package main
 
-import "fmt"
+import (
+	"fmt"
+	"math/bits"
+)
 
 type Rules struct {
 	settings GameSettings
@@ -36,8 +39,7 @@ func (r Rules) IsLegal(state GameState, move Move, player PlayerColor) (bool, st
 		forbid = r.settings.ForbidDoubleThreeWhite
 	}
 	if forbid {
-		// IsForbiddenDoubleThree mutates board only transiently (set/remove move),
-		// so we can run it directly without cloning the whole board.
+		// Board is a value type, so IsForbiddenDoubleThree works on its own copy.
 		if r.IsForbiddenDoubleThree(state.Board, move, player) {
 			return false, "forbidden double three"
 		}
@@ -76,22 +78,16 @@ func (r Rules) IsDraw(board Board) bool {
 
 func (r Rules) IsForbiddenDoubleThree(board Board, move Move, player PlayerColor) bool {
 	cell := CellFromPlayer(player)
-	board.Set(move.X, move.Y, cell)
 	openThrees := 0
-	directions := [4][2]int{{1, 0}, {0, 1}, {1, 1}, {1, -1}}
-	for i := 0; i < 4; i++ {
-		dx := directions[i][0]
-		dy := directions[i][1]
-		if r.isOpenThreeInDirection(board, move, dx, dy, cell) {
+	for _, d := range threeDirections {
+		if isOpenThreeInDirection(&board, move, d[0], d[1], cell) {
 			openThrees++
 			if openThrees >= 2 {
-				board.Remove(move.X, move.Y)
 				return true
 			}
 		}
 	}
-	board.Remove(move.X, move.Y)
-	return openThrees >= 2
+	return false
 }
 
 func (r Rules) FindCaptures(board Board, move Move, playerCell Cell) []Move {
@@ -117,10 +113,10 @@ func (r Rules) FindCapturesInto(board Board, move Move, playerCell Cell, capture
 		y2 := move.Y + 2*dy
 		x3 := move.X + 3*dx
 		y3 := move.Y + 3*dy
-		if !board.InBounds(x3, y3) || !board.InBounds(x2, y2) || !board.InBounds(x1, y1) {
+		if !board.InBounds(x3, y3) {
 			continue
 		}
-		if board.At(x1, y1) == opponentCell && board.At(x2, y2) == opponentCell && board.At(x3, y3) == playerCell {
+		if board.Has(x1, y1, opponentCell) && board.Has(x2, y2, opponentCell) && board.Has(x3, y3, playerCell) {
 			cap1 := Move{X: x1, Y: y1}
 			cap2 := Move{X: x2, Y: y2}
 			dup1 := false
@@ -272,16 +268,7 @@ func (r Rules) CaptureWinStones() int {
 }
 
 func (r Rules) countDirection(board Board, start Move, dx, dy int) int {
-	target := board.At(start.X, start.Y)
-	x := start.X + dx
-	y := start.Y + dy
-	count := 0
-	for board.InBounds(x, y) && board.At(x, y) == target {
-		count++
-		x += dx
-		y += dy
-	}
-	return count
+	return board.Run(start.X, start.Y, dx, dy, board.At(start.X, start.Y))
 }
 
 func (r Rules) collectLine(board Board, start Move, dx, dy int) []Move {
@@ -301,7 +288,9 @@ func (r Rules) collectLine(board Board, start Move, dx, dy int) []Move {
 	return line
 }
 
-func (r Rules) isOpenThreeInDirection(board Board, move Move, dx, dy int, playerCell Cell) bool {
+// isOpenThreeInDirection reports whether a playerCell stone at move, which
+// need not be placed yet, sits in an open three along (dx, dy).
+func isOpenThreeInDirection(board *Board, move Move, dx, dy int, playerCell Cell) bool {
 	const rng = 5
 	const lineSize = rng*2 + 1
 	var line [lineSize]byte
@@ -322,6 +311,7 @@ func (r Rules) isOpenThreeInDirection(board Board, move Move, dx, dy int, player
 		line[i+rng] = value
 	}
 	center := rng
+	line[center] = 'X'
 	for start := 0; start+5 <= lineSize; start++ {
 		end := start + 5
 		if center < start || center >= end {
@@ -357,10 +347,8 @@ func (r Rules) hasAnyAlignment(board Board, playerCell Cell) bool {
 	size := board.Size()
 	directions := [4][2]int{{1, 0}, {0, 1}, {1, 1}, {1, -1}}
 	for y := 0; y < size; y++ {
-		for x := 0; x < size; x++ {
-			if board.At(x, y) != playerCell {
-				continue
-			}
+		for row := board.Row(y, playerCell); row != 0; row &= row - 1 {
+			x := bits.TrailingZeros32(row)
 			move := Move{X: x, Y: y}
 			for i := 0; i < 4; i++ {
 				dx := directions[i][0]
@@ -29,8 +29,24 @@ type searchBacklog struct {
 	stop             atomic.Bool
 	limitWarned      bool
 	queueEmptyLogged bool
+	pool             *workStealingPool
+	controller       *GameController
+	maxBoards        int32
+	activeBoards     atomic.Int32
+	pausedLogged     atomic.Bool
+	live             Board
+	liveSet          bool
+	visits           int64
+	backlogHits      int64
+	solved           map[uint64]struct{}
+	solvedOrder      []uint64
+	busy             atomic.Int64 // nanoseconds spent analyzing boards
 }
 
+// backlogSolvedLimit caps how many deepened boards are remembered for the
+// uplift counters.
+const backlogSolvedLimit = 1 << 16
+
 type backlogNeedsInfo struct {
 	Needs              bool
 	TargetDepth        int
@@ -49,6 +65,7 @@ func newSearchBacklog() *searchBacklog {
 		processing:     make(map[uint64]bool),
 		priorityCounts: make(map[uint64]int),
 		analytics:      make(map[uint64]backlogAnalyticsEntry),
+		solved:         make(map[uint64]struct{}),
 	}
 }
 
@@ -204,6 +221,7 @@ func (b *searchBacklog) pickTaskForProcessing() (backlogTask, uint64, bool) {
 		if !ok || entry.Hash == 0 {
 			entry = backlogAnalyticsEntry{
 				Hash:         hash,
+				Board:        task.state.Board,
 				Stones:       countBoardStones(task.state.Board),
 				Created:      task.created,
 				Hits:         b.priorityCounts[hash],
@@ -211,6 +229,7 @@ func (b *searchBacklog) pickTaskForProcessing() (backlogTask, uint64, bool) {
 				TargetDepth:  task.targetDepth,
 			}
 		}
+		entry.Reuse = backlogExpectedReuse(entry, b.liveBoardLocked())
 		if bestIdx == -1 || compareAnaliticsPriority(entry, bestEntry) < 0 {
 			bestIdx = i
 			bestHash = hash
@@ -247,6 +266,9 @@ func (b *searchBacklog) finishTaskProcessing(hash uint64, remove bool) {
 		entry.AnalysisStartedAtMs = 0
 		b.analytics[hash] = entry
 	}
+	if entry.BacklogDepth > 0 {
+		b.addSolvedLocked(hash)
+	}
 	if !remove {
 		eventPayload = b.analiticsPayloadLocked("board_paused", hash)
 		b.mu.Unlock()
@@ -323,6 +345,7 @@ func (b *searchBacklog) markBoardDepth(hash uint64, depth int) {
 		return
 	}
 	entry.CurrentDepth = depth
+	entry.BacklogDepth = depth
 	b.analytics[hash] = entry
 	payload := b.analiticsPayloadLocked("depth_hit", hash)
 	b.mu.Unlock()
@@ -334,11 +357,13 @@ func (b *searchBacklog) topAnaliticsQueueLocked(limit int) []analiticsQueueEntry
 		return []analiticsQueueEntryDTO{}
 	}
 	items := make([]backlogAnalyticsEntry, 0, len(b.analytics))
+	live := b.liveBoardLocked()
 	for hash := range b.present {
 		entry, ok := b.analytics[hash]
 		if !ok || entry.Hash == 0 {
 			continue
 		}
+		entry.Reuse = backlogExpectedReuse(entry, live)
 		items = append(items, entry)
 	}
 	sortAnaliticsQueue(items)
@@ -355,6 +380,7 @@ func (b *searchBacklog) topAnaliticsQueueLocked(limit int) []analiticsQueueEntry
 func (b *searchBacklog) analiticsPayloadLocked(event string, hash uint64) analiticsPayload {
 	var eventEntry *analiticsQueueEventEntry
 	if analyticsEntry, ok := b.analytics[hash]; ok && analyticsEntry.Hash != 0 {
+		analyticsEntry.Reuse = backlogExpectedReuse(analyticsEntry, b.liveBoardLocked())
 		dto := analiticsEntryToEventEntry(analyticsEntry)
 		eventEntry = &dto
 	}
@@ -362,11 +388,82 @@ func (b *searchBacklog) analiticsPayloadLocked(event string, hash uint64) analit
 		Event:        event,
 		Entry:        eventEntry,
 		TotalInQueue: len(b.present),
+		Uplift:       b.upliftLocked(),
 		UpdatedAt:    time.Now().UnixMilli(),
 	}
 	return payload
 }
 
+func (b *searchBacklog) AnaliticsUplift() analiticsUplift {
+	b.mu.Lock()
+	defer b.mu.Unlock()
+	return b.upliftLocked()
+}
+
+func (b *searchBacklog) upliftLocked() analiticsUplift {
+	uplift := analiticsUplift{
+		LivePositions: b.visits,
+		BacklogHits:   b.backlogHits,
+		BacklogHours:  time.Duration(b.busy.Load()).Hours(),
+	}
+	if uplift.LivePositions > 0 {
+		uplift.HitRate = float64(uplift.BacklogHits) / float64(uplift.LivePositions)
+	}
+	if uplift.BacklogHours > 0 {
+		uplift.HitRatePerHour = uplift.HitRate / uplift.BacklogHours
+	}
+	return uplift
+}
+
+// recordVisit counts a position reached in a real game: it raises the
+// board's visits if it is queued and counts a backlog hit if the backlog
+// already deepened it.
+func (b *searchBacklog) recordVisit(state GameState) {
+	hash := ttKeyFor(state, state.Board.Size())
+	b.mu.Lock()
+	b.visits++
+	if entry := b.analytics[hash]; entry.Hash != 0 {
+		entry.Visits++
+		b.analytics[hash] = entry
+	}
+	if _, ok := b.solved[hash]; !ok {
+		b.mu.Unlock()
+		return
+	}
+	b.backlogHits++
+	payload := b.analiticsPayloadLocked("backlog_hit", hash)
+	b.mu.Unlock()
+	b.publishAnaliticsEvent(payload)
+}
+
+func (b *searchBacklog) addSolvedLocked(hash uint64) {
+	if _, ok := b.solved[hash]; ok {
+		return
+	}
+	if len(b.solvedOrder) >= backlogSolvedLimit {
+		delete(b.solved, b.solvedOrder[0])
+		b.solvedOrder = b.solvedOrder[1:]
+	}
+	b.solved[hash] = struct{}{}
+	b.solvedOrder = append(b.solvedOrder, hash)
+}
+
+// setLiveBoard records the board of the live game, which expected reuse is
+// measured against.
+func (b *searchBacklog) setLiveBoard(board Board) {
+	b.mu.Lock()
+	defer b.mu.Unlock()
+	b.live = board
+	b.liveSet = true
+}
+
+func (b *searchBacklog) liveBoardLocked() *Board {
+	if !b.liveSet {
+		return nil
+	}
+	return &b.live
+}
+
 func (b *searchBacklog) publishAnaliticsEvent(payload analiticsPayload) {
 	b.mu.Lock()
 	hub := b.analiticsHub
@@ -417,12 +514,15 @@ func (b *searchBacklog) shouldStop() bool {
 }
 
 func startSearchBacklogWorker(controller *GameController) {
-	if !GetConfig().AiQueueEnabled {
+	config := GetConfig()
+	if !config.AiQueueEnabled {
 		return
 	}
-	workerCount := backlogWorkerCount(GetConfig(), runtime.NumCPU())
-	fmt.Printf("[ai:queue] starting workers=%d\n", workerCount)
-	searchBacklogManager.startWorkers(controller, workerCount)
+	cpuCount := runtime.NumCPU()
+	boards := backlogWorkerCount(config, cpuCount)
+	threads := backlogPoolSize(config, cpuCount)
+	fmt.Printf("[ai:queue] starting workers=%d boards=%d\n", threads, boards)
+	searchBacklogManager.startWorkers(controller, boards, threads)
 }
 
 func backlogWorkerCount(config Config, cpuCount int) int {
@@ -462,6 +562,23 @@ func backlogAnalyzeThreadCount(config Config, cpuCount int) int {
 	return threads
 }
 
+// backlogPoolSize is the number of scheduler threads shared by every board
+// under analysis: one board's worth of analyze threads per queue worker,
+// capped at the CPU count.
+func backlogPoolSize(config Config, cpuCount int) int {
+	if cpuCount < 1 {
+		cpuCount = 1
+	}
+	size := backlogWorkerCount(config, cpuCount) * backlogAnalyzeThreadCount(config, cpuCount)
+	if size > cpuCount {
+		size = cpuCount
+	}
+	if size < 1 {
+		size = 1
+	}
+	return size
+}
+
 const backlogMinUsefulDepth = 6
 
 func backlogDepthRange(config Config) (int, int) {
@@ -498,8 +615,12 @@ func backlogNeedsAnalysis(state GameState, config Config, cache *AISearchCache)
 		info.Needs = true
 		return info
 	}
-	key := ttKeyFor(state, state.Board.Size())
-	entry, ok := tt.Probe(key, heuristicHashFromConfig(config))
+	key := tt.KeyFor(&state, state.Board.Size())
+	heuristicHash := heuristicHashFromConfig(config)
+	entry, ok := tt.ProbeState(&state, key, heuristicHash)
+	if !ok && SharedColdTier().Promote(tt, key, heuristicHash) {
+		entry, ok = tt.ProbeState(&state, key, heuristicHash)
+	}
 	if ok {
 		info.HasTTEntry = true
 		info.TTEntry = entry
@@ -514,18 +635,15 @@ func backlogNeedsAnalysis(state GameState, config Config, cache *AISearchCache)
 	}
 	if config.AiEnableRootTranspose {
 		if rootTranspose := ensureRootTransposeCache(cache, config); rootTranspose != nil {
-			shapeKey, bbox, shapeOK := rootShapeKey(state, state.Board.Size())
-			if shapeOK {
-				shapeEntry, shapeHit := rootTranspose.Get(shapeKey, 1)
-				if shapeHit && rootTransposeFits(bbox, shapeEntry, state.Board.Size()) {
-					info.HasRootTranspose = true
-					info.RootTransposeEntry = shapeEntry
-					if shapeEntry.Depth > info.SolvedDepth {
-						info.SolvedDepth = shapeEntry.Depth
-					}
-					if shapeEntry.Depth >= targetDepth {
-						info.Needs = false
-					}
+			shapeEntry, bbox, shapeHit := lookupRootTranspose(rootTranspose, state, state.Board.Size(), 1, config)
+			if shapeHit && rootTransposeFits(bbox, shapeEntry, state.Board.Size()) {
+				info.HasRootTranspose = true
+				info.RootTransposeEntry = shapeEntry
+				if shapeEntry.Depth > info.SolvedDepth {
+					info.SolvedDepth = shapeEntry.Depth
+				}
+				if shapeEntry.Depth >= targetDepth {
+					info.Needs = false
 				}
 			}
 		}
@@ -587,47 +705,58 @@ func rootTransposeFits(bbox boardBBox, entry RootTransposeEntry, boardSize int)
 	return true
 }
 
-func (b *searchBacklog) startWorkers(controller *GameController, count int) {
-	if count <= 0 {
-		count = 1
-	}
-	for i := 0; i < count; i++ {
-		go b.worker(controller, i)
-	}
+// startWorkers runs the backlog on a work-stealing pool of threads workers.
+// Idle workers first steal root moves from boards already being analyzed and
+// only pick a new board while fewer than boards are active.
+func (b *searchBacklog) startWorkers(controller *GameController, boards, threads int) *workStealingPool {
+	if boards <= 0 {
+		boards = 1
+	}
+	if threads < boards {
+		threads = boards
+	}
+	b.controller = controller
+	b.maxBoards = int32(boards)
+	b.pool = newWorkStealingPool(threads, b.idleWorker, 150*time.Millisecond)
+	b.pool.Start()
+	return b.pool
 }
 
-func (b *searchBacklog) worker(controller *GameController, _ int) {
-	pausedLogged := false
-	for {
-		if controller != nil {
-			state := controller.State()
-			if state.Status == StatusRunning {
-				b.RequestStop()
-				if b.Len() > 0 && !pausedLogged {
-					fmt.Printf("[ai:queue] game running, pausing backlog (%d queued)\n", b.Len())
-					pausedLogged = true
-				}
-				time.Sleep(150 * time.Millisecond)
-				continue
+func (b *searchBacklog) idleWorker(worker int) bool {
+	if b.controller != nil {
+		state := b.controller.State()
+		if state.Status == StatusRunning {
+			b.RequestStop()
+			if b.Len() > 0 && b.pausedLogged.CompareAndSwap(false, true) {
+				fmt.Printf("[ai:queue] game running, pausing backlog (%d queued)\n", b.Len())
 			}
+			return false
 		}
-		pausedLogged = false
-		task, hash, ok := b.pickTaskForProcessing()
-		if !ok {
-			b.logQueueEmptyIfNeeded()
-			time.Sleep(150 * time.Millisecond)
-			continue
-		}
-		b.setCurrentBoard(hash)
-		b.markBoardStarted(hash)
-		b.ResetStop()
-		completed := b.processTask(task)
-		b.finishTaskProcessing(hash, completed)
-		b.clearCurrentBoard()
+		b.setLiveBoard(state.Board)
+	}
+	b.pausedLogged.Store(false)
+	if b.activeBoards.Add(1) > b.maxBoards {
+		b.activeBoards.Add(-1)
+		return false
+	}
+	defer b.activeBoards.Add(-1)
+	task, hash, ok := b.pickTaskForProcessing()
+	if !ok {
+		b.logQueueEmptyIfNeeded()
+		return false
 	}
+	b.setCurrentBoard(hash)
+	b.markBoardStarted(hash)
+	b.ResetStop()
+	start := time.Now()
+	completed := b.processTask(task, worker)
+	b.busy.Add(int64(time.Since(start)))
+	b.finishTaskProcessing(hash, completed)
+	b.clearCurrentBoard()
+	return true
 }
 
-func (b *searchBacklog) processTask(task backlogTask) bool {
+func (b *searchBacklog) processTask(task backlogTask, worker int) bool {
 	config := GetConfig()
 	debugLogs := config.AiLogSearchStats
 	config.AiTimeBudgetMs = 0
@@ -647,6 +776,9 @@ func (b *searchBacklog) processTask(task backlogTask) bool {
 		return true
 	}
 	analyzeThreads := backlogAnalyzeThreadCount(config, runtime.NumCPU())
+	if b.pool != nil {
+		analyzeThreads = b.pool.Workers()
+	}
 	rootCandidates := collectCandidateMoves(task.state, task.state.ToMove, task.state.Board.Size())
 	effectiveThreads := analyzeThreads
 	if effectiveThreads > len(rootCandidates) {
@@ -678,6 +810,9 @@ func (b *searchBacklog) processTask(task backlogTask) bool {
 		DirectDepthOnly:  true,
 		SkipQueueBacklog: true,
 	}
+	if b.pool != nil {
+		settings.RunRootJobs = b.pool.rootJobRunner(worker)
+	}
 	if debugLogs {
 		settings.OnNodeProgress = func(delta int64) {
 			if delta > 0 {
@@ -818,10 +953,11 @@ func (b *searchBacklog) processTask(task backlogTask) bool {
 		beforeABCutoffs := stats.ABCutoffs
 		depthSettings := settings
 		depthSettings.Depth = depth
+		var depthScores []float64
 		if effectiveThreads > 1 {
-			_, completed = ScoreBoardDirectDepthParallel(task.state.Clone(), task.rules, depthSettings, effectiveThreads)
+			depthScores, completed = ScoreBoardDirectDepthParallel(task.state.Clone(), task.rules, depthSettings, effectiveThreads)
 		} else {
-			_ = ScoreBoard(task.state.Clone(), task.rules, depthSettings)
+			depthScores = ScoreBoard(task.state.Clone(), task.rules, depthSettings)
 			completed = stats.CompletedDepths >= depth
 		}
 		if !completed || stats.CompletedDepths < depth {
@@ -829,6 +965,7 @@ func (b *searchBacklog) processTask(task backlogTask) bool {
 			break
 		}
 		completedDepth = depth
+		recordBookResult(task.state, task.rules, depthSettings, depthScores, depth)
 		if debugLogs {
 			depthElapsedMs := time.Since(depthStart).Milliseconds()
 			deltaNodes := stats.Nodes - beforeNodes
@@ -858,6 +995,7 @@ func (b *searchBacklog) processTask(task backlogTask) bool {
 	}
 
 	elapsed := time.Since(start)
+	recordSearchMetrics("backlog", stats)
 	shouldStop := b.shouldStop()
 	done := completed && completedDepth >= targetDepth && !shouldStop
 	if shouldStop {
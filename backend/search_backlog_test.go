@@ -305,7 +305,7 @@ func TestBacklogNeedsAnalysisSkipsWhenRootTransposeEntryMeetsTarget(t *testing.T
 		t.Fatalf("expected root transpose cache to be initialized")
 	}
 	_, target := backlogDepthRange(cfg)
-	key, _, ok := rootShapeKey(state, state.Board.Size())
+	key, _, _, ok := rootTransposeKey(state, state.Board.Size(), cfg)
 	if !ok {
 		t.Fatalf("expected shape key for non-empty board")
 	}
@@ -367,7 +367,7 @@ func TestBacklogStartDepthUsesKnownAndSolvedDepth(t *testing.T) {
 	}
 }
 
-func TestTopAnaliticsQueueTieBreaksByStonesThenRemainingDepthThenCreated(t *testing.T) {
+func TestTopAnaliticsQueueOrdersByExpectedReuseThenStones(t *testing.T) {
 	b := newSearchBacklog()
 	settings := DefaultGameSettings()
 
@@ -399,14 +399,14 @@ func TestTopAnaliticsQueueTieBreaksByStonesThenRemainingDepthThenCreated(t *test
 	expectedSecond := hashToBoardID(ttKeyFor(stateManyDeep, stateManyDeep.Board.Size()))
 	expectedThird := hashToBoardID(ttKeyFor(stateFew, stateFew.Board.Size()))
 
-	if queue[0].ID != expectedFirst {
-		t.Fatalf("expected first board %s (more stones), got %s", expectedFirst, queue[0].ID)
+	if queue[0].ID != expectedSecond {
+		t.Fatalf("expected first board %s (more remaining depth, more stones), got %s", expectedSecond, queue[0].ID)
 	}
-	if queue[1].ID != expectedSecond {
-		t.Fatalf("expected second board %s (more remaining depth), got %s", expectedSecond, queue[1].ID)
+	if queue[1].ID != expectedThird {
+		t.Fatalf("expected second board %s (more remaining depth), got %s", expectedThird, queue[1].ID)
 	}
-	if queue[2].ID != expectedThird {
-		t.Fatalf("expected third board %s, got %s", expectedThird, queue[2].ID)
+	if queue[2].ID != expectedFirst {
+		t.Fatalf("expected third board %s (one depth left), got %s", expectedFirst, queue[2].ID)
 	}
 }
 
@@ -438,3 +438,60 @@ func TestPickTaskForProcessingTieBreaksByStonesThenRemainingDepthThenCreated(t *
 		t.Fatalf("expected picked task to match hash 0x%x", expectedHash)
 	}
 }
+
+func TestBacklogExpectedReuseUsesVisitsAndLiveProximity(t *testing.T) {
+	b := newSearchBacklog()
+	settings := DefaultGameSettings()
+	live := DefaultGameState(settings)
+	live.Board.Set(9, 9, CellBlack)
+	live.Board.Set(9, 10, CellWhite)
+	b.setLiveBoard(live.Board)
+
+	near := live
+	near.Board.Set(10, 10, CellBlack)
+	near.recomputeHashes()
+	far := DefaultGameState(settings)
+	far.Board.Set(3, 3, CellBlack)
+	far.Board.Set(4, 4, CellWhite)
+	far.recomputeHashes()
+	nearID := hashToBoardID(ttKeyFor(near, near.Board.Size()))
+	farID := hashToBoardID(ttKeyFor(far, far.Board.Size()))
+
+	b.enqueue(backlogTask{state: near, created: time.Unix(2, 0), knownDepth: 6, targetDepth: 12}, false)
+	b.enqueue(backlogTask{state: far, created: time.Unix(1, 0), knownDepth: 6, targetDepth: 12}, false)
+	if queue := b.TopAnaliticsQueue(10); queue[0].ID != nearID || queue[0].ExpectedReuse <= queue[1].ExpectedReuse {
+		t.Fatalf("the board next to the live position should come first: %+v", queue)
+	}
+
+	// Far differs from live on 4 cells: 3 sightings outweigh that.
+	b.recordVisit(far)
+	b.recordVisit(far)
+	queue := b.TopAnaliticsQueue(10)
+	if queue[0].ID != farID || queue[0].Visits != 2 {
+		t.Fatalf("the often visited board should come first: %+v", queue)
+	}
+
+	farHash := ttKeyFor(far, far.Board.Size())
+	b.processing[farHash] = true
+	b.markBoardDepth(farHash, 8)
+	b.finishTaskProcessing(farHash, true)
+	b.busy.Add(int64(30 * time.Minute))
+	b.recordVisit(near)
+	b.recordVisit(far)
+	uplift := b.AnaliticsUplift()
+	if uplift.LivePositions != 4 || uplift.BacklogHits != 1 || uplift.HitRate != 0.25 || uplift.HitRatePerHour != 0.5 {
+		t.Fatalf("uplift: %+v", uplift)
+	}
+}
+
+func TestBacklogPoolSizeMergesWorkersAndAnalyzeThreads(t *testing.T) {
+	cfg := DefaultConfig()
+	cfg.AiQueueWorkers = 2
+	cfg.AiQueueAnalyzeThreads = 3
+	if got := backlogPoolSize(cfg, 16); got != 6 {
+		t.Fatalf("expected pool of 6 threads, got %d", got)
+	}
+	if got := backlogPoolSize(cfg, 4); got != 4 {
+		t.Fatalf("expected pool capped to cpu count, got %d", got)
+	}
+}
@@ -0,0 +1,94 @@
+package main
+
+import (
+	"math"
+	"sync"
+	"sync/atomic"
+	"time"
+)
+
+const (
+	searchParallelYBWC    = "ybwc"
+	searchParallelLazySMP = "lazy_smp"
+)
+
+// lazySMPHelpers runs extra root searches whose only product is TT entries;
+// the calling search still owns the scores it returns.
+type lazySMPHelpers struct {
+	stop  atomic.Bool
+	wg    sync.WaitGroup
+	stats []SearchStats
+}
+
+func useLazySMP(config Config) bool {
+	return config.AiSearchParallelMode == searchParallelLazySMP
+}
+
+// startLazySMPHelpers launches count helpers over candidates. Helper i walks
+// the root list rotated by i and starts one ply deeper on odd indexes, so
+// helpers rarely duplicate each other or the main thread.
+func startLazySMPHelpers(state GameState, rules Rules, settings AIScoreSettings, candidates []Move, minDepth, maxDepth, count int, start time.Time) *lazySMPHelpers {
+	if count <= 0 || len(candidates) == 0 {
+		return nil
+	}
+	if minDepth < 1 {
+		minDepth = 1
+	}
+	h := &lazySMPHelpers{stats: make([]SearchStats, count)}
+	parentStop := settings.ShouldStop
+	rootHash := ttKeyFor(state, settings.BoardSize)
+	for i := 0; i < count; i++ {
+		h.wg.Add(1)
+		go func(helper int) {
+			defer h.wg.Done()
+			localStats := &h.stats[helper]
+			localSettings := settings
+			localSettings.Stats = localStats
+			localSettings.OnGhostUpdate = nil
+			localSettings.OnDepthComplete = nil
+			localSettings.OnDepthScores = nil
+			localSettings.OnSearchProgress = nil
+			localSettings.ShouldStop = func() bool {
+				return h.stop.Load() || (parentStop != nil && parentStop())
+			}
+			localCtx := newMinimaxContext(rules, localSettings, start)
+			localCtx.footprint = newSearchFootprint(state, settings.BoardSize)
+			localState := state.Clone()
+			offset := (helper + 1) % len(candidates)
+			for depth := minDepth + (helper+1)%2; depth <= maxDepth; depth++ {
+				localCtx.killerBase = depth
+				for j := range candidates {
+					if timedOut(localCtx) {
+						return
+					}
+					move := candidates[(j+offset)%len(candidates)]
+					evaluateMoveWithCache(&localState, localCtx, settings.Player, move, depth, depth, rootHash, nil, math.Inf(-1), math.Inf(1))
+				}
+			}
+		}(i)
+	}
+	return h
+}
+
+// finish stops the helpers, waits for them and folds their stats into dst.
+func (h *lazySMPHelpers) finish(dst *SearchStats) {
+	if h == nil {
+		return
+	}
+	h.stop.Store(true)
+	h.wg.Wait()
+	for i := range h.stats {
+		local := &h.stats[i]
+		local.HelperThreads = 1
+		local.HelperNodes = local.Nodes
+		mergeSearchStats(dst, local)
+	}
+}
+
+func candidateMovesOnly(candidates []candidateMove) []Move {
+	moves := make([]Move, len(candidates))
+	for i, cand := range candidates {
+		moves[i] = cand.move
+	}
+	return moves
+}
@@ -0,0 +1,59 @@
+package main
+
+// candidateCapPlies covers every depthFromRoot candidateLimit distinguishes;
+// deeper plies share the last entry.
+const candidateCapPlies = 10
+
+// searchProfile is the config the search reads at every node, resolved once
+// per root search and shared by all of its contexts, so nodes load fields
+// instead of re-resolving heuristics or re-hashing them.
+type searchProfile struct {
+	heuristics    HeuristicConfig
+	weights       ThreatWeights
+	heuristicHash uint64
+	// candidateCaps[tactical][deep][ply], where deep means depthLeft >= 3.
+	candidateCaps [2][2][candidateCapPlies]int
+}
+
+func newSearchProfile(config Config) *searchProfile {
+	p := &searchProfile{heuristics: resolvedHeuristicConfig(config)}
+	p.weights = threatWeightsFor(p.heuristics)
+	p.heuristicHash = heuristicHash(p.heuristics)
+	for tactical := 0; tactical < 2; tactical++ {
+		for deep := 0; deep < 2; deep++ {
+			depthLeft := 3 * deep
+			for ply := 0; ply < candidateCapPlies; ply++ {
+				p.candidateCaps[tactical][deep][ply] = computeCandidateLimit(config, depthLeft, ply, tactical == 1)
+			}
+		}
+	}
+	return p
+}
+
+func (p *searchProfile) candidateLimit(depthLeft, depthFromRoot int, tactical bool) int {
+	t, d := 0, 0
+	if tactical {
+		t = 1
+	}
+	if depthLeft >= 3 {
+		d = 1
+	}
+	return p.candidateCaps[t][d][min(max(depthFromRoot, 0), candidateCapPlies-1)]
+}
+
+// profileOrResolve returns ctx's profile, resolving it for contexts that were
+// built without newMinimaxContext.
+func (ctx *minimaxContext) profileOrResolve() *searchProfile {
+	if ctx.profile == nil {
+		ctx.profile = newSearchProfile(ctx.settings.Config)
+	}
+	return ctx.profile
+}
+
+// withSearchProfile fills settings.Profile from settings.Config if unset.
+func withSearchProfile(settings AIScoreSettings) AIScoreSettings {
+	if settings.Profile == nil {
+		settings.Profile = newSearchProfile(settings.Config)
+	}
+	return settings
+}
@@ -0,0 +1,29 @@
+package main
+
+import "testing"
+
+func TestSearchProfileMatchesConfig(t *testing.T) {
+	configs := []Config{DefaultConfig(), DefaultConfig(), DefaultConfig()}
+	configs[1].AiEnableHardPlyCaps = true
+	configs[1].AiEnableTacticalK = true
+	configs[2].AiEnableHardPlyCaps = false
+	configs[2].AiEnableDynamicTopK = true
+	configs[2].AiEnableTacticalK = false
+	configs[2].AiMaxCandidatesPly9 = 5
+	for i, cfg := range configs {
+		profile := newSearchProfile(cfg)
+		if profile.heuristicHash != heuristicHashFromConfig(cfg) {
+			t.Fatalf("config %d: profile heuristic hash %x, want %x", i, profile.heuristicHash, heuristicHashFromConfig(cfg))
+		}
+		for _, tactical := range []bool{false, true} {
+			for depthLeft := 1; depthLeft <= 5; depthLeft++ {
+				for ply := 0; ply <= candidateCapPlies+2; ply++ {
+					want := computeCandidateLimit(cfg, depthLeft, ply, tactical)
+					if got := profile.candidateLimit(depthLeft, ply, tactical); got != want {
+						t.Fatalf("config %d: candidateLimit(%d, %d, %v) = %d, want %d", i, depthLeft, ply, tactical, got, want)
+					}
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,149 @@
+package main
+
+import "sync"
+
+// searchCarry is what one root search leaves for the next search of the same
+// player: the principal variation as a chain of oriented keys, the depth it
+// completed and its killer and history tables. OnMoveApplied reroots it onto
+// the position the game reached; if that position is off the PV the carry is
+// dropped.
+type searchCarry struct {
+	mu        sync.Mutex
+	boardSize int
+	depth     int
+	pvKeys    []uint64 // pvKeys[0] is the root the tables belong to
+	killers   [][]Move // indexed by ply from pvKeys[0], as killerPly
+	history   []int
+}
+
+func (c *searchCarry) reset() {
+	c.depth = 0
+	c.pvKeys = nil
+	c.killers = nil
+	c.history = nil
+}
+
+// capture records a finished search. The PV is read back from the TT, so it
+// stops at the first position the TT no longer holds.
+func (c *searchCarry) capture(state GameState, ctx *minimaxContext, tt *TranspositionTable, depth int) {
+	if c == nil || depth <= 0 {
+		return
+	}
+	settings := ctx.settings
+	keys := principalVariationKeys(state, ctx.rules, tt, settings.BoardSize, settings.Profile.heuristicHash, depth)
+	killers := make([][]Move, len(ctx.killers))
+	for i, ply := range ctx.killers {
+		killers[i] = append([]Move(nil), ply...)
+	}
+	c.mu.Lock()
+	defer c.mu.Unlock()
+	c.boardSize = settings.BoardSize
+	c.depth = depth
+	c.pvKeys = keys
+	c.killers = killers
+	c.history = append([]int(nil), ctx.history...)
+}
+
+func principalVariationKeys(state GameState, rules Rules, tt *TranspositionTable, boardSize int, heuristicHash uint64, depth int) []uint64 {
+	keys := make([]uint64, 0, depth+1)
+	walkPrincipalVariation(state, rules, tt, boardSize, heuristicHash, depth, func(_ Move, walk *GameState) {
+		keys = append(keys, orientedKeyFor(walk, boardSize))
+	})
+	return keys
+}
+
+// principalVariation is the PV's moves from state, read back from the TT.
+func principalVariation(state GameState, rules Rules, tt *TranspositionTable, boardSize int, heuristicHash uint64, depth int) []Move {
+	moves := make([]Move, 0, depth)
+	walkPrincipalVariation(state, rules, tt, boardSize, heuristicHash, depth, func(move Move, _ *GameState) {
+		if move.IsValid(boardSize) {
+			moves = append(moves, move)
+		}
+	})
+	return moves
+}
+
+// walkPrincipalVariation calls visit with the root, as an invalid move, and
+// then after each of up to depth TT best moves.
+func walkPrincipalVariation(state GameState, rules Rules, tt *TranspositionTable, boardSize int, heuristicHash uint64, depth int, visit func(move Move, walk *GameState)) {
+	walk := state.Clone()
+	if walk.Hash == 0 {
+		walk.recomputeHashes()
+	}
+	visit(Move{X: -1, Y: -1}, &walk)
+	for plies := 0; plies < depth && walk.Status == StatusRunning; plies++ {
+		entry, ok := tt.ProbeState(&walk, tt.KeyFor(&walk, boardSize), heuristicHash)
+		if !ok || !entry.BestMove.IsValid(boardSize) {
+			return
+		}
+		var undo searchMoveUndo
+		if !applyMoveWithUndo(&walk, rules, entry.BestMove, walk.ToMove, &undo) {
+			return
+		}
+		visit(entry.BestMove, &walk)
+	}
+}
+
+// reroot moves the carry to state, which must lie on the stored PV. Killers
+// shift up by the plies played and history is halved so the old tree's
+// counts fade.
+func (c *searchCarry) reroot(state *GameState) {
+	if c == nil {
+		return
+	}
+	c.mu.Lock()
+	defer c.mu.Unlock()
+	if len(c.pvKeys) == 0 {
+		return
+	}
+	if state.Hash == 0 {
+		state.recomputeHashes()
+	}
+	key := orientedKeyFor(state, c.boardSize)
+	plies := -1
+	for i, k := range c.pvKeys {
+		if k == key {
+			plies = i
+			break
+		}
+	}
+	if plies < 0 || c.depth-plies < 1 {
+		c.reset()
+		return
+	}
+	if plies == 0 {
+		return
+	}
+	c.depth -= plies
+	c.pvKeys = c.pvKeys[plies:]
+	if plies < len(c.killers) {
+		c.killers = c.killers[plies:]
+	} else {
+		c.killers = nil
+	}
+	for i := range c.history {
+		c.history[i] /= 2
+	}
+}
+
+// seed copies the carried tables into ctx when state is the carried root and
+// returns the depth the carried tree reached there. ctx sized its tables from
+// the current config, so only the overlap is copied.
+func (c *searchCarry) seed(ctx *minimaxContext, state *GameState) (int, bool) {
+	if c == nil {
+		return 0, false
+	}
+	boardSize := ctx.settings.BoardSize
+	c.mu.Lock()
+	defer c.mu.Unlock()
+	if len(c.pvKeys) == 0 || c.boardSize != boardSize || c.pvKeys[0] != orientedKeyFor(state, boardSize) {
+		return 0, false
+	}
+	for i := 0; i < len(ctx.killers) && i < len(c.killers); i++ {
+		ctx.killers[i] = append(ctx.killers[i][:0], c.killers[i]...)
+	}
+	if len(ctx.history) == len(c.history) {
+		copy(ctx.history, c.history)
+	}
+	return c.depth, true
+}
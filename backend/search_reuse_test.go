@@ -0,0 +1,144 @@
+package main
+
+import (
+	"fmt"
+	"testing"
+	"time"
+)
+
+func TestSearchCarryFollowsThePV(t *testing.T) {
+	corpus, rules := loadBenchCorpus(t)
+	cfg := benchConfig()
+	cfg.AiMaxDepth = 4
+	cache := newAISearchCache()
+	var carry searchCarry
+	search := func(state GameState) *SearchStats {
+		stats := &SearchStats{}
+		ScoreBoard(state, rules, AIScoreSettings{
+			Depth:            cfg.AiMaxDepth,
+			BoardSize:        state.Board.Size(),
+			Player:           state.ToMove,
+			Cache:            &cache,
+			Config:           cfg,
+			Stats:            stats,
+			SkipQueueBacklog: true,
+			Carry:            &carry,
+		})
+		return stats
+	}
+
+	var root GameState
+	for _, pos := range corpus {
+		if pos.name == "middle_wide" {
+			root = pos.state.Clone()
+			break
+		}
+	}
+	if stats := search(root); stats.CarriedDepth != 0 || stats.CompletedDepths != cfg.AiMaxDepth {
+		t.Fatalf("first search: carried=%d completed=%d", stats.CarriedDepth, stats.CompletedDepths)
+	}
+	if carry.depth != cfg.AiMaxDepth || len(carry.pvKeys) < 3 {
+		t.Fatalf("carry holds depth %d and a %d-key PV", carry.depth, len(carry.pvKeys))
+	}
+
+	// Follow the PV two plies, as the game would after our move and a reply.
+	next := root.Clone()
+	tt := cache.TT
+	for ply := 0; ply < 2; ply++ {
+		entry, ok := tt.ProbeState(&next, tt.KeyFor(&next, next.Board.Size()), heuristicHashFromConfig(cfg))
+		if !ok {
+			t.Fatalf("ply %d: PV position missing from the TT", ply)
+		}
+		var undo searchMoveUndo
+		if !applyMoveWithUndo(&next, rules, entry.BestMove, next.ToMove, &undo) {
+			t.Fatalf("ply %d: PV move %v is illegal", ply, entry.BestMove)
+		}
+		carry.reroot(&next)
+	}
+	if carry.depth != cfg.AiMaxDepth-2 {
+		t.Fatalf("rerooted carry depth %d, want %d", carry.depth, cfg.AiMaxDepth-2)
+	}
+	stats := search(next)
+	if stats.CarriedDepth != cfg.AiMaxDepth-2 || stats.CompletedDepths != cfg.AiMaxDepth {
+		t.Fatalf("second search: carried=%d completed=%d", stats.CarriedDepth, stats.CompletedDepths)
+	}
+
+	// A position off the PV drops the carry.
+	carry.reroot(&root)
+	if _, ok := carry.seed(&minimaxContext{settings: AIScoreSettings{BoardSize: root.Board.Size()}}, &root); ok {
+		t.Fatalf("carry survived a reroot onto a position off its PV")
+	}
+}
+
+func TestSearchCarryKeepsKillersOnTheirPly(t *testing.T) {
+	corpus, rules := loadBenchCorpus(t)
+	cfg := benchConfig()
+	cfg.AiMaxDepth = 4
+	cache := newAISearchCache()
+	var carry searchCarry
+	var root GameState
+	for _, pos := range corpus {
+		if pos.name == "middle_wide" {
+			root = pos.state.Clone()
+			break
+		}
+	}
+	settings := AIScoreSettings{
+		Depth:            cfg.AiMaxDepth,
+		BoardSize:        root.Board.Size(),
+		Player:           root.ToMove,
+		Cache:            &cache,
+		Config:           cfg,
+		SkipQueueBacklog: true,
+		Carry:            &carry,
+	}
+	ScoreBoard(root, rules, settings)
+
+	// Nodes one ply below the root cut off at every depth past the first;
+	// indexing by iteration depth left this slot empty.
+	if len(carry.killers) < 4 || len(carry.killers[1]) == 0 {
+		t.Fatalf("no killers carried for ply 1: %v", carry.killers)
+	}
+	want := make([][]Move, len(carry.killers))
+	for i, ply := range carry.killers {
+		want[i] = append([]Move(nil), ply...)
+	}
+
+	next := root.Clone()
+	tt := cache.TT
+	for ply := 0; ply < 2; ply++ {
+		entry, ok := tt.ProbeState(&next, tt.KeyFor(&next, next.Board.Size()), heuristicHashFromConfig(cfg))
+		if !ok {
+			t.Fatalf("ply %d: PV position missing from the TT", ply)
+		}
+		var undo searchMoveUndo
+		if !applyMoveWithUndo(&next, rules, entry.BestMove, next.ToMove, &undo) {
+			t.Fatalf("ply %d: PV move %v is illegal", ply, entry.BestMove)
+		}
+		carry.reroot(&next)
+	}
+
+	// Two plies down, old ply 3 is the new ply 1 and must be found there at
+	// any iteration depth.
+	settings.Player = next.ToMove
+	ctx := newMinimaxContext(rules, withSearchProfile(settings), time.Now())
+	if _, ok := carry.seed(ctx, &next); !ok {
+		t.Fatalf("carry did not seed the PV position")
+	}
+	if len(want[3]) == 0 {
+		t.Fatalf("no killers recorded at ply 3: %v", want)
+	}
+	for ply := 0; ply+2 < len(want) && ply < len(ctx.killers); ply++ {
+		if fmt.Sprint(ctx.killers[ply]) != fmt.Sprint(want[ply+2]) {
+			t.Fatalf("seeded ply %d holds %v, want old ply %d's %v", ply, ctx.killers[ply], ply+2, want[ply+2])
+		}
+	}
+	for _, depth := range []int{1, cfg.AiMaxDepth} {
+		ctx.killerBase = depth
+		for _, move := range want[3] {
+			if !isKillerMove(ctx, depth+1, move) {
+				t.Fatalf("depth %d: killer %v of ply 1 not found", depth, move)
+			}
+		}
+	}
+}
@@ -0,0 +1,58 @@
+package main
+
+// plyScratch owns the move lists built while expanding one node. Only the node
+// at the matching depthFromRoot writes to it, and its children use deeper
+// plies, so lists stay valid for the whole move loop.
+type plyScratch struct {
+	candidates []candidateMove
+	tactical   []candidateMove
+	defensive  []candidateMove
+	scored     []scoredMove
+	moves      []Move
+	wins       []Move
+	blocks     []Move
+	responses  []Move
+}
+
+// searchScratch is shared by every copy of a minimaxContext built from the
+// same newMinimaxContext call, so it must not be used by two goroutines.
+type searchScratch struct {
+	plies []plyScratch
+}
+
+const scratchMovesPerPly = 96
+
+func newSearchScratch(plies int) *searchScratch {
+	if plies < 1 {
+		plies = 1
+	}
+	return &searchScratch{plies: make([]plyScratch, plies)}
+}
+
+func (p *plyScratch) init() {
+	p.candidates = make([]candidateMove, 0, scratchMovesPerPly)
+	p.tactical = make([]candidateMove, 0, scratchMovesPerPly)
+	p.defensive = make([]candidateMove, 0, scratchMovesPerPly)
+	p.scored = make([]scoredMove, 0, scratchMovesPerPly)
+	p.moves = make([]Move, 0, scratchMovesPerPly)
+	p.wins = make([]Move, 0, 16)
+	p.blocks = make([]Move, 0, scratchMovesPerPly)
+	p.responses = make([]Move, 0, scratchMovesPerPly)
+}
+
+// ply returns the buffers for depthFromRoot, allocating them on first use.
+// The table grows past the planned depth when root offsets or extensions
+// need it; a running node keeps its old pointer, whose slices stay valid.
+func (s *searchScratch) ply(depthFromRoot int) *plyScratch {
+	if s == nil || depthFromRoot < 0 {
+		return nil
+	}
+	for depthFromRoot >= len(s.plies) {
+		s.plies = append(s.plies, plyScratch{})
+	}
+	p := &s.plies[depthFromRoot]
+	if p.moves == nil {
+		p.init()
+	}
+	return p
+}
@@ -0,0 +1,195 @@
+package main
+
+import (
+	"fmt"
+	"sync"
+	"time"
+)
+
+// searchTrace is the flight recorder of one root search. Every search
+// context gets its own fixed-size ring, so recording takes no locks; when a
+// ring wraps the oldest events are overwritten. Searches only trace when
+// AiSearchTrace is on and the caller labelled them, and contexts check
+// ctx.trace for nil before building an event, so tracing off costs one
+// branch per site.
+type searchTrace struct {
+	label    string
+	start    time.Time
+	end      time.Time
+	capacity int
+	mu       sync.Mutex
+	rings    []*traceRing
+}
+
+type traceKind uint8
+
+const (
+	traceSearch traceKind = iota
+	traceIteration
+	traceNode
+	traceTTHit
+	traceTTCutoff
+	traceCutoff
+)
+
+var traceKindNames = [...]string{
+	traceSearch:    "search",
+	traceIteration: "iteration",
+	traceNode:      "node",
+	traceTTHit:     "tt_hit",
+	traceTTCutoff:  "tt_cutoff",
+	traceCutoff:    "cutoff",
+}
+
+type tracePhase uint8
+
+const (
+	traceInstant tracePhase = iota
+	traceBegin
+	traceEnd
+)
+
+// traceEvent is fixed-size so a ring is one flat allocation.
+type traceEvent struct {
+	at    int64 // nanoseconds since the search started
+	value float32
+	kind  traceKind
+	phase tracePhase
+	depth int8
+	ply   uint8
+	x, y  int8
+}
+
+type traceRing struct {
+	start  time.Time
+	tid    int
+	events []traceEvent
+	n      uint64
+}
+
+var (
+	searchTracesMu sync.Mutex
+	searchTraces   = map[string]*searchTrace{}
+	lastTrace      *searchTrace
+)
+
+func newSearchTrace(label string, capacity int) *searchTrace {
+	if capacity < 1 {
+		capacity = 1
+	}
+	return &searchTrace{label: label, start: time.Now(), capacity: int(nextPowerOfTwo(uint64(capacity)))}
+}
+
+// ring returns a new ring for one search context; nil when t is nil.
+func (t *searchTrace) ring() *traceRing {
+	if t == nil {
+		return nil
+	}
+	t.mu.Lock()
+	defer t.mu.Unlock()
+	r := &traceRing{start: t.start, tid: len(t.rings), events: make([]traceEvent, t.capacity)}
+	t.rings = append(t.rings, r)
+	return r
+}
+
+func (r *traceRing) emit(kind traceKind, phase tracePhase, ply, depth int, move Move, value float64) {
+	e := &r.events[r.n&uint64(len(r.events)-1)]
+	e.at = int64(time.Since(r.start))
+	e.value = float32(value)
+	e.kind = kind
+	e.phase = phase
+	e.depth = int8(depth)
+	e.ply = uint8(ply)
+	e.x = int8(move.X)
+	e.y = int8(move.Y)
+	r.n++
+}
+
+// finish makes t the latest trace of its label.
+func (t *searchTrace) finish() {
+	t.end = time.Now()
+	searchTracesMu.Lock()
+	searchTraces[t.label] = t
+	lastTrace = t
+	searchTracesMu.Unlock()
+}
+
+// latestSearchTrace returns the last finished trace labelled label, or the
+// last of any label when label is empty.
+func latestSearchTrace(label string) *searchTrace {
+	searchTracesMu.Lock()
+	defer searchTracesMu.Unlock()
+	if label == "" {
+		return lastTrace
+	}
+	return searchTraces[label]
+}
+
+type chromeTraceEvent struct {
+	Name string         `json:"name"`
+	Ph   string         `json:"ph"`
+	Ts   float64        `json:"ts"`
+	Pid  int            `json:"pid"`
+	Tid  int            `json:"tid"`
+	S    string         `json:"s,omitempty"`
+	Args map[string]any `json:"args,omitempty"`
+}
+
+type chromeTrace struct {
+	TraceEvents     []chromeTraceEvent `json:"traceEvents"`
+	DisplayTimeUnit string             `json:"displayTimeUnit"`
+	OtherData       map[string]any     `json:"otherData"`
+}
+
+// chromeTrace converts t to the Chrome trace-event JSON format that
+// chrome://tracing and Perfetto load. It must be called after the search
+// finished, when no context writes to the rings any more.
+func (t *searchTrace) chromeTrace() chromeTrace {
+	t.mu.Lock()
+	rings := append([]*traceRing(nil), t.rings...)
+	t.mu.Unlock()
+	out := chromeTrace{
+		DisplayTimeUnit: "ns",
+		OtherData: map[string]any{
+			"label":       t.label,
+			"started_at":  t.start.UnixMilli(),
+			"duration_ms": t.end.Sub(t.start).Milliseconds(),
+		},
+	}
+	dropped := uint64(0)
+	for _, r := range rings {
+		size := uint64(len(r.events))
+		first := uint64(0)
+		if r.n > size {
+			first = r.n - size
+			dropped += first
+		}
+		for i := first; i < r.n; i++ {
+			e := r.events[i&(size-1)]
+			ev := chromeTraceEvent{Name: traceKindNames[e.kind], Ts: float64(e.at) / 1e3, Pid: 1, Tid: r.tid}
+			switch e.phase {
+			case traceBegin:
+				ev.Ph = "B"
+			case traceEnd:
+				ev.Ph = "E"
+			default:
+				ev.Ph = "i"
+				ev.S = "t"
+			}
+			if e.kind == traceIteration || e.kind == traceSearch {
+				ev.Name = fmt.Sprintf("%s d%d", ev.Name, e.depth)
+			}
+			ev.Args = map[string]any{"depth": e.depth, "ply": e.ply}
+			switch e.kind {
+			case traceTTHit, traceTTCutoff, traceCutoff:
+				ev.Args["value"] = e.value
+			}
+			if e.kind == traceCutoff || e.kind == traceTTHit {
+				ev.Args["move"] = fmt.Sprintf("%d,%d", e.x, e.y)
+			}
+			out.TraceEvents = append(out.TraceEvents, ev)
+		}
+	}
+	out.OtherData["dropped_events"] = dropped
+	return out
+}
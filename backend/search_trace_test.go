@@ -0,0 +1,67 @@
+package main
+
+import (
+	"encoding/json"
+	"testing"
+)
+
+func TestSearchTraceRecordsLabelledSearches(t *testing.T) {
+	corpus, rules := loadBenchCorpus(t)
+	var root GameState
+	for _, pos := range corpus {
+		if pos.name == "middle_wide" {
+			root = pos.state.Clone()
+			break
+		}
+	}
+	cfg := benchConfig()
+	cfg.AiMaxDepth = 3
+	cfg.AiSearchTrace = true
+	cfg.AiSearchTraceEvents = 1 << 20
+	search := func(label string, cfg Config) {
+		cache := newAISearchCache()
+		ScoreBoard(root.Clone(), rules, AIScoreSettings{
+			Depth:            cfg.AiMaxDepth,
+			BoardSize:        root.Board.Size(),
+			Player:           root.ToMove,
+			Cache:            &cache,
+			Config:           cfg,
+			SkipQueueBacklog: true,
+			TraceLabel:       label,
+		})
+	}
+
+	search("", cfg)
+	if latestSearchTrace("") != nil {
+		t.Fatalf("an unlabelled search was traced")
+	}
+	search("trace-test", cfg)
+	trace := latestSearchTrace("trace-test")
+	if trace == nil {
+		t.Fatalf("labelled search left no trace")
+	}
+	dump := trace.chromeTrace()
+	counts := map[string]int{}
+	for _, ev := range dump.TraceEvents {
+		counts[ev.Ph]++
+		if ev.Ph == "i" {
+			counts[ev.Name]++
+		}
+	}
+	if counts["B"] == 0 || counts["B"] != counts["E"] {
+		t.Fatalf("unbalanced spans: %d begins, %d ends", counts["B"], counts["E"])
+	}
+	if counts["node"] == 0 || counts["cutoff"] == 0 {
+		t.Fatalf("no node or cutoff events: %v", counts)
+	}
+	if _, err := json.Marshal(dump); err != nil {
+		t.Fatalf("trace does not encode: %v", err)
+	}
+
+	cfg.AiSearchTraceEvents = 64
+	search("trace-small", cfg)
+	small := latestSearchTrace("trace-small").chromeTrace()
+	if small.OtherData["dropped_events"].(uint64) == 0 || len(small.TraceEvents) > 64*len(latestSearchTrace("trace-small").rings) {
+		t.Fatalf("a 64-event ring kept %d events and dropped %v", len(small.TraceEvents), small.OtherData["dropped_events"])
+	}
+}
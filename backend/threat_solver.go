@@ -0,0 +1,662 @@
+package main
+
+import (
+	"math/bits"
+	"sync"
+)
+
+// threatSolver runs a threat-space search for attacker: VCF (victory by
+// continuous fours) and, within vctDepth, VCT lines that also use threes.
+// It is conservative under the Ninuki rules. It passes on any line where
+// the defender could win at once, a five that a capture could break does
+// not count as a win, and every four is answered by each block, each
+// capture and each capture setup that could break the five.
+//
+// A three counts as a threat only when the attacker has a VCF after it if
+// the defender passes. The defender then tries every square that VCF
+// proof touched, plus captures and counter-fours, which is the usual
+// threat-space relevance assumption.
+type threatSolver struct {
+	rules    Rules
+	attacker PlayerColor
+	defender PlayerColor
+	size     int
+	winLen   int
+
+	maxNodes  int
+	nodes     int
+	exhausted bool
+	stop      func() bool
+	stopped   bool
+
+	failures *[threatFailureSlots]threatFailure
+}
+
+// threatFailure remembers that attack found nothing with depth attacker
+// moves left; a key is proven lost for any depth up to the stored one.
+type threatFailure struct {
+	key   uint64
+	depth int
+}
+
+type threatMove struct {
+	move   Move
+	fours  uint8
+	threes uint8
+}
+
+// threatSquares is a per-row bitset of board cells.
+type threatSquares [maxBoardSize]uint32
+
+type threatSolverResult struct {
+	Move  Move
+	Found bool
+	VCT   bool
+	Nodes int
+}
+
+const (
+	threatFailureSlots = 1 << 12
+	threatMaxThrees    = 10
+	threatMaxMoves     = 64
+	threatStopMask     = 31 // nodes between stop checks, minus one
+	threatResultSlots  = 1 << 10
+)
+
+var threatFailurePool = sync.Pool{New: func() any { return new([threatFailureSlots]threatFailure) }}
+
+// threatResultCache remembers finished solver runs by root position, so the
+// backlog's per-depth searches and ponder rounds solve each root once. Runs
+// cut short by the clock are not stored.
+type threatResultCache struct {
+	mu    sync.Mutex
+	slots [threatResultSlots]threatResultSlot
+}
+
+type threatResultSlot struct {
+	key    uint64
+	result threatSolverResult
+}
+
+var threatResults threatResultCache
+
+func (c *threatResultCache) get(key uint64) (threatSolverResult, bool) {
+	c.mu.Lock()
+	defer c.mu.Unlock()
+	slot := c.slots[key&(threatResultSlots-1)]
+	return slot.result, slot.key == key
+}
+
+func (c *threatResultCache) put(key uint64, result threatSolverResult) {
+	c.mu.Lock()
+	c.slots[key&(threatResultSlots-1)] = threatResultSlot{key: key, result: result}
+	c.mu.Unlock()
+}
+
+func (c *threatResultCache) Clear() {
+	c.mu.Lock()
+	c.slots = [threatResultSlots]threatResultSlot{}
+	c.mu.Unlock()
+}
+
+// threatResultKey folds the root, the attacker, the solver limits and the
+// rules a proof depends on, so a rule change never serves a stale proof.
+func threatResultKey(state *GameState, rules Rules, attacker PlayerColor, cfg Config) uint64 {
+	limits := uint64(cfg.AiThreatSolverDepth)<<48 ^ uint64(cfg.AiThreatSolverVctDepth)<<40 ^ uint64(cfg.AiThreatSolverMaxNodes)
+	ruleBits := uint64(rules.settings.WinLength)<<8 | uint64(rules.settings.CaptureWinStones)<<16
+	if rules.settings.ForbidDoubleThreeBlack {
+		ruleBits |= 1
+	}
+	if rules.settings.ForbidDoubleThreeWhite {
+		ruleBits |= 2
+	}
+	return orientedKeyFor(state, state.Board.Size()) ^ mixKey(limits^uint64(attacker)<<56^mixKey(ruleBits))
+}
+
+func (s *threatSquares) add(move Move) {
+	s[move.Y] |= 1 << uint(move.X)
+}
+
+func (s *threatSquares) merge(other *threatSquares) {
+	for y := range s {
+		s[y] |= other[y]
+	}
+}
+
+// solveThreatSpace looks for a forced win for attacker: first VCF only, then
+// VCT with up to cfg.AiThreatSolverVctDepth threes, sharing one node budget.
+func solveThreatSpace(state GameState, rules Rules, attacker PlayerColor, cfg Config) threatSolverResult {
+	result, _ := solveThreatSpaceUntil(state, rules, attacker, cfg, nil)
+	return result
+}
+
+// solveThreatSpaceUntil is solveThreatSpace polling stop every few nodes; it
+// reports false when stop cut the run short.
+func solveThreatSpaceUntil(state GameState, rules Rules, attacker PlayerColor, cfg Config, stop func() bool) (threatSolverResult, bool) {
+	if cfg.AiThreatSolverDepth <= 0 || state.MustCapture || state.Status != StatusRunning {
+		return threatSolverResult{}, true
+	}
+	failures := threatFailurePool.Get().(*[threatFailureSlots]threatFailure)
+	clear(failures[:])
+	defer threatFailurePool.Put(failures)
+	s := &threatSolver{
+		rules:    rules,
+		attacker: attacker,
+		defender: otherPlayer(attacker),
+		size:     state.Board.Size(),
+		winLen:   rules.WinLength(),
+		maxNodes: cfg.AiThreatSolverMaxNodes,
+		stop:     stop,
+		failures: failures,
+	}
+	if s.maxNodes <= 0 {
+		s.maxNodes = 1 << 30
+	}
+	if s.winLen <= 0 {
+		s.winLen = 5
+	}
+	var proof threatSquares
+	if move, ok := s.attack(&state, cfg.AiThreatSolverDepth, 0, &proof); ok {
+		return threatSolverResult{Move: move, Found: true, Nodes: s.nodes}, true
+	}
+	if cfg.AiThreatSolverVctDepth > 0 && !s.exhausted {
+		if move, ok := s.attack(&state, cfg.AiThreatSolverDepth, cfg.AiThreatSolverVctDepth, &proof); ok {
+			return threatSolverResult{Move: move, Found: true, VCT: true, Nodes: s.nodes}, true
+		}
+	}
+	return threatSolverResult{Nodes: s.nodes}, !s.stopped
+}
+
+// attack reports whether the attacker, to move, wins within depth threat
+// moves, and adds the squares of the proof to proof.
+func (s *threatSolver) attack(state *GameState, depth, vctDepth int, proof *threatSquares) (Move, bool) {
+	if s.exhausted {
+		return Move{}, false
+	}
+	if s.nodes >= s.maxNodes {
+		s.exhausted = true
+		return Move{}, false
+	}
+	if s.nodes&threatStopMask == 0 && s.stop != nil && s.stop() {
+		s.exhausted, s.stopped = true, true
+		return Move{}, false
+	}
+	s.nodes++
+	var fiveBuf [16]Move
+	move, won, breakable := s.immediateWin(fiveBuf[:0], state)
+	if won {
+		proof.add(move)
+		return move, true
+	}
+	if depth <= 0 {
+		return Move{}, false
+	}
+	key := mixKey(state.Hash ^ uint64(s.attacker)<<56 ^ uint64(vctDepth)<<60)
+	slot := &s.failures[key&(threatFailureSlots-1)]
+	if slot.key == key && slot.depth >= depth {
+		return Move{}, false
+	}
+
+	var blockBuf [16]Move
+	blocks, captureWin := s.winSquares(blockBuf[:0], state, s.defender)
+	if captureWin {
+		return Move{}, false
+	}
+	for _, five := range breakable {
+		var local threatSquares
+		if s.tryBreakableFive(state, five, depth, vctDepth, &local) {
+			proof.merge(&local)
+			return five, true
+		}
+		if s.exhausted {
+			return Move{}, false
+		}
+	}
+	var moveBuf [threatMaxMoves]threatMove
+	moves := s.threatMoves(moveBuf[:0], &state.Board, s.attacker, vctDepth > 0)
+	for _, cand := range moves {
+		if len(blocks) > 0 && !containsMove(blocks, cand.move) {
+			continue
+		}
+		var local threatSquares
+		if s.tryThreat(state, cand, depth, vctDepth, &local) {
+			proof.merge(&local)
+			return cand.move, true
+		}
+		if s.exhausted {
+			return Move{}, false
+		}
+	}
+	*slot = threatFailure{key: key, depth: depth}
+	return Move{}, false
+}
+
+// tryThreat plays cand for the attacker and checks every relevant defence.
+func (s *threatSolver) tryThreat(state *GameState, cand threatMove, depth, vctDepth int, proof *threatSquares) bool {
+	var undo searchMoveUndo
+	if !applyMoveWithUndo(state, s.rules, cand.move, s.attacker, &undo) {
+		return false
+	}
+	defer undoMoveWithUndo(state, undo)
+
+	var blockBuf [16]Move
+	if blocks, captureWin := s.winSquares(blockBuf[:0], state, s.defender); captureWin || len(blocks) > 0 {
+		return false
+	}
+	var winBuf [16]Move
+	wins, _ := s.winSquares(winBuf[:0], state, s.attacker)
+	var responses threatSquares
+	var lines threatSquares
+	nextVct := vctDepth
+	if len(wins) > 0 {
+		for _, win := range wins {
+			responses.add(win)
+			s.addLines(&lines, win)
+		}
+	} else {
+		if vctDepth <= 0 {
+			return false
+		}
+		var nullProof threatSquares
+		if _, ok := s.attack(state, depth-1, 0, &nullProof); !ok {
+			return false
+		}
+		responses.merge(&nullProof)
+		lines.merge(&nullProof)
+		for y := 0; y < s.size; y++ {
+			for row := nullProof[y]; row != 0; row &= row - 1 {
+				s.addLines(&lines, Move{X: bits.TrailingZeros32(row), Y: y})
+			}
+		}
+		var counterBuf [threatMaxMoves]threatMove
+		for _, counter := range s.threatMoves(counterBuf[:0], &state.Board, s.defender, false) {
+			responses.add(counter.move)
+		}
+		nextVct = vctDepth - 1
+	}
+	var captureBuf [32]Move
+	for _, capture := range findCaptureMovesInto(captureBuf[:0], *state, s.rules, s.defender) {
+		responses.add(capture)
+	}
+	s.addCaptureSetups(&responses, &state.Board, &lines)
+
+	tried := false
+	for y := 0; y < s.size; y++ {
+		for row := responses[y] &^ state.Board.Occupied(y); row != 0; row &= row - 1 {
+			reply := Move{X: bits.TrailingZeros32(row), Y: y}
+			var replyUndo searchMoveUndo
+			if !applyMoveWithUndo(state, s.rules, reply, s.defender, &replyUndo) {
+				continue
+			}
+			tried = true
+			ok := state.Status == StatusRunning
+			var child threatSquares
+			if ok {
+				_, ok = s.attack(state, depth-1, nextVct, &child)
+			}
+			undoMoveWithUndo(state, replyUndo)
+			if !ok {
+				return false
+			}
+			proof.merge(&child)
+			proof.add(reply)
+		}
+	}
+	if !tried {
+		// No legal defence on the board: the next threat must still win.
+		var child threatSquares
+		if _, ok := s.attack(state, depth-1, nextVct, &child); !ok {
+			return false
+		}
+		proof.merge(&child)
+	}
+	proof.add(cand.move)
+	return true
+}
+
+// immediateWin returns a capture win or an alignment the defender cannot
+// break by capture; breakable fives are appended to dst instead.
+func (s *threatSolver) immediateWin(dst []Move, state *GameState) (Move, bool, []Move) {
+	var buf [16]Move
+	if captures := findCaptureWinMovesInto(buf[:0], *state, s.rules, s.attacker); len(captures) > 0 {
+		return captures[0], true, dst
+	}
+	var counts threatCounts
+	s.countWindows(&state.Board, s.attacker, false, &counts)
+	breakable := dst[:0]
+	for idx := 0; idx < s.size*s.size; idx++ {
+		if counts.wins[idx] == 0 {
+			continue
+		}
+		move := Move{X: idx % s.size, Y: idx / s.size}
+		var undo searchMoveUndo
+		if !applyMoveWithUndo(state, s.rules, move, s.attacker, &undo) {
+			continue
+		}
+		var breakBuf [1]Move
+		broken := len(s.breakingCaptures(breakBuf[:0], state, move, true)) > 0
+		undoMoveWithUndo(state, undo)
+		if !broken {
+			return move, true, dst
+		}
+		if len(breakable) < cap(breakable) {
+			breakable = append(breakable, move)
+		}
+	}
+	return Move{}, false, breakable
+}
+
+// breakingCaptures lists the defender captures that break the five just
+// made at move, as FindAlignmentBreakCaptures would, trying only captures of
+// a pair that touches it. With first it stops at the first one.
+func (s *threatSolver) breakingCaptures(dst []Move, state *GameState, move Move, first bool) []Move {
+	board := &state.Board
+	own := CellFromPlayer(s.attacker)
+	opp := CellFromPlayer(s.defender)
+	var line, tried threatSquares
+	for _, dir := range threatDirections {
+		back := board.Run(move.X, move.Y, -dir[0], -dir[1], own)
+		forward := board.Run(move.X, move.Y, dir[0], dir[1], own)
+		if back+forward+1 < s.winLen {
+			continue
+		}
+		for i := -back; i <= forward; i++ {
+			line.add(Move{X: move.X + i*dir[0], Y: move.Y + i*dir[1]})
+		}
+	}
+	captures := dst[:0]
+	for y := 0; y < s.size; y++ {
+		for row := line[y]; row != 0; row &= row - 1 {
+			x := bits.TrailingZeros32(row)
+			for _, dir := range threatDirections {
+				for _, sign := range [2]int{1, -1} {
+					dx, dy := sign*dir[0], sign*dir[1]
+					if !board.Has(x+dx, y+dy, own) {
+						continue
+					}
+					var capture Move
+					switch {
+					case board.Has(x-dx, y-dy, opp) && board.Has(x+2*dx, y+2*dy, CellEmpty):
+						capture = Move{X: x + 2*dx, Y: y + 2*dy}
+					case board.Has(x+2*dx, y+2*dy, opp) && board.Has(x-dx, y-dy, CellEmpty):
+						capture = Move{X: x - dx, Y: y - dy}
+					default:
+						continue
+					}
+					if tried[capture.Y]&(1<<uint(capture.X)) != 0 {
+						continue
+					}
+					tried.add(capture)
+					if !legalInSearch(state, s.rules, capture, s.defender) {
+						continue
+					}
+					probe := state.Board
+					probe.Set(capture.X, capture.Y, opp)
+					var captureBuf [8]Move
+					for _, captured := range s.rules.FindCapturesInto(probe, capture, opp, captureBuf[:0]) {
+						probe.Remove(captured.X, captured.Y)
+					}
+					if s.rules.hasAnyAlignment(probe, own) {
+						continue
+					}
+					captures = append(captures, capture)
+					if first {
+						return captures
+					}
+				}
+			}
+		}
+	}
+	return captures
+}
+
+// tryBreakableFive plays a five the defender must break by capture, as the
+// game then only allows those captures, and checks each of them.
+func (s *threatSolver) tryBreakableFive(state *GameState, five Move, depth, vctDepth int, proof *threatSquares) bool {
+	var undo searchMoveUndo
+	if !applyMoveWithUndo(state, s.rules, five, s.attacker, &undo) {
+		return false
+	}
+	defer undoMoveWithUndo(state, undo)
+	var blockBuf [16]Move
+	if _, captureWin := s.winSquares(blockBuf[:0], state, s.defender); captureWin {
+		return false
+	}
+	var replyBuf [16]Move
+	for _, reply := range s.breakingCaptures(replyBuf[:0], state, five, false) {
+		var replyUndo searchMoveUndo
+		if !applyMoveWithUndo(state, s.rules, reply, s.defender, &replyUndo) {
+			continue
+		}
+		ok := state.Status == StatusRunning
+		var child threatSquares
+		if ok {
+			_, ok = s.attack(state, depth-1, vctDepth, &child)
+		}
+		undoMoveWithUndo(state, replyUndo)
+		if !ok {
+			return false
+		}
+		proof.merge(&child)
+		proof.add(reply)
+	}
+	proof.add(five)
+	return true
+}
+
+// winSquares returns player's legal five-completing squares and whether the
+// player has a capture win.
+func (s *threatSolver) winSquares(dst []Move, state *GameState, player PlayerColor) ([]Move, bool) {
+	var captureBuf [16]Move
+	if len(findCaptureWinMovesInto(captureBuf[:0], *state, s.rules, player)) > 0 {
+		return dst[:0], true
+	}
+	var counts threatCounts
+	s.countWindows(&state.Board, player, false, &counts)
+	wins := dst[:0]
+	for idx := 0; idx < s.size*s.size && len(wins) < cap(wins); idx++ {
+		if counts.wins[idx] == 0 {
+			continue
+		}
+		move := Move{X: idx % s.size, Y: idx / s.size}
+		if legalInSearch(state, s.rules, move, player) {
+			wins = append(wins, move)
+		}
+	}
+	return wins, false
+}
+
+// threatCounts holds, per empty cell, how many winLen windows free of
+// opponent stones it would bring to five, four and three stones.
+type threatCounts struct {
+	wins  [maxSearchBoardCells]uint8
+	fours [maxSearchBoardCells]uint8
+	twos  [maxSearchBoardCells]uint8
+}
+
+// countWindows slides a winLen window along each direction, counting the
+// stones of every window start at once with a bit-sliced adder over rows.
+func (s *threatSolver) countWindows(board *Board, player PlayerColor, threes bool, out *threatCounts) {
+	own := CellFromPlayer(player)
+	opp := CellFromPlayer(otherPlayer(player))
+	size := s.size
+	span := s.winLen - 1
+	for _, dir := range threatDirections {
+		dx, dy := dir[0], dir[1]
+		starts := uint32(1)<<uint(size) - 1
+		if dx == 1 {
+			starts = uint32(1)<<uint(size-span) - 1
+		}
+		for y := 0; y < size; y++ {
+			if end := y + span*dy; end < 0 || end >= size {
+				continue
+			}
+			// sum holds the stone count of the window starting at bit x.
+			var sum [3]uint32
+			var blocked uint32
+			for i := 0; i <= span; i++ {
+				row := y + i*dy
+				shift := uint(i * dx)
+				blocked |= board.Row(row, opp) >> shift
+				carry := board.Row(row, own) >> shift
+				for b := 0; b < len(sum) && carry != 0; b++ {
+					sum[b], carry = sum[b]^carry, sum[b]&carry
+				}
+			}
+			open := starts &^ blocked
+			for _, level := range [3]struct {
+				stones int
+				counts *[maxSearchBoardCells]uint8
+			}{{s.winLen - 1, &out.wins}, {s.winLen - 2, &out.fours}, {s.winLen - 3, &out.twos}} {
+				if level.counts == &out.twos && !threes {
+					continue
+				}
+				match := open
+				for b := range sum {
+					if level.stones>>uint(b)&1 == 1 {
+						match &= sum[b]
+					} else {
+						match &^= sum[b]
+					}
+				}
+				for ; match != 0; match &= match - 1 {
+					x := bits.TrailingZeros32(match)
+					for i := 0; i <= span; i++ {
+						cx, cy := x+i*dx, y+i*dy
+						if board.IsEmpty(cx, cy) {
+							level.counts[cy*size+cx]++
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+// threatMoves lists the empty squares that bring some window free of
+// opponent stones to winLen-1 stones (fours) and, with threes, those that
+// bring at least two windows to winLen-2. Fours come first.
+func (s *threatSolver) threatMoves(dst []threatMove, board *Board, player PlayerColor, threes bool) []threatMove {
+	var counts threatCounts
+	s.countWindows(board, player, threes, &counts)
+	size := s.size
+	moves := dst[:0]
+	for idx := 0; idx < size*size && len(moves) < cap(moves); idx++ {
+		if counts.fours[idx] > 0 && counts.wins[idx] == 0 {
+			moves = append(moves, threatMove{move: Move{X: idx % size, Y: idx / size}, fours: counts.fours[idx], threes: counts.twos[idx]})
+		}
+	}
+	sortThreatMoves(moves)
+	fourCount := len(moves)
+	for idx := 0; threes && idx < size*size && len(moves) < cap(moves); idx++ {
+		if counts.fours[idx] == 0 && counts.wins[idx] == 0 && counts.twos[idx] >= 2 {
+			moves = append(moves, threatMove{move: Move{X: idx % size, Y: idx / size}, threes: counts.twos[idx]})
+		}
+	}
+	sortThreatMoves(moves[fourCount:])
+	return moves[:min(len(moves), fourCount+threatMaxThrees)]
+}
+
+func sortThreatMoves(moves []threatMove) {
+	for i := 1; i < len(moves); i++ {
+		for j := i; j > 0; j-- {
+			a, b := moves[j], moves[j-1]
+			if a.fours < b.fours || (a.fours == b.fours && a.threes <= b.threes) {
+				break
+			}
+			moves[j], moves[j-1] = b, a
+		}
+	}
+}
+
+// addLines marks the cells within winLen-1 of move along the four lines.
+func (s *threatSolver) addLines(dst *threatSquares, move Move) {
+	for _, dir := range threatDirections {
+		for i := -(s.winLen - 1); i < s.winLen; i++ {
+			x, y := move.X+i*dir[0], move.Y+i*dir[1]
+			if x >= 0 && y >= 0 && x < s.size && y < s.size {
+				dst.add(Move{X: x, Y: y})
+			}
+		}
+	}
+}
+
+// addCaptureSetups adds the open ends of attacker pairs touching lines, where
+// a defender stone would threaten to capture part of a five.
+func (s *threatSolver) addCaptureSetups(dst *threatSquares, board *Board, lines *threatSquares) {
+	own := CellFromPlayer(s.attacker)
+	for y := 0; y < s.size; y++ {
+		for row := lines[y] & board.Row(y, own); row != 0; row &= row - 1 {
+			x := bits.TrailingZeros32(row)
+			for _, dir := range threatDirections {
+				for _, sign := range [2]int{1, -1} {
+					dx, dy := sign*dir[0], sign*dir[1]
+					if !board.InBounds(x+dx, y+dy) || board.At(x+dx, y+dy) != own {
+						continue
+					}
+					before := Move{X: x - dx, Y: y - dy}
+					after := Move{X: x + 2*dx, Y: y + 2*dy}
+					if before.IsValid(s.size) && after.IsValid(s.size) &&
+						board.IsEmpty(before.X, before.Y) && board.IsEmpty(after.X, after.Y) {
+						dst.add(before)
+						dst.add(after)
+					}
+				}
+			}
+		}
+	}
+}
+
+func containsMove(moves []Move, target Move) bool {
+	for _, move := range moves {
+		if move.Equals(target) {
+			return true
+		}
+	}
+	return false
+}
+
+// scoreBoardFromThreatSolver answers a root search with the first move of a
+// proven forced win.
+func scoreBoardFromThreatSolver(state GameState, rules Rules, settings AIScoreSettings) ([]float64, bool) {
+	if !settings.Config.AiEnableThreatSolver || settings.Player != state.ToMove {
+		return nil, false
+	}
+	key := threatResultKey(&state, rules, settings.Player, settings.Config)
+	result, ok := threatResults.get(key)
+	if !ok {
+		stop := func() bool {
+			return settings.Time != nil && settings.Time.expired() || settings.ShouldStop != nil && settings.ShouldStop()
+		}
+		var finished bool
+		if result, finished = solveThreatSpaceUntil(state, rules, settings.Player, settings.Config, stop); finished {
+			threatResults.put(key, result)
+		}
+	} else {
+		result.Nodes = 0
+	}
+	if settings.Stats != nil {
+		settings.Stats.ThreatNodes += int64(result.Nodes)
+	}
+	if !result.Found || !result.Move.IsValid(settings.BoardSize) {
+		return nil, false
+	}
+	// The only scored cell is played as is, so a cached proof is checked
+	// against the position like a book move.
+	if legal, _ := rules.IsLegal(state, result.Move, settings.Player); !legal {
+		return nil, false
+	}
+	scores := make([]float64, settings.BoardSize*settings.BoardSize)
+	for i := range scores {
+		scores[i] = illegalScore
+	}
+	win := -winScore
+	if settings.Player == PlayerBlack {
+		win = winScore
+	}
+	scores[result.Move.Y*settings.BoardSize+result.Move.X] = win
+	if settings.Stats != nil {
+		settings.Stats.CompletedDepths = settings.Depth
+	}
+	return scores, true
+}
@@ -0,0 +1,142 @@
+package main
+
+import "testing"
+
+func threatSolverFixture() (GameState, Rules, Config) {
+	settings := DefaultGameSettings()
+	rules := NewRules(settings)
+	state := DefaultGameState(settings)
+	state.Status = StatusRunning
+	state.ToMove = PlayerBlack
+	cfg := DefaultConfig()
+	cfg.AiThreatSolverMaxNodes = 20000
+	return state, rules, cfg
+}
+
+func TestThreatSolverFindsDoubleFour(t *testing.T) {
+	state, rules, cfg := threatSolverFixture()
+	// (9,5) makes a broken horizontal four and a vertical four at once.
+	for _, m := range []Move{{X: 5, Y: 5}, {X: 6, Y: 5}, {X: 7, Y: 5}, {X: 9, Y: 6}, {X: 9, Y: 7}, {X: 9, Y: 8}} {
+		state.Board.Set(m.X, m.Y, CellBlack)
+	}
+	state.Board.Set(4, 5, CellWhite)
+	state.Board.Set(9, 9, CellWhite)
+	state.Board.Set(12, 12, CellWhite)
+	state.recomputeHashes()
+
+	result := solveThreatSpace(state, rules, PlayerBlack, cfg)
+	if !result.Found || result.VCT || !result.Move.Equals(Move{X: 9, Y: 5}) {
+		t.Fatalf("expected VCF at (9,5), got %+v", result)
+	}
+
+	threatResults.Clear()
+	stats := &SearchStats{}
+	scores, ok := ScoreBoardDirectDepthParallel(state, rules, AIScoreSettings{
+		Depth:     4,
+		BoardSize: state.Board.Size(),
+		Player:    PlayerBlack,
+		Cache:     func() *AISearchCache { c := newAISearchCache(); return &c }(),
+		Config:    cfg,
+		Stats:     stats,
+	}, 2)
+	if !ok || scores[5*state.Board.Size()+9] != winScore || stats.ThreatNodes == 0 {
+		t.Fatalf("expected the solver to short-circuit the search (ok=%v score=%.0f nodes=%d)", ok, scores[5*state.Board.Size()+9], stats.ThreatNodes)
+	}
+}
+
+func TestThreatSolverFindsVCTFromDoubleThree(t *testing.T) {
+	state, _, cfg := threatSolverFixture()
+	settings := DefaultGameSettings()
+	settings.ForbidDoubleThreeBlack = false
+	rules := NewRules(settings)
+	cfg.AiThreatSolverVctDepth = 0
+	// (8,9) makes two broken threes; neither line holds a four yet.
+	for _, m := range []Move{{X: 5, Y: 9}, {X: 6, Y: 9}, {X: 8, Y: 6}, {X: 8, Y: 7}} {
+		state.Board.Set(m.X, m.Y, CellBlack)
+	}
+	state.Board.Set(3, 3, CellWhite)
+	state.Board.Set(14, 14, CellWhite)
+	state.recomputeHashes()
+
+	if result := solveThreatSpace(state, rules, PlayerBlack, cfg); result.Found {
+		t.Fatalf("expected no VCF, got %+v", result)
+	}
+	cfg.AiThreatSolverVctDepth = 1
+	result := solveThreatSpace(state, rules, PlayerBlack, cfg)
+	if !result.Found || !result.VCT || !result.Move.Equals(Move{X: 8, Y: 9}) {
+		t.Fatalf("expected a VCT at (8,9), got %+v", result)
+	}
+}
+
+func TestThreatSolverRespectsCaptureRules(t *testing.T) {
+	state, rules, cfg := threatSolverFixture()
+	for x := 5; x <= 8; x++ {
+		state.Board.Set(x, 5, CellBlack)
+	}
+	state.Board.Set(4, 5, CellWhite)
+	// White can break a five at (9,5) by capturing (6,5)-(6,6) from (6,4).
+	state.Board.Set(6, 6, CellBlack)
+	state.Board.Set(6, 7, CellWhite)
+	state.recomputeHashes()
+
+	// After the forced capture Black refills (6,5), which nothing can break.
+	result := solveThreatSpace(state, rules, PlayerBlack, cfg)
+	if !result.Found || !result.Move.Equals(Move{X: 9, Y: 5}) {
+		t.Fatalf("expected the breakable five to force a win, got %+v", result)
+	}
+	// With eight captures already, that capture wins the game for White.
+	state.CapturedWhite = 8
+	state.recomputeHashes()
+	if result := solveThreatSpace(state, rules, PlayerBlack, cfg); result.Found {
+		t.Fatalf("expected no proven win when the break is a capture win, got %+v", result)
+	}
+}
+
+func TestThreatSolverStopsAndCachesRootResults(t *testing.T) {
+	state, rules, cfg := threatSolverFixture()
+	for _, m := range []Move{{X: 5, Y: 5}, {X: 6, Y: 5}, {X: 7, Y: 5}, {X: 9, Y: 6}, {X: 9, Y: 7}, {X: 9, Y: 8}} {
+		state.Board.Set(m.X, m.Y, CellBlack)
+	}
+	state.Board.Set(4, 5, CellWhite)
+	state.Board.Set(9, 9, CellWhite)
+	state.Board.Set(12, 12, CellWhite)
+	state.recomputeHashes()
+
+	if result, finished := solveThreatSpaceUntil(state, rules, PlayerBlack, cfg, func() bool { return true }); finished || result.Found {
+		t.Fatalf("a stopped solver should give up unfinished, got %+v finished=%v", result, finished)
+	}
+
+	threatResults.Clear()
+	defer threatResults.Clear()
+	settings := AIScoreSettings{BoardSize: state.Board.Size(), Player: PlayerBlack, Config: cfg}
+	settings.ShouldStop = func() bool { return true }
+	if _, ok := scoreBoardFromThreatSolver(state, rules, settings); ok {
+		t.Fatalf("a stopped solver should not answer the search")
+	}
+	for i, want := range []bool{false, true} {
+		settings.ShouldStop = nil
+		settings.Stats = &SearchStats{}
+		if _, ok := scoreBoardFromThreatSolver(state, rules, settings); !ok {
+			t.Fatalf("run %d: expected the forced win", i)
+		}
+		if cached := settings.Stats.ThreatNodes == 0; cached != want {
+			t.Fatalf("run %d: cached=%v, want %v", i, cached, want)
+		}
+	}
+
+	// Other rules are another cache entry.
+	longer := rules.settings
+	longer.WinLength = 6
+	settings.Stats = &SearchStats{}
+	scoreBoardFromThreatSolver(state, NewRules(longer), settings)
+	if settings.Stats.ThreatNodes == 0 {
+		t.Fatalf("a proof cached under win length 5 answered for win length 6")
+	}
+
+	// A cached move that is no longer legal is not played.
+	key := threatResultKey(&state, rules, PlayerBlack, cfg)
+	threatResults.put(key, threatSolverResult{Found: true, Move: Move{X: 5, Y: 5}})
+	if _, ok := scoreBoardFromThreatSolver(state, rules, settings); ok {
+		t.Fatalf("expected a cached illegal move to be refused")
+	}
+}
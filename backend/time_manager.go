@@ -0,0 +1,182 @@
+package main
+
+import (
+	"math"
+	"sync"
+	"sync/atomic"
+	"time"
+)
+
+// searchClock is a coarse millisecond clock for deadline checks: nodes poll
+// one atomic load instead of calling time.Now. A goroutine advances it only
+// while some search holds it, so an idle server has no ticker running.
+var searchClock = &coarseClock{epoch: time.Now()}
+
+type coarseClock struct {
+	epoch time.Time
+	ticks atomic.Int64 // milliseconds since epoch
+	mu    sync.Mutex
+	users int
+	stop  chan struct{}
+}
+
+func (c *coarseClock) acquire() {
+	c.mu.Lock()
+	defer c.mu.Unlock()
+	c.ticks.Store(c.tickAt(time.Now()))
+	c.users++
+	if c.users > 1 {
+		return
+	}
+	c.stop = make(chan struct{})
+	go c.run(c.stop)
+}
+
+func (c *coarseClock) release() {
+	c.mu.Lock()
+	defer c.mu.Unlock()
+	c.users--
+	if c.users == 0 {
+		close(c.stop)
+	}
+}
+
+func (c *coarseClock) run(stop chan struct{}) {
+	ticker := time.NewTicker(time.Millisecond)
+	defer ticker.Stop()
+	for {
+		select {
+		case <-stop:
+			return
+		case now := <-ticker.C:
+			c.ticks.Store(c.tickAt(now))
+		}
+	}
+}
+
+func (c *coarseClock) tickAt(t time.Time) int64 {
+	return t.Sub(c.epoch).Milliseconds()
+}
+
+// timeManager decides how long one move's search may run. The hard limit
+// comes from AiTimeBudgetMs (less a 100ms reply margin) and AiTimeoutMs; nodes
+// poll it through searchClock. With AiAdaptiveTime, ScoreBoard also stops
+// starting new depths past a soft limit: AiTimeSoftPercent of the hard limit,
+// halved in the opening and doubled in tactical positions. Each completed
+// depth then stretches it when the best move changed or the score moved by
+// more than an aspiration window, and shrinks it once the best move held for
+// three depths. The soft limit never passes the hard one.
+type timeManager struct {
+	start    time.Time
+	hard     time.Duration
+	hardTick int64
+	clock    bool // hardTick is valid; otherwise expired falls back to time.Since
+
+	adaptive   bool
+	base       time.Duration
+	soft       time.Duration
+	swing      float64
+	lastMove   Move
+	lastScore  float64
+	stable     int
+	haveResult bool
+}
+
+// newTimeManager returns nil when the search has no time limit.
+func newTimeManager(settings AIScoreSettings, start time.Time) *timeManager {
+	hard := time.Duration(0)
+	if budget := settings.Config.AiTimeBudgetMs; budget > 0 {
+		hard = time.Duration(budget-100) * time.Millisecond
+		if budget <= 100 {
+			hard = time.Duration(budget) * time.Millisecond
+		}
+	}
+	if settings.TimeoutMs > 0 {
+		if timeout := time.Duration(settings.TimeoutMs) * time.Millisecond; hard == 0 || timeout < hard {
+			hard = timeout
+		}
+	}
+	if hard <= 0 {
+		return nil
+	}
+	tm := &timeManager{start: start, hard: hard, soft: hard}
+	if settings.Config.AiAdaptiveTime && settings.Config.AiTimeBudgetMs > 0 && settings.Config.AiTimeSoftPercent > 0 {
+		tm.adaptive = true
+		tm.base = min(hard*time.Duration(settings.Config.AiTimeSoftPercent)/100, hard)
+		tm.soft = tm.base
+		tm.swing = settings.Config.AiAspWindow
+	}
+	return tm
+}
+
+// startTimeManager is newTimeManager for a root search; it holds searchClock
+// until stop.
+func startTimeManager(settings AIScoreSettings, start time.Time) *timeManager {
+	tm := newTimeManager(settings, start)
+	if tm != nil {
+		searchClock.acquire()
+		tm.hardTick = searchClock.tickAt(start.Add(tm.hard))
+		tm.clock = true
+	}
+	return tm
+}
+
+func (tm *timeManager) stop() {
+	if tm != nil && tm.clock {
+		searchClock.release()
+	}
+}
+
+func (tm *timeManager) expired() bool {
+	if tm.clock {
+		return searchClock.ticks.Load() >= tm.hardTick
+	}
+	return time.Since(tm.start) >= tm.hard
+}
+
+// observeRoot scales the soft limit for the game phase and, when tactical
+// reports true, for tactics; tactical is only called for adaptive searches.
+func (tm *timeManager) observeRoot(state *GameState, tactical func() bool) {
+	if tm == nil || !tm.adaptive {
+		return
+	}
+	if state.Board.StoneCount() < 6 {
+		tm.base /= 2
+	}
+	if tactical() {
+		tm.base *= 2
+	}
+	tm.soft = min(tm.base, tm.hard)
+}
+
+// depthCompleted updates the soft limit from a finished depth's best move.
+func (tm *timeManager) depthCompleted(move Move, score float64) {
+	if tm == nil || !tm.adaptive {
+		return
+	}
+	if tm.haveResult {
+		swung := tm.swing > 0 && math.Abs(score-tm.lastScore) > tm.swing
+		switch {
+		case move != tm.lastMove:
+			tm.stable = 0
+			tm.soft = tm.soft * 8 / 5
+		case swung:
+			tm.stable = 0
+			tm.soft = tm.soft * 13 / 10
+		default:
+			tm.stable++
+			if tm.stable >= 2 {
+				tm.soft = tm.soft * 7 / 10
+			}
+		}
+		tm.soft = min(max(tm.soft, tm.base/4), tm.hard)
+	}
+	tm.lastMove = move
+	tm.lastScore = score
+	tm.haveResult = true
+}
+
+// pastSoftLimit reports whether the search should not start another depth.
+func (tm *timeManager) pastSoftLimit() bool {
+	return tm != nil && tm.adaptive && time.Since(tm.start) >= tm.soft
+}
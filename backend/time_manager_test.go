@@ -0,0 +1,74 @@
+package main
+
+import (
+	"testing"
+	"time"
+)
+
+func TestTimeManagerSoftLimitTracksBestMoveStability(t *testing.T) {
+	cfg := DefaultConfig()
+	cfg.AiTimeBudgetMs = 1100
+	cfg.AiTimeSoftPercent = 50
+	cfg.AiAspWindow = 100
+	tm := newTimeManager(AIScoreSettings{Config: cfg}, time.Now())
+	if tm == nil || tm.hard != time.Second || tm.soft != 500*time.Millisecond {
+		t.Fatalf("limits: %+v", tm)
+	}
+	state := DefaultGameState(DefaultGameSettings())
+	tm.observeRoot(&state, func() bool { return true })
+	if tm.soft != 500*time.Millisecond {
+		t.Fatalf("empty tactical board should halve then double the soft limit, got %v", tm.soft)
+	}
+
+	a, b := Move{X: 9, Y: 9}, Move{X: 10, Y: 9}
+	tm.depthCompleted(a, 0)
+	tm.depthCompleted(b, 0)
+	if tm.soft != 800*time.Millisecond {
+		t.Fatalf("a new best move should stretch the soft limit, got %v", tm.soft)
+	}
+	tm.depthCompleted(b, 500)
+	if tm.soft != time.Second {
+		t.Fatalf("a score swing should stretch the soft limit up to the hard one, got %v", tm.soft)
+	}
+	tm.depthCompleted(b, 500)
+	if tm.soft != time.Second {
+		t.Fatalf("one repeat should keep the soft limit, got %v", tm.soft)
+	}
+	for i := 0; i < 10; i++ {
+		tm.depthCompleted(b, 500)
+	}
+	if tm.soft != 125*time.Millisecond {
+		t.Fatalf("a stable best move should shrink the soft limit to a quarter of base, got %v", tm.soft)
+	}
+
+	cfg.AiAdaptiveTime = false
+	if fixed := newTimeManager(AIScoreSettings{Config: cfg}, time.Now()); fixed.pastSoftLimit() {
+		t.Fatalf("without AiAdaptiveTime only the hard limit applies")
+	}
+}
+
+func TestTimeManagerHardLimitUsesCoarseClock(t *testing.T) {
+	cfg := DefaultConfig()
+	cfg.AiTimeBudgetMs = 0
+	if tm := newTimeManager(AIScoreSettings{Config: cfg}, time.Now()); tm != nil {
+		t.Fatalf("a search without limits should get no time manager")
+	}
+	tm := startTimeManager(AIScoreSettings{Config: cfg, TimeoutMs: 30}, time.Now())
+	if !tm.clock || tm.expired() {
+		t.Fatalf("fresh search should hold the clock and not be expired")
+	}
+	deadline := time.Now().Add(2 * time.Second)
+	for !tm.expired() {
+		if time.Now().After(deadline) {
+			t.Fatalf("coarse clock never reached the hard limit")
+		}
+		time.Sleep(time.Millisecond)
+	}
+	tm.stop()
+	searchClock.mu.Lock()
+	users := searchClock.users
+	searchClock.mu.Unlock()
+	if users != 0 {
+		t.Fatalf("clock still held by %d searches", users)
+	}
+}
@@ -64,6 +64,12 @@ type TranspositionTable struct {
 	stripeLocks []sync.RWMutex
 	stripeMask  uint64
 	gen         atomic.Uint32
+	// lockFree, when set, replaces entries and stripe locks; see tt_lockfree.go.
+	lockFree *lockFreeTT
+	// rawKeys keys entries on the plain hash. By default they are keyed on
+	// CanonHash with best moves in the canonical orientation, so the eight
+	// symmetric images of a position share one entry.
+	rawKeys bool
 }
 
 func NewTranspositionTable(size uint64, buckets int) *TranspositionTable {
@@ -107,6 +113,10 @@ func (tt *TranspositionTable) Generation() uint32 {
 }
 
 func (tt *TranspositionTable) Clear() {
+	if tt.lockFree != nil {
+		tt.clearLockFree()
+		return
+	}
 	tt.lockAllStripes()
 	defer tt.unlockAllStripes()
 	for i := range tt.entries {
@@ -123,7 +133,37 @@ func (tt *TranspositionTable) stripeIndexForKey(key uint64) int {
 	return int((key & tt.mask) & tt.stripeMask)
 }
 
+// KeyFor returns the key state is stored under in tt.
+func (tt *TranspositionTable) KeyFor(state *GameState, boardSize int) uint64 {
+	if tt != nil && tt.rawKeys {
+		return orientedKeyFor(state, boardSize)
+	}
+	return ttKeyFor(*state, boardSize)
+}
+
+// ProbeState probes key (from KeyFor) and returns BestMove in state's
+// orientation.
+func (tt *TranspositionTable) ProbeState(state *GameState, key uint64, heuristicHash uint64) (TTEntry, bool) {
+	entry, ok := tt.Probe(key, heuristicHash)
+	if ok && !tt.rawKeys && entry.BestMove.X >= 0 && entry.BestMove.Y >= 0 {
+		entry.BestMove = fromCanonicalMove(state, entry.BestMove)
+	}
+	return entry, ok
+}
+
+// StoreState stores best, given in state's orientation, under key (from
+// KeyFor).
+func (tt *TranspositionTable) StoreState(state *GameState, key uint64, heuristicHash uint64, depth int, value float64, flag TTFlag, best Move, meta TTMeta) (replaced bool, overwrote bool) {
+	if !tt.rawKeys && best.X >= 0 && best.Y >= 0 {
+		best = toCanonicalMove(state, best)
+	}
+	return tt.Store(key, heuristicHash, depth, value, flag, best, meta)
+}
+
 func (tt *TranspositionTable) Probe(key uint64, heuristicHash uint64) (TTEntry, bool) {
+	if tt.lockFree != nil {
+		return tt.probeLockFree(key, heuristicHash)
+	}
 	stripe := tt.stripeIndexForKey(key)
 	tt.stripeLocks[stripe].Lock()
 	defer tt.stripeLocks[stripe].Unlock()
@@ -144,6 +184,9 @@ func (tt *TranspositionTable) Probe(key uint64, heuristicHash uint64) (TTEntry,
 }
 
 func (tt *TranspositionTable) Store(key uint64, heuristicHash uint64, depth int, value float64, flag TTFlag, best Move, meta TTMeta) (replaced bool, overwrote bool) {
+	if tt.lockFree != nil {
+		return tt.storeLockFree(key, heuristicHash, depth, value, flag, best, meta)
+	}
 	stripe := tt.stripeIndexForKey(key)
 	tt.stripeLocks[stripe].Lock()
 	defer tt.stripeLocks[stripe].Unlock()
@@ -158,7 +201,7 @@ func (tt *TranspositionTable) Store(key uint64, heuristicHash uint64, depth int,
 		if !entry.Valid || entry.Key != key || entry.HeuristicHash != heuristicHash {
 			continue
 		}
-		if !shouldReplaceByRules(entry, depth, flag, gen) {
+		if !shouldReplaceSameKey(entry, depth, flag, gen) {
 			return false, false
 		}
 		tt.entries[idx] = TTEntry{
@@ -237,6 +280,7 @@ func (tt *TranspositionTable) Store(key uint64, heuristicHash uint64, depth int,
 		return false, false
 	}
 
+	tt.spillToCold(tt.entries[victim])
 	tt.entries[victim] = TTEntry{
 		Key:           key,
 		HeuristicHash: heuristicHash,
@@ -253,6 +297,9 @@ func (tt *TranspositionTable) Store(key uint64, heuristicHash uint64, depth int,
 }
 
 func (tt *TranspositionTable) DeleteByHeuristicHash(heuristicHash uint64) int {
+	if tt.lockFree != nil {
+		return tt.deleteLockFree(func(side *lockFreeSide) bool { return side.heuristicHash.Load() == heuristicHash })
+	}
 	tt.lockAllStripes()
 	defer tt.unlockAllStripes()
 	deleted := 0
@@ -268,6 +315,9 @@ func (tt *TranspositionTable) DeleteByHeuristicHash(heuristicHash uint64) int {
 }
 
 func (tt *TranspositionTable) DeleteByKey(key uint64) bool {
+	if tt.lockFree != nil {
+		return tt.deleteKeyLockFree(key)
+	}
 	stripe := tt.stripeIndexForKey(key)
 	tt.stripeLocks[stripe].Lock()
 	defer tt.stripeLocks[stripe].Unlock()
@@ -323,6 +373,9 @@ func (tt *TranspositionTable) TopEntriesByHits(offset int, limit int) ([]TTEntry
 }
 
 func (tt *TranspositionTable) Count() int {
+	if tt.lockFree != nil {
+		return tt.countLockFree()
+	}
 	tt.lockAllStripesRead()
 	defer tt.unlockAllStripesRead()
 	count := 0
@@ -338,6 +391,9 @@ func (tt *TranspositionTable) Capacity() int {
 	if tt == nil {
 		return 0
 	}
+	if tt.lockFree != nil {
+		return len(tt.lockFree.slots)
+	}
 	return len(tt.entries)
 }
 
@@ -381,6 +437,9 @@ func (tt *TranspositionTable) unlockAllStripesRead() {
 }
 
 func (tt *TranspositionTable) snapshotEntries() []TTEntry {
+	if tt.lockFree != nil {
+		return tt.snapshotLockFree()
+	}
 	tt.lockAllStripes()
 	defer tt.unlockAllStripes()
 	entries := make([]TTEntry, len(tt.entries))
@@ -388,13 +447,33 @@ func (tt *TranspositionTable) snapshotEntries() []TTEntry {
 	return entries
 }
 
-func (tt *TranspositionTable) loadEntries(entries []TTEntry) {
+// copyEntries copies slots from start into dst and returns how many were
+// copied, so callers can stream the table without a full snapshot.
+func (tt *TranspositionTable) copyEntries(start int, dst []TTEntry) int {
+	if tt.lockFree != nil {
+		return tt.copyLockFreeEntries(start, dst)
+	}
+	tt.lockAllStripesRead()
+	defer tt.unlockAllStripesRead()
+	if start >= len(tt.entries) {
+		return 0
+	}
+	return copy(dst, tt.entries[start:])
+}
+
+// storeEntries writes entries into the slots from start. The lock-free table
+// re-buckets them by key instead, since its slots cannot be written blindly.
+func (tt *TranspositionTable) storeEntries(start int, entries []TTEntry) {
+	if tt.lockFree != nil {
+		tt.loadLockFree(entries)
+		return
+	}
 	tt.lockAllStripes()
 	defer tt.unlockAllStripes()
-	if len(entries) > len(tt.entries) {
-		entries = entries[:len(tt.entries)]
+	if start >= len(tt.entries) {
+		return
 	}
-	copy(tt.entries[:len(entries)], entries)
+	copy(tt.entries[start:], entries)
 }
 
 func replacementClass(entry TTEntry, depth int, flag TTFlag, gen uint32) int {
@@ -414,6 +493,16 @@ func shouldReplaceByRules(entry TTEntry, depth int, flag TTFlag, gen uint32) boo
 	return replacementClass(entry, depth, flag, gen) != 0
 }
 
+// shouldReplaceSameKey also lets a bound replace the opposite bound at the
+// same depth: a PVS re-search of a failed null window produces it, and it is
+// the newer answer for that window.
+func shouldReplaceSameKey(entry TTEntry, depth int, flag TTFlag, gen uint32) bool {
+	if depth == entry.Depth && flag != TTExact && entry.Flag != TTExact && flag != entry.Flag {
+		return true
+	}
+	return shouldReplaceByRules(entry, depth, flag, gen)
+}
+
 func entryAge(gen uint32, entry TTEntry) uint32 {
 	last := entry.GenLastUsed
 	if last == 0 {
@@ -0,0 +1,434 @@
+package main
+
+import "sync/atomic"
+
+// Lock-free TT slots pack an entry into two words. The check word stores
+// key ^ data, so a torn pair from concurrent writers fails verification and
+// reads as a miss instead of a corrupt hit.
+//
+// data layout (low to high bits):
+//
+//	0-31  score (int32)
+//	32-39 depth (clamped to 255)
+//	40-41 flag
+//	42-46 best move x+1 (0 = none)
+//	47-51 best move y+1
+//	52-62 written generation (11 bits)
+//	63    valid
+const (
+	lfDepthShift = 32
+	lfFlagShift  = 40
+	lfMoveXShift = 42
+	lfMoveYShift = 47
+	lfGenShift   = 52
+	lfGenBits    = 11
+	lfGenMask    = 1<<lfGenBits - 1
+	lfValidBit   = uint64(1) << 63
+)
+
+type lockFreeSlot struct {
+	check atomic.Uint64
+	data  atomic.Uint64
+}
+
+// lockFreeSide keeps the fields that searches rarely need. It is written
+// after the slot, so readers only rely on it for diagnostics and persistence.
+type lockFreeSide struct {
+	key           atomic.Uint64
+	heuristicHash atomic.Uint64
+	meta          atomic.Uint64
+	hits          atomic.Uint32
+	lastUsed      atomic.Uint32
+}
+
+type lockFreeTT struct {
+	slots []lockFreeSlot
+	side  []lockFreeSide
+}
+
+// NewLockFreeTranspositionTable builds a TT whose probes and stores use only
+// atomic loads and stores. withMeta enables the side table holding Hits,
+// growth metadata and the unfolded key; without it those fields read as zero
+// and entries cannot be listed, persisted or pruned by heuristic hash.
+func NewLockFreeTranspositionTable(size uint64, buckets int, withMeta bool) *TranspositionTable {
+	tt := NewTranspositionTable(1, 1)
+	if buckets <= 0 {
+		buckets = 2
+	}
+	if size < 1 {
+		size = 1
+	}
+	if (size & (size - 1)) != 0 {
+		size = nextPowerOfTwo(size)
+	}
+	tt.mask = size - 1
+	tt.buckets = buckets
+	tt.entries = nil
+	lf := &lockFreeTT{slots: make([]lockFreeSlot, int(size)*buckets)}
+	if withMeta {
+		lf.side = make([]lockFreeSide, len(lf.slots))
+	}
+	tt.lockFree = lf
+	return tt
+}
+
+func (tt *TranspositionTable) IsLockFree() bool {
+	return tt != nil && tt.lockFree != nil
+}
+
+func foldTTKey(key uint64, heuristicHash uint64) uint64 {
+	return key ^ mixKey(heuristicHash)
+}
+
+func packTTData(depth int, score int32, flag TTFlag, best Move, gen uint32) uint64 {
+	if depth < 0 {
+		depth = 0
+	}
+	if depth > 255 {
+		depth = 255
+	}
+	data := uint64(uint32(score))
+	data |= uint64(depth) << lfDepthShift
+	data |= uint64(flag&3) << lfFlagShift
+	if best.X >= 0 && best.Y >= 0 && best.X < 31 && best.Y < 31 {
+		data |= uint64(best.X+1) << lfMoveXShift
+		data |= uint64(best.Y+1) << lfMoveYShift
+	}
+	data |= uint64(gen&lfGenMask) << lfGenShift
+	return data | lfValidBit
+}
+
+// unpackTTData decodes a slot; gen restores the full written generation from
+// its low bits relative to the current one.
+func unpackTTData(data uint64, gen uint32) TTEntry {
+	entry := TTEntry{
+		Score: int32(uint32(data)),
+		Depth: int((data >> lfDepthShift) & 0xff),
+		Flag:  TTFlag((data >> lfFlagShift) & 3),
+		Valid: data&lfValidBit != 0,
+	}
+	x := int((data>>lfMoveXShift)&31) - 1
+	y := int((data>>lfMoveYShift)&31) - 1
+	if x >= 0 && y >= 0 {
+		entry.BestMove = Move{X: x, Y: y}
+	} else {
+		entry.BestMove = Move{X: -1, Y: -1}
+	}
+	written := uint32((data >> lfGenShift) & lfGenMask)
+	entry.GenWritten = gen - ((gen - written) & lfGenMask)
+	entry.GenLastUsed = entry.GenWritten
+	return entry
+}
+
+func packTTMeta(meta TTMeta) uint64 {
+	var packed uint64
+	packed |= uint64(clampToUint8(meta.GrowLeft))
+	packed |= uint64(clampToUint8(meta.GrowRight)) << 8
+	packed |= uint64(clampToUint8(meta.GrowTop)) << 16
+	packed |= uint64(clampToUint8(meta.GrowBottom)) << 24
+	packed |= uint64(clampToUint8(meta.FrameW)) << 32
+	packed |= uint64(clampToUint8(meta.FrameH)) << 40
+	for i, hit := range [4]bool{meta.HitLeft, meta.HitRight, meta.HitTop, meta.HitBottom} {
+		if hit {
+			packed |= uint64(1) << (48 + i)
+		}
+	}
+	return packed
+}
+
+func applyPackedTTMeta(entry *TTEntry, packed uint64) {
+	entry.GrowLeft = uint8(packed)
+	entry.GrowRight = uint8(packed >> 8)
+	entry.GrowTop = uint8(packed >> 16)
+	entry.GrowBottom = uint8(packed >> 24)
+	entry.FrameW = uint8(packed >> 32)
+	entry.FrameH = uint8(packed >> 40)
+	entry.HitLeft = packed&(1<<48) != 0
+	entry.HitRight = packed&(1<<49) != 0
+	entry.HitTop = packed&(1<<50) != 0
+	entry.HitBottom = packed&(1<<51) != 0
+}
+
+// loadSlot returns the decoded entry at idx when it verifies against folded.
+func (lf *lockFreeTT) loadSlot(idx int, folded uint64, gen uint32) (TTEntry, bool) {
+	data := lf.slots[idx].data.Load()
+	check := lf.slots[idx].check.Load()
+	if data&lfValidBit == 0 || check^data != folded {
+		return TTEntry{}, false
+	}
+	entry := unpackTTData(data, gen)
+	if lf.side != nil {
+		if last := lf.side[idx].lastUsed.Load(); last != 0 {
+			entry.GenLastUsed = last
+		}
+	}
+	return entry, true
+}
+
+// spillToCold hands the entry in idx to the cold tier before it is replaced.
+// The side table gives its key; an entry whose side fields were written by a
+// racing store fails the check and is skipped.
+func (lf *lockFreeTT) spillToCold(tt *TranspositionTable, idx int, gen uint32) {
+	if SharedColdTier() == nil {
+		return
+	}
+	key := lf.side[idx].key.Load()
+	heuristicHash := lf.side[idx].heuristicHash.Load()
+	entry, ok := lf.loadSlot(idx, foldTTKey(key, heuristicHash), gen)
+	if !ok {
+		return
+	}
+	entry.Key = key
+	entry.HeuristicHash = heuristicHash
+	tt.spillToCold(entry)
+}
+
+func (lf *lockFreeTT) writeSlot(idx int, folded uint64, data uint64, key uint64, heuristicHash uint64, meta uint64, gen uint32) {
+	lf.slots[idx].data.Store(data)
+	lf.slots[idx].check.Store(folded ^ data)
+	if lf.side != nil {
+		side := &lf.side[idx]
+		side.key.Store(key)
+		side.heuristicHash.Store(heuristicHash)
+		side.meta.Store(meta)
+		side.hits.Store(0)
+		side.lastUsed.Store(gen)
+	}
+}
+
+func (lf *lockFreeTT) clearSlot(idx int) {
+	lf.slots[idx].data.Store(0)
+	lf.slots[idx].check.Store(0)
+	if lf.side != nil {
+		side := &lf.side[idx]
+		side.key.Store(0)
+		side.heuristicHash.Store(0)
+		side.meta.Store(0)
+		side.hits.Store(0)
+		side.lastUsed.Store(0)
+	}
+}
+
+func (tt *TranspositionTable) probeLockFree(key uint64, heuristicHash uint64) (TTEntry, bool) {
+	lf := tt.lockFree
+	gen := tt.currentGeneration()
+	folded := foldTTKey(key, heuristicHash)
+	start := tt.bucketIndex(key)
+	for i := 0; i < tt.buckets; i++ {
+		idx := start + i
+		entry, ok := lf.loadSlot(idx, folded, gen)
+		if !ok {
+			continue
+		}
+		entry.Key = key
+		entry.HeuristicHash = heuristicHash
+		entry.GenLastUsed = gen
+		if lf.side != nil {
+			side := &lf.side[idx]
+			entry.Hits = side.hits.Add(1)
+			side.lastUsed.Store(gen)
+			applyPackedTTMeta(&entry, side.meta.Load())
+		}
+		return entry, true
+	}
+	return TTEntry{}, false
+}
+
+func (tt *TranspositionTable) storeLockFree(key uint64, heuristicHash uint64, depth int, value float64, flag TTFlag, best Move, meta TTMeta) (replaced bool, overwrote bool) {
+	lf := tt.lockFree
+	gen := tt.currentGeneration()
+	folded := foldTTKey(key, heuristicHash)
+	data := packTTData(depth, scoreToTT(value), flag, best, gen)
+	packedMeta := packTTMeta(meta)
+	start := tt.bucketIndex(key)
+
+	for i := 0; i < tt.buckets; i++ {
+		idx := start + i
+		entry, ok := lf.loadSlot(idx, folded, gen)
+		if !ok {
+			continue
+		}
+		if !shouldReplaceSameKey(entry, depth, flag, gen) {
+			return false, false
+		}
+		lf.writeSlot(idx, folded, data, key, heuristicHash, packedMeta, gen)
+		return false, true
+	}
+
+	for i := 0; i < tt.buckets; i++ {
+		idx := start + i
+		if lf.slots[idx].data.Load()&lfValidBit != 0 {
+			continue
+		}
+		lf.writeSlot(idx, folded, data, key, heuristicHash, packedMeta, gen)
+		return false, false
+	}
+
+	victim := -1
+	victimClass := 0
+	victimAge := uint32(0)
+	for i := 0; i < tt.buckets; i++ {
+		idx := start + i
+		entry := unpackTTData(lf.slots[idx].data.Load(), gen)
+		if lf.side != nil {
+			if last := lf.side[idx].lastUsed.Load(); last != 0 {
+				entry.GenLastUsed = last
+			}
+		}
+		class := replacementClass(entry, depth, flag, gen)
+		if class == 0 {
+			continue
+		}
+		age := entryAge(gen, entry)
+		if victim == -1 || class < victimClass || (class == victimClass && age > victimAge) {
+			victim = idx
+			victimClass = class
+			victimAge = age
+		}
+	}
+	if victim == -1 {
+		return false, false
+	}
+	if lf.side != nil {
+		lf.spillToCold(tt, victim, gen)
+	}
+	// Replacements drop growth metadata, matching the locked table.
+	lf.writeSlot(victim, folded, data, key, heuristicHash, 0, gen)
+	return true, false
+}
+
+func (tt *TranspositionTable) deleteLockFree(match func(side *lockFreeSide) bool) int {
+	lf := tt.lockFree
+	if lf.side == nil {
+		return 0
+	}
+	deleted := 0
+	for i := range lf.slots {
+		if lf.slots[i].data.Load()&lfValidBit == 0 || !match(&lf.side[i]) {
+			continue
+		}
+		lf.clearSlot(i)
+		deleted++
+	}
+	return deleted
+}
+
+func (tt *TranspositionTable) deleteKeyLockFree(key uint64) bool {
+	lf := tt.lockFree
+	if lf.side == nil {
+		return false
+	}
+	start := tt.bucketIndex(key)
+	deleted := false
+	for i := 0; i < tt.buckets; i++ {
+		idx := start + i
+		if lf.slots[idx].data.Load()&lfValidBit == 0 || lf.side[idx].key.Load() != key {
+			continue
+		}
+		lf.clearSlot(idx)
+		deleted = true
+	}
+	return deleted
+}
+
+// snapshotLockFree returns the verifiable entries in slot order. Slots whose
+// side record no longer matches the slot are skipped.
+func (tt *TranspositionTable) snapshotLockFree() []TTEntry {
+	entries := make([]TTEntry, len(tt.lockFree.slots))
+	tt.copyLockFreeEntries(0, entries)
+	return entries
+}
+
+func (tt *TranspositionTable) copyLockFreeEntries(start int, dst []TTEntry) int {
+	lf := tt.lockFree
+	if start >= len(lf.slots) {
+		return 0
+	}
+	n := len(lf.slots) - start
+	if n > len(dst) {
+		n = len(dst)
+	}
+	for i := range dst[:n] {
+		dst[i] = TTEntry{}
+	}
+	if lf.side == nil {
+		return n
+	}
+	gen := tt.currentGeneration()
+	for i := 0; i < n; i++ {
+		side := &lf.side[start+i]
+		key := side.key.Load()
+		heuristicHash := side.heuristicHash.Load()
+		entry, ok := lf.loadSlot(start+i, foldTTKey(key, heuristicHash), gen)
+		if !ok {
+			continue
+		}
+		entry.Key = key
+		entry.HeuristicHash = heuristicHash
+		entry.Hits = side.hits.Load()
+		applyPackedTTMeta(&entry, side.meta.Load())
+		dst[i] = entry
+	}
+	return n
+}
+
+func (tt *TranspositionTable) loadLockFree(entries []TTEntry) {
+	gen := tt.currentGeneration()
+	for _, entry := range entries {
+		if !entry.Valid {
+			continue
+		}
+		folded := foldTTKey(entry.Key, entry.HeuristicHash)
+		data := packTTData(entry.Depth, entry.Score, entry.Flag, entry.BestMove, gen)
+		meta := TTMeta{
+			GrowLeft:   int(entry.GrowLeft),
+			GrowRight:  int(entry.GrowRight),
+			GrowTop:    int(entry.GrowTop),
+			GrowBottom: int(entry.GrowBottom),
+			FrameW:     int(entry.FrameW),
+			FrameH:     int(entry.FrameH),
+			HitLeft:    entry.HitLeft,
+			HitRight:   entry.HitRight,
+			HitTop:     entry.HitTop,
+			HitBottom:  entry.HitBottom,
+		}
+		start := tt.bucketIndex(entry.Key)
+		for i := 0; i < tt.buckets; i++ {
+			idx := start + i
+			if tt.lockFree.slots[idx].data.Load()&lfValidBit != 0 {
+				continue
+			}
+			tt.lockFree.writeSlot(idx, folded, data, entry.Key, entry.HeuristicHash, packTTMeta(meta), gen)
+			if tt.lockFree.side != nil {
+				tt.lockFree.side[idx].hits.Store(entry.Hits)
+			}
+			break
+		}
+	}
+}
+
+func (tt *TranspositionTable) countLockFree() int {
+	count := 0
+	for i := range tt.lockFree.slots {
+		if tt.lockFree.slots[i].data.Load()&lfValidBit != 0 {
+			count++
+		}
+	}
+	return count
+}
+
+func (tt *TranspositionTable) clearLockFree() {
+	for i := range tt.lockFree.slots {
+		tt.lockFree.clearSlot(i)
+	}
+	tt.gen.Store(1)
+}
+
+// lockFreeTTEntryBytes is the per-slot footprint used for memory sizing.
+func lockFreeTTEntryBytes(withMeta bool) int64 {
+	bytes := int64(16)
+	if withMeta {
+		bytes += 32
+	}
+	return bytes
+}
@@ -1,7 +1,11 @@
 package main
 
 import (
-	"encoding/gob"
+	"bufio"
+	"encoding/binary"
+	"errors"
+	"fmt"
+	"io"
 	"log"
 	"os"
 	"path/filepath"
@@ -9,34 +13,242 @@ import (
 
 var dockerCacheDir = "/cache_logs"
 
-type ttPersistenceSnapshot struct {
-	Size    int
-	Buckets int
-	Entries []TTEntry
+// The snapshot is a fixed header followed by every TT slot and then every
+// root-transpose slot, in slot order, as fixed-size little-endian records.
+// Bump ttPersistenceVersion whenever a record layout or meaning changes.
+// Version 2 stores best moves in the canonical orientation.
+const (
+	ttPersistenceMagic       = "GMKTTBIN"
+	ttPersistenceVersion     = 2
+	ttPersistenceRecordBytes = 48
+	rtPersistenceRecordBytes = 32
+	ttPersistenceChunk       = 4096
+)
+
+type ttPersistenceHeader struct {
+	Magic         [8]byte
+	Version       uint32
+	BoardSize     uint32
+	TTRecordBytes uint32
+	RTRecordBytes uint32
+	HeuristicHash uint64
+
+	Size    uint64
+	Buckets uint32
+	Count   uint64
 
-	RootTransposeSize    int
-	RootTransposeBuckets int
-	RootTransposeEntries []RootTransposeEntry
+	RootTransposeSize    uint64
+	RootTransposeBuckets uint32
+	RootTransposeCount   uint64
 }
 
-func countValidTTEntries(entries []TTEntry) int {
-	count := 0
-	for _, entry := range entries {
-		if entry.Valid {
-			count++
+const (
+	persistBitValid = 1 << iota
+	persistBitHitLeft
+	persistBitHitRight
+	persistBitHitTop
+	persistBitHitBottom
+)
+
+func packPersistBits(valid, left, right, top, bottom bool) byte {
+	var bits byte
+	for i, set := range [...]bool{valid, left, right, top, bottom} {
+		if set {
+			bits |= 1 << i
 		}
 	}
-	return count
+	return bits
+}
+
+func encodeTTRecord(buf []byte, e *TTEntry) {
+	binary.LittleEndian.PutUint64(buf[0:], e.Key)
+	binary.LittleEndian.PutUint64(buf[8:], e.HeuristicHash)
+	binary.LittleEndian.PutUint32(buf[16:], uint32(e.Score))
+	binary.LittleEndian.PutUint32(buf[20:], e.Hits)
+	binary.LittleEndian.PutUint32(buf[24:], e.GenWritten)
+	binary.LittleEndian.PutUint32(buf[28:], e.GenLastUsed)
+	binary.LittleEndian.PutUint16(buf[32:], uint16(int16(e.Depth)))
+	buf[34] = byte(e.Flag)
+	buf[35] = byte(int8(e.BestMove.X))
+	buf[36] = byte(int8(e.BestMove.Y))
+	buf[37] = packPersistBits(e.Valid, e.HitLeft, e.HitRight, e.HitTop, e.HitBottom)
+	buf[38], buf[39], buf[40], buf[41] = e.GrowLeft, e.GrowRight, e.GrowTop, e.GrowBottom
+	buf[42], buf[43] = e.FrameW, e.FrameH
+	clear(buf[44:ttPersistenceRecordBytes])
+}
+
+func decodeTTRecord(buf []byte) TTEntry {
+	bits := buf[37]
+	return TTEntry{
+		Key:           binary.LittleEndian.Uint64(buf[0:]),
+		HeuristicHash: binary.LittleEndian.Uint64(buf[8:]),
+		Score:         int32(binary.LittleEndian.Uint32(buf[16:])),
+		Hits:          binary.LittleEndian.Uint32(buf[20:]),
+		GenWritten:    binary.LittleEndian.Uint32(buf[24:]),
+		GenLastUsed:   binary.LittleEndian.Uint32(buf[28:]),
+		Depth:         int(int16(binary.LittleEndian.Uint16(buf[32:]))),
+		Flag:          TTFlag(buf[34]),
+		BestMove:      Move{X: int(int8(buf[35])), Y: int(int8(buf[36]))},
+		Valid:         bits&persistBitValid != 0,
+		HitLeft:       bits&persistBitHitLeft != 0,
+		HitRight:      bits&persistBitHitRight != 0,
+		HitTop:        bits&persistBitHitTop != 0,
+		HitBottom:     bits&persistBitHitBottom != 0,
+		GrowLeft:      buf[38],
+		GrowRight:     buf[39],
+		GrowTop:       buf[40],
+		GrowBottom:    buf[41],
+		FrameW:        buf[42],
+		FrameH:        buf[43],
+	}
+}
+
+func encodeRootTransposeRecord(buf []byte, e *RootTransposeEntry) {
+	binary.LittleEndian.PutUint64(buf[0:], e.Key)
+	binary.LittleEndian.PutUint32(buf[8:], uint32(e.Score))
+	binary.LittleEndian.PutUint32(buf[12:], e.GenWritten)
+	binary.LittleEndian.PutUint32(buf[16:], e.GenLastUsed)
+	binary.LittleEndian.PutUint16(buf[20:], uint16(int16(e.Depth)))
+	buf[22] = byte(e.Flag)
+	buf[23] = byte(int8(e.BestRel.X))
+	buf[24] = byte(int8(e.BestRel.Y))
+	buf[25] = packPersistBits(e.Valid, e.HitLeft, e.HitRight, e.HitTop, e.HitBottom)
+	buf[26], buf[27], buf[28], buf[29] = e.GrowLeft, e.GrowRight, e.GrowTop, e.GrowBottom
+	buf[30], buf[31] = e.FrameW, e.FrameH
+}
+
+func decodeRootTransposeRecord(buf []byte) RootTransposeEntry {
+	bits := buf[25]
+	return RootTransposeEntry{
+		Key:         binary.LittleEndian.Uint64(buf[0:]),
+		Score:       int32(binary.LittleEndian.Uint32(buf[8:])),
+		GenWritten:  binary.LittleEndian.Uint32(buf[12:]),
+		GenLastUsed: binary.LittleEndian.Uint32(buf[16:]),
+		Depth:       int(int16(binary.LittleEndian.Uint16(buf[20:]))),
+		Flag:        TTFlag(buf[22]),
+		BestRel:     Move{X: int(int8(buf[23])), Y: int(int8(buf[24]))},
+		Valid:       bits&persistBitValid != 0,
+		HitLeft:     bits&persistBitHitLeft != 0,
+		HitRight:    bits&persistBitHitRight != 0,
+		HitTop:      bits&persistBitHitTop != 0,
+		HitBottom:   bits&persistBitHitBottom != 0,
+		GrowLeft:    buf[26],
+		GrowRight:   buf[27],
+		GrowTop:     buf[28],
+		GrowBottom:  buf[29],
+		FrameW:      buf[30],
+		FrameH:      buf[31],
+	}
 }
 
-func countValidRootTransposeEntries(entries []RootTransposeEntry) int {
-	count := 0
-	for _, entry := range entries {
-		if entry.Valid {
-			count++
+// writeTTRecords streams the table chunk by chunk, so only one chunk is ever
+// copied out of it. It returns the number of valid entries written.
+func writeTTRecords(w io.Writer, tt *TranspositionTable, count int) (int, error) {
+	entries := make([]TTEntry, ttPersistenceChunk)
+	buf := make([]byte, ttPersistenceChunk*ttPersistenceRecordBytes)
+	valid := 0
+	for start := 0; start < count; {
+		n := tt.copyEntries(start, entries)
+		if n == 0 {
+			return valid, fmt.Errorf("TT shrank to %d slots while writing", start)
+		}
+		for i := 0; i < n; i++ {
+			if entries[i].Valid {
+				valid++
+			}
+			encodeTTRecord(buf[i*ttPersistenceRecordBytes:], &entries[i])
 		}
+		if _, err := w.Write(buf[:n*ttPersistenceRecordBytes]); err != nil {
+			return valid, err
+		}
+		start += n
 	}
-	return count
+	return valid, nil
+}
+
+func writeRootTransposeRecords(w io.Writer, rtc *RootTransposeCache, count int) (int, error) {
+	entries := make([]RootTransposeEntry, ttPersistenceChunk)
+	buf := make([]byte, ttPersistenceChunk*rtPersistenceRecordBytes)
+	valid := 0
+	for start := 0; start < count; {
+		n := rtc.copyEntries(start, entries)
+		if n == 0 {
+			return valid, fmt.Errorf("root-transpose cache shrank to %d slots while writing", start)
+		}
+		for i := 0; i < n; i++ {
+			if entries[i].Valid {
+				valid++
+			}
+			encodeRootTransposeRecord(buf[i*rtPersistenceRecordBytes:], &entries[i])
+		}
+		if _, err := w.Write(buf[:n*rtPersistenceRecordBytes]); err != nil {
+			return valid, err
+		}
+		start += n
+	}
+	return valid, nil
+}
+
+// readTTRecords decodes count records straight into tt.
+func readTTRecords(r io.Reader, tt *TranspositionTable, count int) (int, error) {
+	entries := make([]TTEntry, ttPersistenceChunk)
+	buf := make([]byte, ttPersistenceChunk*ttPersistenceRecordBytes)
+	valid := 0
+	for start := 0; start < count; {
+		n := min(ttPersistenceChunk, count-start)
+		if _, err := io.ReadFull(r, buf[:n*ttPersistenceRecordBytes]); err != nil {
+			return valid, err
+		}
+		for i := 0; i < n; i++ {
+			entries[i] = decodeTTRecord(buf[i*ttPersistenceRecordBytes:])
+			if entries[i].Valid {
+				valid++
+			}
+		}
+		tt.storeEntries(start, entries[:n])
+		start += n
+	}
+	return valid, nil
+}
+
+func readRootTransposeRecords(r io.Reader, rtc *RootTransposeCache, count int) (int, error) {
+	entries := make([]RootTransposeEntry, ttPersistenceChunk)
+	buf := make([]byte, ttPersistenceChunk*rtPersistenceRecordBytes)
+	valid := 0
+	for start := 0; start < count; {
+		n := min(ttPersistenceChunk, count-start)
+		if _, err := io.ReadFull(r, buf[:n*rtPersistenceRecordBytes]); err != nil {
+			return valid, err
+		}
+		for i := 0; i < n; i++ {
+			entries[i] = decodeRootTransposeRecord(buf[i*rtPersistenceRecordBytes:])
+			if entries[i].Valid {
+				valid++
+			}
+		}
+		rtc.storeEntries(start, entries[:n])
+		start += n
+	}
+	return valid, nil
+}
+
+func readTTPersistenceHeader(r io.Reader) (ttPersistenceHeader, error) {
+	var header ttPersistenceHeader
+	if err := binary.Read(r, binary.LittleEndian, &header); err != nil {
+		return header, err
+	}
+	switch {
+	case string(header.Magic[:]) != ttPersistenceMagic:
+		return header, errors.New("not a binary TT snapshot")
+	case header.Version != ttPersistenceVersion:
+		return header, fmt.Errorf("layout version %d, want %d", header.Version, ttPersistenceVersion)
+	case header.TTRecordBytes != ttPersistenceRecordBytes || header.RTRecordBytes != rtPersistenceRecordBytes:
+		return header, fmt.Errorf("record sizes %d/%d, want %d/%d",
+			header.TTRecordBytes, header.RTRecordBytes, ttPersistenceRecordBytes, rtPersistenceRecordBytes)
+	case header.BoardSize != maxBoardSize:
+		return header, fmt.Errorf("board size %d, want %d", header.BoardSize, maxBoardSize)
+	}
+	return header, nil
 }
 
 func loadTTPersistence(cfg Config, cache *AISearchCache) {
@@ -57,34 +269,53 @@ func loadTTPersistence(cfg Config, cache *AISearchCache) {
 	}
 	defer file.Close()
 
-	var snapshot ttPersistenceSnapshot
-	if err := gob.NewDecoder(file).Decode(&snapshot); err != nil {
+	reader := bufio.NewReaderSize(file, 1<<20)
+	header, err := readTTPersistenceHeader(reader)
+	if err != nil {
 		log.Printf("[ai:cache] failed to decode TT persistence %s: %v", path, err)
 		log.Printf("[ai:cache] restored TT persistence: 0 entries")
 		return
 	}
+	if want := heuristicHashFromConfig(cfg); header.HeuristicHash != want {
+		log.Printf("[ai:cache] TT persistence heuristic hash %x does not match current heuristics %x; skipping",
+			header.HeuristicHash, want)
+		log.Printf("[ai:cache] restored TT persistence: 0 entries")
+		return
+	}
 	buckets := cfg.AiTtBuckets
 	if !cfg.AiTtUseSetAssoc {
 		buckets = 1
 	}
 	ttLoaded := false
-	if snapshot.Size != cfg.AiTtSize || snapshot.Buckets != buckets {
+	size, snapshotBuckets, count := int(header.Size), int(header.Buckets), int(header.Count)
+	if size != cfg.AiTtSize || snapshotBuckets != buckets {
 		log.Printf("[ai:cache] TT persistence (%d/%d) does not match current TT config (%d/%d); skipping",
-			snapshot.Size, snapshot.Buckets, cfg.AiTtSize, buckets)
+			size, snapshotBuckets, cfg.AiTtSize, buckets)
+	} else if tt := newConfiguredTT(uint64(size), snapshotBuckets, cfg); tt.Capacity() != count {
+		log.Printf("[ai:cache] TT persistence has %d slots, current TT has %d; skipping", count, tt.Capacity())
 	} else {
-		tt := NewTranspositionTable(uint64(snapshot.Size), snapshot.Buckets)
-		tt.loadEntries(snapshot.Entries)
+		validEntries, err := readTTRecords(reader, tt, count)
+		if err != nil {
+			log.Printf("[ai:cache] failed to decode TT persistence %s: %v", path, err)
+			log.Printf("[ai:cache] restored TT persistence: 0 entries")
+			return
+		}
 		cache.mu.Lock()
 		cache.TT = tt
-		cache.TTSize = snapshot.Size
-		cache.TTBuckets = snapshot.Buckets
+		cache.TTSize = size
+		cache.TTBuckets = snapshotBuckets
+		cache.TTLockFree = cfg.AiTtLockFree
+		cache.TTLockFreeMeta = cfg.AiTtLockFree && cfg.AiTtLockFreeMeta
+		cache.TTRawKeys = !cfg.AiTtSymmetry
 		cache.mu.Unlock()
-		validEntries := countValidTTEntries(snapshot.Entries)
-		log.Printf("[ai:cache] restored TT persistence from %s (%d/%d valid entries)", path, validEntries, len(snapshot.Entries))
+		log.Printf("[ai:cache] restored TT persistence from %s (%d/%d valid entries)", path, validEntries, count)
 		ttLoaded = true
 	}
 	if !ttLoaded {
 		log.Printf("[ai:cache] restored TT persistence: 0 entries")
+		if _, err := reader.Discard(count * ttPersistenceRecordBytes); err != nil {
+			return
+		}
 	}
 
 	if !cfg.AiEnableRootTranspose {
@@ -92,25 +323,36 @@ func loadTTPersistence(cfg Config, cache *AISearchCache) {
 		return
 	}
 	rootBuckets := 2
-	if snapshot.RootTransposeSize <= 0 || len(snapshot.RootTransposeEntries) == 0 {
+	rootSize, rootSnapshotBuckets, rootCount := int(header.RootTransposeSize), int(header.RootTransposeBuckets), int(header.RootTransposeCount)
+	if rootSize <= 0 || rootCount == 0 {
 		log.Printf("[ai:cache] restored root-transpose persistence: 0 entries (not found in snapshot)")
 		return
 	}
-	if snapshot.RootTransposeSize != cfg.AiRootTransposeSize || snapshot.RootTransposeBuckets != rootBuckets {
+	if rootSize != cfg.AiRootTransposeSize || rootSnapshotBuckets != rootBuckets {
 		log.Printf("[ai:cache] root-transpose persistence (%d/%d) does not match current root-transpose config (%d/%d); skipping",
-			snapshot.RootTransposeSize, snapshot.RootTransposeBuckets, cfg.AiRootTransposeSize, rootBuckets)
+			rootSize, rootSnapshotBuckets, cfg.AiRootTransposeSize, rootBuckets)
+		log.Printf("[ai:cache] restored root-transpose persistence: 0 entries")
+		return
+	}
+	rootTranspose := NewRootTransposeCache(uint64(rootSize), rootSnapshotBuckets)
+	if rootTranspose.slotCount() != rootCount {
+		log.Printf("[ai:cache] root-transpose persistence has %d slots, current cache has %d; skipping",
+			rootCount, rootTranspose.slotCount())
+		log.Printf("[ai:cache] restored root-transpose persistence: 0 entries")
+		return
+	}
+	validRootEntries, err := readRootTransposeRecords(reader, rootTranspose, rootCount)
+	if err != nil {
+		log.Printf("[ai:cache] failed to decode root-transpose persistence %s: %v", path, err)
 		log.Printf("[ai:cache] restored root-transpose persistence: 0 entries")
 		return
 	}
-	rootTranspose := NewRootTransposeCache(uint64(snapshot.RootTransposeSize), snapshot.RootTransposeBuckets)
-	rootTranspose.loadEntries(snapshot.RootTransposeEntries)
 	cache.mu.Lock()
 	cache.RootTranspose = rootTranspose
-	cache.RootTransposeSize = snapshot.RootTransposeSize
-	cache.RootTransposeBucks = snapshot.RootTransposeBuckets
+	cache.RootTransposeSize = rootSize
+	cache.RootTransposeBucks = rootSnapshotBuckets
 	cache.mu.Unlock()
-	validRootEntries := countValidRootTransposeEntries(snapshot.RootTransposeEntries)
-	log.Printf("[ai:cache] restored root-transpose persistence from %s (%d/%d valid entries)", path, validRootEntries, len(snapshot.RootTransposeEntries))
+	log.Printf("[ai:cache] restored root-transpose persistence from %s (%d/%d valid entries)", path, validRootEntries, rootCount)
 }
 
 func persistTTPersistence(cfg Config, cache *AISearchCache) {
@@ -128,47 +370,75 @@ func persistTTPersistence(cfg Config, cache *AISearchCache) {
 	cache.mu.Unlock()
 	if tt == nil || size == 0 || buckets == 0 {
 		log.Printf("[ai:cache] stored TT persistence: 0 entries (TT not initialized)")
-	} else {
-		entries := tt.snapshotEntries()
-		validEntries := countValidTTEntries(entries)
-		path := resolveTTPersistencePath(cfg.AiTtPersistencePath)
-		dir := filepath.Dir(path)
-		if dir != "." && dir != "" {
-			if err := os.MkdirAll(dir, 0o755); err != nil {
-				log.Printf("[ai:cache] unable to create TT persistence directory %s: %v", dir, err)
-				return
-			}
-		}
-		rootEntries := []RootTransposeEntry(nil)
-		validRootEntries := 0
-		if cfg.AiEnableRootTranspose && rootTranspose != nil && rootTransposeSize > 0 && rootTransposeBuckets > 0 {
-			rootEntries = rootTranspose.snapshotEntries()
-			validRootEntries = countValidRootTransposeEntries(rootEntries)
-		}
-		file, err := os.Create(path)
-		if err != nil {
-			log.Printf("[ai:cache] failed to create TT persistence %s: %v", path, err)
+		log.Printf("[ai:cache] stored root-transpose persistence: 0 entries (TT not initialized)")
+		return
+	}
+	path := resolveTTPersistencePath(cfg.AiTtPersistencePath)
+	dir := filepath.Dir(path)
+	if dir != "." && dir != "" {
+		if err := os.MkdirAll(dir, 0o755); err != nil {
+			log.Printf("[ai:cache] unable to create TT persistence directory %s: %v", dir, err)
 			return
 		}
-		defer file.Close()
-		snapshot := ttPersistenceSnapshot{
-			Size:    size,
-			Buckets: buckets,
-			Entries: entries,
+	}
+	header := ttPersistenceHeader{
+		Version:       ttPersistenceVersion,
+		BoardSize:     maxBoardSize,
+		TTRecordBytes: ttPersistenceRecordBytes,
+		RTRecordBytes: rtPersistenceRecordBytes,
+		HeuristicHash: heuristicHashFromConfig(cfg),
+		Size:          uint64(size),
+		Buckets:       uint32(buckets),
+		Count:         uint64(tt.Capacity()),
+	}
+	copy(header.Magic[:], ttPersistenceMagic)
+	if cfg.AiEnableRootTranspose && rootTranspose != nil && rootTransposeSize > 0 && rootTransposeBuckets > 0 {
+		header.RootTransposeSize = uint64(rootTransposeSize)
+		header.RootTransposeBuckets = uint32(rootTransposeBuckets)
+		header.RootTransposeCount = uint64(rootTranspose.slotCount())
+	}
 
-			RootTransposeSize:    rootTransposeSize,
-			RootTransposeBuckets: rootTransposeBuckets,
-			RootTransposeEntries: rootEntries,
-		}
-		if err := gob.NewEncoder(file).Encode(&snapshot); err != nil {
-			log.Printf("[ai:cache] failed to encode TT persistence %s: %v", path, err)
-			return
-		}
-		log.Printf("[ai:cache] stored TT persistence to %s (%d/%d valid entries)", path, validEntries, len(entries))
-		log.Printf("[ai:cache] stored root-transpose persistence to %s (%d/%d valid entries)", path, validRootEntries, len(rootEntries))
+	// Write next to the target and rename, so a crash mid-write never leaves
+	// a truncated snapshot behind.
+	tmpPath := path + ".tmp"
+	file, err := os.Create(tmpPath)
+	if err != nil {
+		log.Printf("[ai:cache] failed to create TT persistence %s: %v", path, err)
 		return
 	}
-	log.Printf("[ai:cache] stored root-transpose persistence: 0 entries (TT not initialized)")
+	validEntries, validRootEntries, err := writeTTPersistence(file, header, tt, rootTranspose)
+	if closeErr := file.Close(); err == nil {
+		err = closeErr
+	}
+	if err == nil {
+		err = os.Rename(tmpPath, path)
+	}
+	if err != nil {
+		os.Remove(tmpPath)
+		log.Printf("[ai:cache] failed to encode TT persistence %s: %v", path, err)
+		return
+	}
+	log.Printf("[ai:cache] stored TT persistence to %s (%d/%d valid entries)", path, validEntries, header.Count)
+	log.Printf("[ai:cache] stored root-transpose persistence to %s (%d/%d valid entries)", path, validRootEntries, header.RootTransposeCount)
+}
+
+func writeTTPersistence(file *os.File, header ttPersistenceHeader, tt *TranspositionTable, rootTranspose *RootTransposeCache) (int, int, error) {
+	writer := bufio.NewWriterSize(file, 1<<20)
+	if err := binary.Write(writer, binary.LittleEndian, &header); err != nil {
+		return 0, 0, err
+	}
+	validEntries, err := writeTTRecords(writer, tt, int(header.Count))
+	if err != nil {
+		return validEntries, 0, err
+	}
+	validRootEntries := 0
+	if header.RootTransposeCount > 0 {
+		validRootEntries, err = writeRootTransposeRecords(writer, rootTranspose, int(header.RootTransposeCount))
+		if err != nil {
+			return validEntries, validRootEntries, err
+		}
+	}
+	return validEntries, validRootEntries, writer.Flush()
 }
 
 func resolveTTPersistencePath(path string) string {
@@ -103,3 +103,49 @@ func TestRootTransposePersistenceRoundTrip(t *testing.T) {
 		t.Fatalf("unexpected restored root transpose entry: %+v", rtEntry)
 	}
 }
+
+func TestTTPersistenceLockFreeRoundTripAndHeuristicMismatch(t *testing.T) {
+	temp := t.TempDir()
+	old := dockerCacheDir
+	dockerCacheDir = temp
+	t.Cleanup(func() { dockerCacheDir = old })
+
+	cfg := DefaultConfig()
+	cfg.AiEnableTtPersistence = true
+	cfg.AiTtPersistencePath = "tt_cache.bin"
+	cfg.AiTtUseSetAssoc = true
+	cfg.AiTtBuckets = 2
+	cfg.AiTtSize = 8192
+	cfg.AiTtLockFree = true
+	cfg.AiEnableRootTranspose = false
+
+	cache := newAISearchCache()
+	tt := ensureTT(&cache, cfg)
+	hh := heuristicHashFromConfig(cfg)
+	for i := uint64(1); i <= 5000; i++ {
+		tt.Store(i*0x9e3779b97f4a7c15, hh, int(i%9)+1, float64(i), TTLower, Move{X: int(i % 19), Y: int(i / 19 % 19)}, TTMeta{})
+	}
+	persistTTPersistence(cfg, &cache)
+
+	loaded := newAISearchCache()
+	loadTTPersistence(cfg, &loaded)
+	loadedTT := ensureTT(&loaded, cfg)
+	if got, want := loadedTT.Count(), tt.Count(); got != want {
+		t.Fatalf("expected %d restored entries, got %d", want, got)
+	}
+	key := uint64(4242)
+	key *= 0x9e3779b97f4a7c15
+	want, wantOK := tt.Probe(key, hh)
+	got, ok := loadedTT.Probe(key, hh)
+	if ok != wantOK || got.Depth != want.Depth || got.Score != want.Score || got.BestMove != want.BestMove {
+		t.Fatalf("restored entry %+v (%v) differs from %+v (%v)", got, ok, want, wantOK)
+	}
+
+	other := cfg
+	other.Heuristics.CaptureWinSoonScale += 1
+	skipped := newAISearchCache()
+	loadTTPersistence(other, &skipped)
+	if skipped.TT != nil {
+		t.Fatalf("expected snapshot with a different heuristic hash to be skipped")
+	}
+}
@@ -69,3 +69,145 @@ func TestTTScopesEntriesByHeuristicHash(t *testing.T) {
 		t.Fatalf("expected heuristic B entry to remain after pruning A")
 	}
 }
+
+func TestLockFreeTTConcurrentProbeStore(t *testing.T) {
+	tt := NewLockFreeTranspositionTable(1<<12, 2, true)
+	heuristicHash := heuristicHashFromConfig(DefaultConfig())
+	var wg sync.WaitGroup
+
+	for g := 0; g < 8; g++ {
+		wg.Add(1)
+		go func(seed uint64) {
+			defer wg.Done()
+			for i := 0; i < 4000; i++ {
+				key := mixKey(seed ^ uint64(i))
+				depth := (i % 8) + 1
+				move := Move{X: i % 19, Y: (i / 19) % 19}
+				tt.Store(key, heuristicHash, depth, float64(i), TTExact, move, TTMeta{})
+				if entry, ok := tt.Probe(key, heuristicHash); ok && entry.BestMove.X >= 19 {
+					t.Errorf("corrupt entry returned: %+v", entry)
+				}
+			}
+		}(uint64(g + 1))
+	}
+
+	wg.Wait()
+	if tt.Count() == 0 {
+		t.Fatalf("expected TT to contain entries after concurrent traffic")
+	}
+}
+
+func TestLockFreeTTRoundTripsEntryFields(t *testing.T) {
+	tt := NewLockFreeTranspositionTable(64, 4, true)
+	key := uint64(0x1234)
+	tt.Store(key, 0xaaa, 9, -1234567, TTLower, Move{X: 18, Y: 0}, TTMeta{GrowLeft: 2, FrameW: 7, HitTop: true})
+
+	entry, ok := tt.Probe(key, 0xaaa)
+	if !ok {
+		t.Fatalf("expected lock-free TT hit")
+	}
+	if entry.Depth != 9 || entry.Score != -1234567 || entry.Flag != TTLower {
+		t.Fatalf("unexpected packed fields: %+v", entry)
+	}
+	if entry.BestMove.X != 18 || entry.BestMove.Y != 0 {
+		t.Fatalf("unexpected best move: %+v", entry.BestMove)
+	}
+	if entry.GrowLeft != 2 || entry.FrameW != 7 || !entry.HitTop || entry.Hits != 1 {
+		t.Fatalf("unexpected side-table fields: %+v", entry)
+	}
+	if _, ok := tt.Probe(key, 0xbbb); ok {
+		t.Fatalf("expected miss for another heuristic hash")
+	}
+	if deleted := tt.DeleteByHeuristicHash(0xaaa); deleted != 1 {
+		t.Fatalf("expected one entry pruned, got %d", deleted)
+	}
+	if _, ok := tt.Probe(key, 0xaaa); ok {
+		t.Fatalf("expected entry to be gone after prune")
+	}
+}
+
+func TestEnsureTTRebuildsWhenLockFreeMetaChanges(t *testing.T) {
+	cfg := DefaultConfig()
+	cfg.AiTtSize = 1 << 8
+	cfg.AiTtMaxMemoryBytes = 0
+	cfg.AiTtLockFree = true
+	cfg.AiTtLockFreeMeta = true
+	cache := newAISearchCache()
+	withMeta := ensureTT(&cache, cfg)
+	if withMeta.lockFree.side == nil {
+		t.Fatalf("expected a side table with lock-free meta on")
+	}
+	cfg.AiTtLockFreeMeta = false
+	withoutMeta := ensureTT(&cache, cfg)
+	if withoutMeta == withMeta || withoutMeta.lockFree.side != nil {
+		t.Fatalf("expected a TT without side table once lock-free meta is off")
+	}
+	if ensureTT(&cache, cfg) != withoutMeta {
+		t.Fatalf("expected the TT kept while the config is unchanged")
+	}
+
+	cfg.AiTtLockFree = false
+	locked := ensureTT(&cache, cfg)
+	cfg.AiTtLockFreeMeta = true
+	if ensureTT(&cache, cfg) != locked {
+		t.Fatalf("expected lock-free meta to leave a locked TT alone")
+	}
+}
+
+func TestTTBoundReplacesOppositeBoundAtSameDepth(t *testing.T) {
+	for _, tt := range []*TranspositionTable{NewTranspositionTable(64, 2), NewLockFreeTranspositionTable(64, 2, false)} {
+		key := uint64(0x5678)
+		tt.Store(key, 0xaaa, 6, 100, TTUpper, Move{X: 1, Y: 1}, TTMeta{})
+		tt.Store(key, 0xaaa, 6, 140, TTLower, Move{X: 2, Y: 2}, TTMeta{})
+		entry, ok := tt.Probe(key, 0xaaa)
+		if !ok || entry.Flag != TTLower || entry.Score != 140 {
+			t.Fatalf("expected the re-searched lower bound to replace the upper bound, got %+v", entry)
+		}
+		tt.Store(key, 0xaaa, 6, 120, TTExact, Move{X: 3, Y: 3}, TTMeta{})
+		tt.Store(key, 0xaaa, 6, 90, TTUpper, Move{X: 4, Y: 4}, TTMeta{})
+		if entry, _ := tt.Probe(key, 0xaaa); entry.Flag != TTExact {
+			t.Fatalf("expected a bound not to replace an exact entry, got %+v", entry)
+		}
+	}
+}
+
+func TestTTProbeStateMapsBestMoveAcrossSymmetries(t *testing.T) {
+	const size = 9
+	settings := DefaultGameSettings()
+	settings.BoardSize = size
+	stones := []struct {
+		x, y int
+		cell Cell
+	}{{4, 4, CellBlack}, {5, 4, CellWhite}, {3, 2, CellBlack}, {6, 5, CellWhite}}
+	build := func(transform symmetryTransform) GameState {
+		state := DefaultGameState(settings)
+		state.Status = StatusRunning
+		for _, stone := range stones {
+			x, y := transformCoord(stone.x, stone.y, size, transform)
+			state.Board.Set(x, y, stone.cell)
+		}
+		state.recomputeHashes()
+		return state
+	}
+	for _, rawKeys := range []bool{false, true} {
+		tt := NewTranspositionTable(64, 2)
+		tt.rawKeys = rawKeys
+		base := build(symmetryTransforms[0])
+		best := Move{X: 2, Y: 3}
+		tt.StoreState(&base, tt.KeyFor(&base, size), 0xaaa, 5, 77, TTExact, best, TTMeta{})
+		for i, transform := range symmetryTransforms {
+			state := build(transform)
+			entry, ok := tt.ProbeState(&state, tt.KeyFor(&state, size), 0xaaa)
+			if rawKeys {
+				if ok != (i == 0) {
+					t.Fatalf("raw keys, transform %d: hit=%v", i, ok)
+				}
+				continue
+			}
+			wantX, wantY := transformCoord(best.X, best.Y, size, transform)
+			if !ok || entry.BestMove != (Move{X: wantX, Y: wantY}) {
+				t.Fatalf("transform %d: got move=%v ok=%v, want (%d,%d)", i, entry.BestMove, ok, wantX, wantY)
+			}
+		}
+	}
+}
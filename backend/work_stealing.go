@@ -0,0 +1,230 @@
+package main
+
+import (
+	"sync"
+	"sync/atomic"
+	"time"
+)
+
+type poolJob func(worker int)
+
+// workDeque is a per-worker job stack: the owner pushes and pops at the
+// bottom, thieves take from the top so they get the oldest work.
+type workDeque struct {
+	mu   sync.Mutex
+	jobs []poolJob
+}
+
+func (d *workDeque) pushBottom(job poolJob) {
+	d.mu.Lock()
+	d.jobs = append(d.jobs, job)
+	d.mu.Unlock()
+}
+
+func (d *workDeque) popBottom() (poolJob, bool) {
+	d.mu.Lock()
+	defer d.mu.Unlock()
+	n := len(d.jobs)
+	if n == 0 {
+		return nil, false
+	}
+	job := d.jobs[n-1]
+	d.jobs[n-1] = nil
+	d.jobs = d.jobs[:n-1]
+	return job, true
+}
+
+func (d *workDeque) stealTop() (poolJob, bool) {
+	d.mu.Lock()
+	defer d.mu.Unlock()
+	if len(d.jobs) == 0 {
+		return nil, false
+	}
+	job := d.jobs[0]
+	d.jobs[0] = nil
+	d.jobs = d.jobs[1:]
+	return job, true
+}
+
+func (d *workDeque) Len() int {
+	d.mu.Lock()
+	defer d.mu.Unlock()
+	return len(d.jobs)
+}
+
+type workPoolStats struct {
+	Workers  int
+	Executed int64
+	Stolen   int64
+	// Busy is each worker's time spent in jobs and in idle calls that found
+	// work, since Start.
+	Busy   []time.Duration
+	Uptime time.Duration
+}
+
+// workStealingPool runs jobs on a fixed set of workers. A worker with an empty
+// deque steals from the others, then falls back to idle, which may start new
+// work on that worker (such as picking the next backlog board).
+type workStealingPool struct {
+	deques   []workDeque
+	wake     chan struct{}
+	idle     func(worker int) bool
+	idleWait time.Duration
+	stop     atomic.Bool
+	wg       sync.WaitGroup
+	executed atomic.Int64
+	stolen   atomic.Int64
+	busy     []atomic.Int64 // nanoseconds per worker
+	started  time.Time
+}
+
+func newWorkStealingPool(workers int, idle func(worker int) bool, idleWait time.Duration) *workStealingPool {
+	if workers < 1 {
+		workers = 1
+	}
+	if idleWait <= 0 {
+		idleWait = 150 * time.Millisecond
+	}
+	return &workStealingPool{
+		deques:   make([]workDeque, workers),
+		wake:     make(chan struct{}, workers),
+		busy:     make([]atomic.Int64, workers),
+		idle:     idle,
+		idleWait: idleWait,
+	}
+}
+
+func (p *workStealingPool) Workers() int {
+	return len(p.deques)
+}
+
+func (p *workStealingPool) Start() {
+	p.started = time.Now()
+	for i := range p.deques {
+		p.wg.Add(1)
+		go p.run(i)
+	}
+}
+
+// Close stops the workers after their current job and waits for them.
+func (p *workStealingPool) Close() {
+	p.stop.Store(true)
+	for range p.deques {
+		p.signal()
+	}
+	p.wg.Wait()
+}
+
+func (p *workStealingPool) Stats() workPoolStats {
+	stats := workPoolStats{
+		Workers:  len(p.deques),
+		Executed: p.executed.Load(),
+		Stolen:   p.stolen.Load(),
+		Busy:     make([]time.Duration, len(p.busy)),
+	}
+	for i := range p.busy {
+		stats.Busy[i] = time.Duration(p.busy[i].Load())
+	}
+	if !p.started.IsZero() {
+		stats.Uptime = time.Since(p.started)
+	}
+	return stats
+}
+
+func (p *workStealingPool) signal() {
+	select {
+	case p.wake <- struct{}{}:
+	default:
+	}
+}
+
+func (p *workStealingPool) run(worker int) {
+	defer p.wg.Done()
+	for !p.stop.Load() {
+		if job, ok := p.next(worker); ok {
+			start := time.Now()
+			job(worker)
+			p.busy[worker].Add(int64(time.Since(start)))
+			p.executed.Add(1)
+			continue
+		}
+		if p.idle != nil {
+			start := time.Now()
+			if p.idle(worker) {
+				p.busy[worker].Add(int64(time.Since(start)))
+				continue
+			}
+		}
+		timer := time.NewTimer(p.idleWait)
+		select {
+		case <-p.wake:
+		case <-timer.C:
+		}
+		timer.Stop()
+	}
+}
+
+func (p *workStealingPool) next(worker int) (poolJob, bool) {
+	if job, ok := p.deques[worker].popBottom(); ok {
+		return job, true
+	}
+	n := len(p.deques)
+	for i := 1; i < n; i++ {
+		if job, ok := p.deques[(worker+i)%n].stealTop(); ok {
+			p.stolen.Add(1)
+			return job, true
+		}
+	}
+	return nil, false
+}
+
+// RunAll pushes jobs onto worker's deque and returns once all have finished.
+// The caller drains its own deque in order while idle workers steal from the
+// far end, so the last jobs are the ones most likely to move.
+func (p *workStealingPool) RunAll(worker int, jobs []func()) {
+	if len(jobs) == 0 {
+		return
+	}
+	var wg sync.WaitGroup
+	wg.Add(len(jobs))
+	deque := &p.deques[worker]
+	for i := len(jobs) - 1; i >= 0; i-- {
+		job := jobs[i]
+		deque.pushBottom(func(int) {
+			defer wg.Done()
+			job()
+		})
+	}
+	for i := 1; i < len(jobs) && i < len(p.deques); i++ {
+		p.signal()
+	}
+	for {
+		job, ok := deque.popBottom()
+		if !ok {
+			break
+		}
+		job(worker)
+		p.executed.Add(1)
+	}
+	wg.Wait()
+}
+
+// Submit queues jobs from outside the pool, dealt across the workers' deques
+// so each worker starts on its own share in order, and returns at once.
+func (p *workStealingPool) Submit(jobs []poolJob) {
+	n := len(p.deques)
+	for i := len(jobs) - 1; i >= 0; i-- {
+		p.deques[i%n].pushBottom(jobs[i])
+	}
+	for i := 0; i < len(jobs) && i < n; i++ {
+		p.signal()
+	}
+}
+
+// rootJobRunner adapts RunAll to AIScoreSettings.RunRootJobs for a search
+// running on worker.
+func (p *workStealingPool) rootJobRunner(worker int) func(jobs []func()) {
+	return func(jobs []func()) {
+		p.RunAll(worker, jobs)
+	}
+}
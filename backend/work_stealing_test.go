@@ -0,0 +1,67 @@
+package main
+
+import (
+	"sync/atomic"
+	"testing"
+	"time"
+)
+
+func TestWorkDequeOwnerPopsNewestThiefStealsOldest(t *testing.T) {
+	var d workDeque
+	var order []int
+	for i := 0; i < 3; i++ {
+		i := i
+		d.pushBottom(func(int) { order = append(order, i) })
+	}
+	job, ok := d.stealTop()
+	if !ok {
+		t.Fatalf("expected steal to succeed")
+	}
+	job(0)
+	job, ok = d.popBottom()
+	if !ok {
+		t.Fatalf("expected pop to succeed")
+	}
+	job(0)
+	if len(order) != 2 || order[0] != 0 || order[1] != 2 {
+		t.Fatalf("expected steal=0 pop=2, got %v", order)
+	}
+	if d.Len() != 1 {
+		t.Fatalf("expected one job left, got %d", d.Len())
+	}
+}
+
+func TestWorkStealingPoolRunAllSpreadsJobsAcrossWorkers(t *testing.T) {
+	pool := newWorkStealingPool(4, nil, time.Millisecond)
+	pool.Start()
+	defer pool.Close()
+
+	const jobCount = 16
+	var ran atomic.Int64
+	jobs := make([]func(), jobCount)
+	for i := range jobs {
+		jobs[i] = func() {
+			time.Sleep(2 * time.Millisecond)
+			ran.Add(1)
+		}
+	}
+	done := make(chan struct{})
+	// RunAll must be called from a pool worker, so route it through an
+	// external job on worker 0.
+	pool.deques[0].pushBottom(func(worker int) {
+		pool.RunAll(worker, jobs)
+		close(done)
+	})
+	pool.signal()
+	select {
+	case <-done:
+	case <-time.After(5 * time.Second):
+		t.Fatalf("RunAll did not finish")
+	}
+	if ran.Load() != jobCount {
+		t.Fatalf("expected %d jobs to run, got %d", jobCount, ran.Load())
+	}
+	if pool.Stats().Stolen == 0 {
+		t.Fatalf("expected idle workers to steal jobs")
+	}
+}
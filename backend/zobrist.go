@@ -106,23 +106,76 @@ var symmetryTransforms = [8]symmetryTransform{
 }
 
 func transformCoord(x, y, size int, transform symmetryTransform) (int, int) {
+	return transformRect(x, y, size, size, transform)
+}
+
+// transformRect applies transform to (x, y) inside a w x h rectangle; the
+// result lies in the transformed rectangle, see transformDims.
+func transformRect(x, y, w, h int, transform symmetryTransform) (int, int) {
 	var tx, ty int
+	outW := w
 	switch transform.rot {
 	case 0:
 		tx, ty = x, y
 	case 1:
-		tx, ty = size-1-y, x
+		tx, ty = h-1-y, x
+		outW = h
 	case 2:
-		tx, ty = size-1-x, size-1-y
+		tx, ty = w-1-x, h-1-y
 	default:
-		tx, ty = y, size-1-x
+		tx, ty = y, w-1-x
+		outW = h
 	}
 	if transform.flip {
-		tx = size - 1 - tx
+		tx = outW - 1 - tx
 	}
 	return tx, ty
 }
 
+func transformDims(w, h int, transform symmetryTransform) (int, int) {
+	if transform.rot%2 == 1 {
+		return h, w
+	}
+	return w, h
+}
+
+// inverseSymmetry[i] undoes symmetryTransforms[i].
+var inverseSymmetry = func() [8]int {
+	var inv [8]int
+	for i, forward := range symmetryTransforms {
+		x, y := transformCoord(1, 2, maxBoardSize, forward)
+		for j, back := range symmetryTransforms {
+			if bx, by := transformCoord(x, y, maxBoardSize, back); bx == 1 && by == 2 {
+				inv[i] = j
+				break
+			}
+		}
+	}
+	return inv
+}()
+
+// canonicalSymIndex returns the transform whose hash is CanonHash, i.e. the
+// one mapping the state onto its canonical orientation.
+func canonicalSymIndex(state *GameState) int {
+	for i, hash := range state.HashSym {
+		if hash == state.CanonHash {
+			return i
+		}
+	}
+	return 0
+}
+
+func toCanonicalMove(state *GameState, move Move) Move {
+	x, y := transformCoord(move.X, move.Y, state.Board.Size(), symmetryTransforms[canonicalSymIndex(state)])
+	return Move{X: x, Y: y}
+}
+
+func fromCanonicalMove(state *GameState, move Move) Move {
+	inv := symmetryTransforms[inverseSymmetry[canonicalSymIndex(state)]]
+	x, y := transformCoord(move.X, move.Y, state.Board.Size(), inv)
+	return Move{X: x, Y: y}
+}
+
 func computeSymmetricHashes(state GameState) (uint64, [8]uint64) {
 	hash := uint64(0)
 	var sym [8]uint64
@@ -49,6 +49,7 @@ export default function App() {
   const [activeRightTab, setActiveRightTab] = useState('history')
   const [analiticsQueue, setAnaliticsQueue] = useState([])
   const [analiticsTotalInQueue, setAnaliticsTotalInQueue] = useState(0)
+  const [analiticsUplift, setAnaliticsUplift] = useState(null)
   const [ttCache, setTtCache] = useState({
     count: 0,
     capacity: 0,
@@ -306,6 +307,9 @@ export default function App() {
       if (typeof total === 'number') {
         setAnaliticsTotalInQueue(total)
       }
+      if (payload.uplift) {
+        setAnaliticsUplift(payload.uplift)
+      }
 
       if (eventType === 'board_added' || eventType === 'board_hit' || eventType === 'board_left') {
         refreshAnaliticsQueue().catch(() => {})
@@ -322,6 +326,8 @@ export default function App() {
                 current_depth: entry.current_depth,
                 target_depth: entry.target_depth,
                 hits: entry.hits,
+                visits: entry.visits,
+                expected_reuse: entry.expected_reuse,
                 analyzing: entry.analyzing,
                 analysis_started_at_ms: entry.analysis_started_at_ms
               }
@@ -912,6 +918,13 @@ export default function App() {
             </div>
           ) : (
             <div className="analitics-list">
+              {analiticsUplift && analiticsUplift.live_positions > 0 && (
+                <div className="analitics-more">
+                  Backlog hit rate: {(analiticsUplift.hit_rate * 100).toFixed(1)}% of{' '}
+                  {analiticsUplift.live_positions} positions,{' '}
+                  {(analiticsUplift.hit_rate_per_backlog_hour * 100).toFixed(1)}% per backlog hour
+                </div>
+              )}
               {analiticsQueue.length === 0 && <div className="history-empty">No board in analysis queue.</div>}
               {analiticsQueue.map((entry) => (
                 <div className={`analitics-item ${entry.analyzing ? 'running' : ''}`} key={entry.id}>
@@ -919,6 +932,8 @@ export default function App() {
                   <div className="analitics-meta">
                     <div className="analitics-id">{entry.id}</div>
                     <div>Hits: {entry.hits}</div>
+                    <div>Visits: {entry.visits || 0}</div>
+                    <div>Expected reuse: {(entry.expected_reuse || 0).toFixed(1)}</div>
                     <div>
                       Depth: {entry.current_depth || 0}/{entry.target_depth || 0}
                     </div>